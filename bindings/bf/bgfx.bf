@@ -2173,6 +2173,7 @@ public static class bgfx
 			public uint32 maxTransientVbSize;
 			public uint32 maxTansientIbSize;
 			public uint32 minUniformBufferSize;
+			public uint32 maxSortThreads;
 		}
 	
 		public RendererType rendererType;
@@ -2229,6 +2230,13 @@ public static class bgfx
 			public uint32 maxTransientVbSize;
 			public uint32 maxTransientIbSize;
 			public uint32 minUniformBufferSize;
+			public uint16 maxSortThreads;
+			public uint8 maxQueuedFrames;
+			public uint32 maxDrawCalls;
+			public uint32 maxDrawCallsGrow;
+			public uint16 maxBlitItems;
+			public uint16 maxPipelineThreads;
+			public uint16 maxRecordThreads;
 		}
 	
 		public RendererType type;
@@ -2238,6 +2246,8 @@ public static class bgfx
 		public uint8 debug;
 		public uint8 profile;
 		public uint8 fallback;
+		public uint8 asyncPipelineCompile;
+		public uint8 singlePipelineCache;
 		public PlatformData platformData;
 		public Resolution resolution;
 		public Limits limits;
@@ -2355,11 +2365,22 @@ public static class bgfx
 		public int64 gpuTimerFreq;
 		public int64 waitRender;
 		public int64 waitSubmit;
+		public int64 queueLatency;
+		public int64 pipelineCompileTime;
+		public int64 uploadWaitTime;
+		public int64 cpuTimeSort;
 		public uint32 numDraw;
 		public uint32 numCompute;
 		public uint32 numBlit;
 		public uint32 maxGpuLatency;
 		public uint32 gpuFrameNum;
+		public uint32 numQueuedFrames;
+		public uint32 numPipelinesCompiled;
+		public uint32 numPipelinesPending;
+		public uint32 numDrawSkipped;
+		public uint32 numDescriptorSetsReused;
+		public uint32 numDescriptorSetsCreated;
+		public uint32 uploadSize;
 		public uint16 numDynamicIndexBuffers;
 		public uint16 numDynamicVertexBuffers;
 		public uint16 numFrameBuffers;
@@ -2402,6 +2423,12 @@ public static class bgfx
 	{
 	}
 	
+	[CRepr]
+	public struct DrawBundleHandle {
+	    public uint16 idx;
+	    public bool Valid => idx != uint16.MaxValue;
+	}
+	
 	[CRepr]
 	public struct DynamicIndexBufferHandle {
 	    public uint16 idx;
@@ -2731,6 +2758,20 @@ public static class bgfx
 	[LinkName("bgfx_alloc")]
 	public static extern Memory* alloc(uint32 _size);
 	
+	/// <summary>
+	/// Allocate buffer to pass to bgfx calls from per-frame arena. Buffer
+	/// doesn't need to be freed individually, whole arena is released at once
+	/// when frame is reused.
+	/// @remarks
+	///   Buffer must be passed to bgfx calls before next `bgfx::frame` call.
+	///   When arena is exhausted, falls back to `bgfx::alloc`.
+	/// </summary>
+	///
+	/// <param name="_size">Size to allocate.</param>
+	///
+	[LinkName("bgfx_alloc_frame")]
+	public static extern Memory* alloc_frame(uint32 _size);
+	
 	/// <summary>
 	/// Allocate buffer and copy data into it. Data will be freed inside bgfx.
 	/// </summary>
@@ -3167,6 +3208,36 @@ public static class bgfx
 	[LinkName("bgfx_destroy_program")]
 	public static extern void destroy_program(ProgramHandle _handle);
 	
+	/// <summary>
+	/// Compile pipeline for program, state, vertex layout and frame buffer
+	/// format combination ahead of first draw call using it. Pipeline is
+	/// compiled in background when `Init::Limits::maxPipelineThreads` is
+	/// not 0.
+	/// @remarks
+	///   Only renderers that compile pipeline state objects on first use
+	///   implement this, with other renderers it's no-op.
+	/// </summary>
+	///
+	/// <param name="_program">Program handle.</param>
+	/// <param name="_state">State flags. See: `BGFX_STATE_*`.</param>
+	/// <param name="_layoutHandle">Vertex layout handle.</param>
+	/// <param name="_frameBuffer">Frame buffer handle, pipeline is compiled for any frame buffer with same attachment formats. When handle is invalid, back buffer format is used.</param>
+	/// <param name="_numInstanceData">Number of instance data `vec4` attributes.</param>
+	///
+	[LinkName("bgfx_precache_pipeline")]
+	public static extern void precache_pipeline(ProgramHandle _program, uint64 _state, VertexLayoutHandle _layoutHandle, FrameBufferHandle _frameBuffer, uint8 _numInstanceData);
+	
+	/// <summary>
+	/// Write pipeline cache blob with `CallbackI::cacheWrite` if any pipeline
+	/// was compiled since it was last written.
+	/// @remarks
+	///   Only used when `Init::singlePipelineCache` is enabled, otherwise
+	///   it's no-op.
+	/// </summary>
+	///
+	[LinkName("bgfx_save_pipeline_cache")]
+	public static extern void save_pipeline_cache();
+	
 	/// <summary>
 	/// Validate texture parameters.
 	/// </summary>
@@ -3581,6 +3652,23 @@ public static class bgfx
 	[LinkName("bgfx_destroy_occlusion_query")]
 	public static extern void destroy_occlusion_query(OcclusionQueryHandle _handle);
 	
+	/// <summary>
+	/// Create draw bundle. Draw bundle stores pre-encoded draw calls which
+	/// can be submitted every frame without re-encoding them.
+	/// </summary>
+	///
+	[LinkName("bgfx_create_draw_bundle")]
+	public static extern DrawBundleHandle create_draw_bundle();
+	
+	/// <summary>
+	/// Destroy draw bundle.
+	/// </summary>
+	///
+	/// <param name="_handle">Handle to draw bundle object.</param>
+	///
+	[LinkName("bgfx_destroy_draw_bundle")]
+	public static extern void destroy_draw_bundle(DrawBundleHandle _handle);
+	
 	/// <summary>
 	/// Set palette color value.
 	/// </summary>
@@ -4139,6 +4227,37 @@ public static class bgfx
 	[LinkName("bgfx_encoder_submit_occlusion_query")]
 	public static extern void encoder_submit_occlusion_query(Encoder* _this, ViewId _id, ProgramHandle _program, OcclusionQueryHandle _occlusionQuery, uint32 _depth, uint8 _flags);
 	
+	/// <summary>
+	/// Begin recording draw calls into draw bundle. Submitted draw calls are
+	/// not rendered, instead they are stored with their transforms and
+	/// uniforms into draw bundle, replacing previous content of bundle.
+	/// @remarks
+	///   Transient buffers and occlusion queries can't be used while
+	///   recording draw bundle.
+	/// </summary>
+	///
+	/// <param name="_handle">Draw bundle.</param>
+	///
+	[LinkName("bgfx_encoder_begin_draw_bundle")]
+	public static extern void encoder_begin_draw_bundle(Encoder* _this, DrawBundleHandle _handle);
+	
+	/// <summary>
+	/// End recording draw calls into draw bundle.
+	/// </summary>
+	///
+	[LinkName("bgfx_encoder_end_draw_bundle")]
+	public static extern void encoder_end_draw_bundle(Encoder* _this);
+	
+	/// <summary>
+	/// Submit draw bundle for rendering.
+	/// </summary>
+	///
+	/// <param name="_handle">Draw bundle.</param>
+	/// <param name="_mtx">Transform applied to all transforms stored in draw bundle. Can be `NULL`.</param>
+	///
+	[LinkName("bgfx_encoder_submit_draw_bundle")]
+	public static extern void encoder_submit_draw_bundle(Encoder* _this, DrawBundleHandle _handle, void* _mtx);
+	
 	/// <summary>
 	/// Submit primitive for rendering with index and instance data info from
 	/// indirect buffer.
@@ -4719,6 +4838,37 @@ public static class bgfx
 	[LinkName("bgfx_submit_occlusion_query")]
 	public static extern void submit_occlusion_query(ViewId _id, ProgramHandle _program, OcclusionQueryHandle _occlusionQuery, uint32 _depth, uint8 _flags);
 	
+	/// <summary>
+	/// Begin recording draw calls into draw bundle. Submitted draw calls are
+	/// not rendered, instead they are stored with their transforms and
+	/// uniforms into draw bundle, replacing previous content of bundle.
+	/// @remarks
+	///   Transient buffers and occlusion queries can't be used while
+	///   recording draw bundle.
+	/// </summary>
+	///
+	/// <param name="_handle">Draw bundle.</param>
+	///
+	[LinkName("bgfx_begin_draw_bundle")]
+	public static extern void begin_draw_bundle(DrawBundleHandle _handle);
+	
+	/// <summary>
+	/// End recording draw calls into draw bundle.
+	/// </summary>
+	///
+	[LinkName("bgfx_end_draw_bundle")]
+	public static extern void end_draw_bundle();
+	
+	/// <summary>
+	/// Submit draw bundle for rendering.
+	/// </summary>
+	///
+	/// <param name="_handle">Draw bundle.</param>
+	/// <param name="_mtx">Transform applied to all transforms stored in draw bundle. Can be `NULL`.</param>
+	///
+	[LinkName("bgfx_submit_draw_bundle")]
+	public static extern void submit_draw_bundle(DrawBundleHandle _handle, void* _mtx);
+	
 	/// <summary>
 	/// Submit primitive for rendering with index and instance data info from
 	/// indirect buffer.
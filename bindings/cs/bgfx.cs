@@ -2152,6 +2152,7 @@ public static partial class bgfx
 			public uint maxTransientVbSize;
 			public uint maxTansientIbSize;
 			public uint minUniformBufferSize;
+			public uint maxSortThreads;
 		}
 	
 		public RendererType rendererType;
@@ -2203,6 +2204,13 @@ public static partial class bgfx
 			public uint maxTransientVbSize;
 			public uint maxTransientIbSize;
 			public uint minUniformBufferSize;
+			public ushort maxSortThreads;
+			public byte maxQueuedFrames;
+			public uint maxDrawCalls;
+			public uint maxDrawCallsGrow;
+			public ushort maxBlitItems;
+			public ushort maxPipelineThreads;
+			public ushort maxRecordThreads;
 		}
 	
 		public RendererType type;
@@ -2212,6 +2220,8 @@ public static partial class bgfx
 		public byte debug;
 		public byte profile;
 		public byte fallback;
+		public byte asyncPipelineCompile;
+		public byte singlePipelineCache;
 		public PlatformData platformData;
 		public Resolution resolution;
 		public Limits limits;
@@ -2318,11 +2328,22 @@ public static partial class bgfx
 		public long gpuTimerFreq;
 		public long waitRender;
 		public long waitSubmit;
+		public long queueLatency;
+		public long pipelineCompileTime;
+		public long uploadWaitTime;
+		public long cpuTimeSort;
 		public uint numDraw;
 		public uint numCompute;
 		public uint numBlit;
 		public uint maxGpuLatency;
 		public uint gpuFrameNum;
+		public uint numQueuedFrames;
+		public uint numPipelinesCompiled;
+		public uint numPipelinesPending;
+		public uint numDrawSkipped;
+		public uint numDescriptorSetsReused;
+		public uint numDescriptorSetsCreated;
+		public uint uploadSize;
 		public ushort numDynamicIndexBuffers;
 		public ushort numDynamicVertexBuffers;
 		public ushort numFrameBuffers;
@@ -2363,6 +2384,11 @@ public static partial class bgfx
 	{
 	}
 	
+	public struct DrawBundleHandle {
+	    public ushort idx;
+	    public bool Valid => idx != UInt16.MaxValue;
+	}
+	
 	public struct DynamicIndexBufferHandle {
 	    public ushort idx;
 	    public bool Valid => idx != UInt16.MaxValue;
@@ -2681,6 +2707,20 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_alloc", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe Memory* alloc(uint _size);
 	
+	/// <summary>
+	/// Allocate buffer to pass to bgfx calls from per-frame arena. Buffer
+	/// doesn't need to be freed individually, whole arena is released at once
+	/// when frame is reused.
+	/// @remarks
+	///   Buffer must be passed to bgfx calls before next `bgfx::frame` call.
+	///   When arena is exhausted, falls back to `bgfx::alloc`.
+	/// </summary>
+	///
+	/// <param name="_size">Size to allocate.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_alloc_frame", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe Memory* alloc_frame(uint _size);
+	
 	/// <summary>
 	/// Allocate buffer and copy data into it. Data will be freed inside bgfx.
 	/// </summary>
@@ -3118,6 +3158,36 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_destroy_program", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void destroy_program(ProgramHandle _handle);
 	
+	/// <summary>
+	/// Compile pipeline for program, state, vertex layout and frame buffer
+	/// format combination ahead of first draw call using it. Pipeline is
+	/// compiled in background when `Init::Limits::maxPipelineThreads` is
+	/// not 0.
+	/// @remarks
+	///   Only renderers that compile pipeline state objects on first use
+	///   implement this, with other renderers it's no-op.
+	/// </summary>
+	///
+	/// <param name="_program">Program handle.</param>
+	/// <param name="_state">State flags. See: `BGFX_STATE_*`.</param>
+	/// <param name="_layoutHandle">Vertex layout handle.</param>
+	/// <param name="_frameBuffer">Frame buffer handle, pipeline is compiled for any frame buffer with same attachment formats. When handle is invalid, back buffer format is used.</param>
+	/// <param name="_numInstanceData">Number of instance data `vec4` attributes.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_precache_pipeline", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void precache_pipeline(ProgramHandle _program, ulong _state, VertexLayoutHandle _layoutHandle, FrameBufferHandle _frameBuffer, byte _numInstanceData);
+	
+	/// <summary>
+	/// Write pipeline cache blob with `CallbackI::cacheWrite` if any pipeline
+	/// was compiled since it was last written.
+	/// @remarks
+	///   Only used when `Init::singlePipelineCache` is enabled, otherwise
+	///   it's no-op.
+	/// </summary>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_save_pipeline_cache", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void save_pipeline_cache();
+	
 	/// <summary>
 	/// Validate texture parameters.
 	/// </summary>
@@ -3534,6 +3604,23 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_destroy_occlusion_query", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void destroy_occlusion_query(OcclusionQueryHandle _handle);
 	
+	/// <summary>
+	/// Create draw bundle. Draw bundle stores pre-encoded draw calls which
+	/// can be submitted every frame without re-encoding them.
+	/// </summary>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_create_draw_bundle", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe DrawBundleHandle create_draw_bundle();
+	
+	/// <summary>
+	/// Destroy draw bundle.
+	/// </summary>
+	///
+	/// <param name="_handle">Handle to draw bundle object.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_destroy_draw_bundle", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void destroy_draw_bundle(DrawBundleHandle _handle);
+	
 	/// <summary>
 	/// Set palette color value.
 	/// </summary>
@@ -4092,6 +4179,37 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_encoder_submit_occlusion_query", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void encoder_submit_occlusion_query(Encoder* _this, ushort _id, ProgramHandle _program, OcclusionQueryHandle _occlusionQuery, uint _depth, byte _flags);
 	
+	/// <summary>
+	/// Begin recording draw calls into draw bundle. Submitted draw calls are
+	/// not rendered, instead they are stored with their transforms and
+	/// uniforms into draw bundle, replacing previous content of bundle.
+	/// @remarks
+	///   Transient buffers and occlusion queries can't be used while
+	///   recording draw bundle.
+	/// </summary>
+	///
+	/// <param name="_handle">Draw bundle.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_begin_draw_bundle", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void encoder_begin_draw_bundle(Encoder* _this, DrawBundleHandle _handle);
+	
+	/// <summary>
+	/// End recording draw calls into draw bundle.
+	/// </summary>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_end_draw_bundle", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void encoder_end_draw_bundle(Encoder* _this);
+	
+	/// <summary>
+	/// Submit draw bundle for rendering.
+	/// </summary>
+	///
+	/// <param name="_handle">Draw bundle.</param>
+	/// <param name="_mtx">Transform applied to all transforms stored in draw bundle. Can be `NULL`.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_encoder_submit_draw_bundle", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void encoder_submit_draw_bundle(Encoder* _this, DrawBundleHandle _handle, void* _mtx);
+	
 	/// <summary>
 	/// Submit primitive for rendering with index and instance data info from
 	/// indirect buffer.
@@ -4672,6 +4790,37 @@ public static partial class bgfx
 	[DllImport(DllName, EntryPoint="bgfx_submit_occlusion_query", CallingConvention = CallingConvention.Cdecl)]
 	public static extern unsafe void submit_occlusion_query(ushort _id, ProgramHandle _program, OcclusionQueryHandle _occlusionQuery, uint _depth, byte _flags);
 	
+	/// <summary>
+	/// Begin recording draw calls into draw bundle. Submitted draw calls are
+	/// not rendered, instead they are stored with their transforms and
+	/// uniforms into draw bundle, replacing previous content of bundle.
+	/// @remarks
+	///   Transient buffers and occlusion queries can't be used while
+	///   recording draw bundle.
+	/// </summary>
+	///
+	/// <param name="_handle">Draw bundle.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_begin_draw_bundle", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void begin_draw_bundle(DrawBundleHandle _handle);
+	
+	/// <summary>
+	/// End recording draw calls into draw bundle.
+	/// </summary>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_end_draw_bundle", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void end_draw_bundle();
+	
+	/// <summary>
+	/// Submit draw bundle for rendering.
+	/// </summary>
+	///
+	/// <param name="_handle">Draw bundle.</param>
+	/// <param name="_mtx">Transform applied to all transforms stored in draw bundle. Can be `NULL`.</param>
+	///
+	[DllImport(DllName, EntryPoint="bgfx_submit_draw_bundle", CallingConvention = CallingConvention.Cdecl)]
+	public static extern unsafe void submit_draw_bundle(DrawBundleHandle _handle, void* _mtx);
+	
 	/// <summary>
 	/// Submit primitive for rendering with index and instance data info from
 	/// indirect buffer.
@@ -1365,6 +1365,7 @@ pub const Caps = extern struct {
         maxTransientVbSize: u32,
         maxTansientIbSize: u32,
         minUniformBufferSize: u32,
+        maxSortThreads: u32,
     };
 
         rendererType: RendererType,
@@ -1411,6 +1412,13 @@ pub const Init = extern struct {
         maxTransientVbSize: u32,
         maxTransientIbSize: u32,
         minUniformBufferSize: u32,
+        maxSortThreads: u16,
+        maxQueuedFrames: u8,
+        maxDrawCalls: u32,
+        maxDrawCallsGrow: u32,
+        maxBlitItems: u16,
+        maxPipelineThreads: u16,
+        maxRecordThreads: u16,
     };
 
         type: RendererType,
@@ -1420,6 +1428,8 @@ pub const Init = extern struct {
         debug: bool,
         profile: bool,
         fallback: bool,
+        asyncPipelineCompile: bool,
+        singlePipelineCache: bool,
         platformData: PlatformData,
         resolution: Resolution,
         limits: Limits,
@@ -1525,11 +1535,22 @@ pub const Init = extern struct {
         gpuTimerFreq: i64,
         waitRender: i64,
         waitSubmit: i64,
+        queueLatency: i64,
+        pipelineCompileTime: i64,
+        uploadWaitTime: i64,
+        cpuTimeSort: i64,
         numDraw: u32,
         numCompute: u32,
         numBlit: u32,
         maxGpuLatency: u32,
         gpuFrameNum: u32,
+        numQueuedFrames: u32,
+        numPipelinesCompiled: u32,
+        numPipelinesPending: u32,
+        numDrawSkipped: u32,
+        numDescriptorSetsReused: u32,
+        numDescriptorSetsCreated: u32,
+        uploadSize: u32,
         numDynamicIndexBuffers: u16,
         numDynamicVertexBuffers: u16,
         numFrameBuffers: u16,
@@ -1814,6 +1835,26 @@ pub const Init = extern struct {
         pub inline fn submitOcclusionQuery(self: ?*Encoder, _id: ViewId, _program: ProgramHandle, _occlusionQuery: OcclusionQueryHandle, _depth: u32, _flags: u8) void {
             return bgfx_encoder_submit_occlusion_query(self, _id, _program, _occlusionQuery, _depth, _flags);
         }
+        /// Begin recording draw calls into draw bundle. Submitted draw calls are
+        /// not rendered, instead they are stored with their transforms and
+        /// uniforms into draw bundle, replacing previous content of bundle.
+        /// @remarks
+        ///   Transient buffers and occlusion queries can't be used while
+        ///   recording draw bundle.
+        /// <param name="_handle">Draw bundle.</param>
+        pub inline fn beginDrawBundle(self: ?*Encoder, _handle: DrawBundleHandle) void {
+            return bgfx_encoder_begin_draw_bundle(self, _handle);
+        }
+        /// End recording draw calls into draw bundle.
+        pub inline fn endDrawBundle(self: ?*Encoder) void {
+            return bgfx_encoder_end_draw_bundle(self);
+        }
+        /// Submit draw bundle for rendering.
+        /// <param name="_handle">Draw bundle.</param>
+        /// <param name="_mtx">Transform applied to all transforms stored in draw bundle. Can be `NULL`.</param>
+        pub inline fn submitDrawBundle(self: ?*Encoder, _handle: DrawBundleHandle, _mtx: ?*const anyopaque) void {
+            return bgfx_encoder_submit_draw_bundle(self, _handle, _mtx);
+        }
         /// Submit primitive for rendering with index and instance data info from
         /// indirect buffer.
         /// @attention Availability depends on: `BGFX_CAPS_DRAW_INDIRECT`.
@@ -1933,6 +1974,10 @@ pub const Init = extern struct {
         }
     };
 
+pub const DrawBundleHandle = extern struct {
+    idx: c_ushort,
+};
+
 pub const DynamicIndexBufferHandle = extern struct {
     idx: c_ushort,
 };
@@ -2179,6 +2224,18 @@ pub inline fn alloc(_size: u32) [*c]const Memory {
 }
 extern fn bgfx_alloc(_size: u32) [*c]const Memory;
 
+/// Allocate buffer to pass to bgfx calls from per-frame arena. Buffer
+/// doesn't need to be freed individually, whole arena is released at once
+/// when frame is reused.
+/// @remarks
+///   Buffer must be passed to bgfx calls before next `bgfx::frame` call.
+///   When arena is exhausted, falls back to `bgfx::alloc`.
+/// <param name="_size">Size to allocate.</param>
+pub inline fn allocFrame(_size: u32) [*c]const Memory {
+    return bgfx_alloc_frame(_size);
+}
+extern fn bgfx_alloc_frame(_size: u32) [*c]const Memory;
+
 /// Allocate buffer and copy data into it. Data will be freed inside bgfx.
 /// <param name="_data">Pointer to data to be copied.</param>
 /// <param name="_size">Size of data to be copied.</param>
@@ -2514,6 +2571,33 @@ pub inline fn destroyProgram(_handle: ProgramHandle) void {
 }
 extern fn bgfx_destroy_program(_handle: ProgramHandle) void;
 
+/// Compile pipeline for program, state, vertex layout and frame buffer
+/// format combination ahead of first draw call using it. Pipeline is
+/// compiled in background when `Init::Limits::maxPipelineThreads` is
+/// not 0.
+/// @remarks
+///   Only renderers that compile pipeline state objects on first use
+///   implement this, with other renderers it's no-op.
+/// <param name="_program">Program handle.</param>
+/// <param name="_state">State flags. See: `BGFX_STATE_*`.</param>
+/// <param name="_layoutHandle">Vertex layout handle.</param>
+/// <param name="_frameBuffer">Frame buffer handle, pipeline is compiled for any frame buffer with same attachment formats. When handle is invalid, back buffer format is used.</param>
+/// <param name="_numInstanceData">Number of instance data `vec4` attributes.</param>
+pub inline fn precachePipeline(_program: ProgramHandle, _state: u64, _layoutHandle: VertexLayoutHandle, _frameBuffer: FrameBufferHandle, _numInstanceData: u8) void {
+    return bgfx_precache_pipeline(_program, _state, _layoutHandle, _frameBuffer, _numInstanceData);
+}
+extern fn bgfx_precache_pipeline(_program: ProgramHandle, _state: u64, _layoutHandle: VertexLayoutHandle, _frameBuffer: FrameBufferHandle, _numInstanceData: u8) void;
+
+/// Write pipeline cache blob with `CallbackI::cacheWrite` if any pipeline
+/// was compiled since it was last written.
+/// @remarks
+///   Only used when `Init::singlePipelineCache` is enabled, otherwise
+///   it's no-op.
+pub inline fn savePipelineCache() void {
+    return bgfx_save_pipeline_cache();
+}
+extern fn bgfx_save_pipeline_cache() void;
+
 /// Validate texture parameters.
 /// <param name="_depth">Depth dimension of volume texture.</param>
 /// <param name="_cubeMap">Indicates that texture contains cubemap.</param>
@@ -2869,6 +2953,20 @@ pub inline fn destroyOcclusionQuery(_handle: OcclusionQueryHandle) void {
 }
 extern fn bgfx_destroy_occlusion_query(_handle: OcclusionQueryHandle) void;
 
+/// Create draw bundle. Draw bundle stores pre-encoded draw calls which
+/// can be submitted every frame without re-encoding them.
+pub inline fn createDrawBundle() DrawBundleHandle {
+    return bgfx_create_draw_bundle();
+}
+extern fn bgfx_create_draw_bundle() DrawBundleHandle;
+
+/// Destroy draw bundle.
+/// <param name="_handle">Handle to draw bundle object.</param>
+pub inline fn destroyDrawBundle(_handle: DrawBundleHandle) void {
+    return bgfx_destroy_draw_bundle(_handle);
+}
+extern fn bgfx_destroy_draw_bundle(_handle: DrawBundleHandle) void;
+
 /// Set palette color value.
 /// <param name="_index">Index into palette.</param>
 /// <param name="_rgba">RGBA floating point values.</param>
@@ -3253,6 +3351,23 @@ extern fn bgfx_encoder_submit(self: ?*Encoder, _id: ViewId, _program: ProgramHan
 /// <param name="_flags">Discard or preserve states. See `BGFX_DISCARD_*`.</param>
 extern fn bgfx_encoder_submit_occlusion_query(self: ?*Encoder, _id: ViewId, _program: ProgramHandle, _occlusionQuery: OcclusionQueryHandle, _depth: u32, _flags: u8) void;
 
+/// Begin recording draw calls into draw bundle. Submitted draw calls are
+/// not rendered, instead they are stored with their transforms and
+/// uniforms into draw bundle, replacing previous content of bundle.
+/// @remarks
+///   Transient buffers and occlusion queries can't be used while
+///   recording draw bundle.
+/// <param name="_handle">Draw bundle.</param>
+extern fn bgfx_encoder_begin_draw_bundle(self: ?*Encoder, _handle: DrawBundleHandle) void;
+
+/// End recording draw calls into draw bundle.
+extern fn bgfx_encoder_end_draw_bundle(self: ?*Encoder) void;
+
+/// Submit draw bundle for rendering.
+/// <param name="_handle">Draw bundle.</param>
+/// <param name="_mtx">Transform applied to all transforms stored in draw bundle. Can be `NULL`.</param>
+extern fn bgfx_encoder_submit_draw_bundle(self: ?*Encoder, _handle: DrawBundleHandle, _mtx: ?*const anyopaque) void;
+
 /// Submit primitive for rendering with index and instance data info from
 /// indirect buffer.
 /// @attention Availability depends on: `BGFX_CAPS_DRAW_INDIRECT`.
@@ -3706,6 +3821,32 @@ pub inline fn submitOcclusionQuery(_id: ViewId, _program: ProgramHandle, _occlus
 }
 extern fn bgfx_submit_occlusion_query(_id: ViewId, _program: ProgramHandle, _occlusionQuery: OcclusionQueryHandle, _depth: u32, _flags: u8) void;
 
+/// Begin recording draw calls into draw bundle. Submitted draw calls are
+/// not rendered, instead they are stored with their transforms and
+/// uniforms into draw bundle, replacing previous content of bundle.
+/// @remarks
+///   Transient buffers and occlusion queries can't be used while
+///   recording draw bundle.
+/// <param name="_handle">Draw bundle.</param>
+pub inline fn beginDrawBundle(_handle: DrawBundleHandle) void {
+    return bgfx_begin_draw_bundle(_handle);
+}
+extern fn bgfx_begin_draw_bundle(_handle: DrawBundleHandle) void;
+
+/// End recording draw calls into draw bundle.
+pub inline fn endDrawBundle() void {
+    return bgfx_end_draw_bundle();
+}
+extern fn bgfx_end_draw_bundle() void;
+
+/// Submit draw bundle for rendering.
+/// <param name="_handle">Draw bundle.</param>
+/// <param name="_mtx">Transform applied to all transforms stored in draw bundle. Can be `NULL`.</param>
+pub inline fn submitDrawBundle(_handle: DrawBundleHandle, _mtx: ?*const anyopaque) void {
+    return bgfx_submit_draw_bundle(_handle, _mtx);
+}
+extern fn bgfx_submit_draw_bundle(_handle: DrawBundleHandle, _mtx: ?*const anyopaque) void;
+
 /// Submit primitive for rendering with index and instance data info from
 /// indirect buffer.
 /// @attention Availability depends on: `BGFX_CAPS_DRAW_INDIRECT`.
@@ -974,7 +974,7 @@ struct Mesh
 		for (::GroupArray::iterator it = mesh->m_groups.begin(), itEnd = mesh->m_groups.end(); it != itEnd; ++it)
 		{
 			Group group;
-			group.m_numVertices = it->m_numVertices;
+			group.m_numVertices = uint16_t(it->m_numVertices);
 			const uint32_t vertexSize = group.m_numVertices*stride;
 			group.m_vertices = (uint8_t*)malloc(vertexSize);
 			bx::memCopy(group.m_vertices, it->m_vertices, vertexSize);
@@ -985,7 +985,10 @@ struct Mesh
 			group.m_numIndices = it->m_numIndices;
 			const uint32_t indexSize = 2 * group.m_numIndices;
 			group.m_indices = (uint16_t*)malloc(indexSize);
-			bx::memCopy(group.m_indices, it->m_indices, indexSize);
+			for (uint32_t ii = 0; ii < group.m_numIndices; ++ii)
+			{
+				group.m_indices[ii] = uint16_t(it->m_indices[ii]);
+			}
 
 			mem = bgfx::makeRef(group.m_indices, indexSize);
 			group.m_ibh = bgfx::createIndexBuffer(mem);
@@ -119,6 +119,8 @@ public:
 		m_dim        = 16;
 		m_maxDim     = 40;
 		m_transform  = 0;
+		m_useBundle  = false;
+		m_bundleDim  = 0;
 
 		m_last = m_timeOffset = bx::getHPCounter();
 
@@ -135,6 +137,17 @@ public:
 		init.resolution.width  = m_width;
 		init.resolution.height = m_height;
 		init.resolution.reset  = m_reset;
+
+		// Parallel sort is opt-in. Comparing "Sort" timing between
+		// `--sort-threads 1` and `--sort-threads N` at the same dim
+		// measures parallel sort crossover point.
+		bx::CommandLine cmdLine(_argc, _argv);
+		uint32_t sortThreads = 0;
+		if (cmdLine.hasArg(sortThreads, '\0', "sort-threads") )
+		{
+			init.limits.maxSortThreads = uint16_t(sortThreads);
+		}
+
 		bgfx::init(init);
 
 		const bgfx::Caps* caps = bgfx::getCaps();
@@ -172,6 +185,10 @@ public:
 		// Create static index buffer.
 		m_ibh = bgfx::createIndexBuffer(bgfx::makeRef(s_cubeIndices, sizeof(s_cubeIndices) ) );
 
+		// Create draw bundle, draw calls are recorded into it when draw
+		// bundle mode is enabled.
+		m_bundle = bgfx::createDrawBundle();
+
 		// Imgui.
 		imguiCreate();
 
@@ -194,6 +211,7 @@ public:
 
 		// Cleanup.
 		imguiDestroy();
+		bgfx::destroy(m_bundle);
 		bgfx::destroy(m_ibh);
 		bgfx::destroy(m_vbh);
 		bgfx::destroy(m_program);
@@ -246,49 +264,84 @@ public:
 			const double freq = double(bx::getHPFrequency() );
 			float time = (float)( (now-m_timeOffset)/freq);
 
-			const float* mod = s_mod[_tid%BX_COUNTOF(s_mod)];
+			submitCubes(encoder, _tid, _xstart, _num, time, UINT16_MAX);
+
+			bgfx::end(encoder);
+		}
+	}
+
+	void submitCubes(bgfx::Encoder* _encoder, uint32_t _tid, uint32_t _xstart, uint32_t _num, float _time, uint16_t _scissor)
+	{
+		const float* mod = s_mod[_tid%BX_COUNTOF(s_mod)];
 
-			float mtxS[16];
-			const float scale = 0 == m_transform ? 0.25f : 0.0f;
-			bx::mtxScale(mtxS, scale, scale, scale);
+		float mtxS[16];
+		const float scale = 0 == m_transform ? 0.25f : 0.0f;
+		bx::mtxScale(mtxS, scale, scale, scale);
 
-			const float step = 0.6f;
-			float pos[3];
-			pos[0] = -step*m_dim / 2.0f;
-			pos[1] = -step*m_dim / 2.0f;
-			pos[2] = -15.0;
+		const float step = 0.6f;
+		float pos[3];
+		pos[0] = -step*m_dim / 2.0f;
+		pos[1] = -step*m_dim / 2.0f;
+		pos[2] = -15.0;
 
-			for (uint32_t zz = 0; zz < uint32_t(m_dim); ++zz)
+		for (uint32_t zz = 0; zz < uint32_t(m_dim); ++zz)
+		{
+			for (uint32_t yy = 0; yy < uint32_t(m_dim); ++yy)
 			{
-				for (uint32_t yy = 0; yy < uint32_t(m_dim); ++yy)
+				for (uint32_t xx = _xstart, xend = _xstart+_num; xx < xend; ++xx)
 				{
-					for (uint32_t xx = _xstart, xend = _xstart+_num; xx < xend; ++xx)
-					{
-						float mtxR[16];
-						bx::mtxRotateXYZ(mtxR
-							, (time + xx*0.21f)*mod[0]
-							, (time + yy*0.37f)*mod[1]
-							, (time + zz*0.13f)*mod[2]
-							);
-
-						float mtx[16];
-						bx::mtxMul(mtx, mtxS, mtxR);
-
-						mtx[12] = pos[0] + float(xx)*step;
-						mtx[13] = pos[1] + float(yy)*step;
-						mtx[14] = pos[2] + float(zz)*step;
-
-						encoder->setTransform(mtx);
-						encoder->setVertexBuffer(0, m_vbh);
-						encoder->setIndexBuffer(m_ibh);
-						encoder->setState(BGFX_STATE_DEFAULT);
-						encoder->submit(0, m_program);
-					}
+					float mtxR[16];
+					bx::mtxRotateXYZ(mtxR
+						, (_time + xx*0.21f)*mod[0]
+						, (_time + yy*0.37f)*mod[1]
+						, (_time + zz*0.13f)*mod[2]
+						);
+
+					float mtx[16];
+					bx::mtxMul(mtx, mtxS, mtxR);
+
+					mtx[12] = pos[0] + float(xx)*step;
+					mtx[13] = pos[1] + float(yy)*step;
+					mtx[14] = pos[2] + float(zz)*step;
+
+					_encoder->setTransform(mtx);
+					_encoder->setVertexBuffer(0, m_vbh);
+					_encoder->setIndexBuffer(m_ibh);
+					_encoder->setState(BGFX_STATE_DEFAULT);
+					_encoder->setScissor(_scissor);
+					_encoder->submit(0, m_program);
 				}
 			}
+		}
+	}
 
+	void recordBundle()
+	{
+		bgfx::Encoder* encoder = bgfx::begin();
+
+		if (NULL != encoder)
+		{
+			encoder->beginDrawBundle(m_bundle);
+
+			// Scissor rect is set once and referenced through rect cache by
+			// all recorded draw calls. Draw bundle keeps its own copy, so it
+			// can be replayed in later frames.
+			const uint16_t scissor = encoder->setScissor(
+				  uint16_t(m_width/8)
+				, uint16_t(m_height/8)
+				, uint16_t(m_width*3/4)
+				, uint16_t(m_height*3/4)
+				);
+
+			submitCubes(encoder, 0, 0, uint32_t(m_dim), 0.0f, scissor);
+
+			encoder->endDrawBundle();
 			bgfx::end(encoder);
 		}
+
+		m_bundleDim    = m_dim;
+		m_bundleWidth  = m_width;
+		m_bundleHeight = m_height;
 	}
 
 	bool update() override
@@ -358,6 +411,7 @@ public:
 			ImGui::Separator();
 
 			ImGui::Checkbox("Auto adjust", &m_autoAdjust);
+			ImGui::Checkbox("Draw bundle", &m_useBundle);
 
 			ImGui::SliderInt("Num threads", &m_numThreads, 1, m_maxThreads);
 			const uint32_t numThreads = m_numThreads;
@@ -370,6 +424,7 @@ public:
 			const bgfx::Stats* stats = bgfx::getStats();
 			ImGui::Text("GPU %0.6f [ms]", double(stats->gpuTimeEnd - stats->gpuTimeBegin)*1000.0/stats->gpuTimerFreq);
 			ImGui::Text("CPU %0.6f [ms]", double(stats->cpuTimeEnd - stats->cpuTimeBegin)*1000.0/stats->cpuTimerFreq);
+			ImGui::Text("Sort %0.6f [ms] (%d threads)", double(stats->cpuTimeSort)*1000.0/stats->cpuTimerFreq, bgfx::getCaps()->limits.maxSortThreads);
 			ImGui::Text("Waiting for render thread %0.6f [ms]", double(stats->waitRender) * toMs);
 			ImGui::Text("Waiting for submit thread %0.6f [ms]", double(stats->waitSubmit) * toMs);
 
@@ -397,7 +452,25 @@ public:
 			// if no other draw calls are submitted to view 0.
 			bgfx::touch(0);
 
-			if (1 < numThreads)
+			if (m_useBundle)
+			{
+				// Draw calls are recorded once with scissor and replayed every
+				// frame, only bundle transform is animated.
+				if (m_bundleDim    != m_dim
+				||  m_bundleWidth  != m_width
+				||  m_bundleHeight != m_height)
+				{
+					recordBundle();
+				}
+
+				const float time = (float)( (now-m_timeOffset)/freq);
+
+				float mtx[16];
+				bx::mtxRotateZ(mtx, time*0.3f);
+
+				bgfx::submit(m_bundle, mtx);
+			}
+			else if (1 < numThreads)
 			{
 				for (uint32_t ii = 0; ii < numThreads; ++ii)
 				{
@@ -432,12 +505,16 @@ public:
 	uint32_t m_reset;
 
 	bool     m_autoAdjust;
+	bool     m_useBundle;
 	int32_t  m_scrollArea;
 	int32_t  m_dim;
 	int32_t  m_maxDim;
 	int32_t  m_transform;
 	int32_t  m_numThreads;
 	int32_t  m_maxThreads;
+	int32_t  m_bundleDim;
+	uint32_t m_bundleWidth;
+	uint32_t m_bundleHeight;
 
 	int64_t  m_last;
 	int64_t  m_timeOffset;
@@ -452,6 +529,7 @@ public:
 	bgfx::ProgramHandle m_program;
 	bgfx::VertexBufferHandle m_vbh;
 	bgfx::IndexBufferHandle  m_ibh;
+	bgfx::DrawBundleHandle   m_bundle;
 };
 
 int32_t threadFunc(bx::Thread* _thread, void* _userData)
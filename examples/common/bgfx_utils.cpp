@@ -370,6 +370,27 @@ void Group::reset()
 	m_numIndices = 0;
 	m_indices = NULL;
 	m_prims.clear();
+	m_meshlets.clear();
+}
+
+static uint32_t* copyIndices(bx::AllocatorI* _allocator, const void* _indices, uint32_t _numIndices, bool _index32)
+{
+	uint32_t* indices = (uint32_t*)bx::alloc(_allocator, _numIndices*sizeof(uint32_t) );
+
+	if (_index32)
+	{
+		bx::memCopy(indices, _indices, _numIndices*sizeof(uint32_t) );
+	}
+	else
+	{
+		const uint16_t* indices16 = (const uint16_t*)_indices;
+		for (uint32_t ii = 0; ii < _numIndices; ++ii)
+		{
+			indices[ii] = indices16[ii];
+		}
+	}
+
+	return indices;
 }
 
 namespace bgfx
@@ -379,11 +400,16 @@ namespace bgfx
 
 void Mesh::load(bx::ReaderSeekerI* _reader, bool _ramcopy)
 {
-	constexpr uint32_t kChunkVertexBuffer           = BX_MAKEFOURCC('V', 'B', ' ', 0x1);
-	constexpr uint32_t kChunkVertexBufferCompressed = BX_MAKEFOURCC('V', 'B', 'C', 0x0);
-	constexpr uint32_t kChunkIndexBuffer            = BX_MAKEFOURCC('I', 'B', ' ', 0x0);
-	constexpr uint32_t kChunkIndexBufferCompressed  = BX_MAKEFOURCC('I', 'B', 'C', 0x1);
-	constexpr uint32_t kChunkPrimitive              = BX_MAKEFOURCC('P', 'R', 'I', 0x0);
+	constexpr uint32_t kChunkVertexBuffer             = BX_MAKEFOURCC('V', 'B', ' ', 0x1);
+	constexpr uint32_t kChunkVertexBuffer32           = BX_MAKEFOURCC('V', 'B', ' ', 0x2);
+	constexpr uint32_t kChunkVertexBufferCompressed   = BX_MAKEFOURCC('V', 'B', 'C', 0x0);
+	constexpr uint32_t kChunkVertexBufferCompressed32 = BX_MAKEFOURCC('V', 'B', 'C', 0x1);
+	constexpr uint32_t kChunkIndexBuffer              = BX_MAKEFOURCC('I', 'B', ' ', 0x0);
+	constexpr uint32_t kChunkIndexBuffer32            = BX_MAKEFOURCC('I', 'B', ' ', 0x1);
+	constexpr uint32_t kChunkIndexBufferCompressed    = BX_MAKEFOURCC('I', 'B', 'C', 0x1);
+	constexpr uint32_t kChunkIndexBufferCompressed32  = BX_MAKEFOURCC('I', 'B', 'C', 0x2);
+	constexpr uint32_t kChunkMeshlet                  = BX_MAKEFOURCC('M', 'S', 'H', 0x0);
+	constexpr uint32_t kChunkPrimitive                = BX_MAKEFOURCC('P', 'R', 'I', 0x0);
 
 	using namespace bx;
 	using namespace bgfx;
@@ -400,6 +426,7 @@ void Mesh::load(bx::ReaderSeekerI* _reader, bool _ramcopy)
 		switch (chunk)
 		{
 			case kChunkVertexBuffer:
+			case kChunkVertexBuffer32:
 			{
 				read(_reader, group.m_sphere, &err);
 				read(_reader, group.m_aabb, &err);
@@ -409,7 +436,17 @@ void Mesh::load(bx::ReaderSeekerI* _reader, bool _ramcopy)
 
 				uint16_t stride = m_layout.getStride();
 
-				read(_reader, group.m_numVertices, &err);
+				if (kChunkVertexBuffer32 == chunk)
+				{
+					read(_reader, group.m_numVertices, &err);
+				}
+				else
+				{
+					uint16_t numVertices;
+					read(_reader, numVertices, &err);
+					group.m_numVertices = numVertices;
+				}
+
 				const bgfx::Memory* mem = bgfx::alloc(group.m_numVertices*stride);
 				read(_reader, mem->data, mem->size, &err);
 
@@ -424,6 +461,7 @@ void Mesh::load(bx::ReaderSeekerI* _reader, bool _ramcopy)
 				break;
 
 			case kChunkVertexBufferCompressed:
+			case kChunkVertexBufferCompressed32:
 			{
 				read(_reader, group.m_sphere, &err);
 				read(_reader, group.m_aabb, &err);
@@ -433,7 +471,16 @@ void Mesh::load(bx::ReaderSeekerI* _reader, bool _ramcopy)
 
 				uint16_t stride = m_layout.getStride();
 
-				read(_reader, group.m_numVertices, &err);
+				if (kChunkVertexBufferCompressed32 == chunk)
+				{
+					read(_reader, group.m_numVertices, &err);
+				}
+				else
+				{
+					uint16_t numVertices;
+					read(_reader, numVertices, &err);
+					group.m_numVertices = numVertices;
+				}
 
 				const bgfx::Memory* mem = bgfx::alloc(group.m_numVertices*stride);
 
@@ -458,27 +505,34 @@ void Mesh::load(bx::ReaderSeekerI* _reader, bool _ramcopy)
 				break;
 
 			case kChunkIndexBuffer:
+			case kChunkIndexBuffer32:
 			{
+				const bool index32 = kChunkIndexBuffer32 == chunk;
+				const uint16_t indexSize = index32 ? 4 : 2;
+
 				read(_reader, group.m_numIndices, &err);
 
-				const bgfx::Memory* mem = bgfx::alloc(group.m_numIndices*2);
+				const bgfx::Memory* mem = bgfx::alloc(group.m_numIndices*indexSize);
 				read(_reader, mem->data, mem->size, &err);
 
 				if (_ramcopy)
 				{
-					group.m_indices = (uint16_t*)bx::alloc(allocator, group.m_numIndices*2);
-					bx::memCopy(group.m_indices, mem->data, mem->size);
+					group.m_indices = copyIndices(allocator, mem->data, group.m_numIndices, index32);
 				}
 
-				group.m_ibh = bgfx::createIndexBuffer(mem);
+				group.m_ibh = bgfx::createIndexBuffer(mem, index32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE);
 			}
 				break;
 
 			case kChunkIndexBufferCompressed:
+			case kChunkIndexBufferCompressed32:
 			{
+				const bool index32 = kChunkIndexBufferCompressed32 == chunk;
+				const uint16_t indexSize = index32 ? 4 : 2;
+
 				bx::read(_reader, group.m_numIndices, &err);
 
-				const bgfx::Memory* mem = bgfx::alloc(group.m_numIndices*2);
+				const bgfx::Memory* mem = bgfx::alloc(group.m_numIndices*indexSize);
 
 				uint32_t compressedSize;
 				bx::read(_reader, compressedSize, &err);
@@ -487,17 +541,36 @@ void Mesh::load(bx::ReaderSeekerI* _reader, bool _ramcopy)
 
 				bx::read(_reader, compressedIndices, compressedSize, &err);
 
-				meshopt_decodeIndexBuffer(mem->data, group.m_numIndices, 2, (uint8_t*)compressedIndices, compressedSize);
+				meshopt_decodeIndexBuffer(mem->data, group.m_numIndices, indexSize, (uint8_t*)compressedIndices, compressedSize);
 
 				bx::free(allocator, compressedIndices);
 
 				if (_ramcopy)
 				{
-					group.m_indices = (uint16_t*)bx::alloc(allocator, group.m_numIndices*2);
-					bx::memCopy(group.m_indices, mem->data, mem->size);
+					group.m_indices = copyIndices(allocator, mem->data, group.m_numIndices, index32);
 				}
 
-				group.m_ibh = bgfx::createIndexBuffer(mem);
+				group.m_ibh = bgfx::createIndexBuffer(mem, index32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE);
+			}
+				break;
+
+			case kChunkMeshlet:
+			{
+				uint32_t num;
+				read(_reader, num, &err);
+
+				for (uint32_t ii = 0; ii < num; ++ii)
+				{
+					Meshlet meshlet;
+					read(_reader, meshlet.m_startIndex, &err);
+					read(_reader, meshlet.m_numIndices, &err);
+					read(_reader, meshlet.m_sphere, &err);
+					read(_reader, meshlet.m_coneApex, sizeof(meshlet.m_coneApex), &err);
+					read(_reader, meshlet.m_coneAxis, sizeof(meshlet.m_coneAxis), &err);
+					read(_reader, meshlet.m_coneCutoff, &err);
+
+					group.m_meshlets.push_back(meshlet);
+				}
 			}
 				break;
 
@@ -100,6 +100,19 @@ struct Primitive
 
 typedef stl::vector<Primitive> PrimitiveArray;
 
+struct Meshlet
+{
+	uint32_t m_startIndex;
+	uint32_t m_numIndices;
+
+	bx::Sphere m_sphere;
+	float      m_coneApex[3];
+	float      m_coneAxis[3];
+	float      m_coneCutoff;
+};
+
+typedef stl::vector<Meshlet> MeshletArray;
+
 struct Group
 {
 	Group();
@@ -107,14 +120,15 @@ struct Group
 
 	bgfx::VertexBufferHandle m_vbh;
 	bgfx::IndexBufferHandle m_ibh;
-	uint16_t m_numVertices;
+	uint32_t m_numVertices;
 	uint8_t* m_vertices;
 	uint32_t m_numIndices;
-	uint16_t* m_indices;
+	uint32_t* m_indices;
 	bx::Sphere m_sphere;
 	bx::Aabb   m_aabb;
 	bx::Obb    m_obb;
 	PrimitiveArray m_prims;
+	MeshletArray m_meshlets;
 };
 typedef stl::vector<Group> GroupArray;
 
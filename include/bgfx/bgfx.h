@@ -462,6 +462,7 @@ namespace bgfx
 
 	constexpr uint16_t kInvalidHandle = UINT16_MAX;
 
+	BGFX_HANDLE(DrawBundleHandle)
 	BGFX_HANDLE(DynamicIndexBufferHandle)
 	BGFX_HANDLE(DynamicVertexBufferHandle)
 	BGFX_HANDLE(FrameBufferHandle)
@@ -743,6 +744,16 @@ namespace bgfx
 		bool profile;  //!< Enable device for profiling.
 		bool fallback; //!< Enable fallback to next available renderer.
 
+		/// Skip draw calls whose pipeline is still being compiled in background,
+		/// instead of stalling render thread until compilation is done.
+		bool asyncPipelineCompile;
+
+		/// Keep all compiled pipelines in single pipeline cache blob, which is
+		/// read with `CallbackI::cacheRead` once at init, and written back with
+		/// `CallbackI::cacheWrite` at shutdown, or on `bgfx::savePipelineCache`.
+		/// When disabled each pipeline is cached separately.
+		bool singlePipelineCache;
+
 		/// Platform data.
 		PlatformData platformData;
 
@@ -762,6 +773,36 @@ namespace bgfx
 			uint32_t maxTransientVbSize;   //!< Maximum transient vertex buffer size.
 			uint32_t maxTransientIbSize;   //!< Maximum transient index buffer size.
 			uint32_t minUniformBufferSize; //!< Mimimum uniform buffer size.
+
+			/// Maximum number of threads used to sort render items. Parallel
+			/// sort is disabled when set to 0 or 1.
+			uint16_t maxSortThreads;
+
+			/// Maximum number of frames API thread can queue ahead of render
+			/// thread (default: 1, max: 3). Larger values allow API thread to
+			/// run ahead during render thread spikes at cost of added latency.
+			uint8_t maxQueuedFrames;
+
+			/// Maximum number of draw calls per frame. Render item storage
+			/// is allocated at init.
+			uint32_t maxDrawCalls;
+
+			/// Maximum number of draw calls render item storage can grow to
+			/// when frame runs out of draw calls. Growth is disabled when
+			/// set to 0.
+			uint32_t maxDrawCallsGrow;
+
+			uint16_t maxBlitItems; //!< Maximum number of blit calls per frame.
+
+			/// Maximum number of threads used to compile pipelines in background.
+			/// Pipelines are compiled on render thread when set to 0.
+			uint16_t maxPipelineThreads;
+
+			/// Maximum number of threads used to record draw calls of views
+			/// in parallel. Used only by renderers that support recording
+			/// command buffers from multiple threads. Draw calls are recorded
+			/// on render thread when set to 0.
+			uint16_t maxRecordThreads;
 		};
 
 		Limits limits; //!< Configurable runtime limits.
@@ -863,6 +904,7 @@ namespace bgfx
 			uint32_t maxTransientVbSize;      //!< Maximum transient vertex buffer size.
 			uint32_t maxTransientIbSize;      //!< Maximum transient index buffer size.
 			uint32_t minUniformBufferSize;    //!< Mimimum uniform buffer size.
+			uint32_t maxSortThreads;          //!< Maximum number of threads used to sort render items.
 		};
 
 		Limits limits; //!< Renderer runtime limits.
@@ -1052,12 +1094,26 @@ namespace bgfx
 		int64_t waitRender;                 //!< Time spent waiting for render backend thread to finish issuing
 		                                    //!  draw commands to underlying graphics API.
 		int64_t waitSubmit;                 //!< Time spent waiting for submit thread to advance to next frame.
+		int64_t queueLatency;               //!< Time frame spent queued between `bgfx::frame` call and render
+		                                    //!  thread starting to process it.
+		int64_t pipelineCompileTime;        //!< CPU time spent compiling pipelines that finished compiling
+		                                    //!  during frame.
+		int64_t uploadWaitTime;             //!< Time render thread spent waiting for upload queue.
+		int64_t cpuTimeSort;                //!< Render thread time spent sorting render items.
 
 		uint32_t numDraw;                   //!< Number of draw calls submitted.
 		uint32_t numCompute;                //!< Number of compute calls submitted.
 		uint32_t numBlit;                   //!< Number of blit calls submitted.
 		uint32_t maxGpuLatency;             //!< GPU driver latency.
 		uint32_t gpuFrameNum;               //!< Frame which generated gpuTimeBegin, gpuTimeEnd.
+		uint32_t numQueuedFrames;           //!< Number of frames that were queued ahead of this frame.
+		uint32_t numPipelinesCompiled;      //!< Number of pipelines that finished compiling during frame.
+		uint32_t numPipelinesPending;       //!< Number of pipelines still being compiled in background.
+		uint32_t numDrawSkipped;            //!< Number of draw calls skipped because their pipeline was
+		                                    //!  still being compiled.
+		uint32_t numDescriptorSetsReused;   //!< Number of resource bindings served from descriptor set cache.
+		uint32_t numDescriptorSetsCreated;  //!< Number of resource bindings that required new descriptor set.
+		uint32_t uploadSize;                //!< Number of bytes uploaded through upload queue during frame.
 
 		uint16_t numDynamicIndexBuffers;    //!< Number of used dynamic index buffers.
 		uint16_t numDynamicVertexBuffers;   //!< Number of used dynamic vertex buffers.
@@ -1549,6 +1605,39 @@ namespace bgfx
 			, uint8_t _flags  = BGFX_DISCARD_ALL
 			);
 
+		/// Begin recording draw calls into draw bundle. Submitted draw calls are
+		/// not rendered, instead they are stored with their transforms and
+		/// uniforms into draw bundle, replacing previous content of bundle.
+		///
+		/// @param[in] _handle Draw bundle.
+		///
+		/// @remarks
+		///   Transient buffers and occlusion queries can't be used while
+		///   recording draw bundle.
+		///
+		/// @attention C99's equivalent binding is `bgfx_encoder_begin_draw_bundle`.
+		///
+		void beginDrawBundle(DrawBundleHandle _handle);
+
+		/// End recording draw calls into draw bundle.
+		///
+		/// @attention C99's equivalent binding is `bgfx_encoder_end_draw_bundle`.
+		///
+		void endDrawBundle();
+
+		/// Submit draw bundle for rendering.
+		///
+		/// @param[in] _handle Draw bundle.
+		/// @param[in] _mtx Transform applied to all transforms stored in draw
+		///   bundle. Can be `NULL`.
+		///
+		/// @attention C99's equivalent binding is `bgfx_encoder_submit_draw_bundle`.
+		///
+		void submit(
+			  DrawBundleHandle _handle
+			, const void* _mtx = NULL
+			);
+
 		/// Submit primitive for rendering with index and instance data info from
 		/// indirect buffer.
 		///
@@ -2175,6 +2264,20 @@ namespace bgfx
 	///
 	const Memory* alloc(uint32_t _size);
 
+	/// Allocate buffer to pass to bgfx calls from per-frame arena. Buffer
+	/// doesn't need to be freed individually, whole arena is released at once
+	/// when frame is reused.
+	///
+	/// @param[in] _size Size to allocate.
+	///
+	/// @remarks
+	///   Buffer must be passed to bgfx calls before next `bgfx::frame` call.
+	///   When arena is exhausted, falls back to `bgfx::alloc`.
+	///
+	/// @attention C99's equivalent binding is `bgfx_alloc_frame`.
+	///
+	const Memory* allocFrame(uint32_t _size);
+
 	/// Allocate buffer and copy data into it. Data will be freed inside bgfx.
 	///
 	/// @param[in] _data Pointer to data to be copied.
@@ -2759,6 +2862,44 @@ namespace bgfx
 	///
 	void destroy(ProgramHandle _handle);
 
+	/// Compile pipeline for program, state, vertex layout and frame buffer
+	/// format combination ahead of first draw call using it. Pipeline is
+	/// compiled in background when `Init::Limits::maxPipelineThreads` is
+	/// not 0.
+	///
+	/// @param[in] _program Program handle.
+	/// @param[in] _state State flags. See: `BGFX_STATE_*`.
+	/// @param[in] _layoutHandle Vertex layout handle.
+	/// @param[in] _frameBuffer Frame buffer handle, pipeline is compiled for
+	///   any frame buffer with same attachment formats. When handle is
+	///   invalid, back buffer format is used.
+	/// @param[in] _numInstanceData Number of instance data `vec4` attributes.
+	///
+	/// @remarks
+	///   Only renderers that compile pipeline state objects on first use
+	///   implement this, with other renderers it's no-op.
+	///
+	/// @attention C99's equivalent binding is `bgfx_precache_pipeline`.
+	///
+	void precachePipeline(
+		  ProgramHandle _program
+		, uint64_t _state
+		, VertexLayoutHandle _layoutHandle
+		, FrameBufferHandle _frameBuffer = BGFX_INVALID_HANDLE
+		, uint8_t _numInstanceData = 0
+		);
+
+	/// Write pipeline cache blob with `CallbackI::cacheWrite` if any pipeline
+	/// was compiled since it was last written.
+	///
+	/// @remarks
+	///   Only used when `Init::singlePipelineCache` is enabled, otherwise
+	///   it's no-op.
+	///
+	/// @attention C99's equivalent binding is `bgfx_save_pipeline_cache`.
+	///
+	void savePipelineCache();
+
 	/// Validate texture parameters.
 	///
 	/// @param[in] _depth Depth dimension of volume texture.
@@ -3393,6 +3534,23 @@ namespace bgfx
 	///
 	void destroy(OcclusionQueryHandle _handle);
 
+	/// Create draw bundle. Draw bundle stores pre-encoded draw calls which
+	/// can be submitted every frame without re-encoding them.
+	///
+	/// @returns Handle to draw bundle object.
+	///
+	/// @attention C99's equivalent binding is `bgfx_create_draw_bundle`.
+	///
+	DrawBundleHandle createDrawBundle();
+
+	/// Destroy draw bundle.
+	///
+	/// @param[in] _handle Handle to draw bundle object.
+	///
+	/// @attention C99's equivalent binding is `bgfx_destroy_draw_bundle`.
+	///
+	void destroy(DrawBundleHandle _handle);
+
 	/// Set palette color value.
 	///
 	/// @param[in] _index Index into palette.
@@ -4133,6 +4291,39 @@ namespace bgfx
 		, uint8_t _flags  = BGFX_DISCARD_ALL
 		);
 
+	/// Begin recording draw calls into draw bundle. Submitted draw calls are
+	/// not rendered, instead they are stored with their transforms and
+	/// uniforms into draw bundle, replacing previous content of bundle.
+	///
+	/// @param[in] _handle Draw bundle.
+	///
+	/// @remarks
+	///   Transient buffers and occlusion queries can't be used while
+	///   recording draw bundle.
+	///
+	/// @attention C99's equivalent binding is `bgfx_begin_draw_bundle`.
+	///
+	void beginDrawBundle(DrawBundleHandle _handle);
+
+	/// End recording draw calls into draw bundle.
+	///
+	/// @attention C99's equivalent binding is `bgfx_end_draw_bundle`.
+	///
+	void endDrawBundle();
+
+	/// Submit draw bundle for rendering.
+	///
+	/// @param[in] _handle Draw bundle.
+	/// @param[in] _mtx Transform applied to all transforms stored in draw
+	///   bundle. Can be `NULL`.
+	///
+	/// @attention C99's equivalent binding is `bgfx_submit_draw_bundle`.
+	///
+	void submit(
+		  DrawBundleHandle _handle
+		, const void* _mtx = NULL
+		);
+
 	/// Submit primitive for rendering with index and instance data info from
 	/// indirect buffer.
 	///
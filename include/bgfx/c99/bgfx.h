@@ -499,6 +499,8 @@ typedef struct bgfx_callback_vtbl_s
 
 } bgfx_callback_vtbl_t;
 
+typedef struct bgfx_draw_bundle_handle_s { uint16_t idx; } bgfx_draw_bundle_handle_t;
+
 typedef struct bgfx_dynamic_index_buffer_handle_s { uint16_t idx; } bgfx_dynamic_index_buffer_handle_t;
 
 typedef struct bgfx_dynamic_vertex_buffer_handle_s { uint16_t idx; } bgfx_dynamic_vertex_buffer_handle_t;
@@ -577,6 +579,7 @@ typedef struct bgfx_caps_limits_s
     uint32_t             maxTransientVbSize; /** Maximum transient vertex buffer size.    */
     uint32_t             maxTansientIbSize;  /** Maximum transient index buffer size.     */
     uint32_t             minUniformBufferSize; /** Mimimum uniform buffer size.             */
+    uint32_t             maxSortThreads;     /** Maximum number of threads used to sort render items. */
 
 } bgfx_caps_limits_t;
 
@@ -704,6 +707,47 @@ typedef struct bgfx_init_limits_s
     uint32_t             maxTransientVbSize; /** Maximum transient vertex buffer size.    */
     uint32_t             maxTransientIbSize; /** Maximum transient index buffer size.     */
     uint32_t             minUniformBufferSize; /** Mimimum uniform buffer size.             */
+    
+    /**
+     * Maximum number of threads used to sort render items. Parallel
+     * sort is disabled when set to 0 or 1.
+     */
+    uint16_t             maxSortThreads;
+    
+    /**
+     * Maximum number of frames API thread can queue ahead of render
+     * thread (default: 1, max: 3). Larger values allow API thread to
+     * run ahead during render thread spikes at cost of added latency.
+     */
+    uint8_t              maxQueuedFrames;
+    
+    /**
+     * Maximum number of draw calls per frame. Render item storage
+     * is allocated at init.
+     */
+    uint32_t             maxDrawCalls;
+    
+    /**
+     * Maximum number of draw calls render item storage can grow to
+     * when frame runs out of draw calls. Growth is disabled when
+     * set to 0.
+     */
+    uint32_t             maxDrawCallsGrow;
+    uint16_t             maxBlitItems;       /** Maximum number of blit calls per frame.  */
+    
+    /**
+     * Maximum number of threads used to compile pipelines in background.
+     * Pipelines are compiled on render thread when set to 0.
+     */
+    uint16_t             maxPipelineThreads;
+    
+    /**
+     * Maximum number of threads used to record draw calls of views
+     * in parallel. Used only by renderers that support recording
+     * command buffers from multiple threads. Draw calls are recorded
+     * on render thread when set to 0.
+     */
+    uint16_t             maxRecordThreads;
 
 } bgfx_init_limits_t;
 
@@ -743,6 +787,20 @@ typedef struct bgfx_init_s
     bool                 debug;              /** Enable device for debugging.             */
     bool                 profile;            /** Enable device for profiling.             */
     bool                 fallback;           /** Enable fallback to next available renderer. */
+    
+    /**
+     * Skip draw calls whose pipeline is still being compiled in background,
+     * instead of stalling render thread until compilation is done.
+     */
+    bool                 asyncPipelineCompile;
+    
+    /**
+     * Keep all compiled pipelines in single pipeline cache blob, which is
+     * read with `CallbackI::cacheRead` once at init, and written back with
+     * `CallbackI::cacheWrite` at shutdown, or on `bgfx::savePipelineCache`.
+     * When disabled each pipeline is cached separately.
+     */
+    bool                 singlePipelineCache;
     bgfx_platform_data_t platformData;       /** Platform data.                           */
     bgfx_resolution_t    resolution;         /** Backbuffer resolution and reset parameters. See: `bgfx::Resolution`. */
     bgfx_init_limits_t   limits;             /** Configurable runtime limits parameters.  */
@@ -918,11 +976,22 @@ typedef struct bgfx_stats_s
     int64_t              gpuTimerFreq;       /** GPU timer frequency.                     */
     int64_t              waitRender;         /** Time spent waiting for render backend thread to finish issuing draw commands to underlying graphics API. */
     int64_t              waitSubmit;         /** Time spent waiting for submit thread to advance to next frame. */
+    int64_t              queueLatency;       /** Time frame spent queued between `bgfx::frame` call and render thread starting to process it. */
+    int64_t              pipelineCompileTime; /** CPU time spent compiling pipelines that finished compiling during frame. */
+    int64_t              uploadWaitTime;     /** Time render thread spent waiting for upload queue. */
+    int64_t              cpuTimeSort;        /** Render thread time spent sorting render items. */
     uint32_t             numDraw;            /** Number of draw calls submitted.          */
     uint32_t             numCompute;         /** Number of compute calls submitted.       */
     uint32_t             numBlit;            /** Number of blit calls submitted.          */
     uint32_t             maxGpuLatency;      /** GPU driver latency.                      */
     uint32_t             gpuFrameNum;        /** Frame which generated gpuTimeBegin, gpuTimeEnd. */
+    uint32_t             numQueuedFrames;    /** Number of frames that were queued ahead of this frame. */
+    uint32_t             numPipelinesCompiled; /** Number of pipelines that finished compiling during frame. */
+    uint32_t             numPipelinesPending; /** Number of pipelines still being compiled in background. */
+    uint32_t             numDrawSkipped;     /** Number of draw calls skipped because their pipeline was still being compiled. */
+    uint32_t             numDescriptorSetsReused; /** Number of resource bindings served from descriptor set cache. */
+    uint32_t             numDescriptorSetsCreated; /** Number of resource bindings that required new descriptor set. */
+    uint32_t             uploadSize;         /** Number of bytes uploaded through upload queue during frame. */
     uint16_t             numDynamicIndexBuffers; /** Number of used dynamic index buffers.    */
     uint16_t             numDynamicVertexBuffers; /** Number of used dynamic vertex buffers.   */
     uint16_t             numFrameBuffers;    /** Number of used frame buffers.            */
@@ -1290,6 +1359,21 @@ BGFX_C_API const bgfx_stats_t* bgfx_get_stats(void);
  */
 BGFX_C_API const bgfx_memory_t* bgfx_alloc(uint32_t _size);
 
+/**
+ * Allocate buffer to pass to bgfx calls from per-frame arena. Buffer
+ * doesn't need to be freed individually, whole arena is released at once
+ * when frame is reused.
+ * @remarks
+ *   Buffer must be passed to bgfx calls before next `bgfx::frame` call.
+ *   When arena is exhausted, falls back to `bgfx::alloc`.
+ *
+ * @param[in] _size Size to allocate.
+ *
+ * @returns Allocated memory.
+ *
+ */
+BGFX_C_API const bgfx_memory_t* bgfx_alloc_frame(uint32_t _size);
+
 /**
  * Allocate buffer and copy data into it. Data will be freed inside bgfx.
  *
@@ -1807,6 +1891,36 @@ BGFX_C_API bgfx_program_handle_t bgfx_create_compute_program(bgfx_shader_handle_
  */
 BGFX_C_API void bgfx_destroy_program(bgfx_program_handle_t _handle);
 
+/**
+ * Compile pipeline for program, state, vertex layout and frame buffer
+ * format combination ahead of first draw call using it. Pipeline is
+ * compiled in background when `Init::Limits::maxPipelineThreads` is
+ * not 0.
+ * @remarks
+ *   Only renderers that compile pipeline state objects on first use
+ *   implement this, with other renderers it's no-op.
+ *
+ * @param[in] _program Program handle.
+ * @param[in] _state State flags. See: `BGFX_STATE_*`.
+ * @param[in] _layoutHandle Vertex layout handle.
+ * @param[in] _frameBuffer Frame buffer handle, pipeline is compiled for
+ *  any frame buffer with same attachment formats. When handle is
+ *  invalid, back buffer format is used.
+ * @param[in] _numInstanceData Number of instance data `vec4` attributes.
+ *
+ */
+BGFX_C_API void bgfx_precache_pipeline(bgfx_program_handle_t _program, uint64_t _state, bgfx_vertex_layout_handle_t _layoutHandle, bgfx_frame_buffer_handle_t _frameBuffer, uint8_t _numInstanceData);
+
+/**
+ * Write pipeline cache blob with `CallbackI::cacheWrite` if any pipeline
+ * was compiled since it was last written.
+ * @remarks
+ *   Only used when `Init::singlePipelineCache` is enabled, otherwise
+ *   it's no-op.
+ *
+ */
+BGFX_C_API void bgfx_save_pipeline_cache(void);
+
 /**
  * Validate texture parameters.
  *
@@ -2298,6 +2412,21 @@ BGFX_C_API bgfx_occlusion_query_result_t bgfx_get_result(bgfx_occlusion_query_ha
  */
 BGFX_C_API void bgfx_destroy_occlusion_query(bgfx_occlusion_query_handle_t _handle);
 
+/**
+ * Create draw bundle. Draw bundle stores pre-encoded draw calls which
+ * can be submitted every frame without re-encoding them.
+ *
+ */
+BGFX_C_API bgfx_draw_bundle_handle_t bgfx_create_draw_bundle(void);
+
+/**
+ * Destroy draw bundle.
+ *
+ * @param[in] _handle Handle to draw bundle object.
+ *
+ */
+BGFX_C_API void bgfx_destroy_draw_bundle(bgfx_draw_bundle_handle_t _handle);
+
 /**
  * Set palette color value.
  *
@@ -2847,6 +2976,35 @@ BGFX_C_API void bgfx_encoder_submit(bgfx_encoder_t* _this, bgfx_view_id_t _id, b
  */
 BGFX_C_API void bgfx_encoder_submit_occlusion_query(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_occlusion_query_handle_t _occlusionQuery, uint32_t _depth, uint8_t _flags);
 
+/**
+ * Begin recording draw calls into draw bundle. Submitted draw calls are
+ * not rendered, instead they are stored with their transforms and
+ * uniforms into draw bundle, replacing previous content of bundle.
+ * @remarks
+ *   Transient buffers and occlusion queries can't be used while
+ *   recording draw bundle.
+ *
+ * @param[in] _handle Draw bundle.
+ *
+ */
+BGFX_C_API void bgfx_encoder_begin_draw_bundle(bgfx_encoder_t* _this, bgfx_draw_bundle_handle_t _handle);
+
+/**
+ * End recording draw calls into draw bundle.
+ *
+ */
+BGFX_C_API void bgfx_encoder_end_draw_bundle(bgfx_encoder_t* _this);
+
+/**
+ * Submit draw bundle for rendering.
+ *
+ * @param[in] _handle Draw bundle.
+ * @param[in] _mtx Transform applied to all transforms stored in draw
+ *  bundle. Can be `NULL`.
+ *
+ */
+BGFX_C_API void bgfx_encoder_submit_draw_bundle(bgfx_encoder_t* _this, bgfx_draw_bundle_handle_t _handle, const void* _mtx);
+
 /**
  * Submit primitive for rendering with index and instance data info from
  * indirect buffer.
@@ -3431,6 +3589,35 @@ BGFX_C_API void bgfx_submit(bgfx_view_id_t _id, bgfx_program_handle_t _program,
  */
 BGFX_C_API void bgfx_submit_occlusion_query(bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_occlusion_query_handle_t _occlusionQuery, uint32_t _depth, uint8_t _flags);
 
+/**
+ * Begin recording draw calls into draw bundle. Submitted draw calls are
+ * not rendered, instead they are stored with their transforms and
+ * uniforms into draw bundle, replacing previous content of bundle.
+ * @remarks
+ *   Transient buffers and occlusion queries can't be used while
+ *   recording draw bundle.
+ *
+ * @param[in] _handle Draw bundle.
+ *
+ */
+BGFX_C_API void bgfx_begin_draw_bundle(bgfx_draw_bundle_handle_t _handle);
+
+/**
+ * End recording draw calls into draw bundle.
+ *
+ */
+BGFX_C_API void bgfx_end_draw_bundle(void);
+
+/**
+ * Submit draw bundle for rendering.
+ *
+ * @param[in] _handle Draw bundle.
+ * @param[in] _mtx Transform applied to all transforms stored in draw
+ *  bundle. Can be `NULL`.
+ *
+ */
+BGFX_C_API void bgfx_submit_draw_bundle(bgfx_draw_bundle_handle_t _handle, const void* _mtx);
+
 /**
  * Submit primitive for rendering with index and instance data info from
  * indirect buffer.
@@ -3620,6 +3807,7 @@ typedef enum bgfx_function_id
     BGFX_FUNCTION_ID_GET_CAPS,
     BGFX_FUNCTION_ID_GET_STATS,
     BGFX_FUNCTION_ID_ALLOC,
+    BGFX_FUNCTION_ID_ALLOC_FRAME,
     BGFX_FUNCTION_ID_COPY,
     BGFX_FUNCTION_ID_MAKE_REF,
     BGFX_FUNCTION_ID_MAKE_REF_RELEASE,
@@ -3660,6 +3848,8 @@ typedef enum bgfx_function_id
     BGFX_FUNCTION_ID_CREATE_PROGRAM,
     BGFX_FUNCTION_ID_CREATE_COMPUTE_PROGRAM,
     BGFX_FUNCTION_ID_DESTROY_PROGRAM,
+    BGFX_FUNCTION_ID_PRECACHE_PIPELINE,
+    BGFX_FUNCTION_ID_SAVE_PIPELINE_CACHE,
     BGFX_FUNCTION_ID_IS_TEXTURE_VALID,
     BGFX_FUNCTION_ID_IS_FRAME_BUFFER_VALID,
     BGFX_FUNCTION_ID_CALC_TEXTURE_SIZE,
@@ -3690,6 +3880,8 @@ typedef enum bgfx_function_id
     BGFX_FUNCTION_ID_CREATE_OCCLUSION_QUERY,
     BGFX_FUNCTION_ID_GET_RESULT,
     BGFX_FUNCTION_ID_DESTROY_OCCLUSION_QUERY,
+    BGFX_FUNCTION_ID_CREATE_DRAW_BUNDLE,
+    BGFX_FUNCTION_ID_DESTROY_DRAW_BUNDLE,
     BGFX_FUNCTION_ID_SET_PALETTE_COLOR,
     BGFX_FUNCTION_ID_SET_PALETTE_COLOR_RGBA32F,
     BGFX_FUNCTION_ID_SET_PALETTE_COLOR_RGBA8,
@@ -3737,6 +3929,9 @@ typedef enum bgfx_function_id
     BGFX_FUNCTION_ID_ENCODER_TOUCH,
     BGFX_FUNCTION_ID_ENCODER_SUBMIT,
     BGFX_FUNCTION_ID_ENCODER_SUBMIT_OCCLUSION_QUERY,
+    BGFX_FUNCTION_ID_ENCODER_BEGIN_DRAW_BUNDLE,
+    BGFX_FUNCTION_ID_ENCODER_END_DRAW_BUNDLE,
+    BGFX_FUNCTION_ID_ENCODER_SUBMIT_DRAW_BUNDLE,
     BGFX_FUNCTION_ID_ENCODER_SUBMIT_INDIRECT,
     BGFX_FUNCTION_ID_ENCODER_SUBMIT_INDIRECT_COUNT,
     BGFX_FUNCTION_ID_ENCODER_SET_COMPUTE_INDEX_BUFFER,
@@ -3783,6 +3978,9 @@ typedef enum bgfx_function_id
     BGFX_FUNCTION_ID_TOUCH,
     BGFX_FUNCTION_ID_SUBMIT,
     BGFX_FUNCTION_ID_SUBMIT_OCCLUSION_QUERY,
+    BGFX_FUNCTION_ID_BEGIN_DRAW_BUNDLE,
+    BGFX_FUNCTION_ID_END_DRAW_BUNDLE,
+    BGFX_FUNCTION_ID_SUBMIT_DRAW_BUNDLE,
     BGFX_FUNCTION_ID_SUBMIT_INDIRECT,
     BGFX_FUNCTION_ID_SUBMIT_INDIRECT_COUNT,
     BGFX_FUNCTION_ID_SET_COMPUTE_INDEX_BUFFER,
@@ -3830,6 +4028,7 @@ struct bgfx_interface_vtbl
     const bgfx_caps_t* (*get_caps)(void);
     const bgfx_stats_t* (*get_stats)(void);
     const bgfx_memory_t* (*alloc)(uint32_t _size);
+    const bgfx_memory_t* (*alloc_frame)(uint32_t _size);
     const bgfx_memory_t* (*copy)(const void* _data, uint32_t _size);
     const bgfx_memory_t* (*make_ref)(const void* _data, uint32_t _size);
     const bgfx_memory_t* (*make_ref_release)(const void* _data, uint32_t _size, bgfx_release_fn_t _releaseFn, void* _userData);
@@ -3870,6 +4069,8 @@ struct bgfx_interface_vtbl
     bgfx_program_handle_t (*create_program)(bgfx_shader_handle_t _vsh, bgfx_shader_handle_t _fsh, bool _destroyShaders);
     bgfx_program_handle_t (*create_compute_program)(bgfx_shader_handle_t _csh, bool _destroyShaders);
     void (*destroy_program)(bgfx_program_handle_t _handle);
+    void (*precache_pipeline)(bgfx_program_handle_t _program, uint64_t _state, bgfx_vertex_layout_handle_t _layoutHandle, bgfx_frame_buffer_handle_t _frameBuffer, uint8_t _numInstanceData);
+    void (*save_pipeline_cache)(void);
     bool (*is_texture_valid)(uint16_t _depth, bool _cubeMap, uint16_t _numLayers, bgfx_texture_format_t _format, uint64_t _flags);
     bool (*is_frame_buffer_valid)(uint8_t _num, const bgfx_attachment_t* _attachment);
     void (*calc_texture_size)(bgfx_texture_info_t * _info, uint16_t _width, uint16_t _height, uint16_t _depth, bool _cubeMap, bool _hasMips, uint16_t _numLayers, bgfx_texture_format_t _format);
@@ -3900,6 +4101,8 @@ struct bgfx_interface_vtbl
     bgfx_occlusion_query_handle_t (*create_occlusion_query)(void);
     bgfx_occlusion_query_result_t (*get_result)(bgfx_occlusion_query_handle_t _handle, int32_t* _result);
     void (*destroy_occlusion_query)(bgfx_occlusion_query_handle_t _handle);
+    bgfx_draw_bundle_handle_t (*create_draw_bundle)(void);
+    void (*destroy_draw_bundle)(bgfx_draw_bundle_handle_t _handle);
     void (*set_palette_color)(uint8_t _index, const float _rgba[4]);
     void (*set_palette_color_rgba32f)(uint8_t _index, float _r, float _g, float _b, float _a);
     void (*set_palette_color_rgba8)(uint8_t _index, uint32_t _rgba);
@@ -3947,6 +4150,9 @@ struct bgfx_interface_vtbl
     void (*encoder_touch)(bgfx_encoder_t* _this, bgfx_view_id_t _id);
     void (*encoder_submit)(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, uint32_t _depth, uint8_t _flags);
     void (*encoder_submit_occlusion_query)(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_occlusion_query_handle_t _occlusionQuery, uint32_t _depth, uint8_t _flags);
+    void (*encoder_begin_draw_bundle)(bgfx_encoder_t* _this, bgfx_draw_bundle_handle_t _handle);
+    void (*encoder_end_draw_bundle)(bgfx_encoder_t* _this);
+    void (*encoder_submit_draw_bundle)(bgfx_encoder_t* _this, bgfx_draw_bundle_handle_t _handle, const void* _mtx);
     void (*encoder_submit_indirect)(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_indirect_buffer_handle_t _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags);
     void (*encoder_submit_indirect_count)(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_indirect_buffer_handle_t _indirectHandle, uint32_t _start, bgfx_index_buffer_handle_t _numHandle, uint32_t _numIndex, uint32_t _numMax, uint32_t _depth, uint8_t _flags);
     void (*encoder_set_compute_index_buffer)(bgfx_encoder_t* _this, uint8_t _stage, bgfx_index_buffer_handle_t _handle, bgfx_access_t _access);
@@ -3993,6 +4199,9 @@ struct bgfx_interface_vtbl
     void (*touch)(bgfx_view_id_t _id);
     void (*submit)(bgfx_view_id_t _id, bgfx_program_handle_t _program, uint32_t _depth, uint8_t _flags);
     void (*submit_occlusion_query)(bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_occlusion_query_handle_t _occlusionQuery, uint32_t _depth, uint8_t _flags);
+    void (*begin_draw_bundle)(bgfx_draw_bundle_handle_t _handle);
+    void (*end_draw_bundle)(void);
+    void (*submit_draw_bundle)(bgfx_draw_bundle_handle_t _handle, const void* _mtx);
     void (*submit_indirect)(bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_indirect_buffer_handle_t _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags);
     void (*submit_indirect_count)(bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_indirect_buffer_handle_t _indirectHandle, uint32_t _start, bgfx_index_buffer_handle_t _numHandle, uint32_t _numIndex, uint32_t _numMax, uint32_t _depth, uint8_t _flags);
     void (*set_compute_index_buffer)(uint8_t _stage, bgfx_index_buffer_handle_t _handle, bgfx_access_t _access);
@@ -369,6 +369,141 @@ namespace bgfx
 	PlatformData g_platformData;
 	bool g_platformDataChangedSinceReset = false;
 
+	/// Stored in front of every `Memory` block, and identifies allocator that
+	/// block came from.
+	struct MemoryHeader
+	{
+		enum Enum : uint32_t
+		{
+			Heap  = UINT32_MAX,
+			Arena = UINT32_MAX-1,
+		};
+
+		uint32_t source; //!< Pool size class index, `Heap`, or `Arena`.
+		uint32_t padding[3];
+	};
+
+	static_assert(sizeof(MemoryHeader) == 16, "MemoryHeader must keep Memory 16-byte aligned.");
+
+	/// Offset of data from `Memory` for blocks allocated by `bgfx::alloc` and
+	/// `bgfx::allocFrame`. `sizeof(Memory)` is only 8 bytes on 32-bit platforms,
+	/// so it's padded to keep `Memory::data` 16-byte aligned.
+	static constexpr uint32_t kMemoryDataOffset = (uint32_t(sizeof(Memory) ) + 15) & ~UINT32_C(15);
+
+	/// Thread-safe pool for small `Memory` blocks. Blocks are power of two size
+	/// classes carved out of pages, and each size class has its own lock and
+	/// free list. Pages are returned to allocator only on shutdown.
+	class MemoryPool
+	{
+	public:
+		static constexpr uint32_t kMinBlockShift = 6;     //!< 64 bytes.
+		static constexpr uint32_t kNumClasses    = 7;     //!< Up to 4KiB.
+		static constexpr uint32_t kPageSize      = 64<<10;
+		static constexpr uint32_t kPageHeader    = 64;
+
+		MemoryPool()
+		{
+			for (uint32_t ii = 0; ii < kNumClasses; ++ii)
+			{
+				m_class[ii].m_free  = NULL;
+				m_class[ii].m_pages = NULL;
+			}
+		}
+
+		void* alloc(uint32_t _size, uint32_t& _outClass)
+		{
+			uint32_t cls = 0;
+			for (uint32_t blockSize = 1<<kMinBlockShift; blockSize < _size && cls < kNumClasses; blockSize <<= 1)
+			{
+				++cls;
+			}
+
+			if (cls >= kNumClasses)
+			{
+				return NULL;
+			}
+
+			SizeClass& sc = m_class[cls];
+			bx::MutexScope scope(sc.m_lock);
+
+			if (NULL == sc.m_free)
+			{
+				Page* page = (Page*)bx::alignedAlloc(g_allocator, kPageSize, kPageHeader);
+				page->next = sc.m_pages;
+				sc.m_pages = page;
+
+				const uint32_t blockSize = 1<<(kMinBlockShift+cls);
+				uint8_t* data = (uint8_t*)page + kPageHeader;
+
+				for (uint32_t offset = 0; offset + blockSize <= kPageSize - kPageHeader; offset += blockSize)
+				{
+					Block* block = (Block*)&data[offset];
+					block->next = sc.m_free;
+					sc.m_free   = block;
+				}
+			}
+
+			Block* block = sc.m_free;
+			sc.m_free = block->next;
+
+			_outClass = cls;
+			return block;
+		}
+
+		void free(void* _ptr, uint32_t _class)
+		{
+			BX_ASSERT(_class < kNumClasses, "Invalid memory pool size class %d.", _class);
+
+			SizeClass& sc = m_class[_class];
+			bx::MutexScope scope(sc.m_lock);
+
+			Block* block = (Block*)_ptr;
+			block->next = sc.m_free;
+			sc.m_free   = block;
+		}
+
+		void shutdown()
+		{
+			for (uint32_t ii = 0; ii < kNumClasses; ++ii)
+			{
+				SizeClass& sc = m_class[ii];
+				bx::MutexScope scope(sc.m_lock);
+
+				for (Page* page = sc.m_pages; NULL != page;)
+				{
+					Page* next = page->next;
+					bx::alignedFree(g_allocator, page, kPageHeader);
+					page = next;
+				}
+
+				sc.m_free  = NULL;
+				sc.m_pages = NULL;
+			}
+		}
+
+	private:
+		struct Block
+		{
+			Block* next;
+		};
+
+		struct Page
+		{
+			Page* next;
+		};
+
+		struct SizeClass
+		{
+			bx::Mutex m_lock;
+			Block* m_free;
+			Page*  m_pages;
+		};
+
+		SizeClass m_class[kNumClasses];
+	};
+
+	static MemoryPool s_memoryPool;
+
 	static Handle::TypeName s_typeName[] =
 	{
 		{ "DIB",  "DynamicIndexBuffer"  },
@@ -1316,16 +1451,17 @@ namespace bgfx
 			return;
 		}
 
-		const uint32_t renderItemIdx = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numRenderItems, 1, BGFX_CONFIG_MAX_DRAW_CALLS);
-		if (BGFX_CONFIG_MAX_DRAW_CALLS <= renderItemIdx)
+		const uint32_t renderItemIdx = NULL == m_drawBundle
+			? allocRenderItem()
+			: 0
+			;
+		if (m_frame->m_maxRenderItems <= renderItemIdx)
 		{
 			discard(_flags);
 			++m_numDropped;
 			return;
 		}
 
-		++m_numSubmitted;
-
 		UniformBuffer* uniformBuffer = m_frame->m_uniformBuffer[m_uniformIdx];
 		m_uniformEnd = uniformBuffer->getPos();
 
@@ -1347,9 +1483,6 @@ namespace bgfx
 
 		uint64_t key = m_key.encodeDraw(type);
 
-		m_frame->m_sortKeys[renderItemIdx]   = key;
-		m_frame->m_sortValues[renderItemIdx] = RenderItemCount(renderItemIdx);
-
 		m_draw.m_uniformIdx   = m_uniformIdx;
 		m_draw.m_uniformBegin = m_uniformBegin;
 		m_draw.m_uniformEnd   = m_uniformEnd;
@@ -1375,8 +1508,21 @@ namespace bgfx
 			m_draw.m_occlusionQuery = _occlusionQuery;
 		}
 
-		m_frame->m_renderItem[renderItemIdx].draw = m_draw;
-		m_frame->m_renderItemBind[renderItemIdx]  = m_bind;
+		if (NULL != m_drawBundle)
+		{
+			BX_ASSERT(!isValid(_occlusionQuery), "Occlusion query can't be used with draw bundle.");
+			m_drawBundle->add(key, m_draw, m_bind, m_frame->m_frameCache, uniformBuffer);
+		}
+		else
+		{
+			++m_numSubmitted;
+
+			m_frame->m_sortKeys[renderItemIdx]   = key;
+			m_frame->m_sortValues[renderItemIdx] = RenderItemCount(renderItemIdx);
+
+			m_frame->m_renderItem[renderItemIdx].draw = m_draw;
+			m_frame->m_renderItemBind[renderItemIdx]  = m_bind;
+		}
 
 		m_draw.clear(_flags);
 		m_bind.clear(_flags);
@@ -1386,8 +1532,113 @@ namespace bgfx
 		}
 	}
 
+	void EncoderImpl::submit(const DrawBundle& _bundle, const float* _mtx)
+	{
+		BX_ASSERT(NULL == m_drawBundle, "Draw bundle can't be submitted while recording draw bundle.");
+
+		uint32_t num = _bundle.m_num;
+		if (0 == num)
+		{
+			return;
+		}
+
+		MatrixCache& matrixCache = m_frame->m_frameCache.m_matrixCache;
+		uint32_t numMatrices = _bundle.m_numMatrices;
+		const uint32_t firstMatrix = matrixCache.reserve(&numMatrices);
+
+		// Drop draws whose transforms didn't fit into matrix cache.
+		for (; 0 < num; --num)
+		{
+			const RenderDraw& draw = _bundle.m_draw[num-1];
+			if (draw.m_startMatrix + draw.m_numMatrices <= numMatrices)
+			{
+				break;
+			}
+		}
+
+		const uint32_t maxRenderItems = m_frame->m_maxRenderItems;
+		const uint32_t first = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numRenderItems, num, maxRenderItems);
+		const uint32_t numItems = bx::min(num, maxRenderItems - first);
+
+		m_numSubmitted += numItems;
+		m_numDropped   += _bundle.m_num - numItems;
+
+		if (numItems != _bundle.m_num)
+		{
+			m_frame->m_renderItemsFull = true;
+		}
+
+		if (NULL != _mtx)
+		{
+			for (uint32_t ii = 0; ii < numMatrices; ++ii)
+			{
+				bx::mtxMul(matrixCache.m_cache[firstMatrix+ii].un.val, _bundle.m_matrices[ii].un.val, _mtx);
+			}
+		}
+		else
+		{
+			bx::memCopy(&matrixCache.m_cache[firstMatrix], _bundle.m_matrices, numMatrices*sizeof(Matrix4) );
+		}
+
+		// Scissor rects are stored in the bundle, since rect cache indices
+		// are valid only in the frame the bundle was recorded in.
+		RectCache& rectCache = m_frame->m_frameCache.m_rectCache;
+		uint32_t numRects = _bundle.m_numRects;
+		const uint32_t firstRect = rectCache.reserve(&numRects);
+		bx::memCopy(&rectCache.m_cache[firstRect], _bundle.m_rects, numRects*sizeof(Rect) );
+
+		// Uniforms set for next draw call are moved after bundle uniforms,
+		// so that bundle uniforms are not applied to the next draw call.
+		const uint32_t pending = m_frame->m_uniformBuffer[m_uniformIdx]->getPos() - m_uniformBegin;
+		UniformBuffer::reserve(&m_frame->m_uniformBuffer[m_uniformIdx], _bundle.m_uniformSize + pending);
+
+		UniformBuffer* uniformBuffer = m_frame->m_uniformBuffer[m_uniformIdx];
+		const uint32_t uniformBase = uniformBuffer->getPos();
+		uniformBuffer->write(_bundle.m_uniforms, _bundle.m_uniformSize);
+		uniformBuffer->write(uniformBuffer->getData(m_uniformBegin), pending);
+		m_uniformBegin = uniformBuffer->getPos() - pending;
+
+		for (uint32_t ii = 0; ii < numItems; ++ii)
+		{
+			const uint32_t idx = first + ii;
+
+			uint64_t key = _bundle.m_keys[ii];
+			if (kSortKeyDrawTypeSequence == (key & kSortKeyDrawTypeMask) )
+			{
+				const ViewId view = ViewId( (key & kSortKeyViewMask) >> kSortKeyViewBitShift);
+				const uint64_t seq = uint64_t(s_ctx->getSeqIncr(view) ) << kSortKeyDraw2SeqShift;
+				key = (key & ~kSortKeyDraw2SeqMask) | (seq & kSortKeyDraw2SeqMask);
+			}
+
+			m_frame->m_sortKeys[idx]   = key;
+			m_frame->m_sortValues[idx] = RenderItemCount(idx);
+
+			RenderDraw& draw = m_frame->m_renderItem[idx].draw;
+			draw = _bundle.m_draw[ii];
+			draw.m_startMatrix  += firstMatrix;
+			draw.m_uniformIdx    = m_uniformIdx;
+
+			if (UINT16_MAX != draw.m_scissor)
+			{
+				// Draws whose scissor rect didn't fit into rect cache are not
+				// scissored.
+				draw.m_scissor = draw.m_scissor < numRects
+					? bx::narrowCast<uint16_t>(firstRect + draw.m_scissor)
+					: UINT16_MAX
+					;
+			}
+
+			draw.m_uniformBegin += uniformBase;
+			draw.m_uniformEnd   += uniformBase;
+
+			m_frame->m_renderItemBind[idx] = _bundle.m_bind[ii];
+		}
+	}
+
 	void EncoderImpl::dispatch(ViewId _id, ProgramHandle _handle, uint32_t _numX, uint32_t _numY, uint32_t _numZ, uint8_t _flags)
 	{
+		BX_ASSERT(NULL == m_drawBundle, "Compute dispatch can't be recorded into draw bundle.");
+
 		if (BX_ENABLED(BGFX_CONFIG_DEBUG_UNIFORM) )
 		{
 			m_uniformSet.clear();
@@ -1399,8 +1650,8 @@ namespace bgfx
 			return;
 		}
 
-		const uint32_t renderItemIdx = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numRenderItems, 1, BGFX_CONFIG_MAX_DRAW_CALLS);
-		if (BGFX_CONFIG_MAX_DRAW_CALLS-1 <= renderItemIdx)
+		const uint32_t renderItemIdx = allocRenderItem();
+		if (m_frame->m_maxRenderItems <= renderItemIdx)
 		{
 			discard(_flags);
 			++m_numDropped;
@@ -1440,12 +1691,13 @@ namespace bgfx
 
 	void EncoderImpl::blit(ViewId _id, TextureHandle _dst, uint8_t _dstMip, uint16_t _dstX, uint16_t _dstY, uint16_t _dstZ, TextureHandle _src, uint8_t _srcMip, uint16_t _srcX, uint16_t _srcY, uint16_t _srcZ, uint16_t _width, uint16_t _height, uint16_t _depth)
 	{
-		BX_WARN(m_frame->m_numBlitItems < BGFX_CONFIG_MAX_BLIT_ITEMS
-			, "Exceed number of available blit items per frame. BGFX_CONFIG_MAX_BLIT_ITEMS is %d. Skipping blit."
-			, BGFX_CONFIG_MAX_BLIT_ITEMS
+		const uint32_t maxBlitItems = m_frame->m_maxBlitItems;
+		BX_WARN(m_frame->m_numBlitItems < maxBlitItems
+			, "Exceed number of available blit items per frame. Limits.maxBlitItems is %d. Skipping blit."
+			, maxBlitItems
 			);
-		const uint32_t blitItemIdx = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numBlitItems, 1, BGFX_CONFIG_MAX_BLIT_ITEMS);
-		if (BGFX_CONFIG_MAX_BLIT_ITEMS-1 <= blitItemIdx)
+		const uint32_t blitItemIdx = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numBlitItems, 1, maxBlitItems);
+		if (maxBlitItems-1 <= blitItemIdx)
 		{
 			return;
 		}
@@ -1471,10 +1723,209 @@ namespace bgfx
 		m_frame->m_blitKeys[blitItemIdx] = key.encode();
 	}
 
+	void Frame::compactRenderItems(RenderItemRange* _unused, uint32_t _num)
+	{
+		BGFX_PROFILER_SCOPE("bgfx/Compact render items", kColorSubmit);
+
+		// Sort unused ranges by position, there is at most one range per encoder.
+		for (uint32_t ii = 1; ii < _num; ++ii)
+		{
+			const RenderItemRange range = _unused[ii];
+
+			uint32_t jj = ii;
+			for (; 0 < jj && _unused[jj-1].m_begin > range.m_begin; --jj)
+			{
+				_unused[jj] = _unused[jj-1];
+			}
+
+			_unused[jj] = range;
+		}
+
+		// Fill unused ranges with render items from the end of render item list.
+		uint32_t num   = m_numRenderItems;
+		uint32_t first = 0;
+		uint32_t last  = _num;
+
+		while (first < last)
+		{
+			RenderItemRange& tail = _unused[last-1];
+			if (tail.m_end >= num)
+			{
+				num = bx::min(num, tail.m_begin);
+				--last;
+				continue;
+			}
+
+			RenderItemRange& range = _unused[first];
+			if (range.m_begin == range.m_end)
+			{
+				++first;
+				continue;
+			}
+
+			--num;
+
+			const uint32_t dst = range.m_begin++;
+			m_sortKeys[dst]       = m_sortKeys[num];
+			m_sortValues[dst]     = RenderItemCount(dst);
+			m_renderItem[dst]     = m_renderItem[num];
+			m_renderItemBind[dst] = m_renderItemBind[num];
+		}
+
+		m_numRenderItems = num;
+	}
+
+	template<typename Ty>
+	static Ty* growArray(Ty* _ptr, uint32_t _num, uint32_t _max)
+	{
+		Ty* ptr = (Ty*)bx::alignedAlloc(g_allocator, _max*sizeof(Ty), BX_ALIGNOF(Ty) );
+
+		if (NULL != _ptr)
+		{
+			bx::memCopy(ptr, _ptr, _num*sizeof(Ty) );
+			bx::alignedFree(g_allocator, _ptr, BX_ALIGNOF(Ty) );
+		}
+
+		return ptr;
+	}
+
+	template<typename Ty>
+	static void freeArray(Ty*& _ptr)
+	{
+		if (NULL != _ptr)
+		{
+			bx::alignedFree(g_allocator, _ptr, BX_ALIGNOF(Ty) );
+			_ptr = NULL;
+		}
+	}
+
+	void DrawBundle::add(uint64_t _key, const RenderDraw& _draw, const RenderBind& _bind, const FrameCache& _frameCache, const UniformBuffer* _uniformBuffer)
+	{
+		if (m_num == m_max)
+		{
+			m_max  = bx::max(m_max*2, 64u);
+			m_keys = growArray(m_keys, m_num, m_max);
+			m_draw = growArray(m_draw, m_num, m_max);
+			m_bind = growArray(m_bind, m_num, m_max);
+		}
+
+		const uint32_t numMatrices = _draw.m_numMatrices;
+		if (m_numMatrices + numMatrices > m_maxMatrices)
+		{
+			m_maxMatrices = bx::max(m_maxMatrices*2, m_numMatrices + numMatrices);
+			m_matrices    = growArray(m_matrices, m_numMatrices, m_maxMatrices);
+		}
+
+		const uint32_t uniformSize = _draw.m_uniformEnd - _draw.m_uniformBegin;
+		if (m_uniformSize + uniformSize > m_maxUniformSize)
+		{
+			m_maxUniformSize = bx::max(m_maxUniformSize*2, m_uniformSize + uniformSize);
+			m_uniforms       = growArray(m_uniforms, m_uniformSize, m_maxUniformSize);
+		}
+
+		bx::memCopy(&m_matrices[m_numMatrices], &_frameCache.m_matrixCache.m_cache[_draw.m_startMatrix], numMatrices*sizeof(Matrix4) );
+		bx::memCopy(&m_uniforms[m_uniformSize], _uniformBuffer->getData(_draw.m_uniformBegin), uniformSize);
+
+		RenderDraw& draw = m_draw[m_num];
+		draw = _draw;
+		draw.m_startMatrix  = m_numMatrices;
+		draw.m_uniformBegin = m_uniformSize;
+		draw.m_uniformEnd   = m_uniformSize + uniformSize;
+
+		if (UINT16_MAX != _draw.m_scissor)
+		{
+			const Rect& rect = _frameCache.m_rectCache.m_cache[_draw.m_scissor];
+
+			// Consecutive draws usually share scissor rect, store it once.
+			if (0 == m_numRects
+			||  !rect.isEqual(m_rects[m_numRects-1]) )
+			{
+				if (m_numRects == m_maxRects)
+				{
+					m_maxRects = bx::max(m_maxRects*2, 16u);
+					m_rects    = growArray(m_rects, m_numRects, m_maxRects);
+				}
+
+				m_rects[m_numRects++] = rect;
+			}
+
+			draw.m_scissor = bx::narrowCast<uint16_t>(m_numRects-1);
+		}
+
+		m_keys[m_num] = _key;
+		m_bind[m_num] = _bind;
+
+		++m_num;
+		m_numMatrices += numMatrices;
+		m_uniformSize += uniformSize;
+	}
+
+	void DrawBundle::destroy()
+	{
+		freeArray(m_keys);
+		freeArray(m_draw);
+		freeArray(m_bind);
+		freeArray(m_matrices);
+		freeArray(m_rects);
+		freeArray(m_uniforms);
+
+		m_max            = 0;
+		m_maxMatrices    = 0;
+		m_maxRects       = 0;
+		m_maxUniformSize = 0;
+		reset();
+	}
+
+	void Frame::resizeRenderItems(uint32_t _num)
+	{
+		freeRenderItems();
+
+		m_maxRenderItems = _num;
+
+		const uint32_t num = _num+1;
+		m_sortKeys       = (uint64_t*)bx::alloc(g_allocator, num*sizeof(uint64_t) );
+		m_sortValues     = (RenderItemCount*)bx::alloc(g_allocator, num*sizeof(RenderItemCount) );
+		m_renderItem     = (RenderItem*)bx::alignedAlloc(g_allocator, num*sizeof(RenderItem), BX_ALIGNOF(RenderItem) );
+		m_renderItemBind = (RenderBind*)bx::alignedAlloc(g_allocator, num*sizeof(RenderBind), BX_ALIGNOF(RenderBind) );
+
+		bx::memSet(m_renderItemBind, 0, num*sizeof(RenderBind) );
+
+		SortKey term;
+		term.reset();
+		term.m_program = BGFX_INVALID_HANDLE;
+		m_sortKeys[_num]   = term.encodeDraw(SortKey::SortProgram);
+		m_sortValues[_num] = RenderItemCount(_num);
+
+		m_frameCache.m_matrixCache.create(bx::max<uint32_t>(num, BGFX_CONFIG_MAX_MATRIX_CACHE) );
+	}
+
+	void Frame::freeRenderItems()
+	{
+		if (0 == m_maxRenderItems)
+		{
+			return;
+		}
+
+		bx::free(g_allocator, m_sortKeys);
+		bx::free(g_allocator, m_sortValues);
+		bx::alignedFree(g_allocator, m_renderItem, BX_ALIGNOF(RenderItem) );
+		bx::alignedFree(g_allocator, m_renderItemBind, BX_ALIGNOF(RenderBind) );
+
+		m_frameCache.m_matrixCache.destroy();
+
+		m_sortKeys       = NULL;
+		m_sortValues     = NULL;
+		m_renderItem     = NULL;
+		m_renderItemBind = NULL;
+		m_maxRenderItems = 0;
+	}
+
 	void Frame::sort()
 	{
 		BGFX_PROFILER_SCOPE("bgfx/Sort", kColorSubmit);
 
+		const int64_t sortStart = bx::getHPCounter();
+
 		ViewId viewRemap[BGFX_CONFIG_MAX_VIEWS];
 		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_VIEWS; ++ii)
 		{
@@ -1510,21 +1961,244 @@ namespace bgfx
 			}
 		}
 
-		for (uint32_t ii = 0, num = m_numRenderItems; ii < num; ++ii)
+		s_ctx->reserveTemp(bx::max(m_numRenderItems, m_numBlitItems, m_uniformCacheFrame.m_numItems) );
+
+		if (1 < s_ctx->m_parallelSort.getNumThreads()
+		&&  BGFX_CONFIG_PARALLEL_SORT_MIN_ITEMS <= m_numRenderItems)
 		{
-			m_sortKeys[ii] = SortKey::remapView(m_sortKeys[ii], viewRemap);
+			s_ctx->m_parallelSort.sort(m_sortKeys, s_ctx->m_tempKeys, m_sortValues, s_ctx->m_tempValues, m_numRenderItems, viewRemap);
 		}
+		else
+		{
+			for (uint32_t ii = 0, num = m_numRenderItems; ii < num; ++ii)
+			{
+				m_sortKeys[ii] = SortKey::remapView(m_sortKeys[ii], viewRemap);
+			}
 
-		bx::radixSort(m_sortKeys, s_ctx->m_tempKeys, m_sortValues, s_ctx->m_tempValues, m_numRenderItems);
+			bx::radixSort(m_sortKeys, s_ctx->m_tempKeys, m_sortValues, s_ctx->m_tempValues, m_numRenderItems);
+		}
 
 		for (uint32_t ii = 0, num = m_numBlitItems; ii < num; ++ii)
 		{
 			m_blitKeys[ii] = BlitKey::remapView(m_blitKeys[ii], viewRemap);
 		}
 
-		bx::radixSort(m_blitKeys, (uint32_t*)&s_ctx->m_tempKeys, m_numBlitItems);
+		bx::radixSort(m_blitKeys, (uint32_t*)s_ctx->m_tempKeys, m_numBlitItems);
 
 		m_uniformCacheFrame.sort(viewRemap, s_ctx->m_tempKeys);
+
+		m_perfStats.cpuTimeSort = bx::getHPCounter() - sortStart;
+	}
+
+	ParallelSort::ParallelSort()
+		: m_numThreads(1)
+	{
+	}
+
+	ParallelSort::~ParallelSort()
+	{
+	}
+
+	void ParallelSort::init(uint32_t _numThreads)
+	{
+#if BX_CONFIG_SUPPORTS_THREADING
+		m_numThreads = bx::clamp<uint32_t>(_numThreads, 1, BGFX_CONFIG_MAX_SORT_THREADS);
+
+		for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+		{
+			ThreadData& td = m_threadData[ii];
+			td.m_sort = this;
+			td.m_idx  = ii;
+			m_thread[ii].init(threadFunc, &td, 0, "bgfx - sort thread");
+		}
+
+		BX_TRACE("Parallel sort threads: %d", m_numThreads);
+#else
+		BX_UNUSED(_numThreads);
+		m_numThreads = 1;
+#endif // BX_CONFIG_SUPPORTS_THREADING
+	}
+
+	void ParallelSort::shutdown()
+	{
+#if BX_CONFIG_SUPPORTS_THREADING
+		if (1 < m_numThreads)
+		{
+			m_job = Job::Exit;
+
+			for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+			{
+				m_workSem[ii].post();
+			}
+
+			for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+			{
+				m_thread[ii].shutdown();
+			}
+		}
+#endif // BX_CONFIG_SUPPORTS_THREADING
+
+		m_numThreads = 1;
+	}
+
+	int32_t ParallelSort::threadFunc(bx::Thread* /*_self*/, void* _userData)
+	{
+		BGFX_PROFILER_SET_CURRENT_THREAD_NAME("bgfx - Sort Thread");
+
+#if BX_CONFIG_SUPPORTS_THREADING
+		ThreadData* td = (ThreadData*)_userData;
+		ParallelSort* sort = td->m_sort;
+
+		for (;;)
+		{
+			sort->m_workSem[td->m_idx].wait();
+
+			if (Job::Exit == sort->m_job)
+			{
+				break;
+			}
+
+			sort->execute(td->m_idx);
+			sort->m_doneSem.post();
+		}
+#else
+		BX_UNUSED(_userData);
+#endif // BX_CONFIG_SUPPORTS_THREADING
+
+		return bx::kExitSuccess;
+	}
+
+	void ParallelSort::dispatch(Job::Enum _job)
+	{
+		m_job = _job;
+
+#if BX_CONFIG_SUPPORTS_THREADING
+		for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+		{
+			m_workSem[ii].post();
+		}
+#endif // BX_CONFIG_SUPPORTS_THREADING
+
+		execute(0);
+
+#if BX_CONFIG_SUPPORTS_THREADING
+		for (uint32_t ii = 1; ii < m_numThreads; ++ii)
+		{
+			m_doneSem.wait();
+		}
+#endif // BX_CONFIG_SUPPORTS_THREADING
+	}
+
+	void ParallelSort::execute(uint32_t _idx)
+	{
+		const uint32_t begin = uint32_t(uint64_t(m_num) *  _idx     / m_numThreads);
+		const uint32_t end   = uint32_t(uint64_t(m_num) * (_idx+1) / m_numThreads);
+		const uint32_t shift = m_pass * kRadixBits;
+
+		uint32_t* histogram = m_histogram[_idx];
+
+		switch (m_job)
+		{
+		case Job::Histogram:
+			{
+				if (0 == m_pass)
+				{
+					for (uint32_t ii = begin; ii < end; ++ii)
+					{
+						m_srcKeys[ii] = SortKey::remapView(m_srcKeys[ii], m_viewRemap);
+					}
+				}
+
+				bx::memSet(histogram, 0, sizeof(uint32_t)*kRadixHistogramSize);
+
+				for (uint32_t ii = begin; ii < end; ++ii)
+				{
+					const uint32_t index = uint32_t(m_srcKeys[ii] >> shift) & kRadixMask;
+					++histogram[index];
+				}
+			}
+			break;
+
+		case Job::Scatter:
+			{
+				// Histogram is converted into destination offsets by the calling thread.
+				for (uint32_t ii = begin; ii < end; ++ii)
+				{
+					const uint64_t key   = m_srcKeys[ii];
+					const uint32_t index = uint32_t(key >> shift) & kRadixMask;
+					const uint32_t dest  = histogram[index]++;
+					m_dstKeys[dest]   = key;
+					m_dstValues[dest] = m_srcValues[ii];
+				}
+			}
+			break;
+
+		default:
+			BX_ASSERT(false, "You should not be here.");
+			break;
+		}
+	}
+
+	void ParallelSort::sort(
+		  uint64_t* _keys
+		, uint64_t* _tempKeys
+		, RenderItemCount* _values
+		, RenderItemCount* _tempValues
+		, uint32_t _num
+		, ViewId* _viewRemap
+		)
+	{
+		BGFX_PROFILER_SCOPE("bgfx/Parallel sort", kColorSubmit);
+
+		m_srcKeys   = _keys;
+		m_dstKeys   = _tempKeys;
+		m_srcValues = _values;
+		m_dstValues = _tempValues;
+		m_viewRemap = _viewRemap;
+		m_num       = _num;
+
+		for (m_pass = 0; m_pass < kRadixPasses; ++m_pass)
+		{
+			dispatch(Job::Histogram);
+
+			// Convert per-thread histograms into per-thread scatter offsets. Items
+			// with the same digit from lower thread index slices go first, which
+			// keeps sort stable.
+			uint32_t offset = 0;
+			bool     skip   = false;
+
+			for (uint32_t ii = 0; ii < kRadixHistogramSize && !skip; ++ii)
+			{
+				uint32_t count = 0;
+
+				for (uint32_t jj = 0; jj < m_numThreads; ++jj)
+				{
+					const uint32_t num = m_histogram[jj][ii];
+					m_histogram[jj][ii] = offset + count;
+					count += num;
+				}
+
+				// All keys have the same digit, this pass would not change order.
+				skip    = count == _num;
+				offset += count;
+			}
+
+			if (skip)
+			{
+				continue;
+			}
+
+			dispatch(Job::Scatter);
+
+			bx::swap(m_srcKeys,   m_dstKeys);
+			bx::swap(m_srcValues, m_dstValues);
+		}
+
+		if (m_srcKeys != _keys)
+		{
+			bx::memCopy(_keys,   m_srcKeys,   _num*sizeof(uint64_t) );
+			bx::memCopy(_values, m_srcValues, _num*sizeof(RenderItemCount) );
+		}
 	}
 
 	RenderFrame::Enum renderFrame(int32_t _msecs)
@@ -1760,6 +2434,7 @@ namespace bgfx
 		LIMITS(maxTransientVbSize);
 		LIMITS(maxTransientIbSize);
 		LIMITS(minUniformBufferSize);
+		LIMITS(maxSortThreads);
 #undef LIMITS
 
 		BX_TRACE("");
@@ -2013,11 +2688,7 @@ namespace bgfx
 		m_frameTimeLast = bx::getHPCounter();
 		m_flipAfterRender = !!(m_init.resolution.reset & BGFX_RESET_FLIP_AFTER_RENDER);
 
-		m_submit->create(_init.limits.minResourceCbSize);
-
 #if BGFX_CONFIG_MULTITHREADED
-		m_render->create(_init.limits.minResourceCbSize);
-
 		if (s_renderFrameCalled)
 		{
 			// When bgfx::renderFrame is called before init render thread
@@ -2040,6 +2711,12 @@ namespace bgfx
 
 		BX_TRACE("Running in %s-threaded mode", m_singleThreaded ? "single" : "multi");
 
+		m_numFrames = BX_ENABLED(BGFX_CONFIG_MULTITHREADED)
+			? 1 + (m_singleThreaded ? 1 : _init.limits.maxQueuedFrames)
+			: 1
+			;
+		createFrames(_init.limits.minResourceCbSize);
+
 		s_threadIndex = BGFX_API_THREAD_MAGIC;
 
 		for (uint32_t ii = 0; ii < BX_COUNTOF(m_viewRemap); ++ii)
@@ -2067,6 +2744,8 @@ namespace bgfx
 
 		frameNoRenderWait();
 
+		m_parallelSort.init(_init.limits.maxSortThreads);
+
 		m_encoderHandle = bx::createHandleAlloc(g_allocator, _init.limits.maxEncoders);
 		m_encoder       = (EncoderImpl*)bx::alignedAlloc(g_allocator, sizeof(EncoderImpl)*_init.limits.maxEncoders, BX_ALIGNOF(EncoderImpl) );
 		m_encoderStats  = (EncoderStats*)bx::alloc(g_allocator, sizeof(EncoderStats)*_init.limits.maxEncoders);
@@ -2093,10 +2772,8 @@ namespace bgfx
 			frame();
 			frame();
 			m_vertexLayoutRef.shutdown(m_layoutHandle);
-			m_submit->destroy();
-#if BGFX_CONFIG_MULTITHREADED
-			m_render->destroy();
-#endif // BGFX_CONFIG_MULTITHREADED
+			m_parallelSort.shutdown();
+			destroyFrames();
 			return false;
 		}
 
@@ -2130,17 +2807,21 @@ namespace bgfx
 		m_textVideoMemBlitter.init(m_init.resolution.debugTextScale);
 		m_clearQuad.init();
 
-		m_submit->m_transientVb = createTransientVertexBuffer(_init.limits.maxTransientVbSize);
-		m_submit->m_transientIb = createTransientIndexBuffer(_init.limits.maxTransientIbSize);
-		frame();
-
-		if (BX_ENABLED(BGFX_CONFIG_MULTITHREADED) )
+		for (uint32_t ii = 0; ii < m_numFrames; ++ii)
 		{
 			m_submit->m_transientVb = createTransientVertexBuffer(_init.limits.maxTransientVbSize);
 			m_submit->m_transientIb = createTransientIndexBuffer(_init.limits.maxTransientIbSize);
 			frame();
 		}
 
+		// API thread is allowed to run ahead of render thread only after
+		// initialization is done, since init relies on frame() waiting for
+		// render thread.
+		for (uint32_t ii = 2; ii < m_numFrames; ++ii)
+		{
+			renderSemPost();
+		}
+
 		g_internalData.caps = getCaps();
 
 		return true;
@@ -2148,6 +2829,13 @@ namespace bgfx
 
 	void Context::shutdown()
 	{
+		// Wait for queued frames, shutdown sequence expects render thread to be
+		// at most one frame behind.
+		for (uint32_t ii = 2; ii < m_numFrames; ++ii)
+		{
+			renderSemWait();
+		}
+
 		getCommandBuffer(CommandBuffer::RendererShutdownBegin);
 		frame();
 
@@ -2157,7 +2845,7 @@ namespace bgfx
 		m_clearQuad.shutdown();
 		frame();
 
-		if (BX_ENABLED(BGFX_CONFIG_MULTITHREADED) )
+		for (uint32_t ii = 1; ii < m_numFrames; ++ii)
 		{
 			destroyTransientVertexBuffer(m_submit->m_transientVb);
 			destroyTransientIndexBuffer(m_submit->m_transientIb);
@@ -2182,9 +2870,6 @@ namespace bgfx
 		bx::alignedFree(g_allocator, m_encoder, BX_ALIGNOF(EncoderImpl) );
 		bx::free(g_allocator, m_encoderStats);
 
-		m_dynVertexBufferAllocator.compact();
-		m_dynIndexBufferAllocator.compact();
-
 		BX_ASSERT(
 			  m_layoutHandle.getNumHandles() == m_vertexLayoutRef.m_vertexLayoutMap.getNumElements()
 			, "VertexLayoutRef mismatch, num handles %d, handles in hash map %d."
@@ -2205,14 +2890,14 @@ namespace bgfx
 		{
 			m_thread.shutdown();
 		}
-
-		m_render->destroy();
 #endif // BGFX_CONFIG_MULTITHREADED
 
+		m_parallelSort.shutdown();
+
 		bx::memSet(&g_internalData, 0, sizeof(InternalData) );
 		s_ctx = NULL;
 
-		m_submit->destroy();
+		destroyFrames();
 
 		if (BX_ENABLED(BGFX_CONFIG_DEBUG) )
 		{
@@ -2288,9 +2973,63 @@ namespace bgfx
 			CHECK_HANDLE_LEAK_NAME   ("FrameBufferHandle",         m_frameBufferHandle,        FrameBufferRef, m_frameBufferRef);
 			CHECK_HANDLE_LEAK_RC_NAME("UniformHandle",             m_uniformHandle,            UniformRef,     m_uniformRef    );
 			CHECK_HANDLE_LEAK        ("OcclusionQueryHandle",      m_occlusionQueryHandle                                      );
+			CHECK_HANDLE_LEAK        ("DrawBundleHandle",          m_drawBundleHandle                                          );
 #undef CHECK_HANDLE_LEAK
 #undef CHECK_HANDLE_LEAK_NAME
 		}
+
+		for (uint16_t ii = 0, num = m_drawBundleHandle.getNumHandles(); ii < num; ++ii)
+		{
+			m_drawBundle[m_drawBundleHandle.getHandleAt(ii)].destroy();
+		}
+	}
+
+	void Context::createFrames(uint32_t _minResourceCbSize)
+	{
+		BX_TRACE("Number of frames: %d", m_numFrames);
+
+		for (uint32_t ii = 0; ii < m_numFrames; ++ii)
+		{
+			m_frame[ii] = BX_ALIGNED_NEW(g_allocator, Frame, BX_ALIGNOF(Frame) );
+			m_frame[ii]->create(_minResourceCbSize);
+		}
+
+		m_submitIdx = 0;
+		m_renderIdx = 0;
+		m_renderedIdx = 0;
+		m_numQueuedFrames = 0;
+		m_submit = m_frame[0];
+		m_render = m_frame[0];
+	}
+
+	void Context::destroyFrames()
+	{
+		for (uint32_t ii = 0; ii < m_numFrames; ++ii)
+		{
+			m_frame[ii]->destroy();
+			bx::deleteObject(g_allocator, m_frame[ii], BX_ALIGNOF(Frame) );
+			m_frame[ii] = NULL;
+		}
+
+		m_submit    = NULL;
+		m_render    = NULL;
+		m_numFrames = 0;
+
+		bx::free(g_allocator, m_tempKeys);
+		bx::free(g_allocator, m_tempValues);
+		m_tempKeys   = NULL;
+		m_tempValues = NULL;
+		m_maxTemp    = 0;
+	}
+
+	void Context::reserveTemp(uint32_t _num)
+	{
+		if (_num > m_maxTemp)
+		{
+			m_maxTemp    = bx::alignUp(_num, 4<<10);
+			m_tempKeys   = (uint64_t*)bx::realloc(g_allocator, m_tempKeys, m_maxTemp*sizeof(uint64_t) );
+			m_tempValues = (RenderItemCount*)bx::realloc(g_allocator, m_tempValues, m_maxTemp*sizeof(RenderItemCount) );
+		}
 	}
 
 	void Context::freeDynamicBuffers()
@@ -2459,9 +3198,29 @@ namespace bgfx
 
 		m_submit->finish();
 
-		bx::swap(m_render, m_submit);
+		Frame* queued = m_submit;
+		m_submitIdx = (m_submitIdx + 1) % m_numFrames;
+		m_submit    = m_frame[m_submitIdx];
 
-		bx::memCopy(m_render->m_occlusion, m_submit->m_occlusion, sizeof(m_submit->m_occlusion) );
+		if (queued != m_submit)
+		{
+			// Occlusion results are written by the render thread into the frame it's rendering.
+			// Take them from the most recently rendered frame, not from the oldest frame in the
+			// queue, so getResult doesn't lag behind by the queue depth.
+			const Frame* rendered = m_frame[bx::atomicFetchAndAdd<uint32_t>(&m_renderedIdx, 0)];
+			if (rendered != queued)
+			{
+				bx::memCopy(queued->m_occlusion, rendered->m_occlusion, sizeof(rendered->m_occlusion) );
+			}
+
+			if (rendered != m_submit)
+			{
+				bx::memCopy(m_submit->m_occlusion, rendered->m_occlusion, sizeof(rendered->m_occlusion) );
+			}
+		}
+
+		queued->m_submitTime = bx::getHPCounter();
+		queued->m_perfStats.numQueuedFrames = uint32_t(bx::atomicFetchAndAdd<int32_t>(&m_numQueuedFrames, 1) );
 
 		if (!BX_ENABLED(BGFX_CONFIG_MULTITHREADED)
 		||  m_singleThreaded)
@@ -2469,13 +3228,29 @@ namespace bgfx
 			renderFrame();
 		}
 
-		uint32_t nextFrameNum = m_render->m_frameNum + 1;
+		if (queued->m_renderItemsFull
+		||  queued->m_frameCache.m_matrixCache.isFull() )
+		{
+			const uint32_t maxDrawCalls = g_caps.limits.maxDrawCalls;
+			if (maxDrawCalls < m_init.limits.maxDrawCallsGrow)
+			{
+				g_caps.limits.maxDrawCalls = uint32_t(bx::min<uint64_t>(uint64_t(maxDrawCalls)*2, m_init.limits.maxDrawCallsGrow) );
+				BX_TRACE("Growing render item storage %d -> %d.", maxDrawCalls, g_caps.limits.maxDrawCalls);
+			}
+		}
+
+		if (m_submit->m_maxRenderItems < g_caps.limits.maxDrawCalls)
+		{
+			m_submit->resizeRenderItems(g_caps.limits.maxDrawCalls);
+		}
+
+		uint32_t nextFrameNum = queued->m_frameNum + 1;
 		m_submit->start(nextFrameNum);
 
 		bx::memSet(m_seq, 0, sizeof(m_seq) );
 
 		m_submit->m_textVideoMem->resize(
-			  m_render->m_textVideoMem->m_small
+			  queued->m_textVideoMem->m_small
 			, m_init.resolution.width
 			, m_init.resolution.height
 			);
@@ -2548,6 +3323,11 @@ namespace bgfx
 
 		if (apiSemWait(_msecs) )
 		{
+			const uint32_t renderIdx = m_renderIdx;
+			m_render    = m_frame[renderIdx];
+			m_renderIdx = (m_renderIdx + 1) % m_numFrames;
+			m_render->m_perfStats.queueLatency = bx::getHPCounter() - m_render->m_submitTime;
+
 			{
 				BGFX_PROFILER_SCOPE("bgfx/Exec commands pre", kColorResource);
 				rendererExecCommands(m_render->m_cmdPre);
@@ -2576,6 +3356,8 @@ namespace bgfx
 				rendererExecCommands(m_render->m_cmdPost);
 			}
 
+			bx::atomicCompareAndSwap<uint32_t>(&m_renderedIdx, m_renderedIdx, renderIdx);
+			bx::atomicFetchAndSub<int32_t>(&m_numQueuedFrames, 1);
 			renderSemPost();
 
 			if (m_flipAfterRender)
@@ -3530,6 +4312,37 @@ namespace bgfx
 				}
 				break;
 
+			case CommandBuffer::PrecachePipeline:
+				{
+					BGFX_PROFILER_SCOPE("PrecachePipeline", kColorResource);
+
+					ProgramHandle program;
+					_cmdbuf.read(program);
+
+					uint64_t state;
+					_cmdbuf.read(state);
+
+					VertexLayoutHandle layoutHandle;
+					_cmdbuf.read(layoutHandle);
+
+					FrameBufferHandle frameBuffer;
+					_cmdbuf.read(frameBuffer);
+
+					uint8_t numInstanceData;
+					_cmdbuf.read(numInstanceData);
+
+					m_renderCtx->precachePipeline(program, state, layoutHandle, frameBuffer, numInstanceData);
+				}
+				break;
+
+			case CommandBuffer::SavePipelineCache:
+				{
+					BGFX_PROFILER_SCOPE("SavePipelineCache", kColorResource);
+
+					m_renderCtx->savePipelineCache();
+				}
+				break;
+
 			default:
 				BX_ASSERT(false, "Invalid command: %d", command);
 				break;
@@ -3618,6 +4431,13 @@ namespace bgfx
 		, maxTransientVbSize(BGFX_CONFIG_MAX_TRANSIENT_VERTEX_BUFFER_SIZE)
 		, maxTransientIbSize(BGFX_CONFIG_MAX_TRANSIENT_INDEX_BUFFER_SIZE)
 		, minUniformBufferSize(BGFX_CONFIG_MIN_UNIFORM_BUFFER_SIZE)
+		, maxSortThreads(BGFX_CONFIG_DEFAULT_MAX_SORT_THREADS)
+		, maxQueuedFrames(BGFX_CONFIG_DEFAULT_MAX_QUEUED_FRAMES)
+		, maxDrawCalls(BGFX_CONFIG_MAX_DRAW_CALLS)
+		, maxDrawCallsGrow(0)
+		, maxBlitItems(BGFX_CONFIG_MAX_BLIT_ITEMS)
+		, maxPipelineThreads(BGFX_CONFIG_DEFAULT_MAX_PIPELINE_THREADS)
+		, maxRecordThreads(BGFX_CONFIG_DEFAULT_MAX_RECORD_THREADS)
 	{
 	}
 
@@ -3629,6 +4449,8 @@ namespace bgfx
 		, debug(BX_ENABLED(BGFX_CONFIG_DEBUG) )
 		, profile(BX_ENABLED(BGFX_CONFIG_DEBUG_ANNOTATION) )
 		, fallback(true)
+		, asyncPipelineCompile(false)
+		, singlePipelineCache(false)
 		, callback(NULL)
 		, allocator(NULL)
 	{
@@ -3654,8 +4476,15 @@ namespace bgfx
 
 		Init init = _userInit;
 
-		init.limits.maxEncoders       = bx::clamp<uint16_t>(init.limits.maxEncoders, 1, (0 != BGFX_CONFIG_MULTITHREADED) ? 128 : 1);
-		init.limits.minResourceCbSize = bx::min<uint32_t>(init.limits.minResourceCbSize, BGFX_CONFIG_MIN_RESOURCE_COMMAND_BUFFER_SIZE);
+		init.limits.maxEncoders        = bx::clamp<uint16_t>(init.limits.maxEncoders, 1, (0 != BGFX_CONFIG_MULTITHREADED) ? 128 : 1);
+		init.limits.minResourceCbSize  = bx::min<uint32_t>(init.limits.minResourceCbSize, BGFX_CONFIG_MIN_RESOURCE_COMMAND_BUFFER_SIZE);
+		init.limits.maxSortThreads     = bx::clamp<uint16_t>(init.limits.maxSortThreads, 1, (0 != BGFX_CONFIG_MULTITHREADED) ? BGFX_CONFIG_MAX_SORT_THREADS : 1);
+		init.limits.maxQueuedFrames    = bx::clamp<uint8_t>(init.limits.maxQueuedFrames, 1, BGFX_CONFIG_MAX_QUEUED_FRAMES);
+		init.limits.maxDrawCalls       = bx::clamp<uint32_t>(init.limits.maxDrawCalls, 1, UINT32_MAX-1);
+		init.limits.maxDrawCallsGrow   = bx::min<uint32_t>(init.limits.maxDrawCallsGrow, UINT32_MAX-1);
+		init.limits.maxBlitItems       = bx::clamp<uint16_t>(init.limits.maxBlitItems, 1, UINT16_MAX-1);
+		init.limits.maxPipelineThreads = bx::min<uint16_t>(init.limits.maxPipelineThreads, BX_ENABLED(BX_CONFIG_SUPPORTS_THREADING) ? BGFX_CONFIG_MAX_PIPELINE_THREADS : 0);
+		init.limits.maxRecordThreads   = bx::min<uint16_t>(init.limits.maxRecordThreads, BX_ENABLED(BX_CONFIG_SUPPORTS_THREADING) ? BGFX_CONFIG_MAX_RECORD_THREADS : 0);
 
 		struct ErrorState
 		{
@@ -3690,8 +4519,8 @@ namespace bgfx
 		}
 
 		bx::memSet(&g_caps, 0, sizeof(g_caps) );
-		g_caps.limits.maxDrawCalls            = BGFX_CONFIG_MAX_DRAW_CALLS;
-		g_caps.limits.maxBlits                = BGFX_CONFIG_MAX_BLIT_ITEMS;
+		g_caps.limits.maxDrawCalls            = init.limits.maxDrawCalls;
+		g_caps.limits.maxBlits                = init.limits.maxBlitItems;
 		g_caps.limits.maxTextureSize          = 0;
 		g_caps.limits.maxTextureLayers        = 1;
 		g_caps.limits.maxViews                = BGFX_CONFIG_MAX_VIEWS;
@@ -3715,6 +4544,7 @@ namespace bgfx
 		g_caps.limits.maxTransientVbSize      = init.limits.maxTransientVbSize;
 		g_caps.limits.maxTransientIbSize      = init.limits.maxTransientIbSize;
 		g_caps.limits.minUniformBufferSize    = init.limits.minUniformBufferSize;
+		g_caps.limits.maxSortThreads          = init.limits.maxSortThreads;
 
 		g_caps.vendorId = init.vendorId;
 		g_caps.deviceId = init.deviceId;
@@ -3744,6 +4574,7 @@ namespace bgfx
 		case ErrorState::ContextAllocated:
 			bx::deleteObject(g_allocator, s_ctx, Context::kAlignment);
 			s_ctx = NULL;
+			s_memoryPool.shutdown();
 			[[fallthrough]];
 
 		case ErrorState::Default:
@@ -3780,6 +4611,8 @@ namespace bgfx
 
 		bx::deleteObject(g_allocator, ctx, Context::kAlignment);
 
+		s_memoryPool.shutdown();
+
 		BX_TRACE("Shutdown complete.");
 
 		if (NULL != s_allocatorStub)
@@ -4051,6 +4884,23 @@ namespace bgfx
 		BGFX_ENCODER(submit(_id, _program, _occlusionQuery, _depth, _flags) );
 	}
 
+	void Encoder::beginDrawBundle(DrawBundleHandle _handle)
+	{
+		BGFX_CHECK_HANDLE("beginDrawBundle", s_ctx->m_drawBundleHandle, _handle);
+		BGFX_ENCODER(beginDrawBundle(&s_ctx->m_drawBundle[_handle.idx]) );
+	}
+
+	void Encoder::endDrawBundle()
+	{
+		BGFX_ENCODER(endDrawBundle() );
+	}
+
+	void Encoder::submit(DrawBundleHandle _handle, const void* _mtx)
+	{
+		BGFX_CHECK_HANDLE("submit", s_ctx->m_drawBundleHandle, _handle);
+		BGFX_ENCODER(submit(s_ctx->m_drawBundle[_handle.idx], (const float*)_mtx) );
+	}
+
 	void Encoder::submit(ViewId _id, ProgramHandle _program, IndirectBufferHandle _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags)
 	{
 		BGFX_CHECK_HANDLE_INVALID_OK("submit", s_ctx->m_programHandle, _program);
@@ -4243,15 +5093,61 @@ namespace bgfx
 		return g_caps.rendererType;
 	}
 
+	static void* allocMemoryBlock(uint32_t _size)
+	{
+		const uint32_t size = sizeof(MemoryHeader) + _size;
+
+		uint32_t cls;
+		MemoryHeader* header = (MemoryHeader*)s_memoryPool.alloc(size, cls);
+
+		if (NULL != header)
+		{
+			header->source = cls;
+		}
+		else
+		{
+			header = (MemoryHeader*)bx::alloc(g_allocator, size, 16);
+			header->source = MemoryHeader::Heap;
+		}
+
+		return header + 1;
+	}
+
 	const Memory* alloc(uint32_t _size)
 	{
 		BX_ASSERT(0 < _size, "Invalid memory operation. _size is 0.");
-		Memory* mem = (Memory*)bx::alloc(g_allocator, sizeof(Memory) + _size);
+		Memory* mem = (Memory*)allocMemoryBlock(kMemoryDataOffset + _size);
 		mem->size = _size;
-		mem->data = (uint8_t*)mem + sizeof(Memory);
+		mem->data = (uint8_t*)mem + kMemoryDataOffset;
 		return mem;
 	}
 
+	const Memory* Frame::allocMemory(uint32_t _size)
+	{
+		const uint32_t size   = bx::alignUp(uint32_t(sizeof(MemoryHeader) ) + kMemoryDataOffset + _size, 16);
+		const uint32_t offset = bx::atomicFetchAndAdd<uint32_t>(&m_memoryOffset, size);
+
+		if (offset + size > m_memorySize
+		||  offset + size < offset)
+		{
+			return alloc(_size);
+		}
+
+		MemoryHeader* header = (MemoryHeader*)&m_memory[offset];
+		header->source = MemoryHeader::Arena;
+
+		Memory* mem = (Memory*)(header + 1);
+		mem->size = _size;
+		mem->data = (uint8_t*)mem + kMemoryDataOffset;
+		return mem;
+	}
+
+	const Memory* allocFrame(uint32_t _size)
+	{
+		BX_ASSERT(0 < _size, "Invalid memory operation. _size is 0.");
+		return s_ctx->allocFrame(_size);
+	}
+
 	const Memory* copy(const void* _data, uint32_t _size)
 	{
 		BX_ASSERT(0 < _size, "Invalid memory operation. _size is 0.");
@@ -4269,7 +5165,7 @@ namespace bgfx
 
 	const Memory* makeRef(const void* _data, uint32_t _size, ReleaseFn _releaseFn, void* _userData)
 	{
-		MemoryRef* memRef = (MemoryRef*)bx::alloc(g_allocator, sizeof(MemoryRef) );
+		MemoryRef* memRef = (MemoryRef*)allocMemoryBlock(sizeof(MemoryRef) );
 		memRef->mem.size  = _size;
 		memRef->mem.data  = (uint8_t*)_data;
 		memRef->releaseFn = _releaseFn;
@@ -4279,7 +5175,7 @@ namespace bgfx
 
 	bool isMemoryRef(const Memory* _mem)
 	{
-		return _mem->data != (uint8_t*)_mem + sizeof(Memory);
+		return _mem->data != (uint8_t*)_mem + kMemoryDataOffset;
 	}
 
 	void release(const Memory* _mem)
@@ -4294,7 +5190,22 @@ namespace bgfx
 				memRef->releaseFn(mem->data, memRef->userData);
 			}
 		}
-		bx::free(g_allocator, mem);
+
+		MemoryHeader* header = (MemoryHeader*)mem - 1;
+		switch (header->source)
+		{
+		case MemoryHeader::Heap:
+			bx::free(g_allocator, header, 16);
+			break;
+
+		case MemoryHeader::Arena:
+			// Released in bulk when frame is reused.
+			break;
+
+		default:
+			s_memoryPool.free(header, header->source);
+			break;
+		}
 	}
 
 	void setDebug(uint32_t _debug)
@@ -4581,6 +5492,16 @@ namespace bgfx
 		s_ctx->destroyProgram(_handle);
 	}
 
+	void precachePipeline(ProgramHandle _program, uint64_t _state, VertexLayoutHandle _layoutHandle, FrameBufferHandle _frameBuffer, uint8_t _numInstanceData)
+	{
+		s_ctx->precachePipeline(_program, _state, _layoutHandle, _frameBuffer, _numInstanceData);
+	}
+
+	void savePipelineCache()
+	{
+		s_ctx->savePipelineCache();
+	}
+
 	void isFrameBufferValid(uint8_t _num, const Attachment* _attachment, bx::Error* _err)
 	{
 		BX_ERROR_SCOPE(_err, "Frame buffer validation");
@@ -5362,6 +6283,16 @@ namespace bgfx
 		s_ctx->destroyOcclusionQuery(_handle);
 	}
 
+	DrawBundleHandle createDrawBundle()
+	{
+		return s_ctx->createDrawBundle();
+	}
+
+	void destroy(DrawBundleHandle _handle)
+	{
+		s_ctx->destroyDrawBundle(_handle);
+	}
+
 	void setPaletteColor(uint8_t _index, uint32_t _rgba)
 	{
 		const uint8_t rr = uint8_t(_rgba>>24);
@@ -5702,6 +6633,24 @@ namespace bgfx
 		s_ctx->m_encoder0->submit(_id, _program, _occlusionQuery, _depth, _flags);
 	}
 
+	void beginDrawBundle(DrawBundleHandle _handle)
+	{
+		BGFX_CHECK_ENCODER0();
+		s_ctx->m_encoder0->beginDrawBundle(_handle);
+	}
+
+	void endDrawBundle()
+	{
+		BGFX_CHECK_ENCODER0();
+		s_ctx->m_encoder0->endDrawBundle();
+	}
+
+	void submit(DrawBundleHandle _handle, const void* _mtx)
+	{
+		BGFX_CHECK_ENCODER0();
+		s_ctx->m_encoder0->submit(_handle, _mtx);
+	}
+
 	void submit(ViewId _id, ProgramHandle _program, IndirectBufferHandle _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags)
 	{
 		BGFX_CHECK_ENCODER0();
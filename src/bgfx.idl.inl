@@ -197,6 +197,11 @@ BGFX_C_API const bgfx_memory_t* bgfx_alloc(uint32_t _size)
 	return (const bgfx_memory_t*)bgfx::alloc(_size);
 }
 
+BGFX_C_API const bgfx_memory_t* bgfx_alloc_frame(uint32_t _size)
+{
+	return (const bgfx_memory_t*)bgfx::allocFrame(_size);
+}
+
 BGFX_C_API const bgfx_memory_t* bgfx_copy(const void* _data, uint32_t _size)
 {
 	return (const bgfx_memory_t*)bgfx::copy(_data, _size);
@@ -446,6 +451,19 @@ BGFX_C_API void bgfx_destroy_program(bgfx_program_handle_t _handle)
 	bgfx::destroy(handle.cpp);
 }
 
+BGFX_C_API void bgfx_precache_pipeline(bgfx_program_handle_t _program, uint64_t _state, bgfx_vertex_layout_handle_t _layoutHandle, bgfx_frame_buffer_handle_t _frameBuffer, uint8_t _numInstanceData)
+{
+	union { bgfx_program_handle_t c; bgfx::ProgramHandle cpp; } program = { _program };
+	union { bgfx_vertex_layout_handle_t c; bgfx::VertexLayoutHandle cpp; } layoutHandle = { _layoutHandle };
+	union { bgfx_frame_buffer_handle_t c; bgfx::FrameBufferHandle cpp; } frameBuffer = { _frameBuffer };
+	bgfx::precachePipeline(program.cpp, _state, layoutHandle.cpp, frameBuffer.cpp, _numInstanceData);
+}
+
+BGFX_C_API void bgfx_save_pipeline_cache(void)
+{
+	bgfx::savePipelineCache();
+}
+
 BGFX_C_API bool bgfx_is_texture_valid(uint16_t _depth, bool _cubeMap, uint16_t _numLayers, bgfx_texture_format_t _format, uint64_t _flags)
 {
 	return bgfx::isTextureValid(_depth, _cubeMap, _numLayers, (bgfx::TextureFormat::Enum)_format, _flags);
@@ -640,6 +658,19 @@ BGFX_C_API void bgfx_destroy_occlusion_query(bgfx_occlusion_query_handle_t _hand
 	bgfx::destroy(handle.cpp);
 }
 
+BGFX_C_API bgfx_draw_bundle_handle_t bgfx_create_draw_bundle(void)
+{
+	union { bgfx_draw_bundle_handle_t c; bgfx::DrawBundleHandle cpp; } handle_ret;
+	handle_ret.cpp = bgfx::createDrawBundle();
+	return handle_ret.c;
+}
+
+BGFX_C_API void bgfx_destroy_draw_bundle(bgfx_draw_bundle_handle_t _handle)
+{
+	union { bgfx_draw_bundle_handle_t c; bgfx::DrawBundleHandle cpp; } handle = { _handle };
+	bgfx::destroy(handle.cpp);
+}
+
 BGFX_C_API void bgfx_set_palette_color(uint8_t _index, const float _rgba[4])
 {
 	bgfx::setPaletteColor(_index, _rgba);
@@ -924,6 +955,26 @@ BGFX_C_API void bgfx_encoder_submit_occlusion_query(bgfx_encoder_t* _this, bgfx_
 	This->submit((bgfx::ViewId)_id, program.cpp, occlusionQuery.cpp, _depth, _flags);
 }
 
+BGFX_C_API void bgfx_encoder_begin_draw_bundle(bgfx_encoder_t* _this, bgfx_draw_bundle_handle_t _handle)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	union { bgfx_draw_bundle_handle_t c; bgfx::DrawBundleHandle cpp; } handle = { _handle };
+	This->beginDrawBundle(handle.cpp);
+}
+
+BGFX_C_API void bgfx_encoder_end_draw_bundle(bgfx_encoder_t* _this)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	This->endDrawBundle();
+}
+
+BGFX_C_API void bgfx_encoder_submit_draw_bundle(bgfx_encoder_t* _this, bgfx_draw_bundle_handle_t _handle, const void* _mtx)
+{
+	bgfx::Encoder* This = (bgfx::Encoder*)_this;
+	union { bgfx_draw_bundle_handle_t c; bgfx::DrawBundleHandle cpp; } handle = { _handle };
+	This->submit(handle.cpp, _mtx);
+}
+
 BGFX_C_API void bgfx_encoder_submit_indirect(bgfx_encoder_t* _this, bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_indirect_buffer_handle_t _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags)
 {
 	bgfx::Encoder* This = (bgfx::Encoder*)_this;
@@ -1204,6 +1255,23 @@ BGFX_C_API void bgfx_submit_occlusion_query(bgfx_view_id_t _id, bgfx_program_han
 	bgfx::submit((bgfx::ViewId)_id, program.cpp, occlusionQuery.cpp, _depth, _flags);
 }
 
+BGFX_C_API void bgfx_begin_draw_bundle(bgfx_draw_bundle_handle_t _handle)
+{
+	union { bgfx_draw_bundle_handle_t c; bgfx::DrawBundleHandle cpp; } handle = { _handle };
+	bgfx::beginDrawBundle(handle.cpp);
+}
+
+BGFX_C_API void bgfx_end_draw_bundle(void)
+{
+	bgfx::endDrawBundle();
+}
+
+BGFX_C_API void bgfx_submit_draw_bundle(bgfx_draw_bundle_handle_t _handle, const void* _mtx)
+{
+	union { bgfx_draw_bundle_handle_t c; bgfx::DrawBundleHandle cpp; } handle = { _handle };
+	bgfx::submit(handle.cpp, _mtx);
+}
+
 BGFX_C_API void bgfx_submit_indirect(bgfx_view_id_t _id, bgfx_program_handle_t _program, bgfx_indirect_buffer_handle_t _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags)
 {
 	union { bgfx_program_handle_t c; bgfx::ProgramHandle cpp; } program = { _program };
@@ -1347,6 +1415,7 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_get_caps,
 			bgfx_get_stats,
 			bgfx_alloc,
+			bgfx_alloc_frame,
 			bgfx_copy,
 			bgfx_make_ref,
 			bgfx_make_ref_release,
@@ -1387,6 +1456,8 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_create_program,
 			bgfx_create_compute_program,
 			bgfx_destroy_program,
+			bgfx_precache_pipeline,
+			bgfx_save_pipeline_cache,
 			bgfx_is_texture_valid,
 			bgfx_is_frame_buffer_valid,
 			bgfx_calc_texture_size,
@@ -1417,6 +1488,8 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_create_occlusion_query,
 			bgfx_get_result,
 			bgfx_destroy_occlusion_query,
+			bgfx_create_draw_bundle,
+			bgfx_destroy_draw_bundle,
 			bgfx_set_palette_color,
 			bgfx_set_palette_color_rgba32f,
 			bgfx_set_palette_color_rgba8,
@@ -1464,6 +1537,9 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_encoder_touch,
 			bgfx_encoder_submit,
 			bgfx_encoder_submit_occlusion_query,
+			bgfx_encoder_begin_draw_bundle,
+			bgfx_encoder_end_draw_bundle,
+			bgfx_encoder_submit_draw_bundle,
 			bgfx_encoder_submit_indirect,
 			bgfx_encoder_submit_indirect_count,
 			bgfx_encoder_set_compute_index_buffer,
@@ -1510,6 +1586,9 @@ BGFX_C_API bgfx_interface_vtbl_t* bgfx_get_interface(uint32_t _version)
 			bgfx_touch,
 			bgfx_submit,
 			bgfx_submit_occlusion_query,
+			bgfx_begin_draw_bundle,
+			bgfx_end_draw_bundle,
+			bgfx_submit_draw_bundle,
 			bgfx_submit_indirect,
 			bgfx_submit_indirect_count,
 			bgfx_set_compute_index_buffer,
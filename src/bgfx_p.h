@@ -304,11 +304,7 @@ namespace bgfx
 	extern void isFrameBufferValid(uint8_t _num, const Attachment* _attachment, bx::Error* _err);
 	extern void isIdentifierValid(const bx::StringView& _name, bx::Error* _err);
 
-#if BGFX_CONFIG_MAX_DRAW_CALLS < (64<<10)
-	typedef uint16_t RenderItemCount;
-#else
 	typedef uint32_t RenderItemCount;
-#endif // BGFX_CONFIG_MAX_DRAW_CALLS < (64<<10)
 
 	///
 	struct Handle
@@ -967,6 +963,8 @@ namespace bgfx
 			UpdateViewName,
 			InvalidateOcclusionQuery,
 			SetName,
+			PrecachePipeline,
+			SavePipelineCache,
 			End,
 			RendererShutdownEnd,
 			DestroyVertexLayout,
@@ -1444,9 +1442,25 @@ namespace bgfx
 	struct MatrixCache
 	{
 		MatrixCache()
-			: m_num(1)
+			: m_cache(NULL)
+			, m_num(1)
+			, m_max(0)
+		{
+		}
+
+		void create(uint32_t _max)
 		{
+			m_cache = (Matrix4*)bx::alignedAlloc(g_allocator, _max*sizeof(Matrix4), 16);
+			m_max   = _max;
 			m_cache[0].setIdentity();
+			reset();
+		}
+
+		void destroy()
+		{
+			bx::alignedFree(g_allocator, m_cache, 16);
+			m_cache = NULL;
+			m_max   = 0;
 		}
 
 		void reset()
@@ -1454,12 +1468,25 @@ namespace bgfx
 			m_num = 1;
 		}
 
+		bool isFull() const
+		{
+			return m_num >= m_max - 1;
+		}
+
+		uint32_t reserve(uint32_t* _num)
+		{
+			uint32_t num = *_num;
+			uint32_t first = bx::atomicFetchAndAddsat<uint32_t>(&m_num, num, m_max - 1);
+			BX_WARN(first+num < m_max, "Matrix cache overflow. %d (max: %d)", first+num, m_max);
+			num = bx::min(num, m_max-1-first);
+			*_num = num;
+			return first;
+		}
+
 		uint32_t reserve(uint16_t* _num)
 		{
 			uint32_t num = *_num;
-			uint32_t first = bx::atomicFetchAndAddsat<uint32_t>(&m_num, num, BGFX_CONFIG_MAX_MATRIX_CACHE - 1);
-			BX_WARN(first+num < BGFX_CONFIG_MAX_MATRIX_CACHE, "Matrix cache overflow. %d (max: %d)", first+num, BGFX_CONFIG_MAX_MATRIX_CACHE);
-			num = bx::min(num, BGFX_CONFIG_MAX_MATRIX_CACHE-1-first);
+			uint32_t first = reserve(&num);
 			*_num = bx::narrowCast<uint16_t>(num);
 			return first;
 		}
@@ -1478,9 +1505,9 @@ namespace bgfx
 
 		float* toPtr(uint32_t _cacheIdx)
 		{
-			BX_ASSERT(_cacheIdx < BGFX_CONFIG_MAX_MATRIX_CACHE, "Matrix cache out of bounds index %d (max: %d)"
+			BX_ASSERT(_cacheIdx < m_max, "Matrix cache out of bounds index %d (max: %d)"
 				, _cacheIdx
-				, BGFX_CONFIG_MAX_MATRIX_CACHE
+				, m_max
 				);
 			return m_cache[_cacheIdx].un.val;
 		}
@@ -1490,8 +1517,9 @@ namespace bgfx
 			return uint32_t( (const Matrix4*)_ptr - m_cache);
 		}
 
-		Matrix4 m_cache[BGFX_CONFIG_MAX_MATRIX_CACHE];
+		Matrix4* m_cache;
 		uint32_t m_num;
+		uint32_t m_max;
 	};
 
 	struct RectCache
@@ -1521,6 +1549,16 @@ namespace bgfx
 			return first;
 		}
 
+		uint32_t reserve(uint32_t* _num)
+		{
+			uint32_t num = *_num;
+			const uint32_t first = bx::atomicFetchAndAddsat<uint32_t>(&m_num, num, BGFX_CONFIG_MAX_RECT_CACHE-1);
+			BX_WARN(first+num < BGFX_CONFIG_MAX_RECT_CACHE, "Rect cache overflow. %d (max: %d)", first+num, BGFX_CONFIG_MAX_RECT_CACHE);
+			num = bx::min<uint32_t>(num, BGFX_CONFIG_MAX_RECT_CACHE-1-first);
+			*_num = num;
+			return first;
+		}
+
 		Rect     m_cache[BGFX_CONFIG_MAX_RECT_CACHE];
 		uint32_t m_num;
 	};
@@ -1581,6 +1619,24 @@ namespace bgfx
 			}
 		}
 
+		static void reserve(UniformBuffer** _uniformBuffer, uint32_t _size)
+		{
+			constexpr uint32_t kThreshold = BGFX_CONFIG_UNIFORM_BUFFER_RESIZE_THRESHOLD_SIZE;
+			constexpr uint32_t kIncrement = BGFX_CONFIG_UNIFORM_BUFFER_RESIZE_INCREMENT_SIZE;
+
+			UniformBuffer* uniformBuffer = *_uniformBuffer;
+			if (kThreshold + _size >= uniformBuffer->m_size - uniformBuffer->m_pos)
+			{
+				const uint32_t structSize = sizeof(UniformBuffer)-sizeof(UniformBuffer::m_buffer);
+				uint32_t size = bx::alignUp(uniformBuffer->m_pos + _size + kIncrement, 16);
+				void*    data = bx::realloc(g_allocator, uniformBuffer, size+structSize);
+				uniformBuffer = reinterpret_cast<UniformBuffer*>(data);
+				uniformBuffer->m_size = size;
+
+				*_uniformBuffer = uniformBuffer;
+			}
+		}
+
 		static uint32_t encodeOpcode(uint8_t _type, uint16_t _loc, uint16_t _num, uint16_t _copy)
 		{
 			const uint32_t type = _type << kConstantOpcodeTypeShift;
@@ -1644,6 +1700,11 @@ namespace bgfx
 			return m_pos;
 		}
 
+		const void* getData(uint32_t _pos) const
+		{
+			return &m_buffer[_pos];
+		}
+
 		void reset(uint32_t _pos = 0)
 		{
 			m_pos = _pos;
@@ -2379,6 +2440,12 @@ namespace bgfx
 		RectCache m_rectCache;
 	};
 
+	struct RenderItemRange
+	{
+		uint32_t m_begin;
+		uint32_t m_end;
+	};
+
 	struct ScreenShot
 	{
 		bx::FilePath filePath;
@@ -2388,21 +2455,26 @@ namespace bgfx
 	BX_ALIGN_DECL_CACHE_LINE(struct) Frame
 	{
 		Frame()
-			: m_waitSubmit(0)
+			: m_sortKeys(NULL)
+			, m_sortValues(NULL)
+			, m_renderItem(NULL)
+			, m_renderItemBind(NULL)
+			, m_blitKeys(NULL)
+			, m_blitItem(NULL)
+			, m_maxRenderItems(0)
+			, m_maxBlitItems(0)
+			, m_memory(NULL)
+			, m_memorySize(0)
+			, m_memoryOffset(0)
+			, m_waitSubmit(0)
 			, m_waitRender(0)
+			, m_submitTime(0)
 			, m_frameNum(0)
 			, m_capture(false)
 		{
-			SortKey term;
-			term.reset();
-			term.m_program = BGFX_INVALID_HANDLE;
-			m_sortKeys[BGFX_CONFIG_MAX_DRAW_CALLS]   = term.encodeDraw(SortKey::SortProgram);
-			m_sortValues[BGFX_CONFIG_MAX_DRAW_CALLS] = BGFX_CONFIG_MAX_DRAW_CALLS;
 			bx::memSet(m_occlusion, 0xff, sizeof(m_occlusion) );
 
 			m_perfStats.viewStats = m_viewStats;
-
-			bx::memSet(&m_renderItemBind[0], 0, sizeof(m_renderItemBind) );
 		}
 
 		~Frame()
@@ -2425,6 +2497,18 @@ namespace bgfx
 				}
 			}
 
+			resizeRenderItems(g_caps.limits.maxDrawCalls);
+
+			m_maxBlitItems = g_caps.limits.maxBlits;
+			m_blitKeys     = (uint32_t*)bx::alloc(g_allocator, (m_maxBlitItems+1)*sizeof(uint32_t) );
+			m_blitItem     = (BlitItem*)bx::alloc(g_allocator, (m_maxBlitItems+1)*sizeof(BlitItem) );
+
+			m_memorySize = BGFX_CONFIG_FRAME_MEMORY_SIZE;
+			m_memory     = 0 < m_memorySize
+				? (uint8_t*)bx::alignedAlloc(g_allocator, m_memorySize, 16)
+				: NULL
+				;
+
 			reset();
 			start(0);
 			m_textVideoMem = BX_NEW(g_allocator, TextVideoMem);
@@ -2439,8 +2523,26 @@ namespace bgfx
 
 			bx::free(g_allocator, m_uniformBuffer);
 			bx::deleteObject(g_allocator, m_textVideoMem);
+
+			freeRenderItems();
+
+			bx::free(g_allocator, m_blitKeys);
+			bx::free(g_allocator, m_blitItem);
+			m_blitKeys     = NULL;
+			m_blitItem     = NULL;
+			m_maxBlitItems = 0;
+
+			if (NULL != m_memory)
+			{
+				bx::alignedFree(g_allocator, m_memory, 16);
+				m_memory     = NULL;
+				m_memorySize = 0;
+			}
 		}
 
+		void resizeRenderItems(uint32_t _num);
+		void freeRenderItems();
+
 		void reset()
 		{
 			start(0);
@@ -2454,23 +2556,28 @@ namespace bgfx
 			m_perfStats.transientIbUsed = m_iboffset;
 
 			m_frameCache.reset();
-			m_numRenderItems = 0;
-			m_numBlitItems   = 0;
+			m_numRenderItems  = 0;
+			m_numBlitItems    = 0;
+			m_renderItemsFull = false;
 			m_iboffset = 0;
 			m_vboffset = 0;
 			m_cmdPre.start();
 			m_cmdPost.start();
 			m_capture = false;
 			m_numScreenShots = 0;
+			m_memoryOffset = 0;
 			m_frameNum = frameNum;
 		}
 
+		const Memory* allocMemory(uint32_t _size);
+
 		void finish()
 		{
 			m_cmdPre.finish();
 			m_cmdPost.finish();
 		}
 
+		void compactRenderItems(RenderItemRange* _unused, uint32_t _num);
 		void sort();
 
 		uint32_t getAvailTransientIndexBuffer(uint32_t _num, uint16_t _indexSize)
@@ -2570,21 +2677,24 @@ namespace bgfx
 
 		int32_t m_occlusion[BGFX_CONFIG_MAX_OCCLUSION_QUERIES];
 
-		uint64_t m_sortKeys[BGFX_CONFIG_MAX_DRAW_CALLS+1];
-		RenderItemCount m_sortValues[BGFX_CONFIG_MAX_DRAW_CALLS+1];
-		RenderItem m_renderItem[BGFX_CONFIG_MAX_DRAW_CALLS+1];
-		RenderBind m_renderItemBind[BGFX_CONFIG_MAX_DRAW_CALLS + 1];
+		uint64_t*        m_sortKeys;
+		RenderItemCount* m_sortValues;
+		RenderItem*      m_renderItem;
+		RenderBind*      m_renderItemBind;
 
-		uint32_t m_blitKeys[BGFX_CONFIG_MAX_BLIT_ITEMS+1];
-		BlitItem m_blitItem[BGFX_CONFIG_MAX_BLIT_ITEMS+1];
+		uint32_t* m_blitKeys;
+		BlitItem* m_blitItem;
 
 		UniformCacheFrame m_uniformCacheFrame;
 
 		FrameCache m_frameCache;
 		UniformBuffer** m_uniformBuffer;
 
+		uint32_t m_maxRenderItems;
+		uint32_t m_maxBlitItems;
 		uint32_t m_numRenderItems;
 		uint32_t m_numBlitItems;
+		bool     m_renderItemsFull;
 
 		uint32_t m_iboffset;
 		uint32_t m_vboffset;
@@ -2670,14 +2780,67 @@ namespace bgfx
 		Stats     m_perfStats;
 		ViewStats m_viewStats[BGFX_CONFIG_MAX_VIEWS];
 
+		uint8_t* m_memory;
+		uint32_t m_memorySize;
+		uint32_t m_memoryOffset;
+
 		int64_t m_waitSubmit;
 		int64_t m_waitRender;
+		int64_t m_submitTime;
 
 		uint32_t m_frameNum;
 
 		bool m_capture;
 	};
 
+	struct DrawBundle
+	{
+		DrawBundle()
+			: m_keys(NULL)
+			, m_draw(NULL)
+			, m_bind(NULL)
+			, m_matrices(NULL)
+			, m_rects(NULL)
+			, m_uniforms(NULL)
+			, m_num(0)
+			, m_max(0)
+			, m_numMatrices(0)
+			, m_maxMatrices(0)
+			, m_numRects(0)
+			, m_maxRects(0)
+			, m_uniformSize(0)
+			, m_maxUniformSize(0)
+		{
+		}
+
+		void reset()
+		{
+			m_num         = 0;
+			m_numMatrices = 0;
+			m_numRects    = 0;
+			m_uniformSize = 0;
+		}
+
+		void add(uint64_t _key, const RenderDraw& _draw, const RenderBind& _bind, const FrameCache& _frameCache, const UniformBuffer* _uniformBuffer);
+		void destroy();
+
+		uint64_t*   m_keys;
+		RenderDraw* m_draw;
+		RenderBind* m_bind;
+		Matrix4*    m_matrices;
+		Rect*       m_rects;
+		uint8_t*    m_uniforms;
+
+		uint32_t m_num;
+		uint32_t m_max;
+		uint32_t m_numMatrices;
+		uint32_t m_maxMatrices;
+		uint32_t m_numRects;
+		uint32_t m_maxRects;
+		uint32_t m_uniformSize;
+		uint32_t m_maxUniformSize;
+	};
+
 	BX_ALIGN_DECL_CACHE_LINE(struct) EncoderImpl
 	{
 		EncoderImpl()
@@ -2689,7 +2852,8 @@ namespace bgfx
 			// clear all bytes (inclusively the padding) before we start.
 			bx::memSet(&m_bind, 0, sizeof(m_bind) );
 
-			m_discard = false;
+			m_discard    = false;
+			m_drawBundle = NULL;
 			m_draw.clear(BGFX_DISCARD_ALL);
 			m_compute.clear(BGFX_DISCARD_ALL);
 			m_bind.clear(BGFX_DISCARD_ALL);
@@ -2710,6 +2874,9 @@ namespace bgfx
 
 			m_numSubmitted = 0;
 			m_numDropped   = 0;
+
+			m_renderItemNext = 0;
+			m_renderItemEnd  = 0;
 		}
 
 		void end(bool _finalize)
@@ -2733,6 +2900,31 @@ namespace bgfx
 			}
 		}
 
+		uint32_t allocRenderItem()
+		{
+			if (m_renderItemNext == m_renderItemEnd)
+			{
+				const uint32_t maxRenderItems = m_frame->m_maxRenderItems;
+				const uint32_t first = bx::atomicFetchAndAddsat<uint32_t>(&m_frame->m_numRenderItems, BGFX_CONFIG_RENDER_ITEM_BLOCK_SIZE, maxRenderItems);
+				m_renderItemNext = first;
+				m_renderItemEnd  = bx::min<uint32_t>(first + BGFX_CONFIG_RENDER_ITEM_BLOCK_SIZE, maxRenderItems);
+
+				if (m_renderItemNext == m_renderItemEnd)
+				{
+					m_frame->m_renderItemsFull = true;
+					return maxRenderItems;
+				}
+			}
+
+			return m_renderItemNext++;
+		}
+
+		RenderItemRange getUnusedRenderItems() const
+		{
+			RenderItemRange range = { m_renderItemNext, m_renderItemEnd };
+			return range;
+		}
+
 		void setMarker(const bx::StringView& _name)
 		{
 			UniformBuffer::update(&m_frame->m_uniformBuffer[m_uniformIdx]);
@@ -2834,12 +3026,13 @@ namespace bgfx
 
 		void setTransform(uint32_t _cache, uint16_t _num)
 		{
-			BX_ASSERT(_cache < BGFX_CONFIG_MAX_MATRIX_CACHE, "Matrix cache out of bounds index %d (max: %d)"
+			const uint32_t maxMatrices = m_frame->m_frameCache.m_matrixCache.m_max;
+			BX_ASSERT(_cache < maxMatrices, "Matrix cache out of bounds index %d (max: %d)"
 				, _cache
-				, BGFX_CONFIG_MAX_MATRIX_CACHE
+				, maxMatrices
 				);
 			m_draw.m_startMatrix = _cache;
-			m_draw.m_numMatrices = uint16_t(bx::min<uint32_t>(_cache+_num, BGFX_CONFIG_MAX_MATRIX_CACHE-1) - _cache);
+			m_draw.m_numMatrices = uint16_t(bx::min<uint32_t>(_cache+_num, maxMatrices-1) - _cache);
 		}
 
 		void setIndexBuffer(IndexBufferHandle _handle, const IndexBuffer& _ib, uint32_t _firstIndex, uint32_t _numIndices)
@@ -3042,6 +3235,21 @@ namespace bgfx
 
 		void submit(ViewId _id, ProgramHandle _program, OcclusionQueryHandle _occlusionQuery, uint32_t _depth, uint8_t _flags);
 
+		void submit(const DrawBundle& _bundle, const float* _mtx);
+
+		void beginDrawBundle(DrawBundle* _bundle)
+		{
+			BX_ASSERT(NULL == m_drawBundle, "Draw bundle recording is already in progress.");
+			m_drawBundle = _bundle;
+			m_drawBundle->reset();
+		}
+
+		void endDrawBundle()
+		{
+			BX_ASSERT(NULL != m_drawBundle, "Draw bundle recording is not in progress.");
+			m_drawBundle = NULL;
+		}
+
 		void submit(ViewId _id, ProgramHandle _program, IndirectBufferHandle _indirectHandle, uint32_t _start, uint32_t _num, uint32_t _depth, uint8_t _flags)
 		{
 			m_draw.m_startIndirect  = _start;
@@ -3071,6 +3279,7 @@ namespace bgfx
 		void blit(ViewId _id, TextureHandle _dst, uint8_t _dstMip, uint16_t _dstX, uint16_t _dstY, uint16_t _dstZ, TextureHandle _src, uint8_t _srcMip, uint16_t _srcX, uint16_t _srcY, uint16_t _srcZ, uint16_t _width, uint16_t _height, uint16_t _depth);
 
 		Frame* m_frame;
+		DrawBundle* m_drawBundle;
 
 		SortKey m_key;
 
@@ -3081,6 +3290,9 @@ namespace bgfx
 		uint32_t m_numSubmitted;
 		uint32_t m_numDropped;
 
+		uint32_t m_renderItemNext;
+		uint32_t m_renderItemEnd;
+
 		uint32_t m_uniformBegin;
 		uint32_t m_uniformEnd;
 		uint32_t m_numVertices[BGFX_CONFIG_MAX_VERTEX_STREAMS];
@@ -3192,7 +3404,288 @@ namespace bgfx
 		VertexLayoutHandle m_dynamicVertexBufferRef[BGFX_CONFIG_MAX_DYNAMIC_VERTEX_BUFFERS];
 	};
 
-	// First-fit non-local allocator.
+	// Open addressing hash map for integer keys. Uses linear probing with
+	// robin hood insertion and backward shift removal, so there are no
+	// tombstones and lookups stop early. Keys are expected to be hashes or
+	// small packed ids, home slot is selected with Fibonacci hashing. Values
+	// must be trivially copyable.
+	template<typename KeyT, typename ValueT>
+	class FlatHashMapT
+	{
+	public:
+		static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+		FlatHashMapT()
+			: m_meta(NULL)
+			, m_keys(NULL)
+			, m_values(NULL)
+			, m_numElements(0)
+			, m_capacity(0)
+			, m_shift(64)
+		{
+		}
+
+		~FlatHashMapT()
+		{
+			destroy();
+		}
+
+		FlatHashMapT(const FlatHashMapT&) = delete;
+		FlatHashMapT& operator=(const FlatHashMapT&) = delete;
+
+		ValueT* find(KeyT _key)
+		{
+			const uint32_t idx = findIndex(_key);
+			return kInvalidIndex != idx ? bx::addressOf(m_values[idx]) : NULL;
+		}
+
+		const ValueT* find(KeyT _key) const
+		{
+			const uint32_t idx = findIndex(_key);
+			return kInvalidIndex != idx ? bx::addressOf(m_values[idx]) : NULL;
+		}
+
+		bool insert(KeyT _key, const ValueT& _value)
+		{
+			if (kInvalidIndex != findIndex(_key) )
+			{
+				return false;
+			}
+
+			if ( (m_numElements + 1) * kMaxLoadDen > m_capacity * kMaxLoadNum)
+			{
+				rehash(bx::max(m_capacity * 2, kMinCapacity) );
+			}
+
+			insertUnique(_key, _value);
+
+			return true;
+		}
+
+		bool removeByKey(KeyT _key)
+		{
+			const uint32_t idx = findIndex(_key);
+			if (kInvalidIndex != idx)
+			{
+				removeAt(idx);
+				return true;
+			}
+
+			return false;
+		}
+
+		// Entries following removed entry might be shifted into its slot,
+		// when removing while iterating don't advance index after removal.
+		void removeAt(uint32_t _idx)
+		{
+			BX_ASSERT(isValid(_idx), "Removing invalid entry %d.", _idx);
+
+			const uint32_t mask = m_capacity - 1;
+
+			uint32_t idx  = _idx;
+			uint32_t next = (idx + 1) & mask;
+			while (1 < m_meta[next])
+			{
+				m_meta[idx]   = m_meta[next] - 1;
+				m_keys[idx]   = m_keys[next];
+				m_values[idx] = m_values[next];
+
+				idx  = next;
+				next = (next + 1) & mask;
+			}
+
+			m_meta[idx] = 0;
+			--m_numElements;
+		}
+
+		void reserve(uint32_t _num)
+		{
+			uint32_t capacity = bx::max(m_capacity, kMinCapacity);
+			while (_num * kMaxLoadDen > capacity * kMaxLoadNum)
+			{
+				capacity *= 2;
+			}
+
+			if (capacity != m_capacity)
+			{
+				rehash(capacity);
+			}
+		}
+
+		void reset()
+		{
+			if (0 != m_numElements)
+			{
+				bx::memSet(m_meta, 0, m_capacity);
+				m_numElements = 0;
+			}
+		}
+
+		uint32_t getNumElements() const
+		{
+			return m_numElements;
+		}
+
+		uint32_t getCapacity() const
+		{
+			return m_capacity;
+		}
+
+		bool isValid(uint32_t _idx) const
+		{
+			return 0 != m_meta[_idx];
+		}
+
+		KeyT getKeyAt(uint32_t _idx) const
+		{
+			return m_keys[_idx];
+		}
+
+		ValueT& getValueAt(uint32_t _idx)
+		{
+			return m_values[_idx];
+		}
+
+		const ValueT& getValueAt(uint32_t _idx) const
+		{
+			return m_values[_idx];
+		}
+
+	private:
+		static constexpr uint32_t kMinCapacity = 16;
+		static constexpr uint32_t kMaxLoadNum  = 3;
+		static constexpr uint32_t kMaxLoadDen  = 4;
+
+		uint32_t home(KeyT _key) const
+		{
+			return uint32_t( (uint64_t(_key) * UINT64_C(0x9e3779b97f4a7c15) ) >> m_shift);
+		}
+
+		uint32_t findIndex(KeyT _key) const
+		{
+			if (0 == m_numElements)
+			{
+				return kInvalidIndex;
+			}
+
+			const uint32_t mask = m_capacity - 1;
+
+			// m_meta stores probe distance + 1, entry can't be further than
+			// probe distance of entry in the slot.
+			uint32_t idx = home(_key);
+			for (uint32_t dist = 1; dist <= m_meta[idx]; ++dist)
+			{
+				if (m_keys[idx] == _key)
+				{
+					return idx;
+				}
+
+				idx = (idx + 1) & mask;
+			}
+
+			return kInvalidIndex;
+		}
+
+		void insertUnique(KeyT _key, ValueT _value)
+		{
+			const uint32_t mask = m_capacity - 1;
+
+			uint32_t idx  = home(_key);
+			uint32_t dist = 1;
+
+			for (;;)
+			{
+				const uint8_t meta = m_meta[idx];
+
+				if (0 == meta)
+				{
+					m_meta[idx]   = uint8_t(dist);
+					m_keys[idx]   = _key;
+					m_values[idx] = _value;
+					++m_numElements;
+					return;
+				}
+
+				if (meta < dist)
+				{
+					m_meta[idx] = uint8_t(dist);
+					dist        = meta;
+					bx::swap(m_keys[idx],   _key);
+					bx::swap(m_values[idx], _value);
+				}
+
+				idx = (idx + 1) & mask;
+
+				if (UINT8_MAX == ++dist)
+				{
+					// Pathological clustering, grow and insert carried entry.
+					rehash(m_capacity * 2);
+					insertUnique(_key, _value);
+					return;
+				}
+			}
+		}
+
+		void rehash(uint32_t _capacity)
+		{
+			uint8_t* meta     = m_meta;
+			KeyT*    keys     = m_keys;
+			ValueT*  values   = m_values;
+			uint32_t capacity = m_capacity;
+
+			m_meta        = (uint8_t*)bx::alloc(g_allocator, _capacity);
+			m_keys        = (KeyT*   )bx::alloc(g_allocator, _capacity * sizeof(KeyT) );
+			m_values      = (ValueT* )bx::alloc(g_allocator, _capacity * sizeof(ValueT) );
+			m_capacity    = _capacity;
+			m_shift       = 64 - bx::floorLog2(_capacity);
+			m_numElements = 0;
+
+			bx::memSet(m_meta, 0, _capacity);
+
+			for (uint32_t ii = 0; ii < capacity; ++ii)
+			{
+				if (0 != meta[ii])
+				{
+					insertUnique(keys[ii], values[ii]);
+				}
+			}
+
+			if (NULL != meta)
+			{
+				bx::free(g_allocator, meta);
+				bx::free(g_allocator, keys);
+				bx::free(g_allocator, values);
+			}
+		}
+
+		void destroy()
+		{
+			if (NULL != m_meta)
+			{
+				bx::free(g_allocator, m_meta);
+				bx::free(g_allocator, m_keys);
+				bx::free(g_allocator, m_values);
+
+				m_meta        = NULL;
+				m_keys        = NULL;
+				m_values      = NULL;
+				m_numElements = 0;
+				m_capacity    = 0;
+				m_shift       = 64;
+			}
+		}
+
+		uint8_t* m_meta;
+		KeyT*    m_keys;
+		ValueT*  m_values;
+		uint32_t m_numElements;
+		uint32_t m_capacity;
+		uint32_t m_shift;
+	};
+
+	// Two-level segregated fit (TLSF) non-local allocator. Block headers are
+	// kept outside of managed memory, free blocks are coalesced immediately
+	// on free, and both alloc and free are O(1).
 	class NonLocalAllocator
 	{
 	public:
@@ -3201,6 +3694,7 @@ namespace bgfx
 		NonLocalAllocator()
 			: m_total(0)
 		{
+			reset();
 		}
 
 		~NonLocalAllocator()
@@ -3209,124 +3703,347 @@ namespace bgfx
 
 		void reset()
 		{
-			m_free.clear();
-			m_used.clear();
+			m_blocks.clear();
+			m_freeNodes.clear();
+			m_used.reset();
 			m_total = 0;
+
+			m_flBitmap = 0;
+			bx::memSet(m_slBitmap, 0, sizeof(m_slBitmap) );
+			bx::memSet(m_freeHead, 0xff, sizeof(m_freeHead) );
 		}
 
 		void add(uint64_t _ptr, uint32_t _size)
 		{
-			m_free.push_back(Free(_ptr, _size) );
+			const uint32_t idx = allocNode();
+
+			Block& block = m_blocks[idx];
+			block.m_ptr      = _ptr;
+			block.m_size     = _size;
+			block.m_prevPhys = kInvalidIndex;
+			block.m_nextPhys = kInvalidIndex;
+
+			insertFree(idx);
 		}
 
 		uint64_t remove()
 		{
-			BX_ASSERT(0 == m_used.size(), "");
+			BX_ASSERT(0 == m_used.getNumElements(), "");
 
-			if (0 < m_free.size() )
+			for (uint32_t ii = 0, num = uint32_t(m_blocks.size() ); ii < num; ++ii)
 			{
-				Free freeBlock = m_free.front();
-				m_free.pop_front();
-				return freeBlock.m_ptr;
+				const Block& block = m_blocks[ii];
+
+				if (block.m_free
+				&&  kInvalidIndex == block.m_prevPhys)
+				{
+					const uint64_t ptr = block.m_ptr;
+					removeFree(ii);
+					freeNode(ii);
+					return ptr;
+				}
 			}
 
 			return 0;
 		}
 
-		uint64_t alloc(uint32_t _size)
+		uint64_t alloc(uint32_t _size, uint32_t _align = kAlignment)
 		{
-			_size = bx::max(_size, 16u);
+			if (_size > kMaxAllocSize)
+			{
+				return kInvalidBlock;
+			}
+
+			BX_ASSERT(bx::isPowerOf2(_align), "Alignment must be power of 2 (align: %d).", _align);
 
-			for (FreeList::iterator it = m_free.begin(), itEnd = m_free.end(); it != itEnd; ++it)
+			const uint32_t size  = bx::alignUp(bx::max(_size, kMinBlockSize), kAlignment);
+			const uint32_t align = bx::max(_align, kAlignment);
+
+			uint32_t idx = findFree(size + align - kAlignment);
+			if (kInvalidIndex == idx)
 			{
-				if (it->m_size >= _size)
+				// there is no block large enough.
+				return kInvalidBlock;
+			}
+
+			removeFree(idx);
+
+			const uint64_t alignedPtr = (m_blocks[idx].m_ptr + align - 1) & ~uint64_t(align - 1);
+			const uint32_t pad = uint32_t(alignedPtr - m_blocks[idx].m_ptr);
+
+			if (0 != pad)
+			{
+				// Return leading padding back to free list.
+				const uint32_t rest = allocNode();
+
+				Block& block = m_blocks[idx];
+				Block& split = m_blocks[rest];
+				split.m_ptr      = alignedPtr;
+				split.m_size     = block.m_size - pad;
+				split.m_prevPhys = idx;
+				split.m_nextPhys = block.m_nextPhys;
+
+				if (kInvalidIndex != block.m_nextPhys)
 				{
-					uint64_t ptr = it->m_ptr;
+					m_blocks[block.m_nextPhys].m_prevPhys = rest;
+				}
 
-					m_used.insert(stl::make_pair(ptr, _size) );
-					m_total += _size;
+				block.m_size     = pad;
+				block.m_nextPhys = rest;
 
-					if (it->m_size != _size)
-					{
-						it->m_size -= _size;
-						it->m_ptr  += _size;
-					}
-					else
-					{
-						m_free.erase(it);
-					}
+				insertFree(idx);
+				idx = rest;
+			}
 
-					return ptr;
+			if (m_blocks[idx].m_size - size >= kMinBlockSize)
+			{
+				const uint32_t rest = allocNode();
+
+				Block& block = m_blocks[idx];
+				Block& split = m_blocks[rest];
+				split.m_ptr      = block.m_ptr  + size;
+				split.m_size     = block.m_size - size;
+				split.m_prevPhys = idx;
+				split.m_nextPhys = block.m_nextPhys;
+
+				if (kInvalidIndex != block.m_nextPhys)
+				{
+					m_blocks[block.m_nextPhys].m_prevPhys = rest;
 				}
+
+				block.m_size     = size;
+				block.m_nextPhys = rest;
+
+				insertFree(rest);
 			}
 
-			// there is no block large enough.
-			return kInvalidBlock;
+			const Block& block = m_blocks[idx];
+			m_used.insert(block.m_ptr, idx);
+			m_total += block.m_size;
+
+			return block.m_ptr;
 		}
 
 		void free(uint64_t _block)
 		{
-			UsedList::iterator it = m_used.find(_block);
-			if (it != m_used.end() )
+			const uint32_t* used = m_used.find(_block);
+			if (NULL != used)
 			{
-				m_total -= it->second;
+				uint32_t idx = *used;
+				m_used.removeByKey(_block);
+				m_total -= m_blocks[idx].m_size;
+
+				const uint32_t prev = m_blocks[idx].m_prevPhys;
+				if (kInvalidIndex != prev
+				&&  m_blocks[prev].m_free)
+				{
+					removeFree(prev);
+					merge(prev, idx);
+					idx = prev;
+				}
+
+				const uint32_t next = m_blocks[idx].m_nextPhys;
+				if (kInvalidIndex != next
+				&&  m_blocks[next].m_free)
+				{
+					removeFree(next);
+					merge(idx, next);
+				}
 
-				m_free.push_front(Free(it->first, it->second) );
-				m_used.erase(it);
+				insertFree(idx);
 			}
 		}
 
+		// Free blocks are coalesced on free, returns true when there are no
+		// used blocks left.
 		bool compact()
 		{
-			m_free.sort();
+			return 0 == m_used.getNumElements();
+		}
+
+		uint32_t getTotal() const
+		{
+			return m_total;
+		}
+
+	private:
+		static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+		static constexpr uint32_t kAlignmentLog2 = 4;
+		static constexpr uint32_t kAlignment     = 1<<kAlignmentLog2;
+		static constexpr uint32_t kMinBlockSize  = kAlignment;
+		static constexpr uint32_t kMaxAllocSize  = UINT32_C(1)<<31;
+		static constexpr uint32_t kSlCountLog2   = 5;
+		static constexpr uint32_t kSlCount       = 1<<kSlCountLog2;
+		static constexpr uint32_t kFlShift       = kSlCountLog2 + kAlignmentLog2;
+		static constexpr uint32_t kSmallBlock    = 1<<kFlShift;
+		static constexpr uint32_t kFlCount       = 32 - kFlShift + 1;
+
+		struct Block
+		{
+			uint64_t m_ptr;
+			uint32_t m_size;
+			uint32_t m_prevPhys;
+			uint32_t m_nextPhys;
+			uint32_t m_prevFree;
+			uint32_t m_nextFree;
+			bool     m_free;
+		};
 
-			for (FreeList::iterator it = m_free.begin(), next = it, itEnd = m_free.end(); next != itEnd;)
+		static void mapping(uint32_t _size, uint32_t& _fl, uint32_t& _sl)
+		{
+			if (_size < kSmallBlock)
 			{
-				if ( (it->m_ptr + it->m_size) == next->m_ptr)
-				{
-					it->m_size += next->m_size;
-					next = m_free.erase(next);
-				}
-				else
+				_fl = 0;
+				_sl = _size / (kSmallBlock / kSlCount);
+			}
+			else
+			{
+				const uint32_t fl = bx::floorLog2(_size);
+				_sl = (_size >> (fl - kSlCountLog2) ) ^ kSlCount;
+				_fl = fl - kFlShift + 1;
+			}
+		}
+
+		uint32_t findFree(uint32_t _size) const
+		{
+			// Round up to next list, so that any block in found list is large
+			// enough.
+			if (_size >= kSmallBlock)
+			{
+				_size += (1 << (bx::floorLog2(_size) - kSlCountLog2) ) - 1;
+			}
+
+			uint32_t fl;
+			uint32_t sl;
+			mapping(_size, fl, sl);
+
+			uint32_t slMap = m_slBitmap[fl] & (UINT32_MAX << sl);
+			if (0 == slMap)
+			{
+				const uint32_t flMap = m_flBitmap & (UINT32_MAX << (fl + 1) );
+				if (0 == flMap)
 				{
-					it = next;
-					++next;
+					return kInvalidIndex;
 				}
+
+				fl    = bx::countTrailingZeros(flMap);
+				slMap = m_slBitmap[fl];
 			}
 
-			return 0 == m_used.size();
+			sl = bx::countTrailingZeros(slMap);
+
+			return m_freeHead[fl][sl];
 		}
 
-		uint32_t getTotal() const
+		void insertFree(uint32_t _idx)
 		{
-			return m_total;
+			uint32_t fl;
+			uint32_t sl;
+			mapping(m_blocks[_idx].m_size, fl, sl);
+
+			const uint32_t head = m_freeHead[fl][sl];
+
+			Block& block = m_blocks[_idx];
+			block.m_free     = true;
+			block.m_prevFree = kInvalidIndex;
+			block.m_nextFree = head;
+
+			if (kInvalidIndex != head)
+			{
+				m_blocks[head].m_prevFree = _idx;
+			}
+
+			m_freeHead[fl][sl] = _idx;
+			m_flBitmap    |= 1u << fl;
+			m_slBitmap[fl] |= 1u << sl;
 		}
 
-	private:
-		struct Free
+		void removeFree(uint32_t _idx)
 		{
-			Free(uint64_t _ptr, uint32_t _size)
-				: m_ptr(_ptr)
-				, m_size(_size)
+			uint32_t fl;
+			uint32_t sl;
+			mapping(m_blocks[_idx].m_size, fl, sl);
+
+			Block& block = m_blocks[_idx];
+			block.m_free = false;
+
+			if (kInvalidIndex != block.m_prevFree)
 			{
+				m_blocks[block.m_prevFree].m_nextFree = block.m_nextFree;
 			}
+			else
+			{
+				m_freeHead[fl][sl] = block.m_nextFree;
+
+				if (kInvalidIndex == block.m_nextFree)
+				{
+					m_slBitmap[fl] &= ~(1u << sl);
 
-			bool operator<(const Free& rhs) const
+					if (0 == m_slBitmap[fl])
+					{
+						m_flBitmap &= ~(1u << fl);
+					}
+				}
+			}
+
+			if (kInvalidIndex != block.m_nextFree)
 			{
-				return m_ptr < rhs.m_ptr;
+				m_blocks[block.m_nextFree].m_prevFree = block.m_prevFree;
 			}
+		}
 
-			uint64_t m_ptr;
-			uint32_t m_size;
-		};
+		void merge(uint32_t _idx, uint32_t _next)
+		{
+			Block& block = m_blocks[_idx];
+			const Block& next = m_blocks[_next];
 
-		typedef stl::list<Free> FreeList;
-		FreeList m_free;
+			block.m_size    += next.m_size;
+			block.m_nextPhys = next.m_nextPhys;
 
-		typedef stl::unordered_map<uint64_t, uint32_t> UsedList;
+			if (kInvalidIndex != next.m_nextPhys)
+			{
+				m_blocks[next.m_nextPhys].m_prevPhys = _idx;
+			}
+
+			freeNode(_next);
+		}
+
+		uint32_t allocNode()
+		{
+			if (0 < m_freeNodes.size() )
+			{
+				const uint32_t idx = m_freeNodes.back();
+				m_freeNodes.pop_back();
+				return idx;
+			}
+
+			m_blocks.push_back(Block() );
+			return uint32_t(m_blocks.size() - 1);
+		}
+
+		void freeNode(uint32_t _idx)
+		{
+			Block& block = m_blocks[_idx];
+			block.m_size     = 0;
+			block.m_prevPhys = kInvalidIndex;
+			block.m_nextPhys = kInvalidIndex;
+			block.m_free     = false;
+			m_freeNodes.push_back(_idx);
+		}
+
+		typedef stl::vector<Block> BlockArray;
+		BlockArray m_blocks;
+
+		typedef stl::vector<uint32_t> NodeArray;
+		NodeArray m_freeNodes;
+
+		typedef FlatHashMapT<uint64_t, uint32_t> UsedList;
 		UsedList m_used;
 
 		uint32_t m_total;
+		uint32_t m_flBitmap;
+		uint32_t m_slBitmap[kFlCount];
+		uint32_t m_freeHead[kFlCount][kSlCount];
 	};
 
 	struct UniformCache
@@ -3341,18 +4058,16 @@ namespace bgfx
 		~UniformCache()
 		{
 			BX_ASSERT(true
-				&& 0 == m_uniformKeyHashMap.size()
-				&& 0 == m_uniformEntryMap.size()
+				&& 0 == m_uniformKeyHashMap.getNumElements()
+				&& 0 == m_uniformEntryMap.getNumElements()
 				&& 0 == m_uniformStoreAlloc.getTotal()
 				, "UniformCache leak (keys %d, entries %d, %d bytes)!"
-				, m_uniformKeyHashMap.size()
-				, m_uniformEntryMap.size()
+				, m_uniformKeyHashMap.getNumElements()
+				, m_uniformEntryMap.getNumElements()
 				, m_uniformStoreAlloc.getTotal()
 				);
 
 			bx::free(g_allocator, m_data);
-			m_uniformKeyHashMap.clear();
-			m_uniformEntryMap.clear();
 		}
 
 		void setViewUniform(ViewId _id, UniformHandle _handle, const void* _value, uint16_t _num)
@@ -3404,54 +4119,39 @@ namespace bgfx
 			murmur.add(_value, dataSize);
 			const uint32_t hash = murmur.end();
 
-			UniformKeyHashMap::iterator itKey = m_uniformKeyHashMap.find(_uniformKey);
-			if (itKey != m_uniformKeyHashMap.end() )
+			uint32_t* keyHash = m_uniformKeyHashMap.find(_uniformKey);
+			if (NULL != keyHash)
 			{
-				if (itKey->second == hash)
+				if (*keyHash == hash)
 				{
 					return;
 				}
 
-				UniformEntryMap::iterator itOldEntry = m_uniformEntryMap.find(itKey->second);
-				if (itOldEntry != m_uniformEntryMap.end())
-				{
-					if (release(itOldEntry->second) )
-					{
-						m_uniformEntryMap.erase(itOldEntry);
-					}
-				}
-
-				itKey->second = hash;
-
-				UniformEntryMap::iterator itEntry = m_uniformEntryMap.find(hash);
-				if (itEntry != m_uniformEntryMap.end())
-				{
-					++itEntry->second.refCount;
+				release(*keyHash);
 
-					return;
-				}
+				*keyHash = hash;
 			}
 			else
 			{
-				m_uniformKeyHashMap.insert(stl::make_pair(_uniformKey, hash) );
+				m_uniformKeyHashMap.insert(_uniformKey, hash);
 			}
 
-			UniformEntryMap::iterator itEntry = m_uniformEntryMap.find(hash);
-			if (itEntry != m_uniformEntryMap.end())
+			UniformCacheEntry* entry = m_uniformEntryMap.find(hash);
+			if (NULL != entry)
 			{
-				++itEntry->second.refCount;
+				++entry->refCount;
 			}
 			else
 			{
 				const uint64_t offset = m_uniformStoreAlloc.alloc(dataSize);
 				BX_ASSERT(NonLocalAllocator::kInvalidBlock != offset, "UniformCache: Failed to allocate data!");
 
-				m_uniformEntryMap.insert(stl::make_pair(hash, UniformCacheEntry
+				m_uniformEntryMap.insert(hash, UniformCacheEntry
 					{
 						.offset   = bx::narrowCast<uint32_t>(offset),
 						.size     = bx::narrowCast<uint16_t>(dataSize),
 						.refCount = 1
-					}) );
+					});
 
 				bx::memCopy(&m_data[offset], _value, dataSize);
 			}
@@ -3459,44 +4159,50 @@ namespace bgfx
 
 		void frame(UniformCacheFrame& _outUniformCacheFrame)
 		{
-			m_uniformStoreAlloc.compact();
-
 			_outUniformCacheFrame.resize(
-				  uint32_t(m_uniformKeyHashMap.size() )
+				  m_uniformKeyHashMap.getNumElements()
 				, m_uniformStoreAlloc.getTotal()
 				);
 
-			using OffsetRemap = stl::unordered_map<uint32_t, uint32_t>;
-			OffsetRemap offsetRemap;
+			m_offsetRemap.reset();
+			m_offsetRemap.reserve(m_uniformEntryMap.getNumElements() );
 
 			uint32_t linearOffset = 0;
 			uint32_t num = 0;
-			for (UniformKeyHashMap::const_iterator itKey = m_uniformKeyHashMap.begin(), itEnd = m_uniformKeyHashMap.end(); itKey != itEnd; ++itKey)
+			for (uint32_t ii = 0, capacity = m_uniformKeyHashMap.getCapacity(); ii < capacity; ++ii)
 			{
-				UniformEntryMap::iterator itEntry = m_uniformEntryMap.find(itKey->second);
-				BX_ASSERT(itEntry != m_uniformEntryMap.end()
+				if (!m_uniformKeyHashMap.isValid(ii) )
+				{
+					continue;
+				}
+
+				const uint32_t uniformKey = m_uniformKeyHashMap.getKeyAt(ii);
+				const uint32_t hash       = m_uniformKeyHashMap.getValueAt(ii);
+
+				const UniformCacheEntry* entry = m_uniformEntryMap.find(hash);
+				BX_ASSERT(NULL != entry
 					, "Couldn't find uniform cache entry for key 0x%d, hash 0x%x!"
-					, itKey->first
-					, itKey->second
+					, uniformKey
+					, hash
 					);
 
-				const uint32_t offset = itEntry->second.offset;
-				const uint16_t size   = itEntry->second.size;
+				const uint32_t offset = entry->offset;
+				const uint16_t size   = entry->size;
 
 				UniformCacheKey key;
-				key.decode(uint64_t(itKey->first)<<32);
+				key.decode(uint64_t(uniformKey)<<32);
 				key.m_size = size;
 
-				OffsetRemap::const_iterator itOffset = offsetRemap.find(offset);
-				if (itOffset != offsetRemap.end())
+				const uint32_t* remap = m_offsetRemap.find(offset);
+				if (NULL != remap)
 				{
-					key.m_offset = itOffset->second;
+					key.m_offset = *remap;
 				}
 				else
 				{
 					key.m_offset = linearOffset;
 
-					offsetRemap.insert(stl::make_pair(offset, linearOffset) );
+					m_offsetRemap.insert(offset, linearOffset);
 					bx::memCopy(&_outUniformCacheFrame.m_data[linearOffset], &m_data[offset], size);
 
 					linearOffset += size;
@@ -3510,78 +4216,68 @@ namespace bgfx
 
 		void invalidate(ViewId _viewId)
 		{
-			for (UniformKeyHashMap::iterator itKey = m_uniformKeyHashMap.begin(), itEnd = m_uniformKeyHashMap.end(); itKey != itEnd; ++itKey)
+			for (uint32_t ii = 0; ii < m_uniformKeyHashMap.getCapacity();)
 			{
-				UniformCacheKey key;
-				key.decode(uint64_t(itKey->first) << 32);
-
-				if (key.m_view == _viewId)
+				if (m_uniformKeyHashMap.isValid(ii) )
 				{
-					release(itKey->second);
-
-					UniformKeyHashMap::iterator itErase = itKey;
-					++itKey;
+					UniformCacheKey key;
+					key.decode(uint64_t(m_uniformKeyHashMap.getKeyAt(ii) ) << 32);
 
-					m_uniformKeyHashMap.erase(itErase);
+					if (key.m_view == _viewId)
+					{
+						release(m_uniformKeyHashMap.getValueAt(ii) );
+						m_uniformKeyHashMap.removeAt(ii);
+						continue;
+					}
 				}
+
+				++ii;
 			}
 		}
 
 		void invalidate(UniformHandle _handle)
 		{
-			for (UniformKeyHashMap::iterator itKey = m_uniformKeyHashMap.begin(), itEnd = m_uniformKeyHashMap.end(); itKey != itEnd;)
+			for (uint32_t ii = 0; ii < m_uniformKeyHashMap.getCapacity();)
 			{
-				UniformCacheKey key;
-				key.decode(uint64_t(itKey->first) << 32);
-
-				if (key.m_handle == _handle.idx)
+				if (m_uniformKeyHashMap.isValid(ii) )
 				{
-					release(itKey->second);
+					UniformCacheKey key;
+					key.decode(uint64_t(m_uniformKeyHashMap.getKeyAt(ii) ) << 32);
 
-					UniformKeyHashMap::iterator itErase = itKey;
-					++itKey;
-
-					m_uniformKeyHashMap.erase(itErase);
-				}
-				else
-				{
-					++itKey;
+					if (key.m_handle == _handle.idx)
+					{
+						release(m_uniformKeyHashMap.getValueAt(ii) );
+						m_uniformKeyHashMap.removeAt(ii);
+						continue;
+					}
 				}
-			}
-		}
-
-		bool release(UniformCacheEntry& _entry)
-		{
-			--_entry.refCount;
 
-			if (0 == _entry.refCount)
-			{
-				const uint64_t offset = _entry.offset;
-
-				m_uniformStoreAlloc.free(offset);
-				return true;
+				++ii;
 			}
-
-			return false;
 		}
 
 		void release(uint32_t _hash)
 		{
-			UniformEntryMap::iterator itEntry = m_uniformEntryMap.find(_hash);
-			if (itEntry != m_uniformEntryMap.end())
+			UniformCacheEntry* entry = m_uniformEntryMap.find(_hash);
+			if (NULL != entry)
 			{
-				if (release(itEntry->second) )
+				--entry->refCount;
+
+				if (0 == entry->refCount)
 				{
-					m_uniformEntryMap.erase(itEntry);
+					m_uniformStoreAlloc.free(entry->offset);
+					m_uniformEntryMap.removeByKey(_hash);
 				}
 			}
 		}
 
-		using UniformKeyHashMap = stl::unordered_map<uint32_t, uint32_t>;
-		using UniformEntryMap   = stl::unordered_map<uint32_t, UniformCacheEntry>;
+		using UniformKeyHashMap = FlatHashMapT<uint32_t, uint32_t>;
+		using UniformEntryMap   = FlatHashMapT<uint32_t, UniformCacheEntry>;
+		using OffsetRemap       = FlatHashMapT<uint32_t, uint32_t>;
 
 		UniformKeyHashMap m_uniformKeyHashMap;
 		UniformEntryMap   m_uniformEntryMap;
+		OffsetRemap       m_offsetRemap;
 
 		NonLocalAllocator m_uniformStoreAlloc;
 		uint8_t* m_data;
@@ -3610,6 +4306,8 @@ namespace bgfx
 		virtual void destroyShader(ShaderHandle _handle) = 0;
 		virtual void createProgram(ProgramHandle _handle, ShaderHandle _vsh, ShaderHandle _fsh) = 0;
 		virtual void destroyProgram(ProgramHandle _handle) = 0;
+		virtual void precachePipeline(ProgramHandle _program, uint64_t _state, VertexLayoutHandle _layoutHandle, FrameBufferHandle _frameBuffer, uint8_t _numInstanceData) = 0;
+		virtual void savePipelineCache() = 0;
 		virtual void* createTexture(TextureHandle _handle, const Memory* _mem, uint64_t _flags, uint8_t _skip) = 0;
 		virtual void updateTexture(TextureHandle _handle, uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem) = 0;
 		virtual void readTexture(TextureHandle _handle, void* _data, uint8_t _mip) = 0;
@@ -3640,6 +4338,78 @@ namespace bgfx
 
 	void rendererUpdateUniforms(RendererContextI* _renderCtx, UniformBuffer* _uniformBuffer, uint32_t _begin, uint32_t _end);
 
+	// LSD radix sort of render item keys split across multiple threads. Calling
+	// thread participates in sorting as worker 0.
+	class ParallelSort
+	{
+	public:
+		static constexpr uint32_t kRadixBits          = 11;
+		static constexpr uint32_t kRadixHistogramSize = 1<<kRadixBits;
+		static constexpr uint32_t kRadixMask          = kRadixHistogramSize-1;
+		static constexpr uint32_t kRadixPasses        = (64+kRadixBits-1)/kRadixBits;
+
+		ParallelSort();
+		~ParallelSort();
+
+		void init(uint32_t _numThreads);
+		void shutdown();
+
+		uint32_t getNumThreads() const
+		{
+			return m_numThreads;
+		}
+
+		void sort(
+			  uint64_t* _keys
+			, uint64_t* _tempKeys
+			, RenderItemCount* _values
+			, RenderItemCount* _tempValues
+			, uint32_t _num
+			, ViewId* _viewRemap
+			);
+
+	private:
+		struct Job
+		{
+			enum Enum
+			{
+				Histogram,
+				Scatter,
+				Exit,
+			};
+		};
+
+		struct ThreadData
+		{
+			ParallelSort* m_sort;
+			uint32_t      m_idx;
+		};
+
+		static int32_t threadFunc(bx::Thread* _self, void* _userData);
+
+		void dispatch(Job::Enum _job);
+		void execute(uint32_t _idx);
+
+		uint64_t* m_srcKeys;
+		uint64_t* m_dstKeys;
+		RenderItemCount* m_srcValues;
+		RenderItemCount* m_dstValues;
+		ViewId*   m_viewRemap;
+		uint32_t  m_num;
+		uint32_t  m_pass;
+		Job::Enum m_job;
+
+		uint32_t m_numThreads;
+		uint32_t m_histogram[BGFX_CONFIG_MAX_SORT_THREADS][kRadixHistogramSize];
+
+#if BX_CONFIG_SUPPORTS_THREADING
+		ThreadData    m_threadData[BGFX_CONFIG_MAX_SORT_THREADS];
+		bx::Thread    m_thread[BGFX_CONFIG_MAX_SORT_THREADS];
+		bx::Semaphore m_workSem[BGFX_CONFIG_MAX_SORT_THREADS];
+		bx::Semaphore m_doneSem;
+#endif // BX_CONFIG_SUPPORTS_THREADING
+	};
+
 #if BGFX_CONFIG_DEBUG
 #	define BGFX_API_FUNC(_func) BX_NO_INLINE _func
 #else
@@ -3651,8 +4421,16 @@ namespace bgfx
 		static constexpr uint32_t kAlignment = 64;
 
 		Context()
-			: m_render(&m_frame[0])
-			, m_submit(&m_frame[BGFX_CONFIG_MULTITHREADED ? 1 : 0])
+			: m_render(NULL)
+			, m_submit(NULL)
+			, m_numFrames(0)
+			, m_submitIdx(0)
+			, m_renderIdx(0)
+			, m_renderedIdx(0)
+			, m_numQueuedFrames(0)
+			, m_tempKeys(NULL)
+			, m_tempValues(NULL)
+			, m_maxTemp(0)
 			, m_numFreeDynamicIndexBufferHandles(0)
 			, m_numFreeDynamicVertexBufferHandles(0)
 			, m_numFreeOcclusionQueryHandles(0)
@@ -4028,7 +4806,7 @@ namespace bgfx
 			{
 				CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::DestroyVertexLayout);
 				cmdbuf.write(layoutHandle);
-				m_render->free(layoutHandle);
+				m_submit->free(layoutHandle);
 			}
 
 			m_vertexBufferHandle.free(_handle.idx);
@@ -4421,7 +5199,7 @@ namespace bgfx
 			{
 				CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::DestroyVertexLayout);
 				cmdbuf.write(layoutHandle);
-				m_render->free(layoutHandle);
+				m_submit->free(layoutHandle);
 			}
 
 			DynamicVertexBuffer& dvb = m_dynamicVertexBuffers[_handle.idx];
@@ -4430,6 +5208,11 @@ namespace bgfx
 			m_dynamicVertexBufferHandle.free(_handle.idx);
 		}
 
+		BGFX_API_FUNC(const Memory* allocFrame(uint32_t _size) )
+		{
+			return m_submit->allocMemory(_size);
+		}
+
 		BGFX_API_FUNC(uint32_t getAvailTransientIndexBuffer(uint32_t _num, bool _index32) )
 		{
 			BGFX_MUTEX_SCOPE(m_resourceApiLock);
@@ -5026,6 +5809,29 @@ namespace bgfx
 			}
 		}
 
+		BGFX_API_FUNC(void precachePipeline(ProgramHandle _program, uint64_t _state, VertexLayoutHandle _layoutHandle, FrameBufferHandle _frameBuffer, uint8_t _numInstanceData) )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+			BGFX_CHECK_HANDLE("precachePipeline", m_programHandle, _program);
+			BGFX_CHECK_HANDLE("precachePipeline", m_layoutHandle, _layoutHandle);
+			BGFX_CHECK_HANDLE_INVALID_OK("precachePipeline", m_frameBufferHandle, _frameBuffer);
+
+			CommandBuffer& cmdbuf = getCommandBuffer(CommandBuffer::PrecachePipeline);
+			cmdbuf.write(_program);
+			cmdbuf.write(_state);
+			cmdbuf.write(_layoutHandle);
+			cmdbuf.write(_frameBuffer);
+			cmdbuf.write(_numInstanceData);
+		}
+
+		BGFX_API_FUNC(void savePipelineCache() )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+			getCommandBuffer(CommandBuffer::SavePipelineCache);
+		}
+
 		BGFX_API_FUNC(TextureHandle createTexture(const Memory* _mem, uint64_t _flags, uint8_t _skip, TextureInfo* _info, BackbufferRatio::Enum _ratio, bool _immutable) )
 		{
 			BGFX_MUTEX_SCOPE(m_resourceApiLock);
@@ -5166,7 +5972,10 @@ namespace bgfx
 			cmdbuf.write(_handle);
 			cmdbuf.write(_data);
 			cmdbuf.write(_mip);
-			return m_submit->m_frameNum + 2;
+			// Data is available once the frame which has this request is rendered, API
+			// thread can run ahead of render thread by the number of queued frames.
+			const uint32_t numQueued = bx::max<uint32_t>(m_numFrames, 2) - 1;
+			return m_submit->m_frameNum + 1 + numQueued;
 		}
 
 		void resizeTexture(TextureHandle _handle, uint16_t _width, uint16_t _height, uint8_t _numMips, uint16_t _numLayers)
@@ -5584,6 +6393,26 @@ namespace bgfx
 			m_freeOcclusionQueryHandle[m_numFreeOcclusionQueryHandles++] = _handle;
 		}
 
+		BGFX_API_FUNC(DrawBundleHandle createDrawBundle() )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+			DrawBundleHandle handle = { m_drawBundleHandle.alloc() };
+			BX_WARN(isValid(handle), "Failed to allocate draw bundle handle.");
+
+			return handle;
+		}
+
+		BGFX_API_FUNC(void destroyDrawBundle(DrawBundleHandle _handle) )
+		{
+			BGFX_MUTEX_SCOPE(m_resourceApiLock);
+
+			BGFX_CHECK_HANDLE("destroyDrawBundle", m_drawBundleHandle, _handle);
+
+			m_drawBundle[_handle.idx].destroy();
+			m_drawBundleHandle.free(_handle.idx);
+		}
+
 		BGFX_API_FUNC(void requestScreenShot(FrameBufferHandle _handle, const char* _filePath) )
 		{
 			BGFX_MUTEX_SCOPE(m_resourceApiLock);
@@ -5732,6 +6561,10 @@ namespace bgfx
 			return bx::atomicFetchAndAdd<uint32_t>(&m_seq[_id], 1);
 		}
 
+		void createFrames(uint32_t _minResourceCbSize);
+		void destroyFrames();
+		void reserveTemp(uint32_t _num);
+
 		void dumpViewStats();
 		void freeDynamicBuffers();
 		void freeAllHandles(Frame* _frame);
@@ -5765,8 +6598,9 @@ namespace bgfx
 			bool ok = m_apiSem.wait(_msecs);
 			if (ok)
 			{
-				m_render->m_waitSubmit = bx::getHPCounter()-start;
-				m_submit->m_perfStats.waitSubmit = m_submit->m_waitSubmit;
+				Frame* frame = m_frame[m_renderIdx];
+				frame->m_waitSubmit = bx::getHPCounter()-start;
+				frame->m_perfStats.waitSubmit = frame->m_waitSubmit;
 				return true;
 			}
 
@@ -5803,13 +6637,19 @@ namespace bgfx
 				m_encoderEndSem.wait();
 			}
 
+			RenderItemRange unused[128];
+			BX_ASSERT(numEncoders <= BX_COUNTOF(unused), "Too many encoders %d.", numEncoders);
+
 			for (uint16_t ii = 0; ii < numEncoders; ++ii)
 			{
 				uint16_t idx = m_encoderHandle->getHandleAt(ii);
 				m_encoderStats[ii].cpuTimeBegin = m_encoder[idx].m_cpuTimeBegin;
 				m_encoderStats[ii].cpuTimeEnd   = m_encoder[idx].m_cpuTimeEnd;
+				unused[ii] = m_encoder[idx].getUnusedRenderItems();
 			}
 
+			m_submit->compactRenderItems(unused, numEncoders);
+
 			m_submit->m_perfStats.numEncoders = uint8_t(numEncoders);
 
 			m_encoderHandle->reset();
@@ -5847,6 +6687,9 @@ namespace bgfx
 			m_encoderStats[0].cpuTimeBegin = m_encoder[0].m_cpuTimeBegin;
 			m_encoderStats[0].cpuTimeEnd   = m_encoder[0].m_cpuTimeEnd;
 			m_submit->m_perfStats.numEncoders = 1;
+
+			RenderItemRange unused = m_encoder[0].getUnusedRenderItems();
+			m_submit->compactRenderItems(&unused, 1);
 		}
 #endif // BGFX_CONFIG_MULTITHREADED
 
@@ -5856,12 +6699,20 @@ namespace bgfx
 		uint32_t      m_numEncoders;
 		bx::HandleAlloc* m_encoderHandle;
 
-		Frame  m_frame[1+(BGFX_CONFIG_MULTITHREADED ? 1 : 0)];
-		Frame* m_render;
-		Frame* m_submit;
+		Frame*   m_frame[1+(BGFX_CONFIG_MULTITHREADED ? BGFX_CONFIG_MAX_QUEUED_FRAMES : 0)];
+		Frame*   m_render;
+		Frame*   m_submit;
+		uint32_t m_numFrames;
+		uint32_t m_submitIdx;
+		uint32_t m_renderIdx;
+		uint32_t m_renderedIdx;
+		int32_t  m_numQueuedFrames;
+
+		uint64_t*        m_tempKeys;
+		RenderItemCount* m_tempValues;
+		uint32_t         m_maxTemp;
 
-		uint64_t m_tempKeys[BGFX_CONFIG_MAX_DRAW_CALLS];
-		RenderItemCount m_tempValues[BGFX_CONFIG_MAX_DRAW_CALLS];
+		ParallelSort m_parallelSort;
 
 		IndexBuffer  m_indexBuffers[BGFX_CONFIG_MAX_INDEX_BUFFERS];
 		VertexBuffer m_vertexBuffers[BGFX_CONFIG_MAX_VERTEX_BUFFERS];
@@ -5891,6 +6742,9 @@ namespace bgfx
 		bx::HandleAllocT<BGFX_CONFIG_MAX_FRAME_BUFFERS> m_frameBufferHandle;
 		bx::HandleAllocT<BGFX_CONFIG_MAX_UNIFORMS> m_uniformHandle;
 		bx::HandleAllocT<BGFX_CONFIG_MAX_OCCLUSION_QUERIES> m_occlusionQueryHandle;
+		bx::HandleAllocT<BGFX_CONFIG_MAX_DRAW_BUNDLES> m_drawBundleHandle;
+
+		DrawBundle m_drawBundle[BGFX_CONFIG_MAX_DRAW_BUNDLES];
 
 		typedef bx::HandleHashMapT<BGFX_CONFIG_MAX_UNIFORMS*2> UniformHashMap;
 		UniformHashMap m_uniformHashMap;
@@ -175,6 +175,28 @@
 #	define BGFX_CONFIG_RENDERER_VULKAN_MAX_DESCRIPTOR_SETS_PER_FRAME 1024
 #endif // BGFX_CONFIG_RENDERER_VULKAN_MAX_DESCRIPTOR_SETS_PER_FRAME
 
+/// Configure the amount of descriptor sets cached across frames for Vulkan
+#ifndef BGFX_CONFIG_RENDERER_VULKAN_MAX_CACHED_DESCRIPTOR_SETS
+#	define BGFX_CONFIG_RENDERER_VULKAN_MAX_CACHED_DESCRIPTOR_SETS 1024
+#endif // BGFX_CONFIG_RENDERER_VULKAN_MAX_CACHED_DESCRIPTOR_SETS
+
+/// Configure the amount of cached image views for Vulkan
+#ifndef BGFX_CONFIG_RENDERER_VULKAN_MAX_IMAGE_VIEWS
+#	define BGFX_CONFIG_RENDERER_VULKAN_MAX_IMAGE_VIEWS 1024
+#endif // BGFX_CONFIG_RENDERER_VULKAN_MAX_IMAGE_VIEWS
+
+/// Configure the minimum number of draw calls in view before it's recorded
+/// into secondary command buffer by record thread for Vulkan
+#ifndef BGFX_CONFIG_RENDERER_VULKAN_MIN_RECORD_DRAWS
+#	define BGFX_CONFIG_RENDERER_VULKAN_MIN_RECORD_DRAWS 64
+#endif // BGFX_CONFIG_RENDERER_VULKAN_MIN_RECORD_DRAWS
+
+/// Enable uploading new static resources on dedicated transfer queue for
+/// Vulkan, when device exposes transfer only queue family.
+#ifndef BGFX_CONFIG_RENDERER_VULKAN_TRANSFER_QUEUE
+#	define BGFX_CONFIG_RENDERER_VULKAN_TRANSFER_QUEUE 1
+#endif // BGFX_CONFIG_RENDERER_VULKAN_TRANSFER_QUEUE
+
 /// Enable use of tinystl.
 #ifndef BGFX_CONFIG_USE_TINYSTL
 #	define BGFX_CONFIG_USE_TINYSTL 1
@@ -215,17 +237,34 @@
 #endif // BGFX_CONFIG_MULTITHREADED
 
 #ifndef BGFX_CONFIG_MAX_DRAW_CALLS
+/// Default number of draw calls per frame. Render item storage is allocated
+/// at init, and it can be changed with `Init::Limits::maxDrawCalls`.
 #	define BGFX_CONFIG_MAX_DRAW_CALLS ( (64<<10)-1)
 #endif // BGFX_CONFIG_MAX_DRAW_CALLS
 
+#ifndef BGFX_CONFIG_MAX_MATRIX_CACHE
+/// Minimum number of matrix cache entries per frame. Matrix cache is sized
+/// from `Init::Limits::maxDrawCalls`, this is kept for compatibility and
+/// only takes effect when it's larger.
+#	define BGFX_CONFIG_MAX_MATRIX_CACHE 0
+#endif // BGFX_CONFIG_MAX_MATRIX_CACHE
+
+#ifndef BGFX_CONFIG_RENDER_ITEM_BLOCK_SIZE
+/// Number of render items encoder reserves at once. Encoders fill reserved
+/// block locally, and unused tails of blocks are compacted at the end of frame.
+#	define BGFX_CONFIG_RENDER_ITEM_BLOCK_SIZE 256
+#endif // BGFX_CONFIG_RENDER_ITEM_BLOCK_SIZE
+
+#ifndef BGFX_CONFIG_MAX_DRAW_BUNDLES
+#	define BGFX_CONFIG_MAX_DRAW_BUNDLES (1<<10)
+#endif // BGFX_CONFIG_MAX_DRAW_BUNDLES
+
 #ifndef BGFX_CONFIG_MAX_BLIT_ITEMS
+/// Default number of blit items per frame, it can be changed with
+/// `Init::Limits::maxBlitItems`.
 #	define BGFX_CONFIG_MAX_BLIT_ITEMS (1<<10)
 #endif // BGFX_CONFIG_MAX_BLIT_ITEMS
 
-#ifndef BGFX_CONFIG_MAX_MATRIX_CACHE
-#	define BGFX_CONFIG_MAX_MATRIX_CACHE (BGFX_CONFIG_MAX_DRAW_CALLS+1)
-#endif // BGFX_CONFIG_MAX_MATRIX_CACHE
-
 #ifndef BGFX_CONFIG_MAX_RECT_CACHE
 #	define BGFX_CONFIG_MAX_RECT_CACHE (4<<10)
 #endif //  BGFX_CONFIG_MAX_RECT_CACHE
@@ -356,6 +395,21 @@ static_assert(bx::isPowerOf2(BGFX_CONFIG_MAX_VIEWS), "BGFX_CONFIG_MAX_VIEWS must
 #	define BGFX_CONFIG_CACHED_DEVICE_MEMORY_ALLOCATIONS_SIZE (128 << 20)
 #endif // BGFX_CONFIG_CACHED_DEVICE_MEMORY_ALLOCATIONS_SIZE
 
+#ifndef BGFX_CONFIG_DEVICE_MEMORY_PAGE_SIZE
+/// Size of device memory page from which buffers and textures are
+/// sub-allocated. Allocations larger than half of the page size get
+/// their own device memory allocation.
+/// Note: Currently only used by the Vulkan backend.
+#	define BGFX_CONFIG_DEVICE_MEMORY_PAGE_SIZE (64 << 20)
+#endif // BGFX_CONFIG_DEVICE_MEMORY_PAGE_SIZE
+
+#ifndef BGFX_CONFIG_MAX_DEVICE_MEMORY_PAGES
+/// Maximum number of device memory pages, once reached allocations fall back
+/// to their own device memory allocation.
+/// Note: Currently only used by the Vulkan backend.
+#	define BGFX_CONFIG_MAX_DEVICE_MEMORY_PAGES 256
+#endif // BGFX_CONFIG_MAX_DEVICE_MEMORY_PAGES
+
 #ifndef BGFX_CONFIG_MAX_STAGING_SCRATCH_BUFFER_SIZE
 /// The threshold of data size above which the staging scratch buffer will
 /// not be used, but instead a separate device memory allocation will take
@@ -406,6 +460,70 @@ static_assert(bx::isPowerOf2(BGFX_CONFIG_MAX_VIEWS), "BGFX_CONFIG_MAX_VIEWS must
 #	define BGFX_CONFIG_DEFAULT_MAX_ENCODERS ( (0 != BGFX_CONFIG_MULTITHREADED) ? 8 : 1)
 #endif // BGFX_CONFIG_DEFAULT_MAX_ENCODERS
 
+#ifndef BGFX_CONFIG_DEFAULT_MAX_SORT_THREADS
+/// Default number of threads used by `Frame::sort`. Parallel sort is opt-in,
+/// and it's used only when `Init::limits.maxSortThreads` is larger than 1.
+#	define BGFX_CONFIG_DEFAULT_MAX_SORT_THREADS 0
+#endif // BGFX_CONFIG_DEFAULT_MAX_SORT_THREADS
+
+#ifndef BGFX_CONFIG_MAX_SORT_THREADS
+#	define BGFX_CONFIG_MAX_SORT_THREADS 16
+#endif // BGFX_CONFIG_MAX_SORT_THREADS
+
+#ifndef BGFX_CONFIG_DEFAULT_MAX_PIPELINE_THREADS
+/// Default number of threads used to compile pipeline state objects in
+/// background. Pipelines are compiled on render thread by default, background
+/// compilation is enabled with `Init::limits.maxPipelineThreads`.
+#	define BGFX_CONFIG_DEFAULT_MAX_PIPELINE_THREADS 0
+#endif // BGFX_CONFIG_DEFAULT_MAX_PIPELINE_THREADS
+
+#ifndef BGFX_CONFIG_MAX_PIPELINE_THREADS
+#	define BGFX_CONFIG_MAX_PIPELINE_THREADS 8
+#endif // BGFX_CONFIG_MAX_PIPELINE_THREADS
+
+#ifndef BGFX_CONFIG_DEFAULT_MAX_RECORD_THREADS
+/// Default number of threads used to record draw calls of views in parallel.
+/// Parallel recording is opt-in, and it can be enabled with
+/// `Init::limits.maxRecordThreads`.
+#	define BGFX_CONFIG_DEFAULT_MAX_RECORD_THREADS 0
+#endif // BGFX_CONFIG_DEFAULT_MAX_RECORD_THREADS
+
+#ifndef BGFX_CONFIG_MAX_RECORD_THREADS
+#	define BGFX_CONFIG_MAX_RECORD_THREADS 16
+#endif // BGFX_CONFIG_MAX_RECORD_THREADS
+
+#ifndef BGFX_CONFIG_PARALLEL_SORT_MIN_ITEMS
+/// Minimum number of render items per frame before parallel sort is used.
+/// Below this threshold cost of waking up sort threads is higher than
+/// single-threaded radix sort. Default is an estimate, not a measurement;
+/// tune it for target hardware by building with this set to 0, and comparing
+/// `Stats::cpuTimeSort` in 17-drawstress between `--sort-threads 1` and
+/// `--sort-threads N` while changing dim.
+#	define BGFX_CONFIG_PARALLEL_SORT_MIN_ITEMS (16<<10)
+#endif // BGFX_CONFIG_PARALLEL_SORT_MIN_ITEMS
+
+#ifndef BGFX_CONFIG_DEFAULT_MAX_QUEUED_FRAMES
+#	define BGFX_CONFIG_DEFAULT_MAX_QUEUED_FRAMES 1
+#endif // BGFX_CONFIG_DEFAULT_MAX_QUEUED_FRAMES
+
+#ifndef BGFX_CONFIG_MAX_QUEUED_FRAMES
+/// Maximum number of frames API thread can queue ahead of render thread.
+/// Each queued frame requires additional internal `Frame` object.
+#	define BGFX_CONFIG_MAX_QUEUED_FRAMES 3
+#endif // BGFX_CONFIG_MAX_QUEUED_FRAMES
+
+#ifndef BGFX_CONFIG_FRAME_MEMORY_SIZE
+/// Size of per-frame memory arena used by `bgfx::allocFrame`. Each internal
+/// `Frame` object has its own arena. When arena is exhausted, or size is 0,
+/// `bgfx::allocFrame` falls back to `bgfx::alloc`.
+///
+/// Arenas are allocated at init. Pages of small block pool used by
+/// `bgfx::alloc`, `bgfx::copy` and `bgfx::makeRef` are allocated on demand.
+/// Both are returned to allocator only on shutdown, so memory stays at its
+/// peak after a burst of small allocations.
+#	define BGFX_CONFIG_FRAME_MEMORY_SIZE (1<<20)
+#endif // BGFX_CONFIG_FRAME_MEMORY_SIZE
+
 #ifndef BGFX_CONFIG_MAX_BACK_BUFFERS
 #	define BGFX_CONFIG_MAX_BACK_BUFFERS 4
 #endif // BGFX_CONFIG_MAX_BACK_BUFFERS
@@ -356,17 +356,17 @@ namespace bgfx
 			data.m_hash   = _key;
 			data.m_value  = _value;
 			data.m_parent = _parent;
-			m_hashMap.insert(stl::make_pair(_key, handle) );
+			m_hashMap.insert(_key, handle);
 
 			return bx::addressOf(m_data[handle].m_value);
 		}
 
 		Ty* find(uint64_t _key)
 		{
-			HashMap::iterator it = m_hashMap.find(_key);
-			if (it != m_hashMap.end() )
+			const uint16_t* it = m_hashMap.find(_key);
+			if (NULL != it)
 			{
-				uint16_t handle = it->second;
+				uint16_t handle = *it;
 				m_alloc.touch(handle);
 				return bx::addressOf(m_data[handle].m_value);
 			}
@@ -376,12 +376,12 @@ namespace bgfx
 
 		void invalidate(uint64_t _key)
 		{
-			HashMap::iterator it = m_hashMap.find(_key);
-			if (it != m_hashMap.end() )
+			const uint16_t* it = m_hashMap.find(_key);
+			if (NULL != it)
 			{
-				uint16_t handle = it->second;
+				uint16_t handle = *it;
 				m_alloc.free(handle);
-				m_hashMap.erase(it);
+				m_hashMap.removeByKey(_key);
 				release(m_data[handle].m_value);
 			}
 		}
@@ -392,7 +392,7 @@ namespace bgfx
 			{
 				m_alloc.free(_handle);
 				Data& data = m_data[_handle];
-				m_hashMap.erase(m_hashMap.find(data.m_hash) );
+				m_hashMap.removeByKey(data.m_hash);
 				release(data.m_value);
 			}
 		}
@@ -407,7 +407,7 @@ namespace bgfx
 				if (data.m_parent == _parent)
 				{
 					m_alloc.free(handle);
-					m_hashMap.erase(m_hashMap.find(data.m_hash) );
+					m_hashMap.removeByKey(data.m_hash);
 					release(data.m_value);
 				}
 				else
@@ -426,17 +426,27 @@ namespace bgfx
 				release(data.m_value);
 			}
 
-			m_hashMap.clear();
+			m_hashMap.reset();
 			m_alloc.reset();
 		}
 
 		uint32_t getCount() const
 		{
-			return uint32_t(m_hashMap.size() );
+			return m_hashMap.getNumElements();
+		}
+
+		// Returns parent of least recently used entry, which is evicted next
+		// when cache is full.
+		uint16_t getBackParent()
+		{
+			return 0 == m_alloc.getNumHandles()
+				? UINT16_MAX
+				: m_data[m_alloc.getBack()].m_parent
+				;
 		}
 
 	private:
-		typedef stl::unordered_map<uint64_t, uint16_t> HashMap;
+		typedef FlatHashMapT<uint64_t, uint16_t> HashMap;
 		HashMap m_hashMap;
 		bx::HandleAllocLruT<MaxHandleT> m_alloc;
 		struct Data
@@ -455,15 +465,15 @@ namespace bgfx
 		void add(uint64_t _key, uint16_t _value)
 		{
 			invalidate(_key);
-			m_hashMap.insert(stl::make_pair(_key, _value) );
+			m_hashMap.insert(_key, _value);
 		}
 
 		uint16_t find(uint64_t _key)
 		{
-			HashMap::iterator it = m_hashMap.find(_key);
-			if (it != m_hashMap.end() )
+			const uint16_t* it = m_hashMap.find(_key);
+			if (NULL != it)
 			{
-				return it->second;
+				return *it;
 			}
 
 			return UINT16_MAX;
@@ -471,25 +481,21 @@ namespace bgfx
 
 		void invalidate(uint64_t _key)
 		{
-			HashMap::iterator it = m_hashMap.find(_key);
-			if (it != m_hashMap.end() )
-			{
-				m_hashMap.erase(it);
-			}
+			m_hashMap.removeByKey(_key);
 		}
 
 		void invalidate()
 		{
-			m_hashMap.clear();
+			m_hashMap.reset();
 		}
 
 		uint32_t getCount() const
 		{
-			return uint32_t(m_hashMap.size() );
+			return m_hashMap.getNumElements();
 		}
 
 	private:
-		typedef stl::unordered_map<uint64_t, uint16_t> HashMap;
+		typedef FlatHashMapT<uint64_t, uint16_t> HashMap;
 		HashMap m_hashMap;
 	};
 
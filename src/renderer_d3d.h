@@ -163,7 +163,7 @@ namespace bgfx
 		void add(uint64_t _key, Ty* _value)
 		{
 			invalidate(_key);
-			m_hashMap.insert(stl::make_pair(_key, _value) );
+			m_hashMap.insert(_key, _value);
 			BX_ASSERT(isGraphicsDebuggerPresent()
 				|| 1 == getRefCount(_value), "Interface ref count %d, hash %" PRIx64 "."
 				, getRefCount(_value)
@@ -173,10 +173,10 @@ namespace bgfx
 
 		Ty* find(uint64_t _key)
 		{
-			typename HashMap::iterator it = m_hashMap.find(_key);
-			if (it != m_hashMap.end() )
+			Ty** it = m_hashMap.find(_key);
+			if (NULL != it)
 			{
-				return it->second;
+				return *it;
 			}
 
 			return NULL;
@@ -184,32 +184,38 @@ namespace bgfx
 
 		void invalidate(uint64_t _key)
 		{
-			typename HashMap::iterator it = m_hashMap.find(_key);
-			if (it != m_hashMap.end() )
+			Ty** it = m_hashMap.find(_key);
+			if (NULL != it)
 			{
-				DX_RELEASE_W(it->second, 0);
-				m_hashMap.erase(it);
+				DX_RELEASE_W(*it, 0);
+				m_hashMap.removeByKey(_key);
 			}
 		}
 
 		void invalidate()
 		{
-			for (typename HashMap::iterator it = m_hashMap.begin(), itEnd = m_hashMap.end(); it != itEnd; ++it)
+			for (uint32_t ii = 0, capacity = m_hashMap.getCapacity(); ii < capacity; ++ii)
 			{
-				DX_CHECK_REFCOUNT(it->second, 1);
-				it->second->Release();
+				if (!m_hashMap.isValid(ii) )
+				{
+					continue;
+				}
+
+				Ty* value = m_hashMap.getValueAt(ii);
+				DX_CHECK_REFCOUNT(value, 1);
+				value->Release();
 			}
 
-			m_hashMap.clear();
+			m_hashMap.reset();
 		}
 
 		uint32_t getCount() const
 		{
-			return uint32_t(m_hashMap.size() );
+			return m_hashMap.getNumElements();
 		}
 
 	private:
-		typedef stl::unordered_map<uint64_t, Ty*> HashMap;
+		typedef FlatHashMapT<uint64_t, Ty*> HashMap;
 		HashMap m_hashMap;
 	};
 
@@ -1836,6 +1836,14 @@ namespace bgfx { namespace d3d11
 			m_program[_handle.idx].destroy();
 		}
 
+		void precachePipeline(ProgramHandle /*_program*/, uint64_t /*_state*/, VertexLayoutHandle /*_layoutHandle*/, FrameBufferHandle /*_frameBuffer*/, uint8_t /*_numInstanceData*/) override
+		{
+		}
+
+		void savePipelineCache() override
+		{
+		}
+
 		void* createTexture(TextureHandle _handle, const Memory* _mem, uint64_t _flags, uint8_t _skip) override
 		{
 			return m_textures[_handle.idx].create(_mem, _flags, _skip);
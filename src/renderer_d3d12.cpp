@@ -1411,10 +1411,16 @@ namespace bgfx { namespace d3d12
 					, (void**)&m_dsvDescriptorHeap
 					) );
 
+				// Scratch buffers are not resized, size them for the largest number of
+				// draw calls frame can grow to.
+				const uint32_t maxDrawCalls = bx::max<uint32_t>(g_caps.limits.maxDrawCalls, _init.limits.maxDrawCallsGrow);
+
 				for (uint32_t ii = 0; ii < BX_COUNTOF(m_scratchBuffer); ++ii)
 				{
-					m_scratchBuffer[ii].create(BGFX_CONFIG_MAX_DRAW_CALLS*1024
-						, BGFX_CONFIG_MAX_TEXTURES + BGFX_CONFIG_MAX_SHADERS + BGFX_CONFIG_MAX_DRAW_CALLS
+					m_scratchBuffer[ii].create(uint32_t(bx::min<uint64_t>(uint64_t(maxDrawCalls)*1024, UINT32_MAX) )
+						, bx::min<uint32_t>(BGFX_CONFIG_MAX_TEXTURES + BGFX_CONFIG_MAX_SHADERS + maxDrawCalls
+							, D3D12_MAX_SHADER_VISIBLE_DESCRIPTOR_HEAP_SIZE_TIER_1
+							)
 						);
 				}
 				m_samplerAllocator.create(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER
@@ -1964,6 +1970,14 @@ namespace bgfx { namespace d3d12
 			m_program[_handle.idx].destroy();
 		}
 
+		void precachePipeline(ProgramHandle /*_program*/, uint64_t /*_state*/, VertexLayoutHandle /*_layoutHandle*/, FrameBufferHandle /*_frameBuffer*/, uint8_t /*_numInstanceData*/) override
+		{
+		}
+
+		void savePipelineCache() override
+		{
+		}
+
 		void* createTexture(TextureHandle _handle, const Memory* _mem, uint64_t _flags, uint8_t _skip) override
 		{
 			return m_textures[_handle.idx].create(_mem, _flags, _skip);
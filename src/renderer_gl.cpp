@@ -75,6 +75,27 @@ namespace bgfx { namespace gl
 	};
 	static_assert(BGFX_CONFIG_MAX_INSTANCE_DATA_COUNT == BX_COUNTOF(s_instanceDataName) );
 
+	struct UniformBlock
+	{
+		const char* m_name;
+		uint8_t m_binding;
+	};
+
+	// Uniform blocks emitted by shaderc --uniform-blocks. Vertex and compute
+	// stage use binding 0, fragment stage uses binding 1.
+	static const UniformBlock s_uniformBlock[] =
+	{
+		{ "bgfx_VsUniforms", 0 },
+		{ "bgfx_FsUniforms", 1 },
+		{ "bgfx_CsUniforms", 0 },
+	};
+
+	// Members of uniform block are addressed by byte offset within block
+	// instead of uniform location.
+	static constexpr uint32_t kUniformBlockBit         = UINT32_C(0x80000000);
+	static constexpr uint32_t kUniformBlockFragmentBit = UINT32_C(0x40000000);
+	static constexpr uint32_t kUniformBlockOffsetMask  = UINT32_C(0x0000ffff);
+
 	static const GLenum s_access[] =
 	{
 		GL_READ_ONLY,
@@ -558,6 +579,7 @@ namespace bgfx { namespace gl
 			APPLE_texture_format_BGRA8888,
 			APPLE_texture_max_level,
 
+			ARB_buffer_storage,
 			ARB_clip_control,
 			ARB_compute_shader,
 			ARB_conservative_depth,
@@ -585,6 +607,7 @@ namespace bgfx { namespace gl
 			ARB_multisample,
 			ARB_occlusion_query,
 			ARB_occlusion_query2,
+			ARB_parallel_shader_compile,
 			ARB_program_interface_query,
 			ARB_provoking_vertex,
 			ARB_sampler_objects,
@@ -680,6 +703,7 @@ namespace bgfx { namespace gl
 
 			KHR_debug,
 			KHR_no_error,
+			KHR_parallel_shader_compile,
 
 			MOZ_WEBGL_compressed_texture_s3tc,
 			MOZ_WEBGL_depth_texture,
@@ -776,6 +800,7 @@ namespace bgfx { namespace gl
 		{ "APPLE_texture_format_BGRA8888",            false,                             true  },
 		{ "APPLE_texture_max_level",                  false,                             true  },
 
+		{ "ARB_buffer_storage",                       BGFX_CONFIG_RENDERER_OPENGL >= 44, true  },
 		{ "ARB_clip_control",                         BGFX_CONFIG_RENDERER_OPENGL >= 43, true  },
 		{ "ARB_compute_shader",                       BGFX_CONFIG_RENDERER_OPENGL >= 43, true  },
 		{ "ARB_conservative_depth",                   BGFX_CONFIG_RENDERER_OPENGL >= 42, true  },
@@ -803,6 +828,7 @@ namespace bgfx { namespace gl
 		{ "ARB_multisample",                          false,                             true  },
 		{ "ARB_occlusion_query",                      BGFX_CONFIG_RENDERER_OPENGL >= 33, true  },
 		{ "ARB_occlusion_query2",                     BGFX_CONFIG_RENDERER_OPENGL >= 33, true  },
+		{ "ARB_parallel_shader_compile",              false,                             true  },
 		{ "ARB_program_interface_query",              BGFX_CONFIG_RENDERER_OPENGL >= 43, true  },
 		{ "ARB_provoking_vertex",                     BGFX_CONFIG_RENDERER_OPENGL >= 32, true  },
 		{ "ARB_sampler_objects",                      BGFX_CONFIG_RENDERER_OPENGL >= 33, true  },
@@ -898,6 +924,7 @@ namespace bgfx { namespace gl
 
 		{ "KHR_debug",                                BGFX_CONFIG_RENDERER_OPENGL >= 43, true  },
 		{ "KHR_no_error",                             false,                             true  },
+		{ "KHR_parallel_shader_compile",              false,                             true  },
 
 		{ "MOZ_WEBGL_compressed_texture_s3tc",        false,                             true  },
 		{ "MOZ_WEBGL_depth_texture",                  false,                             true  },
@@ -2233,12 +2260,18 @@ namespace bgfx { namespace gl
 
 	struct RendererContextGL : public RendererContextI
 	{
+		// Captured frame is read back into one of capture buffers, and it's
+		// delivered before that buffer is reused.
+		static constexpr uint32_t kNumCaptureBuffers = 3;
+
 		RendererContextGL()
 			: m_numWindows(1)
 			, m_rtMsaa(false)
 			, m_fbDiscard(BGFX_CLEAR_NONE)
 			, m_capture(NULL)
 			, m_captureSize(0)
+			, m_captureIdx(0)
+			, m_readbackFrame(0)
 			, m_maxAnisotropy(0.0f)
 			, m_maxAnisotropyDefault(0.0f)
 			, m_maxMsaa(0)
@@ -2257,6 +2290,14 @@ namespace bgfx { namespace gl
 			, m_occlusionQuerySupport(false)
 			, m_atocSupport(false)
 			, m_conservativeRasterSupport(false)
+			, m_bufferStorageSupport(false)
+			, m_uniformBufferSupport(false)
+			, m_uniformBlockDirty(0)
+			, m_parallelShaderCompileSupport(false)
+			, m_pixelPackBufferSupport(false)
+			, m_textureUploadSupport(false)
+			, m_numProgramsPending(0)
+			, m_numProgramsLinked(0)
 			, m_flip(false)
 			, m_hash( (BX_PLATFORM_WINDOWS<<1) | BX_ARCH_64BIT)
 			, m_backBufferFbo(0)
@@ -2266,6 +2307,7 @@ namespace bgfx { namespace gl
 			, m_clearQuadDepth(BGFX_INVALID_HANDLE)
 		{
 			bx::memSet(m_msaaBackBufferRbos, 0, sizeof(m_msaaBackBufferRbos) );
+			bx::memSet(m_capturePbo, 0, sizeof(m_capturePbo) );
 		}
 
 		~RendererContextGL()
@@ -3039,6 +3081,64 @@ namespace bgfx { namespace gl
 					|| s_extension[Extension::EXT_shader_image_load_store].m_supported
 					;
 
+				m_bufferStorageSupport = true
+					&& BX_ENABLED(BGFX_GL_CONFIG_PERSISTENT_BUFFER_RING)
+					&& s_extension[Extension::ARB_buffer_storage].m_supported
+					&& NULL != glBufferStorage
+					&& NULL != glMapBufferRange
+					&& NULL != glUnmapBuffer
+					&& NULL != glFenceSync
+					&& NULL != glClientWaitSync
+					&& NULL != glDeleteSync
+					;
+
+				m_uniformBufferSupport = true
+					&& (false
+						|| m_gles3
+						|| s_extension[Extension::ARB_uniform_buffer_object].m_supported
+						)
+					&& NULL != glGetUniformBlockIndex
+					&& NULL != glUniformBlockBinding
+					&& NULL != glGetActiveUniformBlockiv
+					&& NULL != glGetActiveUniformsiv
+					&& NULL != glBindBufferRange
+					;
+
+				if (m_uniformBufferSupport)
+				{
+					GLint align = 256;
+					GL_CHECK(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align) );
+					m_uniformBufferRing.create(BGFX_GL_CONFIG_UNIFORM_BUFFER_SIZE, uint32_t(bx::max(align, 1) ) );
+				}
+
+				m_textureUploadSupport = true
+					&& 0 < BGFX_GL_CONFIG_TEXTURE_UPLOAD_SIZE
+					&& m_bufferStorageSupport
+					;
+
+				if (m_textureUploadSupport)
+				{
+					m_textureUploadRing.create(BGFX_GL_CONFIG_TEXTURE_UPLOAD_SIZE);
+				}
+
+				m_pixelPackBufferSupport = true
+					&& BX_ENABLED(BGFX_GL_CONFIG_ASYNC_READ_BACK)
+					&& (BX_ENABLED(BGFX_CONFIG_RENDERER_OPENGL) || m_gles3)
+					&& NULL != glMapBufferRange
+					&& NULL != glUnmapBuffer
+					&& NULL != glFenceSync
+					&& NULL != glClientWaitSync
+					&& NULL != glDeleteSync
+					;
+
+				m_parallelShaderCompileSupport = true
+					&& BX_ENABLED(BGFX_GL_CONFIG_PARALLEL_SHADER_COMPILE)
+					&& (false
+						|| s_extension[Extension::ARB_parallel_shader_compile].m_supported
+						|| s_extension[Extension::KHR_parallel_shader_compile].m_supported
+						)
+					;
+
 				g_caps.supported |= 0
 					| (m_atocSupport               ? BGFX_CAPS_ALPHA_TO_COVERAGE      : 0)
 					| (m_conservativeRasterSupport ? BGFX_CAPS_CONSERVATIVE_RASTER    : 0)
@@ -3239,10 +3339,12 @@ namespace bgfx { namespace gl
 			if (m_vaoSupport)
 			{
 				GL_CHECK(glBindVertexArray(0) );
+				m_vertexArrayCache.invalidate();
 				GL_CHECK(glDeleteVertexArrays(1, &m_vao) );
 				m_vao = 0;
 			}
 
+			processReadbacks(true);
 			captureFinish();
 
 			invalidateCache();
@@ -3257,6 +3359,16 @@ namespace bgfx { namespace gl
 				m_occlusionQuery.destroy();
 			}
 
+			if (m_uniformBufferSupport)
+			{
+				m_uniformBufferRing.destroy();
+			}
+
+			if (m_textureUploadSupport)
+			{
+				m_textureUploadRing.destroy();
+			}
+
 			destroyMsaaFbo();
 			m_glctx.destroy();
 
@@ -3393,6 +3505,14 @@ namespace bgfx { namespace gl
 			m_program[_handle.idx].destroy();
 		}
 
+		void precachePipeline(ProgramHandle /*_program*/, uint64_t /*_state*/, VertexLayoutHandle /*_layoutHandle*/, FrameBufferHandle /*_frameBuffer*/, uint8_t /*_numInstanceData*/) override
+		{
+		}
+
+		void savePipelineCache() override
+		{
+		}
+
 		void* createTexture(TextureHandle _handle, const Memory* _mem, uint64_t _flags, uint8_t _skip) override
 		{
 			m_textures[_handle.idx].create(_mem, _flags, _skip);
@@ -3409,7 +3529,40 @@ namespace bgfx { namespace gl
 			if (m_readBackSupported)
 			{
 				const TextureGL& texture = m_textures[_handle.idx];
-				const bool compressed    = bimg::isCompressed(bimg::TextureFormat::Enum(texture.m_textureFormat) );
+				const bimg::TextureFormat::Enum format = bimg::TextureFormat::Enum(texture.m_textureFormat);
+				const bool compressed = bimg::isCompressed(format);
+
+				GLuint pbo = 0;
+				uint32_t size = 0;
+				void* data = _data;
+
+				if (m_pixelPackBufferSupport)
+				{
+					const bimg::ImageBlockInfo& info = bimg::getBlockInfo(format);
+					const uint32_t width  = bx::max<uint32_t>(1, texture.m_width >>_mip);
+					const uint32_t height = bx::max<uint32_t>(1, texture.m_height>>_mip);
+					const uint32_t depth  = GL_TEXTURE_3D == texture.m_target
+						? bx::max<uint32_t>(1, texture.m_depth>>_mip)
+						: texture.m_depth
+						;
+
+					if (compressed)
+					{
+						size = ( (width +info.blockWidth -1)/info.blockWidth)
+							 * ( (height+info.blockHeight-1)/info.blockHeight)
+							 * info.blockSize
+							 * depth
+							 ;
+					}
+					else
+					{
+						// Rows are aligned to default GL_PACK_ALIGNMENT.
+						size = bx::alignUp(width*info.bitsPerPixel/8, 4)*height*depth;
+					}
+
+					pbo  = createPixelPackBuffer(size);
+					data = NULL;
+				}
 
 				GL_CHECK(glBindTexture(texture.m_target, texture.m_id) );
 
@@ -3417,7 +3570,7 @@ namespace bgfx { namespace gl
 				{
 					GL_CHECK(glGetCompressedTexImage(texture.m_target
 						, _mip
-						, _data
+						, data
 						) );
 				}
 				else
@@ -3426,11 +3579,19 @@ namespace bgfx { namespace gl
 						, _mip
 						, texture.m_fmt
 						, texture.m_type
-						, _data
+						, data
 						) );
 				}
 
 				GL_CHECK(glBindTexture(texture.m_target, 0) );
+
+				if (0 != pbo)
+				{
+					GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0) );
+
+					ReadbackRequestGL& request = addReadback(ReadbackRequestGL::Texture, pbo, size, getReadTextureDeadline() );
+					request.m_data = _data;
+				}
 			}
 			else if (BX_ENABLED(BGFX_GL_CONFIG_TEXTURE_READ_BACK_EMULATION) )
 			{
@@ -3460,6 +3621,9 @@ namespace bgfx { namespace gl
 
 					if (GL_FRAMEBUFFER_COMPLETE == glCheckFramebufferStatus(GL_FRAMEBUFFER) )
 					{
+						const uint32_t size = texture.m_width*texture.m_height*4;
+						const GLuint pbo = m_pixelPackBufferSupport ? createPixelPackBuffer(size) : 0;
+
 						GL_CHECK(glReadPixels(
 							  0
 							, 0
@@ -3467,8 +3631,16 @@ namespace bgfx { namespace gl
 							, texture.m_height
 							, m_readPixelsFmt
 							, GL_UNSIGNED_BYTE
-							, _data
+							, 0 != pbo ? NULL : _data
 							) );
+
+						if (0 != pbo)
+						{
+							GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0) );
+
+							ReadbackRequestGL& request = addReadback(ReadbackRequestGL::Texture, pbo, size, getReadTextureDeadline() );
+							request.m_data = _data;
+						}
 					}
 
 					frameBuffer.destroy();
@@ -3526,6 +3698,11 @@ namespace bgfx { namespace gl
 		void createFrameBuffer(FrameBufferHandle _handle, void* _nwh, uint32_t _width, uint32_t _height, TextureFormat::Enum _format, TextureFormat::Enum _depthFormat) override
 		{
 			BX_UNUSED(_format, _depthFormat);
+
+			// Vertex array objects are not shared between contexts. Cache is
+			// used only while rendering into main window context.
+			m_vertexArrayCache.invalidate();
+
 			uint16_t denseIdx = m_numWindows++;
 			m_windows[denseIdx] = _handle;
 			m_frameBuffers[_handle.idx].create(denseIdx, _nwh, _width, _height);
@@ -3588,6 +3765,32 @@ namespace bgfx { namespace gl
 			m_glctx.makeCurrent(swapChain);
 
 			uint32_t length = width*height*4;
+
+			// Fence is waited on from main context, read back asynchronously only
+			// from main window.
+			if (m_pixelPackBufferSupport
+			&&  NULL == swapChain)
+			{
+				const GLuint pbo = createPixelPackBuffer(length);
+
+				GL_CHECK(glReadPixels(0
+					, 0
+					, width
+					, height
+					, m_readPixelsFmt
+					, GL_UNSIGNED_BYTE
+					, NULL
+					) );
+
+				GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0) );
+
+				ReadbackRequestGL& request = addReadback(ReadbackRequestGL::ScreenShot, pbo, length, m_readbackFrame + kNumCaptureBuffers - 1);
+				request.m_width  = width;
+				request.m_height = height;
+				request.m_filePath.set(_filePath);
+				return;
+			}
+
 			uint8_t* data = (uint8_t*)bx::alloc(g_allocator, length);
 
 			GL_CHECK(glReadPixels(0
@@ -3699,6 +3902,7 @@ namespace bgfx { namespace gl
 			GL_CHECK(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE) );
 
 			ProgramGL& program = m_program[_blitter.m_program.idx];
+			program.isReady(true);
 			setProgram(program.m_id);
 			setUniform1i(program.m_sampler[0], 0);
 
@@ -3810,6 +4014,12 @@ namespace bgfx { namespace gl
 
 		void setShaderUniform4f(uint8_t /*_flags*/, uint32_t _regIndex, const void* _val, uint32_t _numRegs)
 		{
+			if (0 != (_regIndex & kUniformBlockBit) )
+			{
+				setUniformBlock(UniformType::Vec4, _regIndex, _val, _numRegs);
+				return;
+			}
+
 			setUniform4fv(_regIndex
 				, _numRegs
 				, (const GLfloat*)_val
@@ -3818,6 +4028,12 @@ namespace bgfx { namespace gl
 
 		void setShaderUniform4x4f(uint8_t /*_flags*/, uint32_t _regIndex, const void* _val, uint32_t _numRegs)
 		{
+			if (0 != (_regIndex & kUniformBlockBit) )
+			{
+				setUniformBlock(UniformType::Mat4, _regIndex, _val, _numRegs);
+				return;
+			}
+
 			setUniformMatrix4fv(_regIndex
 				, _numRegs
 				, GL_FALSE
@@ -4315,8 +4531,28 @@ namespace bgfx { namespace gl
 		{
 			if (m_resolution.reset&BGFX_RESET_CAPTURE)
 			{
+				// Frames captured at previous resolution must be delivered first.
+				processReadbacks(true);
+
 				m_captureSize = m_resolution.width*m_resolution.height*4;
 				m_capture = bx::realloc(g_allocator, m_capture, m_captureSize);
+
+				if (m_pixelPackBufferSupport)
+				{
+					if (0 == m_capturePbo[0])
+					{
+						GL_CHECK(glGenBuffers(kNumCaptureBuffers, m_capturePbo) );
+					}
+
+					for (uint32_t ii = 0; ii < kNumCaptureBuffers; ++ii)
+					{
+						GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, m_capturePbo[ii]) );
+						GL_CHECK(glBufferData(GL_PIXEL_PACK_BUFFER, m_captureSize, NULL, GL_STREAM_READ) );
+					}
+
+					GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0) );
+				}
+
 				g_callback->captureBegin(m_resolution.width, m_resolution.height, m_resolution.width*4, TextureFormat::BGRA8, true);
 			}
 			else
@@ -4329,6 +4565,30 @@ namespace bgfx { namespace gl
 		{
 			if (NULL != m_capture)
 			{
+				if (0 != m_capturePbo[0])
+				{
+					// Deadline makes sure capture buffer is delivered before it's
+					// reused kNumCaptureBuffers frames later.
+					const GLuint pbo = m_capturePbo[m_captureIdx];
+					m_captureIdx = (m_captureIdx + 1) % kNumCaptureBuffers;
+
+					GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo) );
+					GL_CHECK(glReadPixels(0
+						, 0
+						, m_resolution.width
+						, m_resolution.height
+						, m_readPixelsFmt
+						, GL_UNSIGNED_BYTE
+						, NULL
+						) );
+					GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0) );
+
+					ReadbackRequestGL& request = addReadback(ReadbackRequestGL::Capture, pbo, m_captureSize, m_readbackFrame + kNumCaptureBuffers - 1);
+					request.m_width  = m_resolution.width;
+					request.m_height = m_resolution.height;
+					return;
+				}
+
 				GL_CHECK(glReadPixels(0
 					, 0
 					, m_resolution.width
@@ -4358,6 +4618,14 @@ namespace bgfx { namespace gl
 		{
 			if (NULL != m_capture)
 			{
+				processReadbacks(true);
+
+				if (0 != m_capturePbo[0])
+				{
+					GL_CHECK(glDeleteBuffers(kNumCaptureBuffers, m_capturePbo) );
+					bx::memSet(m_capturePbo, 0, sizeof(m_capturePbo) );
+				}
+
 				g_callback->captureEnd();
 				bx::free(g_allocator, m_capture);
 				m_capture = NULL;
@@ -4365,6 +4633,154 @@ namespace bgfx { namespace gl
 			}
 		}
 
+		// Returns pointer to pass to GL upload function in place of _data. Call
+		// m_textureUploadRing.unbind() after upload.
+		const void* stageTextureUpload(const void* _data, uint32_t _size)
+		{
+			return m_textureUploadSupport
+				? m_textureUploadRing.stage(_data, _size)
+				: _data
+				;
+		}
+
+		// Returned buffer is left bound to GL_PIXEL_PACK_BUFFER target.
+		GLuint createPixelPackBuffer(uint32_t _size)
+		{
+			GLuint pbo;
+			GL_CHECK(glGenBuffers(1, &pbo) );
+			GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo) );
+			GL_CHECK(glBufferData(GL_PIXEL_PACK_BUFFER, _size, NULL, GL_STREAM_READ) );
+			return pbo;
+		}
+
+		// bgfx::readTexture called in frame N returns N+1+Q, where Q is number
+		// of queued frames. API thread gets that frame number from bgfx::frame
+		// once frame N+1 is rendered, so data must be delivered at the end of
+		// rendering frame N+1. Read texture command is executed after frame N
+		// is rendered, when m_readbackFrame is N.
+		uint32_t getReadTextureDeadline() const
+		{
+			return m_readbackFrame + 1;
+		}
+
+		ReadbackRequestGL& addReadback(ReadbackRequestGL::Enum _type, GLuint _pbo, uint32_t _size, uint32_t _deadline)
+		{
+			ReadbackRequestGL request;
+			request.m_pbo      = _pbo;
+			request.m_fence    = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			request.m_size     = _size;
+			request.m_width    = 0;
+			request.m_height   = 0;
+			request.m_deadline = _deadline;
+			request.m_data     = NULL;
+			request.m_type     = _type;
+
+			m_readbacks.push_back(request);
+
+			return m_readbacks.back();
+		}
+
+		void deliverReadback(const ReadbackRequestGL& _request)
+		{
+			GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, _request.m_pbo) );
+
+			const uint8_t* src = (const uint8_t*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, _request.m_size, GL_MAP_READ_BIT);
+			BX_WARN(NULL != src, "Failed to map pixel pack buffer.");
+
+			if (NULL != src)
+			{
+				const uint32_t width  = _request.m_width;
+				const uint32_t height = _request.m_height;
+
+				switch (_request.m_type)
+				{
+				case ReadbackRequestGL::Texture:
+					bx::memCopy(_request.m_data, src, _request.m_size);
+					break;
+
+				case ReadbackRequestGL::ScreenShot:
+					{
+						uint8_t* data = (uint8_t*)bx::alloc(g_allocator, _request.m_size);
+						copyBgra8(data, src, width, height);
+
+						g_callback->screenShot(_request.m_filePath.getCPtr()
+							, width
+							, height
+							, width*4
+							, data
+							, _request.m_size
+							, true
+							);
+						bx::free(g_allocator, data);
+					}
+					break;
+
+				case ReadbackRequestGL::Capture:
+					copyBgra8(m_capture, src, width, height);
+					g_callback->captureFrame(m_capture, _request.m_size);
+					break;
+
+				default:
+					break;
+				}
+
+				GL_CHECK(glUnmapBuffer(GL_PIXEL_PACK_BUFFER) );
+			}
+
+			GL_CHECK(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0) );
+
+			if (ReadbackRequestGL::Capture != _request.m_type)
+			{
+				GL_CHECK(glDeleteBuffers(1, &_request.m_pbo) );
+			}
+		}
+
+		void copyBgra8(void* _dst, const void* _src, uint32_t _width, uint32_t _height)
+		{
+			if (GL_RGBA == m_readPixelsFmt)
+			{
+				bimg::imageSwizzleBgra8(_dst, _width*4, _width, _height, _src, _width*4);
+			}
+			else
+			{
+				bx::memCopy(_dst, _src, _width*_height*4);
+			}
+		}
+
+		void processReadbacks(bool _finishAll)
+		{
+			uint32_t num = 0;
+
+			for (ReadbackRequestGL& request : m_readbacks)
+			{
+				GLenum result = glClientWaitSync(request.m_fence, 0, 0);
+
+				if (GL_TIMEOUT_EXPIRED == result
+				&& (_finishAll || request.m_deadline <= m_readbackFrame) )
+				{
+					BGFX_PROFILER_SCOPE("glClientWaitSync", kColorWait);
+
+					while (GL_TIMEOUT_EXPIRED == result)
+					{
+						result = glClientWaitSync(request.m_fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_C(1000000) );
+					}
+				}
+
+				// Requests are delivered in order they were issued.
+				if (GL_TIMEOUT_EXPIRED == result)
+				{
+					break;
+				}
+
+				GL_CHECK(glDeleteSync(request.m_fence) );
+				deliverReadback(request);
+
+				++num;
+			}
+
+			m_readbacks.erase(m_readbacks.begin(), m_readbacks.begin() + num);
+		}
+
 		bool programFetchFromCache(GLuint programId, uint64_t _id)
 		{
 			_id ^= m_hash;
@@ -4458,6 +4874,12 @@ namespace bgfx { namespace gl
 
 				uint32_t loc = _uniformBuffer.read();
 
+				if (0 != (loc & kUniformBlockBit) )
+				{
+					setUniformBlock(type, loc, data, num);
+					continue;
+				}
+
 				switch (type)
 				{
 #if BX_PLATFORM_EMSCRIPTEN
@@ -4514,6 +4936,57 @@ namespace bgfx { namespace gl
 			}
 		}
 
+		void setUniformBlock(uint8_t _type, uint32_t _loc, const void* _data, uint32_t _num)
+		{
+			const uint8_t block   = 0 != (_loc & kUniformBlockFragmentBit) ? 1 : 0;
+			const uint32_t offset = _loc & kUniformBlockOffsetMask;
+			uint8_t* dst = &m_uniformBlockScratch[block][offset];
+			const uint8_t* src = (const uint8_t*)_data;
+
+			if (UniformType::Mat3 == _type)
+			{
+				// std140 stores each mat3 column as vec4.
+				BX_ASSERT(offset + _num*48 <= sizeof(m_uniformBlockScratch[0]), "Uniform block scratch overflow.");
+
+				for (uint32_t ii = 0; ii < _num*3; ++ii, dst += 16, src += 12)
+				{
+					if (0 != bx::memCmp(dst, src, 12) )
+					{
+						bx::memCopy(dst, src, 12);
+						m_uniformBlockDirty |= 1<<block;
+					}
+				}
+
+				return;
+			}
+
+			const uint32_t size = g_uniformTypeSize[_type]*_num;
+			BX_ASSERT(offset + size <= sizeof(m_uniformBlockScratch[0]), "Uniform block scratch overflow.");
+
+			if (0 != bx::memCmp(dst, src, size) )
+			{
+				bx::memCopy(dst, src, size);
+				m_uniformBlockDirty |= 1<<block;
+			}
+		}
+
+		void commitUniformBlocks(const ProgramGL& _program, bool _force)
+		{
+			for (uint8_t ii = 0; ii < BX_COUNTOF(_program.m_uniformBlockSize); ++ii)
+			{
+				const uint32_t size = _program.m_uniformBlockSize[ii];
+
+				if (0 != size
+				&& (_force || 0 != (m_uniformBlockDirty & (1<<ii) ) ) )
+				{
+					const uint32_t offset = m_uniformBufferRing.write(m_uniformBlockScratch[ii], size);
+					GL_CHECK(glBindBufferRange(GL_UNIFORM_BUFFER, ii, m_uniformBufferRing.m_id, offset, size) );
+				}
+			}
+
+			m_uniformBlockDirty = 0;
+		}
+
 		void clearQuad(ClearQuad& _clearQuad, const Rect& _rect, const Clear& _clear, uint32_t _height, const float _palette[][4])
 		{
 			uint32_t numMrt = 1;
@@ -4615,6 +5088,7 @@ namespace bgfx { namespace gl
 				GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, vb.m_id) );
 
 				ProgramGL& program = m_program[_clearQuad.m_program[numMrt-1].idx];
+				program.isReady(true);
 				setProgram(program.m_id);
 				program.bindAttributesBegin();
 				program.bindAttributes(layout, 0);
@@ -4797,10 +5271,18 @@ namespace bgfx { namespace gl
 		Resolution m_resolution;
 		void* m_capture;
 		uint32_t m_captureSize;
+		GLuint m_capturePbo[kNumCaptureBuffers];
+		uint32_t m_captureIdx;
+		stl::vector<ReadbackRequestGL> m_readbacks;
+		uint32_t m_readbackFrame;
 		float m_maxAnisotropy;
 		float m_maxAnisotropyDefault;
 		int32_t m_maxMsaa;
 		GLuint m_vao;
+		VertexArrayCacheGL m_vertexArrayCache;
+		UniformBufferRingGL m_uniformBufferRing;
+		TextureUploadRingGL m_textureUploadRing;
+		uint8_t m_uniformBlockScratch[2][16<<10];
 		uint16_t m_maxLabelLen;
 		bool m_blitSupported;
 		bool m_readBackSupported;
@@ -4817,6 +5299,14 @@ namespace bgfx { namespace gl
 		bool m_atocSupport;
 		bool m_conservativeRasterSupport;
 		bool m_imageLoadStoreSupport;
+		bool m_bufferStorageSupport;
+		bool m_uniformBufferSupport;
+		uint8_t m_uniformBlockDirty;
+		bool m_parallelShaderCompileSupport;
+		bool m_pixelPackBufferSupport;
+		bool m_textureUploadSupport;
+		uint32_t m_numProgramsPending;
+		uint32_t m_numProgramsLinked;
 		bool m_flip;
 
 		uint64_t m_hash;
@@ -5050,63 +5540,128 @@ namespace bgfx { namespace gl
 		m_id = glCreateProgram();
 		BX_TRACE("Program create: GL%d: GL%d, GL%d", m_id, _vsh.m_id, _fsh.m_id);
 
-		const uint64_t id = (uint64_t(_vsh.m_hash)<<32) | _fsh.m_hash;
-		const bool cached = s_renderGL->programFetchFromCache(m_id, id);
+		m_vsh  = _vsh.m_id;
+		m_fsh  = _fsh.m_id;
+		m_hash = (uint64_t(_vsh.m_hash)<<32) | _fsh.m_hash;
+		m_pending = false;
 
-		if (!cached)
+		if (s_renderGL->programFetchFromCache(m_id, m_hash) )
 		{
-			GLint linked = 0;
-			if (0 != _vsh.m_id)
-			{
-				GL_CHECK(glAttachShader(m_id, _vsh.m_id) );
+			init();
+			return;
+		}
 
-				if (0 != _fsh.m_id)
-				{
-					GL_CHECK(glAttachShader(m_id, _fsh.m_id) );
-				}
+		if (0 == m_vsh)
+		{
+			BX_WARN(false, "Invalid vertex/compute shader.");
+			GL_CHECK(glDeleteProgram(m_id) );
+			m_usedCount = 0;
+			m_id = 0;
+			return;
+		}
 
-				GL_CHECK(glLinkProgram(m_id) );
-				GL_CHECK(glGetProgramiv(m_id, GL_LINK_STATUS, &linked) );
+		GL_CHECK(glAttachShader(m_id, m_vsh) );
 
-				if (0 == linked)
-				{
-					char log[1024];
-					GL_CHECK(glGetProgramInfoLog(m_id, sizeof(log), NULL, log) );
-					BX_TRACE("%d: %s", linked, log);
-				}
+		if (0 != m_fsh)
+		{
+			GL_CHECK(glAttachShader(m_id, m_fsh) );
+		}
+
+		GL_CHECK(glLinkProgram(m_id) );
+		m_pending = true;
+		++s_renderGL->m_numProgramsPending;
+
+		if (!s_renderGL->m_parallelShaderCompileSupport)
+		{
+			isReady(true);
+		}
+	}
+
+	bool ProgramGL::isReady(bool _wait)
+	{
+		if (!m_pending)
+		{
+			return 0 != m_id;
+		}
+
+		if (!_wait)
+		{
+			GLint completed = 0;
+			GL_CHECK(glGetProgramiv(m_id, GL_COMPLETION_STATUS_KHR, &completed) );
+
+			if (0 == completed)
+			{
+				return false;
 			}
+		}
+
+		m_pending = false;
+		--s_renderGL->m_numProgramsPending;
+
+		GLint linked = 0;
+		GL_CHECK(glGetProgramiv(m_id, GL_LINK_STATUS, &linked) );
+
+		if (0 == linked)
+		{
+			char log[1024];
+			GL_CHECK(glGetProgramInfoLog(m_id, sizeof(log), NULL, log) );
+			BX_TRACE("%d: %s", linked, log);
 
-			if (0 == linked)
+			if (s_renderGL->m_parallelShaderCompileSupport)
 			{
-				BX_WARN(0 != _vsh.m_id, "Invalid vertex/compute shader.");
-				GL_CHECK(glDeleteProgram(m_id) );
-				m_usedCount = 0;
-				m_id = 0;
-				return;
+				// Shader compile status was not checked at shader creation.
+				const GLuint shaders[] = { m_vsh, m_fsh };
+				for (uint32_t ii = 0; ii < BX_COUNTOF(shaders); ++ii)
+				{
+					GLint compiled = GL_TRUE;
+					if (0 != shaders[ii])
+					{
+						GL_CHECK(glGetShaderiv(shaders[ii], GL_COMPILE_STATUS, &compiled) );
+					}
+
+					if (0 == compiled)
+					{
+						GL_CHECK(glGetShaderInfoLog(shaders[ii], sizeof(log), NULL, log) );
+						BGFX_FATAL(false, bgfx::Fatal::InvalidShader, "Failed to compile shader. %d: %s", compiled, log);
+					}
+				}
 			}
 
-			s_renderGL->programCache(m_id, id);
+			GL_CHECK(glDeleteProgram(m_id) );
+			m_usedCount = 0;
+			m_id = 0;
+			return false;
 		}
 
+		s_renderGL->programCache(m_id, m_hash);
+		++s_renderGL->m_numProgramsLinked;
+
 		init();
 
-		if (!cached
-		&&  s_renderGL->m_workaround.m_detachShader)
+		if (s_renderGL->m_workaround.m_detachShader)
 		{
 			// Must be after init, otherwise init might fail to lookup shader
 			// info (NVIDIA Tegra 3 OpenGL ES 2.0 14.01003).
-			GL_CHECK(glDetachShader(m_id, _vsh.m_id) );
+			GL_CHECK(glDetachShader(m_id, m_vsh) );
 
-			if (0 != _fsh.m_id)
+			if (0 != m_fsh)
 			{
-				GL_CHECK(glDetachShader(m_id, _fsh.m_id) );
+				GL_CHECK(glDetachShader(m_id, m_fsh) );
 			}
 		}
+
+		return true;
 	}
 
 	void ProgramGL::destroy()
 	{
-		if (NULL != m_constantBuffer)
+		if (m_pending)
+		{
+			m_pending = false;
+			--s_renderGL->m_numProgramsPending;
+		}
+
+		if (NULL != m_constantBuffer)
 		{
 			UniformBuffer::destroy(m_constantBuffer);
 			m_constantBuffer = NULL;
@@ -5194,6 +5749,37 @@ namespace bgfx { namespace gl
 		m_numPredefined = 0;
 		m_numSamplers = 0;
 
+		GLuint uniformBlockIndex[BX_COUNTOF(s_uniformBlock)];
+		bx::memSet(m_uniformBlockSize, 0, sizeof(m_uniformBlockSize) );
+
+		for (uint32_t ii = 0; ii < BX_COUNTOF(s_uniformBlock); ++ii)
+		{
+			uniformBlockIndex[ii] = GL_INVALID_INDEX;
+
+			if (s_renderGL->m_uniformBufferSupport)
+			{
+				const UniformBlock& block = s_uniformBlock[ii];
+				const GLuint index = glGetUniformBlockIndex(m_id, block.m_name);
+
+				if (GL_INVALID_INDEX != index)
+				{
+					GLint size = 0;
+					GL_CHECK(glGetActiveUniformBlockiv(m_id, index, GL_UNIFORM_BLOCK_DATA_SIZE, &size) );
+					GL_CHECK(glUniformBlockBinding(m_id, index, block.m_binding) );
+
+					BX_ASSERT(uint32_t(size) <= sizeof(s_renderGL->m_uniformBlockScratch[0])
+						, "Uniform block %s is too large (%d bytes)."
+						, block.m_name
+						, size
+						);
+					BX_TRACE("Uniform block %s, binding %d, size %d", block.m_name, block.m_binding, size);
+
+					uniformBlockIndex[ii] = index;
+					m_uniformBlockSize[block.m_binding] = uint32_t(size);
+				}
+			}
+		}
+
 		BX_TRACE("Uniforms (%d):", activeUniforms);
 		for (int32_t ii = 0; ii < activeUniforms; ++ii)
 		{
@@ -5240,6 +5826,37 @@ namespace bgfx { namespace gl
 				loc = glGetUniformLocation(m_id, name);
 			}
 
+			if (-1 == loc
+			&&  0 != (m_uniformBlockSize[0] | m_uniformBlockSize[1]) )
+			{
+				const GLuint index = GLuint(ii);
+				GLint blockIndex  = -1;
+				GLint blockOffset = 0;
+				GL_CHECK(glGetActiveUniformsiv(m_id, 1, &index, GL_UNIFORM_BLOCK_INDEX, &blockIndex) );
+				GL_CHECK(glGetActiveUniformsiv(m_id, 1, &index, GL_UNIFORM_OFFSET,      &blockOffset) );
+
+				for (uint32_t jj = 0; jj < BX_COUNTOF(s_uniformBlock); ++jj)
+				{
+					if (GLuint(blockIndex) == uniformBlockIndex[jj])
+					{
+						loc = GLint(0
+							| kUniformBlockBit
+							| (0 != s_uniformBlock[jj].m_binding ? kUniformBlockFragmentBit : 0)
+							| (uint32_t(blockOffset) & kUniformBlockOffsetMask)
+							);
+
+						// Block members are reported as <block name>.<member name>.
+						const bx::StringView dot = bx::strFind(name, '.');
+						if (!dot.isEmpty() )
+						{
+							bx::memMove(name, dot.getPtr()+1, bx::strLen(dot.getPtr()+1)+1);
+						}
+
+						break;
+					}
+				}
+			}
+
 			num = bx::uint32_max(num, 1);
 
 			int32_t offset = 0;
@@ -5532,15 +6149,397 @@ namespace bgfx { namespace gl
 		}
 	}
 
+	void BufferRingGL::create(GLenum _target, uint32_t _size)
+	{
+		const GLbitfield flags = 0
+			| GL_MAP_WRITE_BIT
+			| GL_MAP_PERSISTENT_BIT
+			| GL_MAP_COHERENT_BIT
+			;
+
+		m_target  = _target;
+		m_size    = _size;
+		m_current = 0;
+
+		GL_CHECK(glGenBuffers(kNumRegions, m_id) );
+
+		for (uint32_t ii = 0; ii < kNumRegions; ++ii)
+		{
+			BX_ASSERT(0 != m_id[ii], "Failed to generate buffer id.");
+			GL_CHECK(glBindBuffer(m_target, m_id[ii]) );
+			GL_CHECK(glBufferStorage(m_target, _size, NULL, flags) );
+			m_data[ii]  = (uint8_t*)glMapBufferRange(m_target, 0, _size, flags);
+			m_fence[ii] = NULL;
+			BX_ASSERT(NULL != m_data[ii], "Failed to map buffer.");
+		}
+
+		GL_CHECK(glBindBuffer(m_target, 0) );
+	}
+
+	void BufferRingGL::destroy()
+	{
+		for (uint32_t ii = 0; ii < kNumRegions; ++ii)
+		{
+			if (NULL != m_fence[ii])
+			{
+				GL_CHECK(glDeleteSync(m_fence[ii]) );
+				m_fence[ii] = NULL;
+			}
+
+			GL_CHECK(glBindBuffer(m_target, m_id[ii]) );
+			GL_CHECK(glUnmapBuffer(m_target) );
+		}
+
+		GL_CHECK(glBindBuffer(m_target, 0) );
+		GL_CHECK(glDeleteBuffers(kNumRegions, m_id) );
+	}
+
+	GLuint BufferRingGL::update(uint32_t _offset, uint32_t _size, const void* _data)
+	{
+		BX_ASSERT(_offset + _size <= m_size, "Updating outside of buffer ring region.");
+
+		GLsync& fence = m_fence[m_current];
+
+		if (NULL != fence)
+		{
+			// Region is still used by GPU, wait for frame that used it.
+			GLenum result = glClientWaitSync(fence, 0, 0);
+
+			while (GL_TIMEOUT_EXPIRED == result)
+			{
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_C(1000000) );
+			}
+
+			GL_CHECK(glDeleteSync(fence) );
+			fence = NULL;
+		}
+
+		bx::memCopy(&m_data[m_current][_offset], _data, _size);
+
+		return m_id[m_current];
+	}
+
+	void BufferRingGL::fence()
+	{
+		GLsync& fence = m_fence[m_current];
+
+		if (NULL != fence)
+		{
+			GL_CHECK(glDeleteSync(fence) );
+		}
+
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		// Next frame writes into next region, while GPU is still using this one.
+		m_current = (m_current + 1) % kNumRegions;
+	}
+
+	void TextureUploadRingGL::create(uint32_t _size)
+	{
+		const GLbitfield flags = 0
+			| GL_MAP_WRITE_BIT
+			| GL_MAP_PERSISTENT_BIT
+			| GL_MAP_COHERENT_BIT
+			;
+
+		m_size       = _size;
+		m_current    = 0;
+		m_offset     = 0;
+		m_uploadSize = 0;
+		m_waitTime   = 0;
+		m_bound      = false;
+
+		// Offset 0 is never handed out, since NULL data means there is nothing
+		// to upload.
+		const uint32_t size = kAlign + kNumRegions*_size;
+
+		GL_CHECK(glGenBuffers(1, &m_id) );
+		GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_id) );
+		GL_CHECK(glBufferStorage(GL_PIXEL_UNPACK_BUFFER, size, NULL, flags) );
+		m_data = (uint8_t*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+		BX_ASSERT(NULL != m_data, "Failed to map buffer.");
+		GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0) );
+
+		for (uint32_t ii = 0; ii < kNumRegions; ++ii)
+		{
+			m_fence[ii] = NULL;
+		}
+	}
+
+	void TextureUploadRingGL::destroy()
+	{
+		for (uint32_t ii = 0; ii < kNumRegions; ++ii)
+		{
+			if (NULL != m_fence[ii])
+			{
+				GL_CHECK(glDeleteSync(m_fence[ii]) );
+				m_fence[ii] = NULL;
+			}
+		}
+
+		GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_id) );
+		GL_CHECK(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) );
+		GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0) );
+		GL_CHECK(glDeleteBuffers(1, &m_id) );
+		m_id = 0;
+	}
+
+	const void* TextureUploadRingGL::stage(const void* _data, uint32_t _size)
+	{
+		const uint32_t offset = bx::alignUp(m_offset, kAlign);
+
+		if (NULL == _data
+		||  offset + _size > m_size)
+		{
+			return _data;
+		}
+
+		GLsync& fence = m_fence[m_current];
+
+		if (NULL != fence)
+		{
+			// Region is still used by GPU, wait for frame that used it.
+			const int64_t start = bx::getHPCounter();
+
+			GLenum result = glClientWaitSync(fence, 0, 0);
+
+			while (GL_TIMEOUT_EXPIRED == result)
+			{
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_C(1000000) );
+			}
+
+			GL_CHECK(glDeleteSync(fence) );
+			fence = NULL;
+
+			m_waitTime += bx::getHPCounter() - start;
+		}
+
+		const uint32_t pos = kAlign + m_current*m_size + offset;
+		bx::memCopy(&m_data[pos], _data, _size);
+
+		m_offset      = offset + _size;
+		m_uploadSize += _size;
+
+		if (!m_bound)
+		{
+			GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_id) );
+			m_bound = true;
+		}
+
+		return (const void*)uintptr_t(pos);
+	}
+
+	void TextureUploadRingGL::unbind()
+	{
+		if (m_bound)
+		{
+			GL_CHECK(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0) );
+			m_bound = false;
+		}
+	}
+
+	void TextureUploadRingGL::frame()
+	{
+		if (0 != m_offset)
+		{
+			m_fence[m_current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			m_current = (m_current + 1) % kNumRegions;
+			m_offset  = 0;
+		}
+	}
+
+	void UniformBufferRingGL::create(uint32_t _size, uint32_t _align)
+	{
+		m_size  = _size;
+		m_align = _align;
+		m_pos   = 0;
+
+		GL_CHECK(glGenBuffers(1, &m_id) );
+		GL_CHECK(glBindBuffer(GL_UNIFORM_BUFFER, m_id) );
+		GL_CHECK(glBufferData(GL_UNIFORM_BUFFER, m_size, NULL, GL_DYNAMIC_DRAW) );
+		GL_CHECK(glBindBuffer(GL_UNIFORM_BUFFER, 0) );
+	}
+
+	void UniformBufferRingGL::destroy()
+	{
+		GL_CHECK(glBindBuffer(GL_UNIFORM_BUFFER, 0) );
+		GL_CHECK(glDeleteBuffers(1, &m_id) );
+		m_id = 0;
+	}
+
+	uint32_t UniformBufferRingGL::write(const void* _data, uint32_t _size)
+	{
+		uint32_t offset = bx::alignUp(m_pos, m_align);
+
+		GL_CHECK(glBindBuffer(GL_UNIFORM_BUFFER, m_id) );
+
+		if (offset + _size > m_size)
+		{
+			// Orphan buffer, previously written data might be still in use by GPU.
+			GL_CHECK(glBufferData(GL_UNIFORM_BUFFER, m_size, NULL, GL_DYNAMIC_DRAW) );
+			offset = 0;
+		}
+
+		GL_CHECK(glBufferSubData(GL_UNIFORM_BUFFER, offset, _size, _data) );
+		m_pos = offset + _size;
+
+		return offset;
+	}
+
+	GLuint VertexArrayCacheGL::find(uint32_t _hash, const Key& _key)
+	{
+		const uint16_t* it = m_hashMap.find(_hash);
+		if (NULL != it)
+		{
+			const uint16_t handle = *it;
+			const Data& data = m_data[handle];
+
+			if (0 == bx::memCmp(&data.m_key, &_key, sizeof(Key) ) )
+			{
+				m_alloc.touch(handle);
+				return data.m_id;
+			}
+		}
+
+		return 0;
+	}
+
+	GLuint VertexArrayCacheGL::add(uint32_t _hash, const Key& _key)
+	{
+		BX_ASSERT(_key.m_num <= BX_COUNTOF(_key.m_buffer), "Too many buffers referenced by vertex array object.");
+
+		// Hash collision, entry with different key is replaced.
+		const uint16_t* it = m_hashMap.find(_hash);
+		if (NULL != it)
+		{
+			remove(*it);
+		}
+
+		uint16_t handle = m_alloc.alloc();
+		if (UINT16_MAX == handle)
+		{
+			remove(m_alloc.getBack() );
+			handle = m_alloc.alloc();
+		}
+
+		BX_ASSERT(UINT16_MAX != handle, "Failed to find handle.");
+
+		Data& data = m_data[handle];
+		data.m_hash = _hash;
+		bx::memCopy(&data.m_key, &_key, sizeof(Key) );
+		GL_CHECK(glGenVertexArrays(1, &data.m_id) );
+		m_hashMap.insert(_hash, handle);
+
+		return data.m_id;
+	}
+
+	void VertexArrayCacheGL::invalidate(GLuint _buffer)
+	{
+		for (uint16_t ii = 0; ii < m_alloc.getNumHandles();)
+		{
+			const uint16_t handle = m_alloc.getHandleAt(ii);
+			const Key& key = m_data[handle].m_key;
+
+			bool found = false;
+			for (uint32_t jj = 0; jj < key.m_num && !found; ++jj)
+			{
+				found = _buffer == key.m_buffer[jj];
+			}
+
+			if (found)
+			{
+				remove(handle);
+			}
+			else
+			{
+				++ii;
+			}
+		}
+	}
+
+	void VertexArrayCacheGL::remove(uint16_t _handle)
+	{
+		Data& data = m_data[_handle];
+		m_hashMap.removeByKey(data.m_hash);
+		m_alloc.free(_handle);
+		GL_CHECK(glDeleteVertexArrays(1, &data.m_id) );
+	}
+
+	void VertexArrayCacheGL::invalidate()
+	{
+		for (uint16_t ii = 0, num = m_alloc.getNumHandles(); ii < num; ++ii)
+		{
+			const uint16_t handle = m_alloc.getHandleAt(ii);
+			GL_CHECK(glDeleteVertexArrays(1, &m_data[handle].m_id) );
+		}
+
+		m_hashMap.reset();
+		m_alloc.reset();
+	}
+
+	void IndexBufferGL::createRing()
+	{
+		if (NULL == m_ring)
+		{
+			GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
+			GL_CHECK(glDeleteBuffers(1, &m_id) );
+
+			m_ring = BX_NEW(g_allocator, BufferRingGL);
+			m_ring->create(GL_ELEMENT_ARRAY_BUFFER, m_size);
+			m_id = m_ring->m_id[m_ring->m_current];
+		}
+	}
+
 	void IndexBufferGL::destroy()
 	{
 		GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
+
+		if (NULL != m_ring)
+		{
+			m_ring->destroy();
+			bx::deleteObject(g_allocator, m_ring);
+			m_ring = NULL;
+			return;
+		}
+
 		GL_CHECK(glDeleteBuffers(1, &m_id) );
 	}
 
+	void VertexBufferGL::createRing()
+	{
+		if (NULL == m_ring)
+		{
+			s_renderGL->m_vertexArrayCache.invalidate(m_id);
+
+			GL_CHECK(glBindBuffer(m_target, 0) );
+			GL_CHECK(glDeleteBuffers(1, &m_id) );
+
+			m_ring = BX_NEW(g_allocator, BufferRingGL);
+			m_ring->create(m_target, m_size);
+			m_id = m_ring->m_id[m_ring->m_current];
+		}
+	}
+
 	void VertexBufferGL::destroy()
 	{
 		GL_CHECK(glBindBuffer(m_target, 0) );
+
+		VertexArrayCacheGL& vertexArrayCache = s_renderGL->m_vertexArrayCache;
+
+		if (NULL != m_ring)
+		{
+			for (uint32_t ii = 0; ii < BufferRingGL::kNumRegions; ++ii)
+			{
+				vertexArrayCache.invalidate(m_ring->m_id[ii]);
+			}
+
+			m_ring->destroy();
+			bx::deleteObject(g_allocator, m_ring);
+			m_ring = NULL;
+			return;
+		}
+
+		vertexArrayCache.invalidate(m_id);
 		GL_CHECK(glDeleteBuffers(1, &m_id) );
 	}
 
@@ -5848,12 +6847,13 @@ namespace bgfx { namespace gl
 								, depth
 								, 0
 								, mip.m_size
-								, mip.m_data
+								, s_renderGL->stageTextureUpload(mip.m_data, mip.m_size)
 								) );
+							s_renderGL->m_textureUploadRing.unbind();
 						}
 						else
 						{
-							const uint8_t* data = mip.m_data;
+							const void* data = mip.m_data;
 
 							if (convert)
 							{
@@ -5868,6 +6868,10 @@ namespace bgfx { namespace gl
 									);
 								data = temp;
 							}
+							else
+							{
+								data = s_renderGL->stageTextureUpload(data, mip.m_size);
+							}
 
 							GL_CHECK(texImage(imageTarget
 								, msaaQuality
@@ -5881,6 +6885,7 @@ namespace bgfx { namespace gl
 								, m_type
 								, data
 								) );
+							s_renderGL->m_textureUploadRing.unbind();
 						}
 					}
 					else if (!computeWrite)
@@ -6049,8 +7054,9 @@ namespace bgfx { namespace gl
 				, _depth
 				, internalFmt
 				, _mem->size
-				, data
+				, data == _mem->data ? s_renderGL->stageTextureUpload(data, _mem->size) : data
 				) );
+			s_renderGL->m_textureUploadRing.unbind();
 		}
 		else
 		{
@@ -6081,8 +7087,9 @@ namespace bgfx { namespace gl
 				, _depth
 				, m_fmt
 				, m_type
-				, data
+				, data == _mem->data ? s_renderGL->stageTextureUpload(data, _mem->size) : data
 				) );
+			s_renderGL->m_textureUploadRing.unbind();
 		}
 
 		if (!convert
@@ -6558,6 +7565,7 @@ namespace bgfx { namespace gl
 					const bool usesTextureMS    = !bx::findIdentifierMatch(code, s_ARB_texture_multisample).isEmpty();
 					const bool usesPacking      = !bx::findIdentifierMatch(code, s_ARB_shading_language_packing).isEmpty();
 					const bool usesInterpQ      = !bx::findIdentifierMatch(code, s_intepolationQualifier).isEmpty();
+					const bool usesUniformBlock = !bx::findIdentifierMatch(code, "std140").isEmpty();
 
 					uint32_t version = false
 						|| usesTextureArray
@@ -6596,6 +7604,11 @@ namespace bgfx { namespace gl
 						bx::write(&writer, "#extension GL_ARB_draw_instanced : enable\n", &err);
 					}
 
+					if (430 > version && usesUniformBlock)
+					{
+						bx::write(&writer, "#extension GL_ARB_uniform_buffer_object : enable\n", &err);
+					}
+
 					if (usesGpuShader4)
 					{
 						bx::write(&writer, "#extension GL_EXT_gpu_shader4 : enable\n", &err);
@@ -6909,8 +7922,13 @@ namespace bgfx { namespace gl
 
 			GL_CHECK(glCompileShader(m_id) );
 
-			GLint compiled = 0;
-			GL_CHECK(glGetShaderiv(m_id, GL_COMPILE_STATUS, &compiled) );
+			GLint compiled = GL_TRUE;
+			if (!s_renderGL->m_parallelShaderCompileSupport)
+			{
+				// Querying compile status blocks until compile is done. With parallel
+				// shader compile it's checked only if program using shader fails to link.
+				GL_CHECK(glGetShaderiv(m_id, GL_COMPILE_STATUS, &compiled) );
+			}
 
 			if (0 == compiled)
 			{
@@ -7491,6 +8509,10 @@ namespace bgfx { namespace gl
 
 	void RendererContextGL::submit(Frame* _render, ClearQuad& _clearQuad, TextVideoMemBlitter& _textVideoMemBlitter)
 	{
+		// Read back deadlines are frame numbers, so they match frame numbers
+		// returned to API thread.
+		m_readbackFrame = _render->m_frameNum;
+
 		if (_render->m_capture)
 		{
 			renderDocTriggerCapture();
@@ -7524,14 +8546,28 @@ namespace bgfx { namespace gl
 		{
 			BGFX_PROFILER_SCOPE("bgfx/Update transient index buffer", kColorResource);
 			TransientIndexBuffer* ib = _render->m_transientIb;
-			m_indexBuffers[ib->handle.idx].update(0, _render->m_iboffset, ib->data, true);
+			IndexBufferGL& indexBuffer = m_indexBuffers[ib->handle.idx];
+
+			if (m_bufferStorageSupport)
+			{
+				indexBuffer.createRing();
+			}
+
+			indexBuffer.update(0, _render->m_iboffset, ib->data, true);
 		}
 
 		if (0 < _render->m_vboffset)
 		{
 			BGFX_PROFILER_SCOPE("bgfx/Update transient vertex buffer", kColorResource);
 			TransientVertexBuffer* vb = _render->m_transientVb;
-			m_vertexBuffers[vb->handle.idx].update(0, _render->m_vboffset, vb->data, true);
+			VertexBufferGL& vertexBuffer = m_vertexBuffers[vb->handle.idx];
+
+			if (m_bufferStorageSupport)
+			{
+				vertexBuffer.createRing();
+			}
+
+			vertexBuffer.update(0, _render->m_vboffset, vb->data, true);
 		}
 
 		_render->sort();
@@ -7550,6 +8586,10 @@ namespace bgfx { namespace gl
 		ProgramHandle currentProgram = BGFX_INVALID_HANDLE;
 		ProgramHandle boundProgram   = BGFX_INVALID_HANDLE;
 		SortKey key;
+
+		// Vertex array objects are not shared between contexts, cache is used
+		// only when rendering into main window.
+		const bool vertexArrayCache = 0 != m_vao && 1 == m_numWindows;
 		uint16_t view = UINT16_MAX;
 		FrameBufferHandle fbh = { BGFX_CONFIG_MAX_FRAME_BUFFERS };
 
@@ -7590,6 +8630,7 @@ namespace bgfx { namespace gl
 		uint32_t statsNumInstances[BX_COUNTOF(s_primInfo)] = {};
 		uint32_t statsNumIndices = 0;
 		uint32_t statsKeyType[2] = {};
+		uint32_t numDrawSkipped = 0;
 
 		Profiler<TimerQueryGL> profiler(
 			  _render
@@ -7696,6 +8737,12 @@ namespace bgfx { namespace gl
 						const RenderCompute& compute = renderItem.compute;
 
 						ProgramGL& program = m_program[key.m_program.idx];
+						if (!program.isReady() )
+						{
+							numDrawSkipped += 0 != program.m_id;
+							continue;
+						}
+
 						setProgram(program.m_id);
 
 						GLbitfield barrier = 0;
@@ -7749,7 +8796,10 @@ namespace bgfx { namespace gl
 
 						if (0 != barrier)
 						{
-							bool constantsChanged = compute.m_uniformBegin < compute.m_uniformEnd;
+							// Uniform block data is not program state, it must be
+							// committed every time program is used.
+							const bool uniformBlocks = 0 != (program.m_uniformBlockSize[0] | program.m_uniformBlockSize[1]);
+							bool constantsChanged = uniformBlocks || compute.m_uniformBegin < compute.m_uniformEnd;
 							rendererUpdateUniforms(this, _render->m_uniformBuffer[compute.m_uniformIdx], compute.m_uniformBegin, compute.m_uniformEnd);
 
 							if (constantsChanged
@@ -7759,6 +8809,7 @@ namespace bgfx { namespace gl
 							}
 
 							viewState.setPredefined<1>(this, view, program, _render, compute);
+							commitUniformBlocks(program, uniformBlocks);
 
 							if (isValid(compute.m_indirectBuffer) )
 							{
@@ -7806,6 +8857,9 @@ namespace bgfx { namespace gl
 				{
 					wasCompute = false;
 
+					// Compute changed current program, and uniform block data.
+					currentProgram = BGFX_INVALID_HANDLE;
+
 					setViewType(view, " ");
 					BGFX_GL_PROFILER_END();
 					BGFX_GL_PROFILER_BEGIN(view, kColorDraw);
@@ -8190,7 +9244,21 @@ namespace bgfx { namespace gl
 				if (key.m_program.idx != currentProgram.idx)
 				{
 					currentProgram = key.m_program;
-					GLuint id = isValid(currentProgram) ? m_program[currentProgram.idx].m_id : 0;
+					GLuint id = 0;
+
+					if (isValid(currentProgram) )
+					{
+						ProgramGL& program = m_program[currentProgram.idx];
+						if (program.isReady() )
+						{
+							id = program.m_id;
+						}
+						else
+						{
+							// Program is still linking, draw is skipped until it's done.
+							numDrawSkipped += 0 != program.m_id;
+						}
+					}
 
 					// Skip rendering if program index is valid, but program is invalid.
 					currentProgram = 0 == id ? ProgramHandle{kInvalidHandle} : currentProgram;
@@ -8212,6 +9280,7 @@ namespace bgfx { namespace gl
 					}
 
 					viewState.setPredefined<1>(this, view, program, _render, draw);
+					commitUniformBlocks(program, programChanged);
 
 					{
 						GLbitfield barrier = 0;
@@ -8308,6 +9377,64 @@ namespace bgfx { namespace gl
 							bindAttribs = true;
 						}
 
+						if (vertexArrayCache
+						&&  bindAttribs
+						&&  0 != currentState.m_streamMask)
+						{
+							VertexArrayCacheGL::Key key;
+							bx::memSet(&key, 0, sizeof(key) );
+							bx::memCopy(key.m_attributes, program.m_attributes, sizeof(key.m_attributes) );
+
+							for (uint32_t ii = 0; -1 != program.m_instanceData[ii]; ++ii)
+							{
+								key.m_instanceData[ii]   = program.m_instanceData[ii];
+								key.m_instanceOffset[ii] = program.m_instanceOffset[ii];
+							}
+
+							key.m_streamMask = draw.m_streamMask;
+
+							if (UINT8_MAX != draw.m_streamMask)
+							{
+								for (BitMaskToIndexIteratorT it(draw.m_streamMask); !it.isDone(); it.next() )
+								{
+									const uint8_t idx = it.idx;
+
+									const VertexBufferGL& vb = m_vertexBuffers[draw.m_stream[idx].m_handle.idx];
+									const uint16_t decl = isValid(draw.m_stream[idx].m_layoutHandle)
+										? draw.m_stream[idx].m_layoutHandle.idx
+										: vb.m_layoutHandle.idx;
+									key.m_layoutHash[key.m_num]  = m_vertexLayouts[decl].m_hash;
+									key.m_startVertex[key.m_num] = draw.m_stream[idx].m_startVertex;
+									key.m_buffer[key.m_num++]    = vb.m_id;
+								}
+							}
+
+							if (isValid(draw.m_instanceDataBuffer) )
+							{
+								key.m_instanceDataStride  = draw.m_instanceDataStride;
+								key.m_instanceDataOffset  = draw.m_instanceDataOffset;
+								key.m_buffer[key.m_num++] = m_vertexBuffers[draw.m_instanceDataBuffer.idx].m_id;
+							}
+
+							const uint32_t hash = bx::hash<bx::HashMurmur2A>(&key, sizeof(key) );
+
+							GLuint vao = m_vertexArrayCache.find(hash, key);
+							if (0 == vao)
+							{
+								// Attributes are specified below into new vertex array object.
+								vao = m_vertexArrayCache.add(hash, key);
+							}
+							else
+							{
+								bindAttribs = false;
+							}
+
+							GL_CHECK(glBindVertexArray(vao) );
+
+							// Index buffer binding is part of vertex array object state.
+							currentState.m_indexBuffer = BGFX_INVALID_HANDLE;
+						}
+
 						if (currentState.m_indexBuffer.idx != draw.m_indexBuffer.idx)
 						{
 							currentState.m_indexBuffer = draw.m_indexBuffer;
@@ -8338,7 +9465,9 @@ namespace bgfx { namespace gl
 									m_program[boundProgram.idx].unbindInstanceData();
 								}
 
-								boundProgram = currentProgram;
+								// Attributes bound into cached vertex array object are never
+								// unbound.
+								boundProgram = vertexArrayCache ? ProgramHandle{kInvalidHandle} : currentProgram;
 
 								program.bindAttributesBegin();
 
@@ -8567,6 +9696,11 @@ namespace bgfx { namespace gl
 				boundProgram = BGFX_INVALID_HANDLE;
 			}
 
+			if (vertexArrayCache)
+			{
+				GL_CHECK(glBindVertexArray(m_vao) );
+			}
+
 			if (wasCompute)
 			{
 				setViewType(view, "C");
@@ -8601,7 +9735,37 @@ namespace bgfx { namespace gl
 
 		BGFX_GL_PROFILER_END();
 
+		if (0 < _render->m_iboffset)
+		{
+			BufferRingGL* ring = m_indexBuffers[_render->m_transientIb->handle.idx].m_ring;
+
+			if (NULL != ring)
+			{
+				ring->fence();
+			}
+		}
+
+		if (0 < _render->m_vboffset)
+		{
+			BufferRingGL* ring = m_vertexBuffers[_render->m_transientVb->handle.idx].m_ring;
+
+			if (NULL != ring)
+			{
+				ring->fence();
+			}
+		}
+
+		if (m_textureUploadSupport)
+		{
+			m_textureUploadRing.frame();
+		}
+
 		m_glctx.makeCurrent(NULL);
+
+		// Deliver read backs whose fence is signaled, and wait for those that
+		// must be delivered by this frame.
+		processReadbacks(false);
+
 		int64_t timeEnd = bx::getHPCounter();
 		int64_t frameTime = timeEnd - timeBegin;
 
@@ -8644,6 +9808,15 @@ namespace bgfx { namespace gl
 		bx::memCopy(perfStats.numPrims, statsNumPrimsRendered, sizeof(perfStats.numPrims) );
 		perfStats.gpuMemoryMax  = -INT64_MAX;
 		perfStats.gpuMemoryUsed = -INT64_MAX;
+		perfStats.numPipelinesCompiled = m_numProgramsLinked;
+		perfStats.numPipelinesPending  = m_numProgramsPending;
+		perfStats.numDrawSkipped       = numDrawSkipped;
+		perfStats.uploadSize           = m_textureUploadRing.m_uploadSize;
+		perfStats.uploadWaitTime       = m_textureUploadRing.m_waitTime;
+
+		m_numProgramsLinked = 0;
+		m_textureUploadRing.m_uploadSize = 0;
+		m_textureUploadRing.m_waitTime   = 0;
 
 		if (_render->m_debug & (BGFX_DEBUG_IFH|BGFX_DEBUG_STATS) )
 		{
@@ -39,6 +39,43 @@
 #	define BGFX_GL_CONFIG_TEXTURE_READ_BACK_EMULATION 0
 #endif // BGFX_GL_CONFIG_TEXTURE_READ_BACK_EMULATION
 
+// Back transient buffers with persistently mapped ring buffers when
+// ARB_buffer_storage is available.
+#ifndef BGFX_GL_CONFIG_PERSISTENT_BUFFER_RING
+#	define BGFX_GL_CONFIG_PERSISTENT_BUFFER_RING 1
+#endif // BGFX_GL_CONFIG_PERSISTENT_BUFFER_RING
+
+// Maximum number of cached vertex array objects. Least recently used vertex
+// array object is evicted when cache is full.
+#ifndef BGFX_GL_CONFIG_MAX_VERTEX_ARRAYS
+#	define BGFX_GL_CONFIG_MAX_VERTEX_ARRAYS 256
+#endif // BGFX_GL_CONFIG_MAX_VERTEX_ARRAYS
+
+// Size of streamed uniform buffer used by shaders compiled with uniform
+// blocks (shaderc --uniform-blocks).
+#ifndef BGFX_GL_CONFIG_UNIFORM_BUFFER_SIZE
+#	define BGFX_GL_CONFIG_UNIFORM_BUFFER_SIZE (1<<20)
+#endif // BGFX_GL_CONFIG_UNIFORM_BUFFER_SIZE
+
+// Link programs without blocking when KHR_parallel_shader_compile is
+// available. Draws using program that is not linked yet are skipped.
+#ifndef BGFX_GL_CONFIG_PARALLEL_SHADER_COMPILE
+#	define BGFX_GL_CONFIG_PARALLEL_SHADER_COMPILE 1
+#endif // BGFX_GL_CONFIG_PARALLEL_SHADER_COMPILE
+
+// Read back textures, screen shots and captured frames through pixel pack
+// buffers, and deliver data once fence inserted after read is signaled.
+#ifndef BGFX_GL_CONFIG_ASYNC_READ_BACK
+#	define BGFX_GL_CONFIG_ASYNC_READ_BACK 1
+#endif // BGFX_GL_CONFIG_ASYNC_READ_BACK
+
+// Maximum number of bytes uploaded to textures per frame through persistently
+// mapped pixel unpack buffer ring. Uploads over budget are passed directly to
+// driver. Set to 0 to disable.
+#ifndef BGFX_GL_CONFIG_TEXTURE_UPLOAD_SIZE
+#	define BGFX_GL_CONFIG_TEXTURE_UPLOAD_SIZE (8<<20)
+#endif // BGFX_GL_CONFIG_TEXTURE_UPLOAD_SIZE
+
 #define BGFX_GL_PROFILER_BEGIN(_view, _abgr)                                               \
 	BX_MACRO_BLOCK_BEGIN                                                                   \
 		GL_CHECK(glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, s_viewName[view]) ); \
@@ -1121,10 +1158,78 @@ typedef uint64_t GLuint64;
 #	define GL_DISPATCH_INDIRECT_BUFFER 0x90EE
 #endif // GL_DISPATCH_INDIRECT_BUFFER
 
+#ifndef GL_MAP_READ_BIT
+#	define GL_MAP_READ_BIT 0x0001
+#endif // GL_MAP_READ_BIT
+
+#ifndef GL_MAP_WRITE_BIT
+#	define GL_MAP_WRITE_BIT 0x0002
+#endif // GL_MAP_WRITE_BIT
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#	define GL_MAP_PERSISTENT_BIT 0x0040
+#endif // GL_MAP_PERSISTENT_BIT
+
+#ifndef GL_MAP_COHERENT_BIT
+#	define GL_MAP_COHERENT_BIT 0x0080
+#endif // GL_MAP_COHERENT_BIT
+
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#	define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif // GL_SYNC_GPU_COMMANDS_COMPLETE
+
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#	define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif // GL_SYNC_FLUSH_COMMANDS_BIT
+
+#ifndef GL_TIMEOUT_EXPIRED
+#	define GL_TIMEOUT_EXPIRED 0x911B
+#endif // GL_TIMEOUT_EXPIRED
+
+#ifndef GL_PIXEL_PACK_BUFFER
+#	define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif // GL_PIXEL_PACK_BUFFER
+
+#ifndef GL_PIXEL_UNPACK_BUFFER
+#	define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#endif // GL_PIXEL_UNPACK_BUFFER
+
+#ifndef GL_STREAM_READ
+#	define GL_STREAM_READ 0x88E1
+#endif // GL_STREAM_READ
+
+#ifndef GL_UNIFORM_BUFFER
+#	define GL_UNIFORM_BUFFER 0x8A11
+#endif // GL_UNIFORM_BUFFER
+
+#ifndef GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+#	define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT 0x8A34
+#endif // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+
+#ifndef GL_UNIFORM_BLOCK_DATA_SIZE
+#	define GL_UNIFORM_BLOCK_DATA_SIZE 0x8A40
+#endif // GL_UNIFORM_BLOCK_DATA_SIZE
+
+#ifndef GL_UNIFORM_BLOCK_INDEX
+#	define GL_UNIFORM_BLOCK_INDEX 0x8A3A
+#endif // GL_UNIFORM_BLOCK_INDEX
+
+#ifndef GL_UNIFORM_OFFSET
+#	define GL_UNIFORM_OFFSET 0x8A3B
+#endif // GL_UNIFORM_OFFSET
+
+#ifndef GL_INVALID_INDEX
+#	define GL_INVALID_INDEX 0xFFFFFFFFu
+#endif // GL_INVALID_INDEX
+
 #ifndef GL_MAX_NAME_LENGTH
 #	define GL_MAX_NAME_LENGTH 0x92F6
 #endif // GL_MAX_NAME_LENGTH
 
+#ifndef GL_COMPLETION_STATUS_KHR
+#	define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif // GL_COMPLETION_STATUS_KHR
+
 #ifndef GL_DEBUG_SEVERITY_NOTIFICATION
 #	define GL_DEBUG_SEVERITY_NOTIFICATION 0x826b
 #endif // GL_DEBUG_SEVERITY_NOTIFICATION
@@ -1343,12 +1448,155 @@ namespace bgfx { namespace gl
 		HashMap m_hashMap;
 	};
 
+	// Persistently and coherently mapped buffer, split into regions that are
+	// rotated once per frame by fence(). Region is reused only after fence
+	// inserted at the end of frame that used it is signaled.
+	//
+	// Transient buffer data is still written by API thread into frame memory
+	// and copied into mapped region by update(). Ring replaces driver side
+	// buffer orphaning and glBufferSubData upload, not that copy.
+	struct BufferRingGL
+	{
+		static constexpr uint32_t kNumRegions = 3;
+
+		void create(GLenum _target, uint32_t _size);
+		void destroy();
+		GLuint update(uint32_t _offset, uint32_t _size, const void* _data);
+		void fence();
+
+		GLuint   m_id[kNumRegions];
+		uint8_t* m_data[kNumRegions];
+		GLsync   m_fence[kNumRegions];
+		GLenum   m_target;
+		uint32_t m_size;
+		uint32_t m_current;
+	};
+
+	// Persistently mapped pixel unpack buffer, split into per frame regions.
+	// Texture data is copied into region of current frame, and region is
+	// reused only after fence inserted at the end of frame that used it is
+	// signaled.
+	struct TextureUploadRingGL
+	{
+		static constexpr uint32_t kNumRegions = 3;
+		static constexpr uint32_t kAlign      = 16;
+
+		TextureUploadRingGL()
+			: m_id(0)
+			, m_uploadSize(0)
+			, m_waitTime(0)
+			, m_bound(false)
+		{
+		}
+
+		void create(uint32_t _size);
+		void destroy();
+
+		// Returns offset into ring, and leaves ring bound to
+		// GL_PIXEL_UNPACK_BUFFER target. When frame budget is exhausted
+		// returns _data.
+		const void* stage(const void* _data, uint32_t _size);
+		void unbind();
+		void frame();
+
+		GLuint   m_id;
+		uint8_t* m_data;
+		GLsync   m_fence[kNumRegions];
+		uint32_t m_size; // Region size.
+		uint32_t m_current;
+		uint32_t m_offset;
+		uint32_t m_uploadSize;
+		int64_t  m_waitTime;
+		bool     m_bound;
+	};
+
+	// Read back copied into pixel pack buffer. Buffer is mapped and data is
+	// delivered once fence inserted after copy is signaled.
+	struct ReadbackRequestGL
+	{
+		enum Enum
+		{
+			Texture,
+			ScreenShot,
+			Capture,
+
+			Count
+		};
+
+		GLuint   m_pbo;
+		GLsync   m_fence;
+		uint32_t m_size;
+		uint32_t m_width;
+		uint32_t m_height;
+		uint32_t m_deadline; // Frame number by which data must be delivered.
+		void*    m_data;
+		Enum     m_type;
+		bx::FilePath m_filePath;
+	};
+
+	// Uniform block data is appended to buffer, and buffer is orphaned when
+	// there is no more space left.
+	struct UniformBufferRingGL
+	{
+		void create(uint32_t _size, uint32_t _align);
+		void destroy();
+		uint32_t write(const void* _data, uint32_t _size);
+
+		GLuint   m_id;
+		uint32_t m_size;
+		uint32_t m_align;
+		uint32_t m_pos;
+	};
+
+	// Vertex array objects keyed by program attribute locations, vertex
+	// streams, layouts, base vertices, and instance data stream. Entries are
+	// invalidated when any of referenced buffers is destroyed.
+	struct VertexArrayCacheGL
+	{
+		// Full key is stored with each entry and compared on lookup, hash
+		// is used only to find entry. Key must be zero initialized, since it's
+		// hashed and compared as raw memory.
+		struct Key
+		{
+			GLint    m_attributes[Attrib::Count];
+			GLint    m_instanceData[BGFX_CONFIG_MAX_INSTANCE_DATA_COUNT];
+			uint16_t m_instanceOffset[BGFX_CONFIG_MAX_INSTANCE_DATA_COUNT];
+			uint32_t m_layoutHash[BGFX_CONFIG_MAX_VERTEX_STREAMS];
+			uint32_t m_startVertex[BGFX_CONFIG_MAX_VERTEX_STREAMS];
+			GLuint   m_buffer[BGFX_CONFIG_MAX_VERTEX_STREAMS+1];
+			uint32_t m_instanceDataStride;
+			uint32_t m_instanceDataOffset;
+			uint8_t  m_streamMask;
+			uint8_t  m_num;
+		};
+
+		GLuint find(uint32_t _hash, const Key& _key);
+		GLuint add(uint32_t _hash, const Key& _key);
+		void invalidate(GLuint _buffer);
+		void invalidate();
+
+		struct Data
+		{
+			uint32_t m_hash;
+			GLuint   m_id;
+			Key      m_key;
+		};
+
+		void remove(uint16_t _handle);
+
+		typedef FlatHashMapT<uint32_t, uint16_t> HashMap;
+		HashMap m_hashMap;
+		bx::HandleAllocLruT<BGFX_GL_CONFIG_MAX_VERTEX_ARRAYS> m_alloc;
+		Data m_data[BGFX_GL_CONFIG_MAX_VERTEX_ARRAYS];
+	};
+
 	struct IndexBufferGL
 	{
 		void create(uint32_t _size, void* _data, uint16_t _flags)
 		{
 			m_size  = _size;
 			m_flags = _flags;
+			m_ring  = NULL;
 
 			GL_CHECK(glGenBuffers(1, &m_id) );
 			BX_ASSERT(0 != m_id, "Failed to generate buffer id.");
@@ -1365,6 +1613,12 @@ namespace bgfx { namespace gl
 		{
 			BX_ASSERT(0 != m_id, "Updating invalid index buffer.");
 
+			if (NULL != m_ring)
+			{
+				m_id = m_ring->update(_offset, _size, _data);
+				return;
+			}
+
 			if (_discard)
 			{
 				// orphan buffer...
@@ -1381,11 +1635,13 @@ namespace bgfx { namespace gl
 			GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
 		}
 
+		void createRing();
 		void destroy();
 
 		GLuint m_id;
 		uint32_t m_size;
 		uint16_t m_flags;
+		BufferRingGL* m_ring;
 	};
 
 	struct VertexBufferGL
@@ -1394,6 +1650,7 @@ namespace bgfx { namespace gl
 		{
 			m_size = _size;
 			m_layoutHandle = _layoutHandle;
+			m_ring = NULL;
 			const bool drawIndirect = 0 != (_flags & BGFX_BUFFER_DRAW_INDIRECT);
 
 			m_target = drawIndirect ? GL_DRAW_INDIRECT_BUFFER : GL_ARRAY_BUFFER;
@@ -1413,6 +1670,12 @@ namespace bgfx { namespace gl
 		{
 			BX_ASSERT(0 != m_id, "Updating invalid vertex buffer.");
 
+			if (NULL != m_ring)
+			{
+				m_id = m_ring->update(_offset, _size, _data);
+				return;
+			}
+
 			if (_discard)
 			{
 				// orphan buffer...
@@ -1429,12 +1692,14 @@ namespace bgfx { namespace gl
 			GL_CHECK(glBindBuffer(m_target, 0) );
 		}
 
+		void createRing();
 		void destroy();
 
 		GLuint m_id;
 		GLenum m_target;
 		uint32_t m_size;
 		VertexLayoutHandle m_layoutHandle;
+		BufferRingGL* m_ring;
 	};
 
 	struct TextureGL
@@ -1534,6 +1799,7 @@ namespace bgfx { namespace gl
 	{
 		ProgramGL()
 			: m_id(0)
+			, m_pending(false)
 			, m_constantBuffer(NULL)
 			, m_numPredefined(0)
 		{
@@ -1544,6 +1810,11 @@ namespace bgfx { namespace gl
 		void destroy();
 		void init();
 
+		// Returns true when program is linked. While link is pending it polls
+		// GL_COMPLETION_STATUS_KHR, unless _wait is true, and finishes linking
+		// once driver is done.
+		bool isReady(bool _wait = false);
+
 		void bindAttributesBegin();
 		void bindAttributes(const VertexLayout& _layout, uint32_t _baseVertex = 0);
 		void bindInstanceData(uint32_t _stride, uint32_t _baseVertex = 0) const;
@@ -1552,6 +1823,10 @@ namespace bgfx { namespace gl
 		void unbindAttributes();
 
 		GLuint m_id;
+		GLuint m_vsh; // Shaders attached to program while link is pending.
+		GLuint m_fsh;
+		uint64_t m_hash;
+		bool m_pending;
 
 		uint8_t m_unboundUsedAttrib[Attrib::Count]; // For tracking unbound used attributes between begin()/end().
 		uint8_t m_usedCount;
@@ -1561,6 +1836,8 @@ namespace bgfx { namespace gl
 		GLint    m_instanceData[BGFX_CONFIG_MAX_INSTANCE_DATA_COUNT+1];
 		uint16_t m_instanceOffset[BGFX_CONFIG_MAX_INSTANCE_DATA_COUNT];
 
+		uint32_t m_uniformBlockSize[2]; // Vertex (or compute), and fragment uniform block size.
+
 		GLint m_sampler[BGFX_CONFIG_MAX_TEXTURE_SAMPLERS];
 		uint8_t m_numSamplers;
 
@@ -1165,15 +1165,15 @@ namespace bgfx { namespace mtl
 		void add(uint64_t _id, Ty _item)
 		{
 			invalidate(_id);
-			m_hashMap.insert(stl::make_pair(_id, _item) );
+			m_hashMap.insert(_id, _item);
 		}
 
 		Ty find(uint64_t _id)
 		{
-			typename HashMap::iterator it = m_hashMap.find(_id);
-			if (it != m_hashMap.end() )
+			Ty* it = m_hashMap.find(_id);
+			if (NULL != it)
 			{
-				return it->second;
+				return *it;
 			}
 
 			return NULL;
@@ -1181,31 +1181,36 @@ namespace bgfx { namespace mtl
 
 		void invalidate(uint64_t _id)
 		{
-			typename HashMap::iterator it = m_hashMap.find(_id);
-			if (it != m_hashMap.end() )
+			Ty* it = m_hashMap.find(_id);
+			if (NULL != it)
 			{
-				release(it->second);
-				m_hashMap.erase(it);
+				release(*it);
+				m_hashMap.removeByKey(_id);
 			}
 		}
 
 		void invalidate()
 		{
-			for (typename HashMap::iterator it = m_hashMap.begin(), itEnd = m_hashMap.end(); it != itEnd; ++it)
+			for (uint32_t ii = 0, capacity = m_hashMap.getCapacity(); ii < capacity; ++ii)
 			{
-				release(it->second);
+				if (!m_hashMap.isValid(ii) )
+				{
+					continue;
+				}
+
+				release(m_hashMap.getValueAt(ii) );
 			}
 
-			m_hashMap.clear();
+			m_hashMap.reset();
 		}
 
 		uint32_t getCount() const
 		{
-			return uint32_t(m_hashMap.size() );
+			return m_hashMap.getNumElements();
 		}
 
 	private:
-		typedef stl::unordered_map<uint64_t, Ty> HashMap;
+		typedef FlatHashMapT<uint64_t, Ty> HashMap;
 		HashMap m_hashMap;
 	};
 
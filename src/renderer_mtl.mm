@@ -1076,6 +1076,14 @@ static_assert(BX_COUNTOF(s_accessNames) == Access::Count, "Invalid s_accessNames
 			m_program[_handle.idx].destroy();
 		}
 
+		void precachePipeline(ProgramHandle /*_program*/, uint64_t /*_state*/, VertexLayoutHandle /*_layoutHandle*/, FrameBufferHandle /*_frameBuffer*/, uint8_t /*_numInstanceData*/) override
+		{
+		}
+
+		void savePipelineCache() override
+		{
+		}
+
 		void* createTexture(TextureHandle _handle, const Memory* _mem, uint64_t _flags, uint8_t _skip) override
 		{
 			m_textures[_handle.idx].create(_mem, _flags, _skip);
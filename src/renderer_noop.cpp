@@ -164,6 +164,14 @@ namespace bgfx { namespace noop
 		{
 		}
 
+		void precachePipeline(ProgramHandle /*_program*/, uint64_t /*_state*/, VertexLayoutHandle /*_layoutHandle*/, FrameBufferHandle /*_frameBuffer*/, uint8_t /*_numInstanceData*/) override
+		{
+		}
+
+		void savePipelineCache() override
+		{
+		}
+
 		void* createTexture(TextureHandle /*_handle*/, const Memory* /*_mem*/, uint64_t /*_flags*/, uint8_t /*_skip*/) override
 		{
 			return NULL;
@@ -142,6 +142,35 @@ namespace bgfx { namespace vk
 		VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER,
 	};
 
+	static const VkDynamicState s_dynamicStates[] =
+	{
+		VK_DYNAMIC_STATE_VIEWPORT,
+		VK_DYNAMIC_STATE_SCISSOR,
+		VK_DYNAMIC_STATE_BLEND_CONSTANTS,
+		VK_DYNAMIC_STATE_STENCIL_REFERENCE,
+	};
+
+	static const VkDynamicState s_extendedDynamicStates[] =
+	{
+		VK_DYNAMIC_STATE_CULL_MODE_EXT,
+		VK_DYNAMIC_STATE_FRONT_FACE_EXT,
+		VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT,
+		VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT,
+		VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT,
+		VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT,
+		VK_DYNAMIC_STATE_STENCIL_TEST_ENABLE_EXT,
+		VK_DYNAMIC_STATE_STENCIL_OP_EXT,
+	};
+
+	// State set dynamically when VK_EXT_extended_dynamic_state is supported.
+	static constexpr uint64_t kExtendedDynamicStateMask = 0
+		| BGFX_STATE_CULL_MASK
+		| BGFX_STATE_FRONT_CCW
+		| BGFX_STATE_DEPTH_TEST_MASK
+		| BGFX_STATE_WRITE_Z
+		| BGFX_STATE_PT_MASK
+		;
+
 	struct PresentMode
 	{
 		VkPresentModeKHR mode;
@@ -378,6 +407,7 @@ VK_IMPORT_DEVICE
 			EXT_custom_border_color,
 			EXT_debug_report,
 			EXT_debug_utils,
+			EXT_extended_dynamic_state,
 			EXT_line_rasterization,
 			EXT_memory_budget,
 			EXT_shader_viewport_index_layer,
@@ -418,6 +448,7 @@ VK_IMPORT_DEVICE
 		{ "VK_EXT_custom_border_color",             1, false, false, true,                                                          Layer::Count },
 		{ "VK_EXT_debug_report",                    1, false, false, false,                                                         Layer::Count },
 		{ "VK_EXT_debug_utils",                     1, false, false, BGFX_CONFIG_DEBUG_OBJECT_NAME || BGFX_CONFIG_DEBUG_ANNOTATION, Layer::Count },
+		{ "VK_EXT_extended_dynamic_state",          1, false, false, true,                                                          Layer::Count },
 		{ "VK_EXT_line_rasterization",              1, false, false, true,                                                          Layer::Count },
 		{ "VK_EXT_memory_budget",                   1, false, false, true,                                                          Layer::Count },
 		{ "VK_EXT_shader_viewport_index_layer",     1, false, false, true,                                                          Layer::Count },
@@ -1161,21 +1192,41 @@ VK_IMPORT_DEVICE
 
 #define MAX_DESCRIPTOR_SETS (BGFX_CONFIG_RENDERER_VULKAN_MAX_DESCRIPTOR_SETS_PER_FRAME * BGFX_CONFIG_MAX_FRAME_LATENCY)
 
+	// Set on record threads, they can't validate state owned by render thread.
+	static BX_THREAD_LOCAL bool s_recordThread(false);
+
 	struct RendererContextVK : public RendererContextI
 	{
 		RendererContextVK()
 			: m_allocatorCb(NULL)
 			, m_memoryLru()
+			, m_dedicatedMemorySize(0)
 			, m_renderDocDll(NULL)
 			, m_vulkan1Dll(NULL)
+			, m_numDescriptorSetsReused(0)
+			, m_numDescriptorSetsCreated(0)
+			, m_blitLayouts(NULL)
+			, m_maxBlitLayouts(0)
 			, m_maxAnisotropy(1.0f)
 			, m_depthClamp(false)
 			, m_wireframe(false)
-			, m_captureBuffer(VK_NULL_HANDLE)
-			, m_captureMemory()
 			, m_captureSize(0)
+			, m_readbackFrame(0)
 			, m_variableRateShadingSupported(false)
+			, m_extendedDynamicStateSupport(false)
+			, m_numDynamicStates(0)
+			, m_asyncPipelineCompile(false)
+			, m_singlePipelineCache(false)
+			, m_pipelineCacheDirty(false)
+			, m_pipelineCacheId(0)
+			, m_numPipelinesCompiled(0)
+			, m_pipelineCompileTime(0)
+			, m_maxUniformSize(0)
 		{
+			for (uint32_t ii = 0; ii < BX_COUNTOF(m_captureBuffer); ++ii)
+			{
+				m_captureBuffer[ii] = VK_NULL_HANDLE;
+			}
 		}
 
 		~RendererContextVK()
@@ -1208,14 +1259,17 @@ VK_IMPORT_DEVICE
 			VkPhysicalDeviceLineRasterizationFeaturesEXT lineRasterizationFeatures = {};
 			VkPhysicalDeviceCustomBorderColorFeaturesEXT customBorderColorFeatures = {};
 			VkPhysicalDeviceFragmentShadingRateFeaturesKHR fragmentShadingRate = {};
+			VkPhysicalDeviceExtendedDynamicStateFeaturesEXT extendedDynamicStateFeatures = {};
 
 			m_fbh = BGFX_INVALID_HANDLE;
 			bx::memSet(m_uniforms, 0, sizeof(m_uniforms) );
+			bx::memSet(m_uniformSize, 0, sizeof(m_uniformSize) );
 			bx::memSet(&m_resolution, 0, sizeof(m_resolution) );
 
 			bool imported = true;
 			VkResult result;
-			m_globalQueueFamily = UINT32_MAX;
+			m_globalQueueFamily   = UINT32_MAX;
+			m_transferQueueFamily = UINT32_MAX;
 
 			if (_init.debug
 			||  _init.profile)
@@ -1620,6 +1674,14 @@ VK_IMPORT_INSTANCE
 						customBorderColorFeatures.pNext = NULL;
 					}
 
+					if (s_extension[Extension::EXT_extended_dynamic_state].m_supported)
+					{
+						next->pNext = (VkBaseOutStructure*)&extendedDynamicStateFeatures;
+						next = (VkBaseOutStructure*)&extendedDynamicStateFeatures;
+						extendedDynamicStateFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+						extendedDynamicStateFeatures.pNext = NULL;
+					}
+
 					nextFeatures = deviceFeatures2.pNext;
 
 					vkGetPhysicalDeviceFeatures2KHR(m_physicalDevice, &deviceFeatures2);
@@ -1673,6 +1735,11 @@ VK_IMPORT_INSTANCE
 					&& customBorderColorFeatures.customBorderColors
 					;
 
+				m_extendedDynamicStateSupport = true
+					&& s_extension[Extension::EXT_extended_dynamic_state].m_supported
+					&& extendedDynamicStateFeatures.extendedDynamicState
+					;
+
 				m_timerQuerySupport = m_deviceProperties.properties.limits.timestampComputeAndGraphics;
 
 				const bool indirectDrawSupport = true
@@ -1712,6 +1779,26 @@ VK_IMPORT_INSTANCE
 
 				m_variableRateShadingSupported = s_extension[Extension::KHR_fragment_shading_rate].m_supported;
 
+				m_numDynamicStates = 0;
+
+				for (uint32_t ii = 0; ii < BX_COUNTOF(s_dynamicStates); ++ii)
+				{
+					m_dynamicStates[m_numDynamicStates++] = s_dynamicStates[ii];
+				}
+
+				if (m_extendedDynamicStateSupport)
+				{
+					for (uint32_t ii = 0; ii < BX_COUNTOF(s_extendedDynamicStates); ++ii)
+					{
+						m_dynamicStates[m_numDynamicStates++] = s_extendedDynamicStates[ii];
+					}
+				}
+
+				if (m_variableRateShadingSupported)
+				{
+					m_dynamicStates[m_numDynamicStates++] = VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR;
+				}
+
 				const uint32_t maxAttachments = bx::min<uint32_t>(
 					  m_deviceProperties.properties.limits.maxFragmentOutputAttachments
 					, m_deviceProperties.properties.limits.maxColorAttachments
@@ -1816,6 +1903,11 @@ VK_IMPORT_INSTANCE
 				}
 
 				vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &m_memoryProperties);
+
+				m_memoryAllocator.init(
+					  m_memoryProperties
+					, uint32_t(m_deviceProperties.properties.limits.bufferImageGranularity)
+					);
 			}
 
 			{
@@ -1856,6 +1948,23 @@ VK_IMPORT_INSTANCE
 					{
 						m_globalQueueFamily = ii;
 					}
+
+					// Transfer only queue family is usually backed by dedicated
+					// copy engine, which can upload while graphics queue renders.
+					const bool transferOnly = true
+						&& 0 != (qfp.queueFlags & VK_QUEUE_TRANSFER_BIT)
+						&& 0 == (qfp.queueFlags & requiredFlags)
+						&& 1 == qfp.minImageTransferGranularity.width
+						&& 1 == qfp.minImageTransferGranularity.height
+						&& 1 == qfp.minImageTransferGranularity.depth
+						;
+
+					if (BX_ENABLED(BGFX_CONFIG_RENDERER_VULKAN_TRANSFER_QUEUE)
+					&&  UINT32_MAX == m_transferQueueFamily
+					&&  transferOnly)
+					{
+						m_transferQueueFamily = ii;
+					}
 				}
 
 				bx::free(g_allocator, queueFamilyPropertices);
@@ -1865,6 +1974,15 @@ VK_IMPORT_INSTANCE
 					BX_TRACE("Init error: Unable to find combined graphics and compute queue.");
 					goto error;
 				}
+
+				if (UINT32_MAX != m_transferQueueFamily)
+				{
+					BX_TRACE("Using queue family %d for uploads.", m_transferQueueFamily);
+				}
+				else
+				{
+					BX_TRACE("Transfer only queue family not found, uploading on graphics queue.");
+				}
 			}
 
 			{
@@ -1925,20 +2043,29 @@ VK_IMPORT_INSTANCE
 				}
 
 				float queuePriorities[1] = { 0.0f };
-				VkDeviceQueueCreateInfo dcqi;
-				dcqi.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-				dcqi.pNext = NULL;
-				dcqi.flags = 0;
-				dcqi.queueFamilyIndex = m_globalQueueFamily;
-				dcqi.queueCount       = 1;
-				dcqi.pQueuePriorities = queuePriorities;
+				VkDeviceQueueCreateInfo dcqi[2];
+				dcqi[0].sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+				dcqi[0].pNext = NULL;
+				dcqi[0].flags = 0;
+				dcqi[0].queueFamilyIndex = m_globalQueueFamily;
+				dcqi[0].queueCount       = 1;
+				dcqi[0].pQueuePriorities = queuePriorities;
+
+				uint32_t numQueueCreateInfos = 1;
+
+				if (UINT32_MAX != m_transferQueueFamily)
+				{
+					dcqi[1] = dcqi[0];
+					dcqi[1].queueFamilyIndex = m_transferQueueFamily;
+					numQueueCreateInfos = 2;
+				}
 
 				VkDeviceCreateInfo dci;
 				dci.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
 				dci.pNext = nextFeatures;
 				dci.flags = 0;
-				dci.queueCreateInfoCount = 1;
-				dci.pQueueCreateInfos    = &dcqi;
+				dci.queueCreateInfoCount = numQueueCreateInfos;
+				dci.pQueueCreateInfos    = dcqi;
 				dci.enabledLayerCount    = numEnabledLayers;
 				dci.ppEnabledLayerNames  = enabledLayer;
 				dci.enabledExtensionCount   = numEnabledExtensions;
@@ -1998,6 +2125,20 @@ VK_IMPORT_DEVICE
 					BX_TRACE("Init error: allocating command buffer failed %d: %s.", result, getName(result) );
 					goto error;
 				}
+
+				if (UINT32_MAX != m_transferQueueFamily)
+				{
+					VkQueue transferQueue;
+					vkGetDeviceQueue(m_device, m_transferQueueFamily, 0, &transferQueue);
+
+					result = m_upload.init(m_transferQueueFamily, transferQueue);
+
+					if (VK_SUCCESS != result)
+					{
+						BX_TRACE("Init error: creating upload queue failed %d: %s.", result, getName(result) );
+						goto error;
+					}
+				}
 			}
 
 			errorState = ErrorState::CommandQueueCreated;
@@ -2072,14 +2213,89 @@ VK_IMPORT_DEVICE
 					}
 				}
 
+				// Cached descriptor sets are freed individually once evicted, but
+				// only after frames in flight are done with them, so pool has room
+				// for twice the cache size. Pool is sized for 4 textures per set on
+				// average, once exhausted descriptor sets come from per frame pool.
+				const uint32_t maxCachedSets = BGFX_CONFIG_RENDERER_VULKAN_MAX_CACHED_DESCRIPTOR_SETS * 2;
+
+				VkDescriptorPoolSize cacheDps[] =
+				{
+					{ VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,          maxCachedSets * 4 },
+					{ VK_DESCRIPTOR_TYPE_SAMPLER,                maxCachedSets * 4 },
+					{ VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, maxCachedSets * 2 },
+					{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,         maxCachedSets * 4 },
+					{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          maxCachedSets * 4 },
+				};
+
+				dpci.maxSets       = maxCachedSets;
+				dpci.poolSizeCount = BX_COUNTOF(cacheDps);
+				dpci.pPoolSizes    = cacheDps;
+
+				result = vkCreateDescriptorPool(m_device, &dpci, m_allocatorCb, &m_descriptorSetCachePool);
+
+				if (VK_SUCCESS != result)
+				{
+					BX_TRACE("Init error: vkCreateDescriptorPool failed %d: %s.", result, getName(result) );
+					goto error;
+				}
+
+				m_singlePipelineCache = _init.singlePipelineCache;
+				m_pipelineCacheDirty  = false;
+
+				void*    cacheData = NULL;
+				uint32_t cacheSize = 0;
+
+				if (m_singlePipelineCache)
+				{
+					// Pipeline cache blob is only usable with the same device and
+					// driver, key it by both so that driver update doesn't pick
+					// up stale blob.
+					const VkPhysicalDeviceProperties& pdp = m_deviceProperties.properties;
+
+					bx::HashMurmur2A hash;
+					hash.begin();
+					hash.add(pdp.vendorID);
+					hash.add(pdp.deviceID);
+					hash.add(pdp.driverVersion);
+					hash.add(pdp.pipelineCacheUUID, VK_UUID_SIZE);
+					m_pipelineCacheId = (uint64_t(BX_MAKEFOURCC('V', 'K', 'P', 'C') ) << 32) | hash.end();
+
+					const uint32_t length = g_callback->cacheReadSize(m_pipelineCacheId);
+
+					if (0 < length)
+					{
+						cacheData = bx::alloc(g_allocator, length);
+						if (g_callback->cacheRead(m_pipelineCacheId, cacheData, length) )
+						{
+							BX_TRACE("Loading pipeline cache blob (size %d).", length);
+							cacheSize = length;
+						}
+					}
+				}
+
 				VkPipelineCacheCreateInfo pcci;
 				pcci.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
 				pcci.pNext = NULL;
 				pcci.flags = 0;
-				pcci.initialDataSize = 0;
-				pcci.pInitialData    = NULL;
+				pcci.initialDataSize = cacheSize;
+				pcci.pInitialData    = cacheData;
 				result = vkCreatePipelineCache(m_device, &pcci, m_allocatorCb, &m_pipelineCache);
 
+				if (VK_SUCCESS != result
+				&&  0 < cacheSize)
+				{
+					BX_TRACE("Init: Pipeline cache blob rejected %d: %s, starting with empty cache.", result, getName(result) );
+					pcci.initialDataSize = 0;
+					pcci.pInitialData    = NULL;
+					result = vkCreatePipelineCache(m_device, &pcci, m_allocatorCb, &m_pipelineCache);
+				}
+
+				if (NULL != cacheData)
+				{
+					bx::free(g_allocator, cacheData);
+				}
+
 				if (VK_SUCCESS != result)
 				{
 					BX_TRACE("Init error: vkCreatePipelineCache failed %d: %s.", result, getName(result) );
@@ -2143,6 +2359,18 @@ VK_IMPORT_DEVICE
 				goto error;
 			}
 
+			m_pipelineCompiler.init(_init.limits.maxPipelineThreads);
+			m_asyncPipelineCompile = _init.asyncPipelineCompile;
+
+			{
+				const VkResult recordResult = m_recorder.init(_init.limits.maxRecordThreads);
+
+				if (VK_SUCCESS != recordResult)
+				{
+					BX_TRACE("Init warning: creating record threads failed %d: %s, recording on render thread.", recordResult, getName(recordResult) );
+				}
+			}
+
 			g_internalData.context = m_device;
 			return true;
 
@@ -2165,6 +2393,7 @@ VK_IMPORT_DEVICE
 					m_scratchStagingBuffer[ii].destroy();
 					vkDestroy(m_descriptorPool[ii]);
 				}
+				vkDestroy(m_descriptorSetCachePool);
 				vkDestroy(m_pipelineCache);
 				[[fallthrough]];
 
@@ -2174,9 +2403,11 @@ VK_IMPORT_DEVICE
 
 			case ErrorState::CommandQueueCreated:
 				m_cmd.shutdown();
+				m_upload.shutdown();
 				[[fallthrough]];
 
 			case ErrorState::DeviceCreated:
+				m_memoryAllocator.shutdown();
 				vkDestroyDevice(m_device, m_allocatorCb);
 				[[fallthrough]];
 
@@ -2205,8 +2436,18 @@ VK_IMPORT_DEVICE
 
 		void shutdown()
 		{
+			finishPipelines(true);
+			m_pipelineCompiler.shutdown();
+			savePipelineCache();
+
 			VK_CHECK(vkDeviceWaitIdle(m_device) );
 
+			m_recorder.shutdown();
+
+			bx::free(g_allocator, m_blitLayouts);
+			m_blitLayouts    = NULL;
+			m_maxBlitLayouts = 0;
+
 			if (m_timerQuerySupport)
 			{
 				m_gpuTimer.shutdown();
@@ -2221,6 +2462,7 @@ VK_IMPORT_DEVICE
 			m_samplerCache.invalidate();
 			m_samplerBorderColorCache.invalidate();
 			m_imageViewCache.invalidate();
+			m_descriptorSetCache.invalidate();
 
 			m_uniformScratchBuffer.destroy();
 
@@ -2259,6 +2501,9 @@ VK_IMPORT_DEVICE
 			m_memoryLru.evictAll();
 
 			m_cmd.shutdown();
+			m_upload.shutdown();
+
+			m_memoryAllocator.shutdown();
 
 			vkDestroy(m_pipelineCache);
 
@@ -2267,6 +2512,8 @@ VK_IMPORT_DEVICE
 				vkDestroy(m_descriptorPool[ii]);
 			}
 
+			vkDestroy(m_descriptorSetCachePool);
+
 			vkDestroyDevice(m_device, m_allocatorCb);
 
 			if (VK_NULL_HANDLE != m_debugReportCallback)
@@ -2299,6 +2546,14 @@ VK_IMPORT_DEVICE
 
 		void flip() override
 		{
+			// Submit readback copies recorded after frame was submitted, so GPU
+			// can work on them while next frame is recorded.
+			if (!m_readbacks.empty()
+			&&  m_readbacks.back().m_submitted == m_cmd.m_submitted)
+			{
+				kick();
+			}
+
 			int64_t start = bx::getHPCounter();
 
 			for (uint16_t ii = 0; ii < m_numWindows; ++ii)
@@ -2323,6 +2578,7 @@ VK_IMPORT_DEVICE
 
 		void destroyIndexBuffer(IndexBufferHandle _handle) override
 		{
+			m_descriptorSetCache.invalidate(DescriptorSetCacheVK::makeResource(Binding::IndexBuffer, _handle.idx) );
 			m_indexBuffers[_handle.idx].destroy();
 		}
 
@@ -2344,6 +2600,7 @@ VK_IMPORT_DEVICE
 
 		void destroyVertexBuffer(VertexBufferHandle _handle) override
 		{
+			m_descriptorSetCache.invalidate(DescriptorSetCacheVK::makeResource(Binding::VertexBuffer, _handle.idx) );
 			m_vertexBuffers[_handle.idx].destroy();
 		}
 
@@ -2359,6 +2616,7 @@ VK_IMPORT_DEVICE
 
 		void destroyDynamicIndexBuffer(IndexBufferHandle _handle) override
 		{
+			m_descriptorSetCache.invalidate(DescriptorSetCacheVK::makeResource(Binding::IndexBuffer, _handle.idx) );
 			m_indexBuffers[_handle.idx].destroy();
 		}
 
@@ -2375,16 +2633,24 @@ VK_IMPORT_DEVICE
 
 		void destroyDynamicVertexBuffer(VertexBufferHandle _handle) override
 		{
+			m_descriptorSetCache.invalidate(DescriptorSetCacheVK::makeResource(Binding::VertexBuffer, _handle.idx) );
 			m_vertexBuffers[_handle.idx].destroy();
 		}
 
 		void createShader(ShaderHandle _handle, const Memory* _mem) override
 		{
-			m_shaders[_handle.idx].create(_mem);
+			ShaderVK& shader = m_shaders[_handle.idx];
+			shader.create(_mem);
+
+			// Uniform block size before it was moved into push constant range.
+			const uint32_t uniformSize = shader.m_size + shader.m_pushConstantRange.offset + shader.m_pushConstantRange.size;
+			m_maxUniformSize = bx::max(m_maxUniformSize, uniformSize);
 		}
 
 		void destroyShader(ShaderHandle _handle) override
 		{
+			// Background pipeline compilation might still reference shader.
+			finishPipelines(NULL, &m_shaders[_handle.idx]);
 			m_shaders[_handle.idx].destroy();
 		}
 
@@ -2395,9 +2661,36 @@ VK_IMPORT_DEVICE
 
 		void destroyProgram(ProgramHandle _handle) override
 		{
+			finishPipelines(&m_program[_handle.idx], NULL);
 			m_program[_handle.idx].destroy();
 		}
 
+		void savePipelineCache() override
+		{
+			if (!m_singlePipelineCache
+			||  !m_pipelineCacheDirty)
+			{
+				return;
+			}
+
+			size_t dataSize;
+			VK_CHECK(vkGetPipelineCacheData(m_device, m_pipelineCache, &dataSize, NULL) );
+
+			if (0 < dataSize)
+			{
+				void* data = bx::alloc(g_allocator, dataSize);
+
+				VK_CHECK(vkGetPipelineCacheData(m_device, m_pipelineCache, &dataSize, data) );
+
+				BX_TRACE("Saving pipeline cache blob (size %d).", uint32_t(dataSize) );
+				g_callback->cacheWrite(m_pipelineCacheId, data, uint32_t(dataSize) );
+
+				bx::free(g_allocator, data);
+			}
+
+			m_pipelineCacheDirty = false;
+		}
+
 		void* createTexture(TextureHandle _handle, const Memory* _mem, uint64_t _flags, uint8_t _skip) override
 		{
 			return m_textures[_handle.idx].create(m_commandBuffer, _mem, _flags, _skip);
@@ -2428,12 +2721,13 @@ VK_IMPORT_DEVICE
 				, _mip
 				);
 
-			kick(true);
-
-			texture.m_readback.readback(stagingMemory.mem, stagingMemory.offset, _data, _mip);
-
-			vkDestroy(stagingBuffer);
-			recycleMemory(stagingMemory);
+			// Data is expected by the time API thread gets frame number returned
+			// by bgfx::readTexture, which is after next frame is rendered.
+			ReadbackRequestVK& request = addReadback(ReadbackRequestVK::Texture, stagingBuffer, stagingMemory);
+			request.m_readback = texture.m_readback;
+			request.m_deadline = m_readbackFrame + 1;
+			request.m_data     = _data;
+			request.m_mip      = _mip;
 		}
 
 		void resizeTexture(TextureHandle _handle, uint16_t _width, uint16_t _height, uint8_t _numMips, uint16_t _numLayers) override
@@ -2477,6 +2771,8 @@ VK_IMPORT_DEVICE
 
 		void destroyTexture(TextureHandle _handle) override
 		{
+			// Cached descriptor sets might reference texture's image views.
+			m_descriptorSetCache.invalidate(DescriptorSetCacheVK::makeResource(Binding::Texture, _handle.idx) );
 			m_imageViewCache.invalidateWithParent(_handle.idx);
 			m_textures[_handle.idx].destroy();
 		}
@@ -2535,6 +2831,7 @@ VK_IMPORT_DEVICE
 			void* data = bx::alloc(g_allocator, size);
 			bx::memSet(data, 0, size);
 			m_uniforms[_handle.idx] = data;
+			m_uniformSize[_handle.idx] = size;
 			m_uniformReg.add(_handle, _name);
 		}
 
@@ -2542,6 +2839,7 @@ VK_IMPORT_DEVICE
 		{
 			bx::free(g_allocator, m_uniforms[_handle.idx]);
 			m_uniforms[_handle.idx] = NULL;
+			m_uniformSize[_handle.idx] = 0;
 		}
 
 		void requestScreenShot(FrameBufferHandle _fbh, const char* _filePath) override
@@ -2550,39 +2848,13 @@ VK_IMPORT_DEVICE
 				? m_frameBuffers[_fbh.idx]
 				: m_backBuffer
 				;
-			const SwapChainVK& swapChain = frameBuffer.m_swapChain;
 
-			if (!isSwapChainReadable(swapChain) )
+			// Swap chain image is copied in submit before it's presented, here
+			// is only reported when that's not possible.
+			if (!isSwapChainReadable(frameBuffer.m_swapChain) )
 			{
 				BX_TRACE("Unable to capture screenshot %s.", _filePath);
-				return;
 			}
-
-			auto callback = [](void* _src, uint32_t _width, uint32_t _height, uint32_t _pitch, const void* _userData)
-			{
-				const char* filePath = (const char*)_userData;
-				g_callback->screenShot(
-					  filePath
-					, _width
-					, _height
-					, _pitch
-					, _src
-					, _height * _pitch
-					, false
-					);
-			};
-
-			const uint8_t bpp = bimg::getBitsPerPixel(bimg::TextureFormat::Enum(swapChain.m_colorFormat) );
-			const uint32_t size = frameBuffer.m_width * frameBuffer.m_height * bpp / 8;
-
-			DeviceMemoryAllocationVK stagingMemory;
-			VkBuffer stagingBuffer;
-			VK_CHECK(createReadbackBuffer(size, &stagingBuffer, &stagingMemory) );
-
-			readSwapChain(swapChain, stagingBuffer, stagingMemory, callback, _filePath);
-
-			vkDestroy(stagingBuffer);
-			recycleMemory(stagingMemory);
 		}
 
 		void updateViewName(ViewId _id, const char* _name) override
@@ -2674,6 +2946,14 @@ VK_IMPORT_DEVICE
 
 		void submitUniformCache(UniformCacheState& _ucs, uint16_t _view);
 
+		void writeUniformScratch(RecordStateVK& _state, ChunkedScratchBufferOffset& _outSbo, uint32_t _vsSize, uint32_t _fsSize);
+
+		void recordDraw(RecordStateVK& _state, ViewState& _viewState, Frame* _render, uint16_t _view, ProgramHandle _program, const RenderItem& _renderItem, const RenderBind& _renderBind);
+
+		uint32_t prepareRecordJobs(Frame* _render);
+
+		void recordJob(RecordThreadVK& _thread, Frame* _render, RecordJobVK& _job);
+
 		void submit(Frame* _render, ClearQuad& _clearQuad, TextVideoMemBlitter& _textVideoMemBlitter) override;
 
 		void dbgTextRenderBegin(TextVideoMemBlitter& _blitter) override
@@ -2716,6 +2996,10 @@ VK_IMPORT_DEVICE
 				);
 			vkCmdBindPipeline(m_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pso);
 
+			uint64_t dynamicState   = UINT64_MAX;
+			uint64_t dynamicStencil = UINT64_MAX;
+			setDynamicState(m_commandBuffer, dynamicState, dynamicStencil, state, BGFX_STENCIL_NONE);
+
 			ProgramVK& program = m_program[_blitter.m_program.idx];
 			float proj[16];
 			bx::mtxOrtho(proj, 0.0f, (float)width, (float)height, 0.0f, 0.0f, 1000.0f, 0.0f, false);
@@ -2733,8 +3017,12 @@ VK_IMPORT_DEVICE
 
 			ChunkedScratchBufferVK& uniformScratchBuffer = m_uniformScratchBuffer;
 
+			const uint32_t vsSize = program.m_vsh->m_size;
+
 			ChunkedScratchBufferOffset sbo;
-			uniformScratchBuffer.write(sbo, m_vsScratch, program.m_vsh->m_size);
+			uniformScratchBuffer.write(sbo, m_vsScratch, vsSize);
+
+			program.pushConstants(m_commandBuffer, m_vsScratch, m_fsScratch);
 
 			const TextureVK& texture = m_textures[_blitter.m_texture.idx];
 
@@ -2753,7 +3041,7 @@ VK_IMPORT_DEVICE
 				, 0
 				, 1
 				, &descriptorSet
-				, 1
+				, 0 < vsSize ? 1 : 0
 				, sbo.offsets
 				);
 
@@ -2809,12 +3097,19 @@ VK_IMPORT_DEVICE
 				m_frameBuffers[ii].preReset();
 			}
 
+			// Deliver all readbacks before capture buffers are released.
+			processReadbacks(true);
+
 			if (m_captureSize > 0)
 			{
 				g_callback->captureEnd();
 
-				release(m_captureBuffer);
-				recycleMemory(m_captureMemory);
+				for (uint32_t ii = 0; ii < BX_COUNTOF(m_captureBuffer); ++ii)
+				{
+					release(m_captureBuffer[ii]);
+					recycleMemory(m_captureMemory[ii]);
+				}
+
 				m_captureSize = 0;
 			}
 		}
@@ -2836,11 +3131,20 @@ VK_IMPORT_DEVICE
 
 				if (captureSize > m_captureSize)
 				{
-					release(m_captureBuffer);
-					recycleMemory(m_captureMemory);
-
 					m_captureSize = captureSize;
-					VK_CHECK(createReadbackBuffer(m_captureSize, &m_captureBuffer, &m_captureMemory) );
+
+					// Capture is read back from frame in flight after GPU is done
+					// with it, so each frame in flight needs its own buffer.
+					for (uint32_t ii = 0; ii < BX_COUNTOF(m_captureBuffer); ++ii)
+					{
+						release(m_captureBuffer[ii]);
+						recycleMemory(m_captureMemory[ii]);
+
+						if (ii < m_maxFrameLatency)
+						{
+							VK_CHECK(createReadbackBuffer(m_captureSize, &m_captureBuffer[ii], &m_captureMemory[ii]) );
+						}
+					}
 				}
 
 				g_callback->captureBegin(m_resolution.width, m_resolution.height, dstPitch, TextureFormat::BGRA8, false);
@@ -2860,6 +3164,7 @@ VK_IMPORT_DEVICE
 			if (m_maxAnisotropy != maxAnisotropy)
 			{
 				m_maxAnisotropy = maxAnisotropy;
+				m_descriptorSetCache.invalidate();
 				m_samplerCache.invalidate();
 				m_samplerBorderColorCache.invalidate();
 			}
@@ -2869,6 +3174,7 @@ VK_IMPORT_DEVICE
 			if (m_depthClamp != depthClamp)
 			{
 				m_depthClamp = depthClamp;
+				finishPipelines(true);
 				m_pipelineStateCache.invalidate();
 			}
 
@@ -3034,6 +3340,7 @@ VK_IMPORT_DEVICE
 			if (m_wireframe != wireframe)
 			{
 				m_wireframe = wireframe;
+				finishPipelines(true);
 				m_pipelineStateCache.invalidate();
 			}
 		}
@@ -3212,6 +3519,93 @@ VK_IMPORT_DEVICE
 			_desc.maxDepthBounds = 1.0f;
 		}
 
+		void setDynamicState(VkCommandBuffer _commandBuffer, uint64_t& _currentState, uint64_t& _currentStencil, uint64_t _state, uint64_t _stencil)
+		{
+			if (!m_extendedDynamicStateSupport)
+			{
+				return;
+			}
+
+			_state   &= kExtendedDynamicStateMask;
+			_stencil &= kStencilNoRefMask;
+
+			// UINT64_MAX means state is unknown (after reset), XOR would miss single bit
+			// states that are set, so emit all of dynamic state once.
+			const uint64_t changedState = UINT64_MAX == _currentState
+				? kExtendedDynamicStateMask
+				: _currentState ^ _state
+				;
+			_currentState = _state;
+
+			if (BGFX_STATE_CULL_MASK & changedState)
+			{
+				const uint32_t cull = (_state&BGFX_STATE_CULL_MASK) >> BGFX_STATE_CULL_SHIFT;
+				vkCmdSetCullModeEXT(_commandBuffer, s_cullMode[cull]);
+			}
+
+			if (BGFX_STATE_FRONT_CCW & changedState)
+			{
+				vkCmdSetFrontFaceEXT(_commandBuffer, (_state&BGFX_STATE_FRONT_CCW) ? VK_FRONT_FACE_COUNTER_CLOCKWISE : VK_FRONT_FACE_CLOCKWISE);
+			}
+
+			if (BGFX_STATE_PT_MASK & changedState)
+			{
+				vkCmdSetPrimitiveTopologyEXT(_commandBuffer, s_primInfo[(_state&BGFX_STATE_PT_MASK) >> BGFX_STATE_PT_SHIFT].m_topology);
+			}
+
+			if (BGFX_STATE_DEPTH_TEST_MASK & changedState)
+			{
+				const uint32_t func = (_state&BGFX_STATE_DEPTH_TEST_MASK) >> BGFX_STATE_DEPTH_TEST_SHIFT;
+				vkCmdSetDepthTestEnableEXT(_commandBuffer, 0 != func);
+
+				if (0 != func)
+				{
+					vkCmdSetDepthCompareOpEXT(_commandBuffer, s_cmpFunc[func]);
+				}
+			}
+
+			if (BGFX_STATE_WRITE_Z & changedState)
+			{
+				vkCmdSetDepthWriteEnableEXT(_commandBuffer, !!(BGFX_STATE_WRITE_Z & _state) );
+			}
+
+			if (_currentStencil != _stencil)
+			{
+				_currentStencil = _stencil;
+
+				vkCmdSetStencilTestEnableEXT(_commandBuffer, 0 != _stencil);
+
+				if (0 != _stencil)
+				{
+					const uint32_t fstencil = unpackStencil(0, _stencil);
+					uint32_t bstencil = unpackStencil(1, _stencil);
+					const uint32_t frontAndBack = bstencil != BGFX_STENCIL_NONE && bstencil != fstencil;
+					bstencil = frontAndBack ? bstencil : fstencil;
+
+					vkCmdSetStencilOpEXT(
+						  _commandBuffer
+						, frontAndBack ? VK_STENCIL_FACE_FRONT_BIT : VK_STENCIL_FACE_FRONT_AND_BACK
+						, s_stencilOp[(fstencil & BGFX_STENCIL_OP_FAIL_S_MASK) >> BGFX_STENCIL_OP_FAIL_S_SHIFT]
+						, s_stencilOp[(fstencil & BGFX_STENCIL_OP_PASS_Z_MASK) >> BGFX_STENCIL_OP_PASS_Z_SHIFT]
+						, s_stencilOp[(fstencil & BGFX_STENCIL_OP_FAIL_Z_MASK) >> BGFX_STENCIL_OP_FAIL_Z_SHIFT]
+						, s_cmpFunc[(fstencil & BGFX_STENCIL_TEST_MASK) >> BGFX_STENCIL_TEST_SHIFT]
+						);
+
+					if (frontAndBack)
+					{
+						vkCmdSetStencilOpEXT(
+							  _commandBuffer
+							, VK_STENCIL_FACE_BACK_BIT
+							, s_stencilOp[(bstencil & BGFX_STENCIL_OP_FAIL_S_MASK) >> BGFX_STENCIL_OP_FAIL_S_SHIFT]
+							, s_stencilOp[(bstencil & BGFX_STENCIL_OP_PASS_Z_MASK) >> BGFX_STENCIL_OP_PASS_Z_SHIFT]
+							, s_stencilOp[(bstencil & BGFX_STENCIL_OP_FAIL_Z_MASK) >> BGFX_STENCIL_OP_FAIL_Z_SHIFT]
+							, s_cmpFunc[(bstencil & BGFX_STENCIL_TEST_MASK) >> BGFX_STENCIL_TEST_SHIFT]
+							);
+					}
+				}
+			}
+		}
+
 		void setInputLayout(VkPipelineVertexInputStateCreateInfo& _vertexInputState, uint8_t _numStream, const VertexLayout** _layout, const ProgramVK& _program, uint8_t _numInstanceData)
 		{
 			_vertexInputState.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -3541,6 +3935,13 @@ VK_IMPORT_DEVICE
 				}
 				else
 				{
+					// Sampler with previous border color is released, and it
+					// might be referenced by cached descriptor sets.
+					if (0 != colorHashKey)
+					{
+						m_descriptorSetCache.invalidate();
+					}
+
 					m_samplerBorderColorCache.add(hashKey, newColorHashKey);
 				}
 			}
@@ -3620,6 +4021,13 @@ VK_IMPORT_DEVICE
 				| ( _stencil ? VK_IMAGE_ASPECT_STENCIL_BIT : VK_IMAGE_ASPECT_DEPTH_BIT)
 				;
 
+			if (BGFX_CONFIG_RENDERER_VULKAN_MAX_IMAGE_VIEWS == m_imageViewCache.getCount() )
+			{
+				// Adding view will evict least recently used one, which might
+				// be referenced by cached descriptor sets using its texture.
+				m_descriptorSetCache.invalidate(DescriptorSetCacheVK::makeResource(Binding::Texture, m_imageViewCache.getBackParent() ) );
+			}
+
 			VkImageView view;
 			VK_CHECK(texture.createView(0, texture.m_numSides, _mip, _numMips, _type, aspectMask, false, &view) );
 			m_imageViewCache.add(hashKey, view, _handle.idx);
@@ -3629,6 +4037,8 @@ VK_IMPORT_DEVICE
 
 		VkPipeline getPipeline(ProgramHandle _program)
 		{
+			CommandRecorderScopeVK scope(m_recorder);
+
 			ProgramVK& program = m_program[_program.idx];
 
 			bx::HashMurmur2A murmur;
@@ -3663,12 +4073,20 @@ VK_IMPORT_DEVICE
 			VK_CHECK(vkCreateComputePipelines(m_device, m_pipelineCache, 1, &cpci, m_allocatorCb, &pipeline) );
 
 			m_pipelineStateCache.add(hash, pipeline);
+			m_pipelineCacheDirty = true;
 
 			return pipeline;
 		}
 
 		VkPipeline getPipeline(uint64_t _state, uint64_t _stencil, uint8_t _numStreams, const VertexLayout** _layouts, ProgramHandle _program, uint8_t _numInstanceData)
 		{
+			return getPipeline(_state, _stencil, _numStreams, _layouts, _program, _numInstanceData, m_fbh, true);
+		}
+
+		VkPipeline getPipeline(uint64_t _state, uint64_t _stencil, uint8_t _numStreams, const VertexLayout** _layouts, ProgramHandle _program, uint8_t _numInstanceData, FrameBufferHandle _fbh, bool _wait)
+		{
+			CommandRecorderScopeVK scope(m_recorder);
+
 			ProgramVK& program = m_program[_program.idx];
 
 			_state &= 0
@@ -3688,6 +4106,22 @@ VK_IMPORT_DEVICE
 
 			_stencil &= kStencilNoRefMask;
 
+			if (m_extendedDynamicStateSupport)
+			{
+				// Cull mode, depth and stencil state, and primitive topology
+				// are set with setDynamicState. Pipeline only depends on
+				// topology class (triangle, line, or point).
+				const uint64_t pt = _state & BGFX_STATE_PT_MASK;
+
+				_state &= ~kExtendedDynamicStateMask;
+				_state |= 0
+					| (BGFX_STATE_PT_TRISTRIP  == pt ? 0
+					:  BGFX_STATE_PT_LINESTRIP == pt ? BGFX_STATE_PT_LINES
+					:  pt)
+					;
+				_stencil = 0;
+			}
+
 			VertexLayout layout;
 			if (0 < _numStreams)
 			{
@@ -3702,8 +4136,8 @@ VK_IMPORT_DEVICE
 				}
 			}
 
-			const FrameBufferVK& frameBuffer = isValid(m_fbh)
-				? m_frameBuffers[m_fbh.idx]
+			const FrameBufferVK& frameBuffer = isValid(_fbh)
+				? m_frameBuffers[_fbh.idx]
 				: m_backBuffer
 				;
 
@@ -3736,89 +4170,102 @@ VK_IMPORT_DEVICE
 				return pipeline;
 			}
 
-			VkPipelineColorBlendAttachmentState blendAttachmentState[BGFX_CONFIG_MAX_FRAME_BUFFER_ATTACHMENTS];
-			VkPipelineColorBlendStateCreateInfo colorBlendState;
-			colorBlendState.pAttachments = blendAttachmentState;
-			setBlendState(colorBlendState, _state);
+			if (NULL == m_pipelineJobs.find(hash) )
+			{
+				PipelineJobVK* job = BX_NEW(g_allocator, PipelineJobVK);
+				initPipelineJob(*job, hash, _state, _stencil, _numStreams, _layouts, program, _numInstanceData, frameBuffer);
+				m_pipelineJobs.insert(hash, job);
+
+				if (0 == m_pipelineCompiler.getNumThreads() )
+				{
+					compilePipeline(*job);
+					finishPipeline(job);
+					return m_pipelineStateCache.find(hash);
+				}
+
+				m_pipelineCompiler.push(job);
+			}
+
+			if (!_wait)
+			{
+				return VK_NULL_HANDLE;
+			}
+
+			// Pipeline is being compiled in background, collect finished
+			// pipelines until it's done.
+			while (NULL != m_pipelineJobs.find(hash) )
+			{
+				finishPipeline(m_pipelineCompiler.pop(true) );
+			}
+
+			return m_pipelineStateCache.find(hash);
+		}
+
+		void initPipelineJob(PipelineJobVK& _job, uint32_t _hash, uint64_t _state, uint64_t _stencil, uint8_t _numStreams, const VertexLayout** _layouts, const ProgramVK& _program, uint8_t _numInstanceData, const FrameBufferVK& _frameBuffer)
+		{
+			_job.colorBlendState.pAttachments = _job.blendAttachmentState;
+			setBlendState(_job.colorBlendState, _state);
 
-			VkPipelineInputAssemblyStateCreateInfo inputAssemblyState;
+			VkPipelineInputAssemblyStateCreateInfo& inputAssemblyState = _job.inputAssemblyState;
 			inputAssemblyState.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
 			inputAssemblyState.pNext = NULL;
 			inputAssemblyState.flags = 0;
 			inputAssemblyState.topology = s_primInfo[(_state&BGFX_STATE_PT_MASK) >> BGFX_STATE_PT_SHIFT].m_topology;
 			inputAssemblyState.primitiveRestartEnable = VK_FALSE;
 
-			VkPipelineRasterizationStateCreateInfo rasterizationState;
-			setRasterizerState(rasterizationState, _state, m_wireframe);
+			setRasterizerState(_job.rasterizationState, _state, m_wireframe);
 
-			VkBaseInStructure* nextRasterizationState = (VkBaseInStructure*)&rasterizationState;
+			VkBaseInStructure* nextRasterizationState = (VkBaseInStructure*)&_job.rasterizationState;
 
-			VkPipelineRasterizationConservativeStateCreateInfoEXT conservativeRasterizationState;
 			if (s_extension[Extension::EXT_conservative_rasterization].m_supported)
 			{
-				nextRasterizationState->pNext = (VkBaseInStructure*)&conservativeRasterizationState;
-				nextRasterizationState = (VkBaseInStructure*)&conservativeRasterizationState;
-				setConservativeRasterizerState(conservativeRasterizationState, _state);
+				nextRasterizationState->pNext = (VkBaseInStructure*)&_job.conservativeRasterizationState;
+				nextRasterizationState = (VkBaseInStructure*)&_job.conservativeRasterizationState;
+				setConservativeRasterizerState(_job.conservativeRasterizationState, _state);
 			}
 
-			VkPipelineRasterizationLineStateCreateInfoEXT lineRasterizationState;
 			if (m_lineAASupport)
 			{
-				nextRasterizationState->pNext = (VkBaseInStructure*)&lineRasterizationState;
-				nextRasterizationState = (VkBaseInStructure*)&lineRasterizationState;
-				setLineRasterizerState(lineRasterizationState, _state);
+				nextRasterizationState->pNext = (VkBaseInStructure*)&_job.lineRasterizationState;
+				nextRasterizationState = (VkBaseInStructure*)&_job.lineRasterizationState;
+				setLineRasterizerState(_job.lineRasterizationState, _state);
 			}
 
-			VkPipelineDepthStencilStateCreateInfo depthStencilState;
-			setDepthStencilState(depthStencilState, _state, _stencil);
-
-			VkVertexInputBindingDescription  inputBinding[BGFX_CONFIG_MAX_VERTEX_STREAMS + 1];
-			VkVertexInputAttributeDescription inputAttrib[Attrib::Count + BGFX_CONFIG_MAX_INSTANCE_DATA_COUNT];
+			setDepthStencilState(_job.depthStencilState, _state, _stencil);
 
-			VkPipelineVertexInputStateCreateInfo vertexInputState;
-			vertexInputState.pVertexBindingDescriptions   = inputBinding;
-			vertexInputState.pVertexAttributeDescriptions = inputAttrib;
-			setInputLayout(vertexInputState, _numStreams, _layouts, program, _numInstanceData);
+			VkPipelineVertexInputStateCreateInfo& vertexInputState = _job.vertexInputState;
+			vertexInputState.pVertexBindingDescriptions   = _job.inputBinding;
+			vertexInputState.pVertexAttributeDescriptions = _job.inputAttrib;
+			setInputLayout(vertexInputState, _numStreams, _layouts, _program, _numInstanceData);
 
-			const VkDynamicState dynamicStates[] =
-			{
-				VK_DYNAMIC_STATE_VIEWPORT,
-				VK_DYNAMIC_STATE_SCISSOR,
-				VK_DYNAMIC_STATE_BLEND_CONSTANTS,
-				VK_DYNAMIC_STATE_STENCIL_REFERENCE,
-				VK_DYNAMIC_STATE_FRAGMENT_SHADING_RATE_KHR, // optional
-			};
-
-			VkPipelineDynamicStateCreateInfo dynamicState;
+			VkPipelineDynamicStateCreateInfo& dynamicState = _job.dynamicState;
 			dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
 			dynamicState.pNext = NULL;
 			dynamicState.flags = 0;
-			dynamicState.dynamicStateCount = BX_COUNTOF(dynamicStates) -
-				(m_variableRateShadingSupported ? 0 : 1)
-				;
-			dynamicState.pDynamicStates = dynamicStates;
+			dynamicState.dynamicStateCount = m_numDynamicStates;
+			dynamicState.pDynamicStates    = m_dynamicStates;
 
-			VkPipelineShaderStageCreateInfo shaderStages[2];
+			VkPipelineShaderStageCreateInfo* shaderStages = _job.shaderStages;
 			shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 			shaderStages[0].pNext = NULL;
 			shaderStages[0].flags = 0;
 			shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
-			shaderStages[0].module = program.m_vsh->m_module;
+			shaderStages[0].module = _program.m_vsh->m_module;
 			shaderStages[0].pName  = "main";
 			shaderStages[0].pSpecializationInfo = NULL;
 
-			if (NULL != program.m_fsh)
+			if (NULL != _program.m_fsh)
 			{
 				shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 				shaderStages[1].pNext = NULL;
 				shaderStages[1].flags = 0;
 				shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-				shaderStages[1].module = program.m_fsh->m_module;
+				shaderStages[1].module = _program.m_fsh->m_module;
 				shaderStages[1].pName  = "main";
 				shaderStages[1].pSpecializationInfo = NULL;
 			}
 
-			VkPipelineViewportStateCreateInfo viewportState;
+			VkPipelineViewportStateCreateInfo& viewportState = _job.viewportState;
 			viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
 			viewportState.pNext = NULL;
 			viewportState.flags = 0;
@@ -3827,113 +4274,215 @@ VK_IMPORT_DEVICE
 			viewportState.scissorCount  = 1;
 			viewportState.pScissors     = NULL;
 
-			VkPipelineMultisampleStateCreateInfo multisampleState;
+			VkPipelineMultisampleStateCreateInfo& multisampleState = _job.multisampleState;
 			multisampleState.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
 			multisampleState.pNext = NULL;
 			multisampleState.flags = 0;
-			multisampleState.rasterizationSamples  = frameBuffer.m_sampler.Sample;
+			multisampleState.rasterizationSamples  = _frameBuffer.m_sampler.Sample;
 			multisampleState.sampleShadingEnable   = VK_FALSE;
 			multisampleState.minSampleShading      = 0.0f;
 			multisampleState.pSampleMask           = NULL;
 			multisampleState.alphaToCoverageEnable = !!(BGFX_STATE_BLEND_ALPHA_TO_COVERAGE & _state);
 			multisampleState.alphaToOneEnable      = VK_FALSE;
 
-			VkGraphicsPipelineCreateInfo graphicsPipeline;
+			VkGraphicsPipelineCreateInfo& graphicsPipeline = _job.graphicsPipeline;
 			graphicsPipeline.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 			graphicsPipeline.pNext = NULL;
 			graphicsPipeline.flags = 0;
-			graphicsPipeline.stageCount = NULL == program.m_fsh ? 1 : 2;
+			graphicsPipeline.stageCount = NULL == _program.m_fsh ? 1 : 2;
 			graphicsPipeline.pStages    = shaderStages;
 			graphicsPipeline.pVertexInputState   = &vertexInputState;
 			graphicsPipeline.pInputAssemblyState = &inputAssemblyState;
 			graphicsPipeline.pTessellationState  = NULL;
 			graphicsPipeline.pViewportState      = &viewportState;
-			graphicsPipeline.pRasterizationState = &rasterizationState;
+			graphicsPipeline.pRasterizationState = &_job.rasterizationState;
 			graphicsPipeline.pMultisampleState   = &multisampleState;
-			graphicsPipeline.pDepthStencilState  = &depthStencilState;
-			graphicsPipeline.pColorBlendState    = &colorBlendState;
+			graphicsPipeline.pDepthStencilState  = &_job.depthStencilState;
+			graphicsPipeline.pColorBlendState    = &_job.colorBlendState;
 			graphicsPipeline.pDynamicState       = &dynamicState;
-			graphicsPipeline.layout     = program.m_pipelineLayout;
-			graphicsPipeline.renderPass = frameBuffer.m_renderPass;
+			graphicsPipeline.layout     = _program.m_pipelineLayout;
+			graphicsPipeline.renderPass = _frameBuffer.m_renderPass;
 			graphicsPipeline.subpass    = 0;
 			graphicsPipeline.basePipelineHandle = VK_NULL_HANDLE;
 			graphicsPipeline.basePipelineIndex  = 0;
 
-			uint32_t length = g_callback->cacheReadSize(hash);
-			bool cached = length > 0;
+			_job.m_next      = NULL;
+			_job.m_program   = &_program;
+			_job.m_cacheData = NULL;
+			_job.m_cacheSize = 0;
+			_job.m_hash      = _hash;
+			_job.m_cache     = VK_NULL_HANDLE;
+			_job.m_pipeline  = VK_NULL_HANDLE;
+			_job.m_time      = 0;
 
-			void* cachedData = NULL;
+			if (m_singlePipelineCache)
+			{
+				return;
+			}
 
-			VkPipelineCacheCreateInfo pcci;
-			pcci.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-			pcci.pNext = NULL;
-			pcci.flags = 0;
-			pcci.initialDataSize = 0;
-			pcci.pInitialData    = NULL;
+			// Cache callback is not required to be thread safe, cached data is
+			// read here and written back in finishPipeline on render thread.
+			const uint32_t length = g_callback->cacheReadSize(_hash);
 
-			if (cached)
+			if (0 < length)
 			{
-				cachedData = bx::alloc(g_allocator, length);
-				if (g_callback->cacheRead(hash, cachedData, length) )
+				_job.m_cacheData = bx::alloc(g_allocator, length);
+				if (g_callback->cacheRead(_hash, _job.m_cacheData, length) )
 				{
 					BX_TRACE("Loading cached pipeline state (size %d).", length);
-					bx::MemoryReader reader(cachedData, length);
-
-					pcci.initialDataSize = (size_t)reader.remaining();
-					pcci.pInitialData    = reader.getDataPtr();
+					_job.m_cacheSize = length;
 				}
 			}
+		}
+
+		// Called from render thread, or from pipeline compiler threads.
+		void compilePipeline(PipelineJobVK& _job)
+		{
+			const int64_t timeBegin = bx::getHPCounter();
+
+			if (m_singlePipelineCache)
+			{
+				// Pipeline cache is internally synchronized, all compiler
+				// threads can use it at the same time.
+				VK_CHECK(vkCreateGraphicsPipelines(
+					  m_device
+					, m_pipelineCache
+					, 1
+					, &_job.graphicsPipeline
+					, m_allocatorCb
+					, &_job.m_pipeline
+					) );
+
+				_job.m_time = bx::getHPCounter() - timeBegin;
+				return;
+			}
 
-			VkPipelineCache cache;
-			VK_CHECK(vkCreatePipelineCache(m_device, &pcci, m_allocatorCb, &cache) );
+			VkPipelineCacheCreateInfo pcci;
+			pcci.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+			pcci.pNext = NULL;
+			pcci.flags = 0;
+			pcci.initialDataSize = _job.m_cacheSize;
+			pcci.pInitialData    = _job.m_cacheData;
+
+			VK_CHECK(vkCreatePipelineCache(m_device, &pcci, m_allocatorCb, &_job.m_cache) );
 
 			VK_CHECK(vkCreateGraphicsPipelines(
 				  m_device
-				, cache
+				, _job.m_cache
 				, 1
-				, &graphicsPipeline
+				, &_job.graphicsPipeline
 				, m_allocatorCb
-				, &pipeline
+				, &_job.m_pipeline
 				) );
-			m_pipelineStateCache.add(hash, pipeline);
 
 			size_t dataSize;
-			VK_CHECK(vkGetPipelineCacheData(m_device, cache, &dataSize, NULL) );
+			VK_CHECK(vkGetPipelineCacheData(m_device, _job.m_cache, &dataSize, NULL) );
+
+			_job.m_cacheSize = 0;
 
 			if (0 < dataSize)
 			{
-				if (length < dataSize)
-				{
-					cachedData = bx::realloc(g_allocator, cachedData, dataSize);
+				_job.m_cacheData = bx::realloc(g_allocator, _job.m_cacheData, dataSize);
+
+				VK_CHECK(vkGetPipelineCacheData(m_device, _job.m_cache, &dataSize, _job.m_cacheData) );
+				_job.m_cacheSize = uint32_t(dataSize);
+			}
+
+			_job.m_time = bx::getHPCounter() - timeBegin;
+		}
+
+		void finishPipeline(PipelineJobVK* _job)
+		{
+			if (VK_NULL_HANDLE != _job->m_cache)
+			{
+				if (0 < _job->m_cacheSize)
+				{
+					g_callback->cacheWrite(_job->m_hash, _job->m_cacheData, _job->m_cacheSize);
 				}
 
-				VK_CHECK(vkGetPipelineCacheData(m_device, cache, &dataSize, cachedData) );
-				g_callback->cacheWrite(hash, cachedData, (uint32_t)dataSize);
+				VK_CHECK(vkMergePipelineCaches(m_device, m_pipelineCache, 1, &_job->m_cache) );
+				vkDestroy(_job->m_cache);
 			}
 
-			VK_CHECK(vkMergePipelineCaches(m_device, m_pipelineCache, 1, &cache) );
-			vkDestroy(cache);
+			m_pipelineStateCache.add(_job->m_hash, _job->m_pipeline);
+			m_pipelineCacheDirty = true;
+			m_pipelineJobs.removeByKey(_job->m_hash);
 
-			if (NULL != cachedData)
+			m_numPipelinesCompiled++;
+			m_pipelineCompileTime += _job->m_time;
+
+			if (NULL != _job->m_cacheData)
 			{
-				bx::free(g_allocator, cachedData);
+				bx::free(g_allocator, _job->m_cacheData);
 			}
 
-			return pipeline;
+			bx::deleteObject(g_allocator, _job);
 		}
 
-		VkDescriptorSet getDescriptorSet(const ProgramVK& _program, const RenderBind& _renderBind, VkBuffer _uniformBuffer, const float _palette[][4])
+		void finishPipelines(bool _wait)
 		{
-			VkDescriptorSet descriptorSet;
+			if (_wait)
+			{
+				while (0 != m_pipelineJobs.getNumElements() )
+				{
+					finishPipeline(m_pipelineCompiler.pop(true) );
+				}
+			}
+			else
+			{
+				for (PipelineJobVK* job = m_pipelineCompiler.pop(false); NULL != job; job = m_pipelineCompiler.pop(false) )
+				{
+					finishPipeline(job);
+				}
+			}
+		}
 
-			VkDescriptorSetAllocateInfo dsai;
-			dsai.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-			dsai.pNext              = NULL;
-			dsai.descriptorPool     = m_descriptorPool[m_cmd.m_currentFrameInFlight];
-			dsai.descriptorSetCount = 1;
-			dsai.pSetLayouts        = &_program.m_descriptorSetLayout;
+		bool isPipelineJobPending(const ProgramVK* _program, const ShaderVK* _shader) const
+		{
+			for (uint32_t ii = 0, num = m_pipelineJobs.getCapacity(); ii < num; ++ii)
+			{
+				if (m_pipelineJobs.isValid(ii) )
+				{
+					const ProgramVK* program = m_pipelineJobs.getValueAt(ii)->m_program;
+
+					if (_program == program
+					|| (NULL != _shader && (_shader == program->m_vsh || _shader == program->m_fsh) ) )
+					{
+						return true;
+					}
+				}
+			}
+
+			return false;
+		}
+
+		// Collects finished pipelines until none of pending jobs reference
+		// program or shader, other jobs keep compiling in background.
+		void finishPipelines(const ProgramVK* _program, const ShaderVK* _shader)
+		{
+			while (isPipelineJobPending(_program, _shader) )
+			{
+				finishPipeline(m_pipelineCompiler.pop(true) );
+			}
+		}
+
+		void precachePipeline(ProgramHandle _program, uint64_t _state, VertexLayoutHandle _layoutHandle, FrameBufferHandle _frameBuffer, uint8_t _numInstanceData) override
+		{
+			const VertexLayout* layout = &m_vertexLayouts[_layoutHandle.idx];
+			getPipeline(_state
+				, packStencil(BGFX_STENCIL_DEFAULT, BGFX_STENCIL_DEFAULT)
+				, 1
+				, &layout
+				, _program
+				, _numInstanceData
+				, _frameBuffer
+				, false
+				);
+		}
 
-			VK_CHECK(vkAllocateDescriptorSets(m_device, &dsai, &descriptorSet) );
+		VkDescriptorSet getDescriptorSet(const ProgramVK& _program, const RenderBind& _renderBind, VkBuffer _uniformBuffer, const float _palette[][4])
+		{
+			CommandRecorderScopeVK scope(m_recorder);
 
 			VkDescriptorImageInfo  imageInfo[BGFX_CONFIG_MAX_TEXTURE_SAMPLERS];
 			VkDescriptorBufferInfo bufferInfo[BGFX_CONFIG_MAX_TEXTURE_SAMPLERS];
@@ -3941,6 +4490,11 @@ VK_IMPORT_DEVICE
 			constexpr uint32_t kMaxDescriptorSets = 2 * BGFX_CONFIG_MAX_TEXTURE_SAMPLERS + 2;
 			VkWriteDescriptorSet wds[kMaxDescriptorSets] = {};
 
+			// Textures and buffers referenced by descriptor set, when any of
+			// them is destroyed cached descriptor set is evicted.
+			uint32_t resource[BGFX_CONFIG_MAX_TEXTURE_SAMPLERS];
+			uint8_t  numResources = 0;
+
 			uint32_t wdsCount    = 0;
 			uint32_t bufferCount = 0;
 			uint32_t imageCount  = 0;
@@ -3953,6 +4507,11 @@ VK_IMPORT_DEVICE
 				if (kInvalidHandle != bind.m_idx
 				&&  isValid(bindInfo.uniformHandle) )
 				{
+					resource[numResources++] = DescriptorSetCacheVK::makeResource(
+						  Binding::Image == bind.m_type ? uint8_t(Binding::Texture) : bind.m_type
+						, bind.m_idx
+						);
+
 					switch (bind.m_type)
 					{
 					case Binding::Image:
@@ -3961,7 +4520,6 @@ VK_IMPORT_DEVICE
 
 							wds[wdsCount].sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 							wds[wdsCount].pNext            = NULL;
-							wds[wdsCount].dstSet           = descriptorSet;
 							wds[wdsCount].dstBinding       = bindInfo.binding;
 							wds[wdsCount].dstArrayElement  = 0;
 							wds[wdsCount].descriptorCount  = 1;
@@ -3986,8 +4544,12 @@ VK_IMPORT_DEVICE
 								type = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
 							}
 
+							// Image layout is transitioned by render thread while record
+							// threads are running, views recorded by them are validated
+							// in prepareRecordJobs.
 							BX_ASSERT(
-								  texture.m_currentImageLayout == texture.m_sampledLayout
+								   s_recordThread
+								|| texture.m_currentImageLayout == texture.m_sampledLayout
 								, "Mismatching image layout. Texture currently used as a framebuffer attachment?"
 								);
 
@@ -4011,7 +4573,6 @@ VK_IMPORT_DEVICE
 						{
 							wds[wdsCount].sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 							wds[wdsCount].pNext            = NULL;
-							wds[wdsCount].dstSet           = descriptorSet;
 							wds[wdsCount].dstBinding       = bindInfo.binding;
 							wds[wdsCount].dstArrayElement  = 0;
 							wds[wdsCount].descriptorCount  = 1;
@@ -4050,8 +4611,12 @@ VK_IMPORT_DEVICE
 								: _program.m_textures[bindInfo.index].type
 								;
 
+							// Image layout is transitioned by render thread while record
+							// threads are running, views recorded by them are validated
+							// in prepareRecordJobs.
 							BX_ASSERT(
-								  texture.m_currentImageLayout == texture.m_sampledLayout
+								   s_recordThread
+								|| texture.m_currentImageLayout == texture.m_sampledLayout
 								, "Mismatching image layout. Texture currently used as a framebuffer attachment?"
 								);
 
@@ -4067,7 +4632,6 @@ VK_IMPORT_DEVICE
 
 							wds[wdsCount].sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 							wds[wdsCount].pNext            = NULL;
-							wds[wdsCount].dstSet           = descriptorSet;
 							wds[wdsCount].dstBinding       = bindInfo.binding;
 							wds[wdsCount].dstArrayElement  = 0;
 							wds[wdsCount].descriptorCount  = 1;
@@ -4079,7 +4643,6 @@ VK_IMPORT_DEVICE
 
 							wds[wdsCount].sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 							wds[wdsCount].pNext            = NULL;
-							wds[wdsCount].dstSet           = descriptorSet;
 							wds[wdsCount].dstBinding       = bindInfo.samplerBinding;
 							wds[wdsCount].dstArrayElement  = 0;
 							wds[wdsCount].descriptorCount  = 1;
@@ -4107,7 +4670,6 @@ VK_IMPORT_DEVICE
 
 				wds[wdsCount].sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 				wds[wdsCount].pNext            = NULL;
-				wds[wdsCount].dstSet           = descriptorSet;
 				wds[wdsCount].dstBinding       = _program.m_vsh->m_uniformBinding;
 				wds[wdsCount].dstArrayElement  = 0;
 				wds[wdsCount].descriptorCount  = 1;
@@ -4127,7 +4689,6 @@ VK_IMPORT_DEVICE
 
 				wds[wdsCount].sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 				wds[wdsCount].pNext            = NULL;
-				wds[wdsCount].dstSet           = descriptorSet;
 				wds[wdsCount].dstBinding       = _program.m_fsh->m_uniformBinding;
 				wds[wdsCount].dstArrayElement  = 0;
 				wds[wdsCount].descriptorCount  = 1;
@@ -4139,10 +4700,78 @@ VK_IMPORT_DEVICE
 				++bufferCount;
 			}
 
+			// Descriptor set is keyed by its content, so that the same bindings
+			// hit the cache regardless of which draw or frame requested them.
+			uint64_t keyData[1 + kMaxDescriptorSets*4];
+			uint32_t keySize = 0;
+			keyData[keySize++] = uint64_t(_program.m_descriptorSetLayout.vk);
+
+			for (uint32_t ii = 0; ii < wdsCount; ++ii)
+			{
+				const VkWriteDescriptorSet& write = wds[ii];
+				keyData[keySize++] = (uint64_t(write.dstBinding) << 32) | uint64_t(write.descriptorType);
+
+				if (NULL != write.pImageInfo)
+				{
+					keyData[keySize++] = uint64_t(write.pImageInfo->sampler);
+					keyData[keySize++] = uint64_t(write.pImageInfo->imageView);
+					keyData[keySize++] = uint64_t(write.pImageInfo->imageLayout);
+				}
+				else
+				{
+					keyData[keySize++] = uint64_t(write.pBufferInfo->buffer);
+					keyData[keySize++] = uint64_t(write.pBufferInfo->offset);
+					keyData[keySize++] = uint64_t(write.pBufferInfo->range);
+				}
+			}
+
+			const uint32_t keyDataSize = uint32_t(keySize*sizeof(uint64_t) );
+			const uint64_t hash = 0
+				| (uint64_t(bx::hash<bx::HashCrc32>(keyData, keyDataSize) ) << 32)
+				|  uint64_t(bx::hash<bx::HashMurmur2A>(keyData, keyDataSize) )
+				;
+
+			VkDescriptorSet* cached = m_descriptorSetCache.find(hash, keyData, keyDataSize);
+
+			if (NULL != cached)
+			{
+				++m_numDescriptorSetsReused;
+				return *cached;
+			}
+
+			++m_numDescriptorSetsCreated;
+
+			VkDescriptorSet descriptorSet;
+
+			VkDescriptorSetAllocateInfo dsai;
+			dsai.sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+			dsai.pNext              = NULL;
+			dsai.descriptorPool     = m_descriptorSetCachePool;
+			dsai.descriptorSetCount = 1;
+			dsai.pSetLayouts        = &_program.m_descriptorSetLayout;
+
+			// Evicted descriptor sets are returned to cache pool only after
+			// frames in flight are done with them, when cache pool is exhausted
+			// fall back to per frame pool, and don't cache descriptor set.
+			const bool cache = VK_SUCCESS == vkAllocateDescriptorSets(m_device, &dsai, &descriptorSet);
+
+			if (!cache)
+			{
+				dsai.descriptorPool = m_descriptorPool[m_cmd.m_currentFrameInFlight];
+				VK_CHECK(vkAllocateDescriptorSets(m_device, &dsai, &descriptorSet) );
+			}
+
+			for (uint32_t ii = 0; ii < wdsCount; ++ii)
+			{
+				wds[ii].dstSet = descriptorSet;
+			}
+
 			vkUpdateDescriptorSets(m_device, wdsCount, wds, 0, NULL);
 
-			VkDescriptorSet temp = descriptorSet;
-			release(temp);
+			if (cache)
+			{
+				m_descriptorSetCache.add(hash, keyData, keyDataSize, descriptorSet, resource, numResources);
+			}
 
 			return descriptorSet;
 		}
@@ -4157,63 +4786,150 @@ VK_IMPORT_DEVICE
 				;
 		}
 
-		typedef void (*SwapChainReadFunc)(void* /*src*/, uint32_t /*width*/, uint32_t /*height*/, uint32_t /*pitch*/, const void* /*userData*/);
+		ReadbackRequestVK& addReadback(ReadbackRequestVK::Enum _type, VkBuffer _buffer, DeviceMemoryAllocationVK _memory)
+		{
+			ReadbackRequestVK request;
+			request.m_buffer        = _buffer;
+			request.m_memory        = _memory;
+			request.m_submitted     = m_cmd.m_submitted;
+			request.m_frameInFlight = m_cmd.m_currentFrameInFlight;
+			request.m_deadline      = UINT32_MAX;
+			request.m_data          = NULL;
+			request.m_mip           = 0;
+			request.m_type          = _type;
+
+			m_readbacks.push_back(request);
+
+			return m_readbacks.back();
+		}
+
+		void readSwapChain(const SwapChainVK& _swapChain, VkBuffer _buffer, DeviceMemoryAllocationVK _memory, ReadbackRequestVK::Enum _type, const char* _filePath = NULL)
+		{
+			// source for the copy is the last rendered swapchain image
+			const VkImage image = _swapChain.m_backBufferColorImage[_swapChain.m_backBufferColorIdx];
+			const VkImageLayout layout = _swapChain.m_backBufferColorImageLayout[_swapChain.m_backBufferColorIdx];
+
+			const uint32_t width  = _swapChain.m_sci.imageExtent.width;
+			const uint32_t height = _swapChain.m_sci.imageExtent.height;
+
+			ReadbackVK readback;
+			readback.create(image, width, height, _swapChain.m_colorFormat);
+			readback.copyImageToBuffer(m_commandBuffer, _buffer, layout, VK_IMAGE_ASPECT_COLOR_BIT);
+
+			ReadbackRequestVK& request = addReadback(_type, _buffer, _memory);
+			request.m_readback = readback;
+
+			if (NULL != _filePath)
+			{
+				request.m_filePath.set(_filePath);
+			}
+		}
+
+		void readSwapChain(const SwapChainVK& _swapChain, const char* _filePath)
+		{
+			const uint8_t bpp = bimg::getBitsPerPixel(bimg::TextureFormat::Enum(_swapChain.m_colorFormat) );
+			const uint32_t size = _swapChain.m_sci.imageExtent.width * _swapChain.m_sci.imageExtent.height * bpp / 8;
+
+			DeviceMemoryAllocationVK stagingMemory;
+			VkBuffer stagingBuffer;
+			VK_CHECK(createReadbackBuffer(size, &stagingBuffer, &stagingMemory) );
+
+			readSwapChain(_swapChain, stagingBuffer, stagingMemory, ReadbackRequestVK::ScreenShot, _filePath);
+		}
 
-		bool readSwapChain(const SwapChainVK& _swapChain, VkBuffer _buffer, DeviceMemoryAllocationVK _memory, SwapChainReadFunc _func, const void* _userData = NULL)
+		void deliverSwapChain(const ReadbackRequestVK& _request)
 		{
-			if (isSwapChainReadable(_swapChain) )
+			const ReadbackVK& readback = _request.m_readback;
+			const uint32_t width  = readback.m_width;
+			const uint32_t height = readback.m_height;
+			const uint32_t pitch  = readback.pitch();
+
+			uint8_t* src;
+			VK_CHECK(vkMapMemory(m_device, _request.m_memory.mem, _request.m_memory.offset, _request.m_memory.size, 0, (void**)&src) );
+
+			void* dst = src;
+			uint32_t dstPitch = pitch;
+
+			if (readback.m_format == TextureFormat::RGBA8)
+			{
+				bimg::imageSwizzleBgra8(src, pitch, width, height, src, pitch);
+			}
+			else if (readback.m_format != TextureFormat::BGRA8)
+			{
+				const uint8_t dstBpp = bimg::getBitsPerPixel(bimg::TextureFormat::BGRA8);
+				dstPitch = width * dstBpp / 8;
+
+				dst = bx::alloc(g_allocator, height * dstPitch);
+
+				bimg::imageConvert(g_allocator, dst, bimg::TextureFormat::BGRA8, src, bimg::TextureFormat::Enum(readback.m_format), width, height, 1);
+			}
+
+			if (ReadbackRequestVK::ScreenShot == _request.m_type)
+			{
+				g_callback->screenShot(
+					  _request.m_filePath.getCPtr()
+					, width
+					, height
+					, dstPitch
+					, dst
+					, height * dstPitch
+					, false
+					);
+			}
+			else
 			{
-				// source for the copy is the last rendered swapchain image
-				const VkImage image = _swapChain.m_backBufferColorImage[_swapChain.m_backBufferColorIdx];
-				const VkImageLayout layout = _swapChain.m_backBufferColorImageLayout[_swapChain.m_backBufferColorIdx];
+				g_callback->captureFrame(dst, height * dstPitch);
+			}
 
-				const uint32_t width  = _swapChain.m_sci.imageExtent.width;
-				const uint32_t height = _swapChain.m_sci.imageExtent.height;
+			if (dst != src)
+			{
+				bx::free(g_allocator, dst);
+			}
 
-				ReadbackVK readback;
-				readback.create(image, width, height, _swapChain.m_colorFormat);
-				const uint32_t pitch = readback.pitch();
+			vkUnmapMemory(m_device, _request.m_memory.mem);
+		}
 
-				readback.copyImageToBuffer(m_commandBuffer, _buffer, layout, VK_IMAGE_ASPECT_COLOR_BIT);
+		void processReadbacks(bool _finishAll)
+		{
+			uint32_t num = 0;
 
-				// stall for commandbuffer to finish
-				kick(true);
+			for (ReadbackRequestVK& request : m_readbacks)
+			{
+				const bool wait = false
+					|| _finishAll
+					|| request.m_deadline <= m_readbackFrame
+					;
 
-				uint8_t* src;
-				VK_CHECK(vkMapMemory(m_device, _memory.mem, _memory.offset, _memory.size, 0, (void**)&src) );
+				if (wait
+				&&  request.m_submitted == m_cmd.m_submitted)
+				{
+					kick();
+				}
 
-				if (_swapChain.m_colorFormat == TextureFormat::RGBA8)
+				if (!m_cmd.isComplete(request.m_submitted, request.m_frameInFlight, wait) )
 				{
-					bimg::imageSwizzleBgra8(src, pitch, width, height, src, pitch);
-					_func(src, width, height, pitch, _userData);
+					break;
 				}
-				else if (_swapChain.m_colorFormat == TextureFormat::BGRA8)
+
+				if (ReadbackRequestVK::Texture == request.m_type)
 				{
-					_func(src, width, height, pitch, _userData);
+					request.m_readback.readback(request.m_memory.mem, request.m_memory.offset, request.m_data, request.m_mip);
 				}
 				else
 				{
-					const uint8_t dstBpp = bimg::getBitsPerPixel(bimg::TextureFormat::BGRA8);
-					const uint32_t dstPitch = width * dstBpp / 8;
-					const uint32_t dstSize = height * dstPitch;
-
-					void* dst = bx::alloc(g_allocator, dstSize);
-
-					bimg::imageConvert(g_allocator, dst, bimg::TextureFormat::BGRA8, src, bimg::TextureFormat::Enum(_swapChain.m_colorFormat), width, height, 1);
-
-					_func(dst, width, height, dstPitch, _userData);
-
-					bx::free(g_allocator, dst);
+					deliverSwapChain(request);
 				}
 
-				vkUnmapMemory(m_device, _memory.mem);
-
-				readback.destroy();
+				if (ReadbackRequestVK::Capture != request.m_type)
+				{
+					vkDestroy(request.m_buffer);
+					recycleMemory(request.m_memory);
+				}
 
-				return true;
+				++num;
 			}
 
-			return false;
+			m_readbacks.erase(m_readbacks.begin(), m_readbacks.begin() + num);
 		}
 
 		void capture()
@@ -4222,13 +4938,23 @@ VK_IMPORT_DEVICE
 			{
 				m_backBuffer.resolve();
 
-				auto callback = [](void* _src, uint32_t /*_width*/, uint32_t _height, uint32_t _pitch, const void* /*_userData*/)
+				const SwapChainVK& swapChain = m_backBuffer.m_swapChain;
+
+				if (isSwapChainReadable(swapChain) )
 				{
-					const uint32_t size = _height * _pitch;
-					g_callback->captureFrame(_src, size);
-				};
+					// Capture buffer of this frame in flight must be delivered
+					// before it's overwritten.
+					processReadbacks(false);
 
-				readSwapChain(m_backBuffer.m_swapChain, m_captureBuffer, m_captureMemory, callback);
+					const uint32_t frameInFlight = m_cmd.m_currentFrameInFlight;
+
+					readSwapChain(
+						  swapChain
+						, m_captureBuffer[frameInFlight]
+						, m_captureMemory[frameInFlight]
+						, ReadbackRequestVK::Capture
+						);
+				}
 			}
 		}
 
@@ -4433,9 +5159,13 @@ VK_IMPORT_DEVICE
 
 		void kick(bool _finishAll = false)
 		{
+			m_upload.close(m_commandBuffer, m_cmd);
+
 			m_cmd.kick(_finishAll);
 			VK_CHECK(m_cmd.alloc(&m_commandBuffer) );
 			m_cmd.finish(_finishAll);
+
+			m_upload.open();
 		}
 
 		int32_t selectMemoryType(uint32_t _memoryTypeBits, uint32_t _propertyFlags, int32_t _startIndex = 0) const
@@ -4462,15 +5192,22 @@ VK_IMPORT_DEVICE
 			// can be desirable when memory mapping the allocation. A memory allocation
 			// can only be mapped once. So handing out multiple subregions of one bigger
 			// allocation can lead to problems, when they get mapped multiple times.
-			// Right now, with the LRU system, we are still only handing out the full
-			// memory allocation, and never subregions of it, so it's impossible right
-			// now to map a single allocation multiple times.
-			// The argument is there to indicate this, but it's ignored right now, for the above
-			// reason: any cached memory is fine, as long as we don't partition it.
-			BX_UNUSED(_forcePrivateDeviceAllocation);
+			// Memory requested as host visible is therefore never sub-allocated, only
+			// memory that is never mapped comes from device memory pages.
+			const int32_t memoryType = selectMemoryType(requirements->memoryTypeBits, propertyFlags, 0);
+
+			if (!_forcePrivateDeviceAllocation
+			&&  0 <= memoryType
+			&&  0 == (propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) )
+			{
+				if (m_memoryAllocator.alloc(*requirements, memoryType, memory) )
+				{
+					return VK_SUCCESS;
+				}
+			}
+
 			{
 				// Check LRU cache.
-				int memoryType = selectMemoryType(requirements->memoryTypeBits, propertyFlags, 0);
 				bool found = m_memoryLru.find(bx::narrowCast<uint32_t>(requirements->size), memoryType, memory);
 				if (found)
 				{
@@ -4499,12 +5236,18 @@ VK_IMPORT_DEVICE
 					memory->memoryTypeIndex = searchIndex;
 					memory->size = bx::narrowCast<uint32_t>(ma.allocationSize);
 					memory->offset = 0;
+					memory->page = UINT16_MAX;
 					result = vkAllocateMemory(m_device, &ma, m_allocatorCb, &memory->mem);
 				}
 			}
 			while (result != VK_SUCCESS
 			   &&  searchIndex >= 0);
 
+			if (VK_SUCCESS == result)
+			{
+				m_dedicatedMemorySize += memory->size;
+			}
+
 			return result;
 		}
 
@@ -4523,6 +5266,7 @@ VK_IMPORT_DEVICE
 			bci.pQueueFamilyIndices = NULL;
 			bci.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 			bci.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+			m_upload.setSharingMode(bci);
 
 			result = vkCreateBuffer(m_device, &bci, m_allocatorCb, _buffer);
 			if (VK_SUCCESS != result)
@@ -4659,6 +5403,8 @@ VK_IMPORT_DEVICE
 		int64_t m_presentElapsed;
 
 		MemoryLruVK m_memoryLru;
+		DeviceMemoryAllocatorVK m_memoryAllocator;
+		int64_t m_dedicatedMemorySize;
 
 		ChunkedScratchBufferVK m_uniformScratchBuffer;
 		StagingScratchBufferVK m_scratchStagingBuffer[BGFX_CONFIG_MAX_FRAME_LATENCY];
@@ -4666,11 +5412,14 @@ VK_IMPORT_DEVICE
 		uint32_t        m_maxFrameLatency;
 		CommandQueueVK  m_cmd;
 		VkCommandBuffer m_commandBuffer;
+		UploadQueueVK   m_upload;
 
 		VkDevice m_device;
 		uint32_t m_globalQueueFamily;
 		VkQueue  m_globalQueue;
+		uint32_t m_transferQueueFamily;
 		VkDescriptorPool m_descriptorPool[BGFX_CONFIG_MAX_FRAME_LATENCY];
+		VkDescriptorPool m_descriptorSetCachePool;
 		VkPipelineCache  m_pipelineCache;
 
 		TimerQueryVK m_gpuTimer;
@@ -4688,29 +5437,56 @@ VK_IMPORT_DEVICE
 		FrameBufferVK  m_frameBuffers[BGFX_CONFIG_MAX_FRAME_BUFFERS];
 
 		void* m_uniforms[BGFX_CONFIG_MAX_UNIFORMS];
+		uint32_t m_uniformSize[BGFX_CONFIG_MAX_UNIFORMS];
 		Matrix4 m_predefinedUniforms[PredefinedUniform::Count];
 		UniformRegistry m_uniformReg;
 
 		StateCacheT<VkPipeline> m_pipelineStateCache;
+		FlatHashMapT<uint32_t, PipelineJobVK*> m_pipelineJobs;
+		PipelineCompilerVK m_pipelineCompiler;
+		CommandRecorderVK m_recorder;
+		RecordJobVK m_recordJob[BGFX_CONFIG_MAX_VIEWS];
 		StateCacheT<VkDescriptorSetLayout> m_descriptorSetLayoutCache;
 		StateCacheT<VkRenderPass> m_renderPassCache;
 		StateCacheT<VkSampler> m_samplerCache;
 		StateCacheT<uint32_t> m_samplerBorderColorCache;
-		StateCacheLru<VkImageView, 1024> m_imageViewCache;
+		StateCacheLru<VkImageView, BGFX_CONFIG_RENDERER_VULKAN_MAX_IMAGE_VIEWS> m_imageViewCache;
+		DescriptorSetCacheVK m_descriptorSetCache;
+		uint32_t m_numDescriptorSetsReused;
+		uint32_t m_numDescriptorSetsCreated;
+
+		VkImageLayout* m_blitLayouts;
+		uint32_t m_maxBlitLayouts;
 
 		Resolution m_resolution;
 		float m_maxAnisotropy;
 		bool m_depthClamp;
 		bool m_wireframe;
 
-		VkBuffer m_captureBuffer;
-		DeviceMemoryAllocationVK m_captureMemory;
+		VkBuffer m_captureBuffer[BGFX_CONFIG_MAX_FRAME_LATENCY];
+		DeviceMemoryAllocationVK m_captureMemory[BGFX_CONFIG_MAX_FRAME_LATENCY];
 		uint32_t m_captureSize;
 
+		stl::vector<ReadbackRequestVK> m_readbacks;
+		uint32_t m_readbackFrame;
+
 		bool m_variableRateShadingSupported;
+		bool m_extendedDynamicStateSupport;
+
+		VkDynamicState m_dynamicStates[BX_COUNTOF(s_dynamicStates) + BX_COUNTOF(s_extendedDynamicStates) + 1];
+		uint32_t m_numDynamicStates;
+
+		bool m_asyncPipelineCompile;
+		bool m_singlePipelineCache;
+		bool m_pipelineCacheDirty;
+		uint64_t m_pipelineCacheId;
+		uint32_t m_numPipelinesCompiled;
+		int64_t m_pipelineCompileTime;
 
 		TextVideoMem m_textVideoMem;
 
+		uint32_t m_maxUniformSize;
+
 		uint8_t m_fsScratch[64<<10];
 		uint8_t m_vsScratch[64<<10];
 
@@ -4778,6 +5554,9 @@ VK_DESTROY
 	{
 		if (VK_NULL_HANDLE != _obj)
 		{
+			// Only cached descriptor sets are released, per frame descriptor
+			// sets are freed by resetting per frame descriptor pool.
+			vkFreeDescriptorSets(s_renderVK->m_device, s_renderVK->m_descriptorSetCachePool, 1, &_obj);
 			_obj = VK_NULL_HANDLE;
 		}
 	}
@@ -4797,6 +5576,102 @@ VK_DESTROY
 		s_renderVK->release(_obj);
 	}
 
+	VkDescriptorSet* DescriptorSetCacheVK::find(uint64_t _hash, const void* _key, uint32_t _keySize)
+	{
+		const uint16_t* it = m_hashMap.find(_hash);
+		if (NULL != it)
+		{
+			const uint16_t handle = *it;
+			Data& data = m_data[handle];
+
+			if (_keySize == data.m_keySize
+			&&  0 == bx::memCmp(data.m_key, _key, _keySize) )
+			{
+				m_alloc.touch(handle);
+				return bx::addressOf(data.m_descriptorSet);
+			}
+		}
+
+		return NULL;
+	}
+
+	void DescriptorSetCacheVK::add(uint64_t _hash, const void* _key, uint32_t _keySize, VkDescriptorSet _descriptorSet, const uint32_t* _resource, uint8_t _num)
+	{
+		BX_ASSERT(_num <= BX_COUNTOF(m_data[0].m_resource), "Too many resources referenced by descriptor set.");
+
+		// Hash collision, entry with different key is replaced.
+		const uint16_t* it = m_hashMap.find(_hash);
+		if (NULL != it)
+		{
+			remove(*it);
+		}
+
+		uint16_t handle = m_alloc.alloc();
+		if (UINT16_MAX == handle)
+		{
+			remove(m_alloc.getBack() );
+			handle = m_alloc.alloc();
+		}
+
+		BX_ASSERT(UINT16_MAX != handle, "Failed to find handle.");
+
+		Data& data = m_data[handle];
+		data.m_hash          = _hash;
+		data.m_key           = bx::alloc(g_allocator, _keySize);
+		data.m_keySize       = _keySize;
+		data.m_descriptorSet = _descriptorSet;
+		data.m_numResources  = _num;
+		bx::memCopy(data.m_key, _key, _keySize);
+		bx::memCopy(data.m_resource, _resource, _num*sizeof(uint32_t) );
+		m_hashMap.insert(_hash, handle);
+	}
+
+	void DescriptorSetCacheVK::invalidate(uint32_t _resource)
+	{
+		for (uint16_t ii = 0; ii < m_alloc.getNumHandles();)
+		{
+			const uint16_t handle = m_alloc.getHandleAt(ii);
+			const Data& data = m_data[handle];
+
+			bool found = false;
+			for (uint32_t jj = 0; jj < data.m_numResources && !found; ++jj)
+			{
+				found = _resource == data.m_resource[jj];
+			}
+
+			if (found)
+			{
+				remove(handle);
+			}
+			else
+			{
+				++ii;
+			}
+		}
+	}
+
+	void DescriptorSetCacheVK::invalidate()
+	{
+		for (uint16_t ii = 0, num = m_alloc.getNumHandles(); ii < num; ++ii)
+		{
+			const uint16_t handle = m_alloc.getHandleAt(ii);
+			bx::free(g_allocator, m_data[handle].m_key);
+			release(m_data[handle].m_descriptorSet);
+		}
+
+		m_hashMap.reset();
+		m_alloc.reset();
+	}
+
+	void DescriptorSetCacheVK::remove(uint16_t _handle)
+	{
+		Data& data = m_data[_handle];
+		m_hashMap.removeByKey(data.m_hash);
+		m_alloc.free(_handle);
+		bx::free(g_allocator, data.m_key);
+		release(data.m_descriptorSet);
+	}
+
 	void MemoryLruVK::recycle(DeviceMemoryAllocationVK& _alloc)
 	{
 		if (MAX_ENTRIES == lru.getNumHandles() )
@@ -4805,6 +5680,7 @@ VK_DESTROY
 			uint16_t handle = lru.getBack();
 			DeviceMemoryAllocationVK& alloc = entries[handle];
 			totalSizeCached -= alloc.size;
+			s_renderVK->m_dedicatedMemorySize -= alloc.size;
 			release(alloc.mem);
 
 			// Touch slot and overwrite
@@ -4825,6 +5701,7 @@ VK_DESTROY
 			uint16_t handle = lru.getBack();
 			DeviceMemoryAllocationVK& alloc = entries[handle];
 			totalSizeCached -= alloc.size;
+			s_renderVK->m_dedicatedMemorySize -= alloc.size;
 			release(alloc.mem);
 			lru.free(handle);
 		}
@@ -4894,6 +5771,7 @@ VK_DESTROY
 
 		while (slot != UINT16_MAX)
 		{
+			s_renderVK->m_dedicatedMemorySize -= entries[slot].size;
 			release(entries[slot].mem);
 			slot = lru.getNext(slot);
 		}
@@ -4902,45 +5780,212 @@ VK_DESTROY
 		totalSizeCached = 0;
 	}
 
-	void StagingScratchBufferVK::create(uint32_t _size, uint32_t _count, VkBufferUsageFlags usage, uint32_t _align)
+	void DeviceMemoryAllocatorVK::init(const VkPhysicalDeviceMemoryProperties& _memoryProperties, uint32_t _granularity)
 	{
-		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
-		const VkDevice device = s_renderVK->m_device;
-
-		const uint32_t entrySize = bx::strideAlign(_size, _align);
-		const uint32_t chunkSize = entrySize * _count;
+		m_granularity = bx::max<uint32_t>(_granularity, 1);
 
-		VkBufferCreateInfo bci;
-		bci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-		bci.pNext = NULL;
-		bci.flags = 0;
-		bci.size  = chunkSize;
-		bci.usage = usage;
-		bci.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
-		bci.queueFamilyIndexCount = 0;
-		bci.pQueueFamilyIndices   = NULL;
+		for (uint32_t ii = 0; ii < _memoryProperties.memoryTypeCount; ++ii)
+		{
+			// Don't let single page take big chunk of small heaps.
+			const VkDeviceSize heapSize = _memoryProperties.memoryHeaps[_memoryProperties.memoryTypes[ii].heapIndex].size;
+			uint32_t pageSize = BGFX_CONFIG_DEVICE_MEMORY_PAGE_SIZE;
 
-		VK_CHECK(vkCreateBuffer(
-			  device
-			, &bci
-			, allocatorCb
-			, &m_buffer
-			) );
+			while (pageSize > (1<<20)
+			&&     pageSize > heapSize / 8)
+			{
+				pageSize >>= 1;
+			}
 
-		VkMemoryRequirements mr;
-		vkGetBufferMemoryRequirements(
-			  device
-			, m_buffer
-			, &mr
-			);
+			m_pageSize[ii] = pageSize;
+		}
+	}
 
-		VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-		VkResult result = s_renderVK->allocateMemory(&mr, flags, &m_deviceMem, true);
+	void DeviceMemoryAllocatorVK::shutdown()
+	{
+		const VkDevice device = s_renderVK->m_device;
+		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
 
-		if (VK_SUCCESS != result)
+		while (0 < m_pageHandle.getNumHandles() )
 		{
-			flags &= ~VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-			VK_CHECK(s_renderVK->allocateMemory(&mr, flags, &m_deviceMem, true) );
+			const uint16_t handle = m_pageHandle.getHandleAt(0);
+			Page* page = m_page[handle];
+
+			BX_WARN(page->allocator.compact(), "Device memory page %d is still in use.", handle);
+
+			vkFreeMemory(device, page->mem, allocatorCb);
+			bx::deleteObject(g_allocator, page);
+
+			m_page[handle] = NULL;
+			m_pageHandle.free(handle);
+		}
+
+		m_used     = 0;
+		m_reserved = 0;
+	}
+
+	bool DeviceMemoryAllocatorVK::alloc(const VkMemoryRequirements& _requirements, int32_t _memoryTypeIndex, DeviceMemoryAllocationVK* _alloc)
+	{
+		BGFX_PROFILER_SCOPE("DeviceMemoryAllocatorVK::alloc", kColorResource);
+
+		const uint32_t pageSize = m_pageSize[_memoryTypeIndex];
+
+		if (_requirements.size > pageSize / 2)
+		{
+			return false;
+		}
+
+		// Rounding both size and alignment to granularity guarantees that
+		// linear and optimal resources never end up next to each other
+		// within the same granularity block.
+		const uint32_t size  = bx::alignUp(uint32_t(_requirements.size), m_granularity);
+		const uint32_t align = bx::max<uint32_t>(uint32_t(_requirements.alignment), m_granularity);
+
+		for (uint16_t ii = 0, num = m_pageHandle.getNumHandles(); ii < num; ++ii)
+		{
+			const uint16_t handle = m_pageHandle.getHandleAt(ii);
+			Page* page = m_page[handle];
+
+			if (page->memoryTypeIndex == _memoryTypeIndex)
+			{
+				const uint64_t offset = page->allocator.alloc(size, align);
+
+				if (NonLocalAllocator::kInvalidBlock != offset)
+				{
+					_alloc->mem    = page->mem;
+					_alloc->offset = uint32_t(offset);
+					_alloc->size   = size;
+					_alloc->memoryTypeIndex = _memoryTypeIndex;
+					_alloc->page   = handle;
+
+					m_used += size;
+					return true;
+				}
+			}
+		}
+
+		if (BGFX_CONFIG_MAX_DEVICE_MEMORY_PAGES == m_pageHandle.getNumHandles() )
+		{
+			return false;
+		}
+
+		VkMemoryAllocateInfo ma;
+		ma.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		ma.pNext = NULL;
+		ma.allocationSize  = pageSize;
+		ma.memoryTypeIndex = _memoryTypeIndex;
+
+		VkDeviceMemory mem;
+
+		{
+			BGFX_PROFILER_SCOPE("vkAllocateMemory", kColorResource);
+
+			if (VK_SUCCESS != vkAllocateMemory(s_renderVK->m_device, &ma, s_renderVK->m_allocatorCb, &mem) )
+			{
+				return false;
+			}
+		}
+
+		const uint16_t handle = m_pageHandle.alloc();
+
+		Page* page = BX_NEW(g_allocator, Page);
+		page->mem = mem;
+		page->memoryTypeIndex = _memoryTypeIndex;
+		page->allocator.add(0, pageSize);
+		m_page[handle] = page;
+
+		m_reserved += pageSize;
+
+		const uint64_t offset = page->allocator.alloc(size, align);
+		BX_ASSERT(NonLocalAllocator::kInvalidBlock != offset, "Failed to sub-allocate from empty device memory page.");
+
+		_alloc->mem    = page->mem;
+		_alloc->offset = uint32_t(offset);
+		_alloc->size   = size;
+		_alloc->memoryTypeIndex = _memoryTypeIndex;
+		_alloc->page   = handle;
+
+		m_used += size;
+		return true;
+	}
+
+	void DeviceMemoryAllocatorVK::free(const DeviceMemoryAllocationVK& _alloc)
+	{
+		Page* page = m_page[_alloc.page];
+		BX_ASSERT(NULL != page && page->mem == _alloc.mem, "Invalid device memory page %d.", _alloc.page);
+
+		page->allocator.free(_alloc.offset);
+		m_used -= _alloc.size;
+
+		if (page->allocator.compact() )
+		{
+			// Keep one empty page around per memory type, to avoid allocating
+			// and freeing page when single resource is created and destroyed
+			// repeatedly.
+			uint32_t numPages = 0;
+
+			for (uint16_t ii = 0, num = m_pageHandle.getNumHandles(); ii < num; ++ii)
+			{
+				numPages += m_page[m_pageHandle.getHandleAt(ii)]->memoryTypeIndex == page->memoryTypeIndex;
+			}
+
+			if (1 < numPages)
+			{
+				BGFX_PROFILER_SCOPE("vkFreeMemory", kColorResource);
+
+				vkFreeMemory(s_renderVK->m_device, page->mem, s_renderVK->m_allocatorCb);
+				m_reserved -= m_pageSize[page->memoryTypeIndex];
+
+				bx::deleteObject(g_allocator, page);
+				m_page[_alloc.page] = NULL;
+				m_pageHandle.free(_alloc.page);
+			}
+		}
+	}
+
+	void StagingScratchBufferVK::create(uint32_t _size, uint32_t _count, VkBufferUsageFlags usage, uint32_t _align)
+	{
+		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
+		const VkDevice device = s_renderVK->m_device;
+
+		const uint32_t entrySize = bx::strideAlign(_size, _align);
+		const uint32_t chunkSize = entrySize * _count;
+
+		VkBufferCreateInfo bci;
+		bci.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+		bci.pNext = NULL;
+		bci.flags = 0;
+		bci.size  = chunkSize;
+		bci.usage = usage;
+		bci.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
+		bci.queueFamilyIndexCount = 0;
+		bci.pQueueFamilyIndices   = NULL;
+
+		if (0 != (usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT) )
+		{
+			s_renderVK->m_upload.setSharingMode(bci);
+		}
+
+		VK_CHECK(vkCreateBuffer(
+			  device
+			, &bci
+			, allocatorCb
+			, &m_buffer
+			) );
+
+		VkMemoryRequirements mr;
+		vkGetBufferMemoryRequirements(
+			  device
+			, m_buffer
+			, &mr
+			);
+
+		VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+		VkResult result = s_renderVK->allocateMemory(&mr, flags, &m_deviceMem, true);
+
+		if (VK_SUCCESS != result)
+		{
+			flags &= ~VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+			VK_CHECK(s_renderVK->allocateMemory(&mr, flags, &m_deviceMem, true) );
 		}
 
 		m_size = (uint32_t)mr.size;
@@ -5180,6 +6225,46 @@ VK_DESTROY
 		bx::memCopy(&sbc.data[offset1], _fsData, _fsSize);
 	}
 
+	void ChunkedScratchBufferVK::allocSlab(ChunkedScratchBufferSlab& _outSlab, uint32_t _minSize)
+	{
+		const uint32_t size = bx::strideAlign(bx::max(_minSize, m_chunkSize/8), m_align);
+
+		const ChunkedScratchBufferAlloc sba = alloc(size);
+
+		const Chunk& sbc = m_chunks[sba.chunkIdx];
+
+		_outSlab.buffer = sbc.buffer;
+		_outSlab.data   = sbc.data;
+		_outSlab.offset = sba.offset;
+		_outSlab.size   = sba.offset + size;
+	}
+
+	bool ChunkedScratchBufferVK::write(ChunkedScratchBufferSlab& _slab, ChunkedScratchBufferOffset& _outSbo, const void* _vsData, uint32_t _vsSize, const void* _fsData, uint32_t _fsSize) const
+	{
+		const uint32_t vsSize = bx::strideAlign(_vsSize, m_align);
+		const uint32_t fsSize = bx::strideAlign(_fsSize, m_align);
+		const uint32_t size   = vsSize + fsSize;
+
+		if (_slab.offset + size > _slab.size)
+		{
+			return false;
+		}
+
+		const uint32_t offset0 = _slab.offset;
+		const uint32_t offset1 = offset0 + vsSize;
+
+		_outSbo.buffer = _slab.buffer;
+		_outSbo.offsets[0] = offset0;
+		_outSbo.offsets[1] = offset1;
+
+		bx::memCopy(&_slab.data[offset0], _vsData, _vsSize);
+		bx::memCopy(&_slab.data[offset1], _fsData, _fsSize);
+
+		_slab.offset += size;
+
+		return true;
+	}
+
 	void ChunkedScratchBufferVK::begin()
 	{
 		BX_ASSERT(0 == m_chunkPos, "");
@@ -5212,12 +6297,12 @@ retry:
 
 		VkDevice device = s_renderVK->m_device;
 
-		const uint32_t numReserved = m_chunkControl.getNumReserved();
-		BX_ASSERT(0 == numReserved % m_chunkSize, "Number of reserved must always be aligned to chunk size!");
+		const uint32_t reservedSize = m_chunkControl.getNumReserved();
+		BX_ASSERT(0 == reservedSize % m_chunkSize, "Number of reserved must always be aligned to chunk size!");
 
 		const uint32_t first = m_chunkControl.m_current / m_chunkSize;
 
-		for (uint32_t ii = first, end = numReserved / m_chunkSize + first; ii < end; ++ii)
+		for (uint32_t ii = first, end = reservedSize / m_chunkSize + first; ii < end; ++ii)
 		{
 			const Chunk& chunk = m_chunks[ii % m_chunks.size()];
 
@@ -5233,7 +6318,7 @@ retry:
 			numFlush -= m_chunkSize;
 		}
 
-		m_consume[s_renderVK->m_cmd.m_currentFrameInFlight] = numReserved;
+		m_consume[s_renderVK->m_cmd.m_currentFrameInFlight] = reservedSize;
 
 		m_totalUsed = m_chunkControl.getNumUsed();
 	}
@@ -5277,6 +6362,10 @@ retry:
 
 		if (!m_dynamic)
 		{
+			// Static buffer isn't referenced by any frame in flight, its content
+			// can be uploaded on upload queue.
+			m_uploadPending = s_renderVK->m_upload.claim(*this);
+
 			update(_commandBuffer, 0, _size, _data);
 		}
 	}
@@ -5292,13 +6381,21 @@ retry:
 		region.srcOffset = stagingBuffer.m_offset;
 		region.dstOffset = _offset;
 		region.size      = _size;
-		vkCmdCopyBuffer(_commandBuffer, stagingBuffer.m_buffer, m_buffer, 1, &region);
 
-		setMemoryBarrier(
-			  _commandBuffer
-			, VK_PIPELINE_STAGE_TRANSFER_BIT
-			, VK_PIPELINE_STAGE_TRANSFER_BIT
-			);
+		if (m_uploadPending)
+		{
+			s_renderVK->m_upload.copyBuffer(*this, stagingBuffer.m_buffer, region);
+		}
+		else
+		{
+			vkCmdCopyBuffer(_commandBuffer, stagingBuffer.m_buffer, m_buffer, 1, &region);
+
+			setMemoryBarrier(
+				  _commandBuffer
+				, VK_PIPELINE_STAGE_TRANSFER_BIT
+				, VK_PIPELINE_STAGE_TRANSFER_BIT
+				);
+		}
 
 		if (!stagingBuffer.m_isFromScratch)
 		{
@@ -5315,6 +6412,7 @@ retry:
 			s_renderVK->recycleMemory(m_deviceMem);
 
 			m_dynamic = false;
+			m_uploadPending = false;
 		}
 	}
 
@@ -5324,6 +6422,34 @@ retry:
 		m_layoutHandle = _layoutHandle;
 	}
 
+	static bool hasPushConstants(const uint32_t* _spirv, uint32_t _numWords)
+	{
+		// Skip header: magic, version, generator, bound, and schema.
+		for (uint32_t ii = 5; ii < _numWords;)
+		{
+			const uint32_t opcode    = _spirv[ii] & 0xffff;
+			const uint32_t wordCount = _spirv[ii] >> 16;
+
+			if (0 == wordCount
+			||  ii + wordCount > _numWords)
+			{
+				break;
+			}
+
+			// OpVariable: result type, result id, storage class.
+			if (SpvOpcode::Variable == opcode
+			&&  4 <= wordCount
+			&&  SpvStorageClass::PushConstant == _spirv[ii + 3])
+			{
+				return true;
+			}
+
+			ii += wordCount;
+		}
+
+		return false;
+	}
+
 	void ShaderVK::create(const Memory* _mem)
 	{
 		bx::MemoryReader reader(_mem->data, _mem->size);
@@ -5615,6 +6741,20 @@ retry:
 
 		bx::read(&reader, m_size, &err);
 
+		m_pushConstantRange.stageFlags = shaderStage;
+		m_pushConstantRange.offset     = 0;
+		m_pushConstantRange.size       = 0;
+
+		if (m_size > 0
+		&&  hasPushConstants( (const uint32_t*)m_code->data, m_code->size/sizeof(uint32_t) ) )
+		{
+			// Uniform block was placed in push constants by shaderc, fragment
+			// shader block starts after vertex shader one.
+			m_pushConstantRange.offset = fragment ? kSpirvPushConstantFragmentOffset : 0;
+			m_pushConstantRange.size   = m_size - m_pushConstantRange.offset;
+			m_size = 0;
+		}
+
 		// fill binding description with uniform information
 		uint16_t bidx = 0;
 		if (m_size > 0)
@@ -5839,12 +6979,28 @@ retry:
 			}
 		}
 
+		VkPushConstantRange pushConstantRanges[2];
+		uint32_t numPushConstantRanges = 0;
+
+		if (0 < m_vsh->m_pushConstantRange.size)
+		{
+			pushConstantRanges[numPushConstantRanges++] = m_vsh->m_pushConstantRange;
+		}
+
+		if (NULL != m_fsh
+		&&  0 < m_fsh->m_pushConstantRange.size)
+		{
+			pushConstantRanges[numPushConstantRanges++] = m_fsh->m_pushConstantRange;
+		}
+
+		m_pushConstants = 0 < numPushConstantRanges;
+
 		VkPipelineLayoutCreateInfo plci;
 		plci.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
 		plci.pNext = NULL;
 		plci.flags = 0;
-		plci.pushConstantRangeCount = 0;
-		plci.pPushConstantRanges = NULL;
+		plci.pushConstantRangeCount = numPushConstantRanges;
+		plci.pPushConstantRanges = pushConstantRanges;
 		plci.setLayoutCount = (m_descriptorSetLayout == VK_NULL_HANDLE ? 0 : 1);
 		plci.pSetLayouts = &m_descriptorSetLayout;
 
@@ -5862,950 +7018,1703 @@ retry:
 		m_numPredefined = 0;
 		m_vsh = NULL;
 		m_fsh = NULL;
+		m_pushConstants = false;
 	}
 
-	VkResult TimerQueryVK::init()
+	void ProgramVK::pushConstants(VkCommandBuffer _commandBuffer, const uint8_t* _vsData, const uint8_t* _fsData) const
 	{
-		BGFX_PROFILER_SCOPE("TimerQueryVK::init", kColorFrame);
-		VkResult result = VK_SUCCESS;
+		const VkPushConstantRange& vsRange = m_vsh->m_pushConstantRange;
 
-		const VkDevice device = s_renderVK->m_device;
-		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+		if (0 < vsRange.size)
+		{
+			vkCmdPushConstants(
+				  _commandBuffer
+				, m_pipelineLayout
+				, vsRange.stageFlags
+				, vsRange.offset
+				, vsRange.size
+				, &_vsData[vsRange.offset]
+				);
+		}
 
-		const uint32_t count = m_control.m_size * 2;
+		if (NULL != m_fsh)
+		{
+			const VkPushConstantRange& fsRange = m_fsh->m_pushConstantRange;
 
-		VkQueryPoolCreateInfo qpci;
-		qpci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
-		qpci.pNext = NULL;
-		qpci.flags = 0;
-		qpci.queryType = VK_QUERY_TYPE_TIMESTAMP;
-		qpci.queryCount = count;
-		qpci.pipelineStatistics = 0;
+			if (0 < fsRange.size)
+			{
+				vkCmdPushConstants(
+					  _commandBuffer
+					, m_pipelineLayout
+					, fsRange.stageFlags
+					, fsRange.offset
+					, fsRange.size
+					, &_fsData[fsRange.offset]
+					);
+			}
+		}
+	}
 
-		result = vkCreateQueryPool(device, &qpci, s_renderVK->m_allocatorCb, &m_queryPool);
+	void PipelineCompilerVK::init(uint32_t _numThreads)
+	{
+		m_workHead = NULL;
+		m_workTail = NULL;
+		m_doneHead = NULL;
+		m_exit     = false;
 
-		if (VK_SUCCESS != result)
+#if BX_CONFIG_SUPPORTS_THREADING
+		m_numThreads = bx::min<uint32_t>(_numThreads, BGFX_CONFIG_MAX_PIPELINE_THREADS);
+
+		for (uint32_t ii = 0; ii < m_numThreads; ++ii)
 		{
-			BX_TRACE("Create timer query error: vkCreateQueryPool failed %d: %s.", result, getName(result) );
-			return result;
+			m_thread[ii].init(threadFunc, this, 0, "bgfx - pipeline thread");
 		}
+#else
+		BX_UNUSED(_numThreads);
+		m_numThreads = 0;
+#endif // BX_CONFIG_SUPPORTS_THREADING
+	}
 
-		vkCmdResetQueryPool(commandBuffer, m_queryPool, 0, count);
+	void PipelineCompilerVK::shutdown()
+	{
+#if BX_CONFIG_SUPPORTS_THREADING
+		if (0 < m_numThreads)
+		{
+			{
+				bx::MutexScope scope(m_mutex);
+				m_exit = true;
+			}
 
-		const uint32_t size = count * sizeof(uint64_t);
-		result = s_renderVK->createReadbackBuffer(size, &m_readback, &m_readbackMemory);
+			for (uint32_t ii = 0; ii < m_numThreads; ++ii)
+			{
+				m_workSem.post();
+			}
 
-		if (VK_SUCCESS != result)
-		{
-			return result;
+			for (uint32_t ii = 0; ii < m_numThreads; ++ii)
+			{
+				m_thread[ii].shutdown();
+			}
 		}
+#endif // BX_CONFIG_SUPPORTS_THREADING
 
-		result = vkMapMemory(device, m_readbackMemory.mem, m_readbackMemory.offset, VK_WHOLE_SIZE, 0, (void**)&m_queryResult);
+		m_numThreads = 0;
+	}
 
-		if (VK_SUCCESS != result)
+	void PipelineCompilerVK::push(PipelineJobVK* _job)
+	{
+#if BX_CONFIG_SUPPORTS_THREADING
 		{
-			BX_TRACE("Create timer query error: vkMapMemory failed %d: %s.", result, getName(result) );
-			return result;
-		}
+			bx::MutexScope scope(m_mutex);
 
-		m_frequency = uint64_t(1000000000.0 / double(s_renderVK->m_deviceProperties.properties.limits.timestampPeriod) );
+			_job->m_next = NULL;
 
-		for (uint32_t ii = 0; ii < BX_COUNTOF(m_result); ++ii)
-		{
-			m_result[ii].reset();
-		}
+			if (NULL == m_workTail)
+			{
+				m_workHead = _job;
+			}
+			else
+			{
+				m_workTail->m_next = _job;
+			}
 
-		m_control.reset();
+			m_workTail = _job;
+		}
 
-		return result;
+		m_workSem.post();
+#else
+		BX_UNUSED(_job);
+#endif // BX_CONFIG_SUPPORTS_THREADING
 	}
 
-	void TimerQueryVK::shutdown()
+	PipelineJobVK* PipelineCompilerVK::pop(bool _wait)
 	{
-		vkDestroy(m_queryPool);
-		vkDestroy(m_readback);
-		vkUnmapMemory(s_renderVK->m_device, m_readbackMemory.mem);
-		s_renderVK->recycleMemory(m_readbackMemory);
-	}
+#if BX_CONFIG_SUPPORTS_THREADING
+		// Done semaphore is posted once per finished job.
+		if (m_doneSem.wait(_wait ? -1 : 0) )
+		{
+			bx::MutexScope scope(m_mutex);
 
-	uint32_t TimerQueryVK::begin(uint32_t _resultIdx, uint32_t _frameNum)
-	{
-		BGFX_PROFILER_SCOPE("TimerQueryVK::begin", kColorFrame);
+			PipelineJobVK* job = m_doneHead;
+			m_doneHead = job->m_next;
 
-		while (0 == m_control.reserve(1) )
-		{
-			m_control.consume(1);
+			return job;
 		}
+#else
+		BX_UNUSED(_wait);
+#endif // BX_CONFIG_SUPPORTS_THREADING
 
-		Result& result = m_result[_resultIdx];
-		++result.m_pending;
+		return NULL;
+	}
 
-		const uint32_t idx = m_control.m_current;
-		Query& query = m_query[idx];
-		query.m_resultIdx = _resultIdx;
-		query.m_ready     = false;
-		query.m_frameNum  = _frameNum;
+	int32_t PipelineCompilerVK::threadFunc(bx::Thread* /*_self*/, void* _userData)
+	{
+		BGFX_PROFILER_SET_CURRENT_THREAD_NAME("bgfx - Pipeline Thread");
 
-		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
-		const uint32_t offset = idx * 2 + 0;
+#if BX_CONFIG_SUPPORTS_THREADING
+		PipelineCompilerVK* compiler = (PipelineCompilerVK*)_userData;
 
-		vkCmdResetQueryPool(commandBuffer, m_queryPool, offset, 2);
-		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, offset + 0);
+		for (;;)
+		{
+			compiler->m_workSem.wait();
 
-		m_control.commit(1);
+			PipelineJobVK* job;
 
-		return idx;
-	}
+			{
+				bx::MutexScope scope(compiler->m_mutex);
 
-	void TimerQueryVK::end(uint32_t _idx)
-	{
-		BGFX_PROFILER_SCOPE("TimerQueryVK::end", kColorFrame);
+				if (compiler->m_exit)
+				{
+					break;
+				}
 
-		Query& query = m_query[_idx];
-		query.m_ready = true;
-		query.m_completed = s_renderVK->m_cmd.m_submitted + s_renderVK->m_maxFrameLatency;
+				job = compiler->m_workHead;
+				compiler->m_workHead = job->m_next;
 
-		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
-		const uint32_t offset = _idx * 2 + 0;
+				if (NULL == compiler->m_workHead)
+				{
+					compiler->m_workTail = NULL;
+				}
+			}
 
-		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, offset + 1);
+			s_renderVK->compilePipeline(*job);
 
-		vkCmdCopyQueryPoolResults(
-			  commandBuffer
-			, m_queryPool
-			, offset
-			, 2
-			, m_readback
-			, offset * sizeof(uint64_t)
-			, sizeof(uint64_t)
-			, VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT
-			);
+			{
+				bx::MutexScope scope(compiler->m_mutex);
 
-		setMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+				job->m_next = compiler->m_doneHead;
+				compiler->m_doneHead = job;
+			}
 
-		while (update() )
+			compiler->m_doneSem.post();
+		}
+#else
+		BX_UNUSED(_userData);
+#endif // BX_CONFIG_SUPPORTS_THREADING
+
+		return bx::kExitSuccess;
+	}
+
+	void RecordStateVK::reset()
+	{
+		m_currentState.clear();
+		m_currentState.m_stateFlags = BGFX_STATE_NONE;
+		m_currentState.m_stencil    = packStencil(BGFX_STENCIL_NONE, BGFX_STENCIL_NONE);
+
+		m_currentProgram       = BGFX_INVALID_HANDLE;
+		m_currentPipeline      = VK_NULL_HANDLE;
+		m_currentDescriptorSet = VK_NULL_HANDLE;
+		m_currentBindHash      = 0;
+		m_currentIndexFormat   = VK_INDEX_TYPE_MAX_ENUM;
+		m_blendFactor          = UINT64_MAX;
+		m_dynamicState         = UINT64_MAX;
+		m_dynamicStencil       = UINT64_MAX;
+		m_hasPredefined        = false;
+		m_viewHasScissor       = false;
+		m_restoreScissor       = false;
+		m_viewScissorRect.clear();
+	}
+
+	void RecordStateVK::resetStats()
+	{
+		bx::memSet(m_numPrimsSubmitted, 0, sizeof(m_numPrimsSubmitted) );
+		bx::memSet(m_numPrimsRendered,  0, sizeof(m_numPrimsRendered) );
+		bx::memSet(m_numInstances,      0, sizeof(m_numInstances) );
+		m_numIndices        = 0;
+		m_numDrawSkipped    = 0;
+		m_numDescriptorSets = 0;
+	}
+
+	void RecordStateVK::addStats(const RecordStateVK& _state)
+	{
+		for (uint32_t ii = 0; ii < Topology::Count; ++ii)
 		{
+			m_numPrimsSubmitted[ii] += _state.m_numPrimsSubmitted[ii];
+			m_numPrimsRendered[ii]  += _state.m_numPrimsRendered[ii];
+			m_numInstances[ii]      += _state.m_numInstances[ii];
 		}
+
+		m_numIndices        += _state.m_numIndices;
+		m_numDrawSkipped    += _state.m_numDrawSkipped;
+		m_numDescriptorSets += _state.m_numDescriptorSets;
 	}
 
-	bool TimerQueryVK::update()
+	void RecordStateVK::update(const UniformBuffer& _uniformBuffer, uint32_t _begin, uint32_t _end)
 	{
-		if (0 != m_control.getNumUsed() )
+		// Same as rendererUpdateUniforms, but it doesn't modify read position
+		// of uniform buffer, since it can be read by multiple threads.
+		for (uint32_t pos = _begin; pos < _end;)
 		{
-			uint32_t idx = m_control.m_read;
-			Query& query = m_query[idx];
+			uint32_t opcode;
+			bx::memCopy(&opcode, _uniformBuffer.getData(pos), sizeof(uint32_t) );
+			pos += sizeof(uint32_t);
 
-			if (!query.m_ready)
+			if (UniformType::End == opcode)
 			{
-				return false;
+				break;
 			}
 
-			if (query.m_completed > s_renderVK->m_cmd.m_submitted)
-			{
-				return false;
-			}
+			uint8_t type;
+			uint16_t loc;
+			uint16_t num;
+			uint16_t copy;
+			UniformBuffer::decodeOpcode(opcode, type, loc, num, copy);
 
-			m_control.consume(1);
+			const uint32_t size = g_uniformTypeSize[type]*num;
+			const char* data = (const char*)_uniformBuffer.getData(pos);
+			pos += size;
 
-			Result& result = m_result[query.m_resultIdx];
-			--result.m_pending;
-			result.m_frameNum = query.m_frameNum;
+			if (UniformType::Count > type)
+			{
+				bx::memCopy(m_uniforms[loc], copy ? data : *(const char**)(data), size);
+			}
+			else if (BX_ENABLED(BGFX_CONFIG_DEBUG_ANNOTATION) )
+			{
+				const uint32_t abgr = kColorMarker;
 
-			uint32_t offset = idx * 2;
-			result.m_begin  = m_queryResult[offset+0];
-			result.m_end    = m_queryResult[offset+1];
+				VkDebugUtilsLabelEXT dul;
+				dul.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+				dul.pNext = NULL;
+				dul.pLabelName = data;
+				dul.color[0] = ( (abgr >> 24) & 0xff) / 255.0f;
+				dul.color[1] = ( (abgr >> 16) & 0xff) / 255.0f;
+				dul.color[2] = ( (abgr >> 8)  & 0xff) / 255.0f;
+				dul.color[3] = ( (abgr >> 0)  & 0xff) / 255.0f;
 
-			return true;
+				vkCmdInsertDebugUtilsLabelEXT(m_commandBuffer, &dul);
+			}
 		}
-
-		return false;
 	}
 
-	VkResult OcclusionQueryVK::init()
+	void RecordStateVK::commit(const UniformBuffer& _uniformBuffer)
 	{
-		BGFX_PROFILER_SCOPE("OcclusionQueryVK::init", kColorFrame);
+		for (uint32_t pos = 0;;)
+		{
+			uint32_t opcode;
+			bx::memCopy(&opcode, _uniformBuffer.getData(pos), sizeof(uint32_t) );
+			pos += sizeof(uint32_t);
 
-		VkResult result = VK_SUCCESS;
+			if (UniformType::End == opcode)
+			{
+				break;
+			}
 
-		const VkDevice device = s_renderVK->m_device;
-		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+			uint8_t type;
+			uint16_t loc;
+			uint16_t num;
+			uint16_t copy;
+			UniformBuffer::decodeOpcode(opcode, type, loc, num, copy);
 
-		const uint32_t count = BX_COUNTOF(m_handle);
+			const char* data;
+			if (copy)
+			{
+				data = (const char*)_uniformBuffer.getData(pos);
+				pos += g_uniformTypeSize[type]*num;
+			}
+			else
+			{
+				UniformHandle handle;
+				bx::memCopy(&handle, _uniformBuffer.getData(pos), sizeof(UniformHandle) );
+				pos += sizeof(UniformHandle);
+				data = (const char*)m_uniforms[handle.idx];
+			}
 
-		VkQueryPoolCreateInfo qpci;
-		qpci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
-		qpci.pNext = NULL;
-		qpci.flags = 0;
-		qpci.queryType = VK_QUERY_TYPE_OCCLUSION;
-		qpci.queryCount = count;
-		qpci.pipelineStatistics = 0;
+			switch (type)
+			{
+			case UniformType::Mat3:
+			case UniformType::Mat3|kUniformFragmentBit:
+				{
+					float* value = (float*)data;
+					for (uint32_t ii = 0, count = num/3; ii < count; ++ii,  loc += 3*16, value += 9)
+					{
+						Matrix4 mtx;
+						mtx.un.val[ 0] = value[0];
+						mtx.un.val[ 1] = value[1];
+						mtx.un.val[ 2] = value[2];
+						mtx.un.val[ 3] = 0.0f;
+						mtx.un.val[ 4] = value[3];
+						mtx.un.val[ 5] = value[4];
+						mtx.un.val[ 6] = value[5];
+						mtx.un.val[ 7] = 0.0f;
+						mtx.un.val[ 8] = value[6];
+						mtx.un.val[ 9] = value[7];
+						mtx.un.val[10] = value[8];
+						mtx.un.val[11] = 0.0f;
+						setShaderUniform(uint8_t(type), loc, &mtx.un.val[0], 3);
+					}
+				}
+				break;
 
-		result = vkCreateQueryPool(device, &qpci, s_renderVK->m_allocatorCb, &m_queryPool);
+			case UniformType::Sampler:
+			case UniformType::Sampler|kUniformFragmentBit:
+				// do nothing, but VkDescriptorSetImageInfo would be set before drawing
+				break;
 
-		if (VK_SUCCESS != result)
-		{
-			BX_TRACE("Create occlusion query error: vkCreateQueryPool failed %d: %s.", result, getName(result) );
-			return result;
-		}
+			case UniformType::Vec4:
+			case UniformType::Vec4 | kUniformFragmentBit:
+			case UniformType::Mat4:
+			case UniformType::Mat4 | kUniformFragmentBit:
+				{
+					setShaderUniform(uint8_t(type), loc, data, num);
+				}
+				break;
 
-		vkCmdResetQueryPool(commandBuffer, m_queryPool, 0, count);
+			case UniformType::End:
+				break;
 
-		const uint32_t size = count * sizeof(uint32_t);
-		result = s_renderVK->createReadbackBuffer(size, &m_readback, &m_readbackMemory);
+			default:
+				BX_TRACE("%4d: INVALID 0x%08x, t %d, l %d, n %d, c %d", pos, opcode, type, loc, num, copy);
+				break;
+			}
+		}
+	}
 
-		if (VK_SUCCESS != result)
+	void RecordStateVK::setShaderUniform(uint8_t _flags, uint32_t _regIndex, const void* _val, uint32_t _numRegs)
+	{
+		if (_flags & kUniformFragmentBit)
 		{
-			return result;
+			bx::memCopy(&m_fsScratch[_regIndex], _val, _numRegs*16);
 		}
-
-		result = vkMapMemory(device, m_readbackMemory.mem, m_readbackMemory.offset, VK_WHOLE_SIZE, 0, (void**)&m_queryResult);
-
-		if (VK_SUCCESS != result)
+		else
 		{
-			BX_TRACE("Create occlusion query error: vkMapMemory failed %d: %s.", result, getName(result) );
-			return result;
+			bx::memCopy(&m_vsScratch[_regIndex], _val, _numRegs*16);
 		}
-
-		m_control.reset();
-
-		return result;
 	}
 
-	void OcclusionQueryVK::shutdown()
+	RecordThreadVK::RecordThreadVK()
+		: m_recorder(NULL)
+		, m_uniformCacheItem(0)
+		, m_resetViewState(true)
+		, m_frameInFlight(0)
+		, m_numCommandBuffers(0)
+		, m_fsScratch(NULL)
+		, m_vsScratch(NULL)
+		, m_scratchSize(0)
 	{
-		vkDestroy(m_queryPool);
-		vkDestroy(m_readback);
-		vkUnmapMemory(s_renderVK->m_device, m_readbackMemory.mem);
-		s_renderVK->recycleMemory(m_readbackMemory);
+		bx::memSet(m_commandPool, 0, sizeof(m_commandPool) );
+		bx::memSet(m_uniforms, 0, sizeof(m_uniforms) );
+		bx::memSet(m_uniformSize, 0, sizeof(m_uniformSize) );
+		bx::memSet(&m_slab, 0, sizeof(m_slab) );
+
+		m_state.m_commandBuffer = VK_NULL_HANDLE;
+		m_state.m_fbh           = BGFX_INVALID_HANDLE;
+		m_state.m_uniforms      = m_uniforms;
+		m_state.m_vsScratch     = m_vsScratch;
+		m_state.m_fsScratch     = m_fsScratch;
+		m_state.m_slab          = &m_slab;
+		m_state.m_isFrameBufferValid = true;
+		m_state.reset();
+		m_state.resetStats();
 	}
 
-	void OcclusionQueryVK::begin(OcclusionQueryHandle _handle)
+	VkResult RecordThreadVK::init(CommandRecorderVK* _recorder)
 	{
-		BGFX_PROFILER_SCOPE("OcclusionQueryVK::shutdown", kColorFrame);
+		m_recorder = _recorder;
 
-		m_control.reserve(1);
+		VkCommandPoolCreateInfo cpci;
+		cpci.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		cpci.pNext = NULL;
+		cpci.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		cpci.queueFamilyIndex = s_renderVK->m_globalQueueFamily;
 
-		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
+		const VkDevice device = s_renderVK->m_device;
 
-		m_handle[m_control.m_current] = _handle;
-		vkCmdBeginQuery(commandBuffer, m_queryPool, _handle.idx, 0);
+		for (uint32_t ii = 0, maxFrameLatency = s_renderVK->m_maxFrameLatency; ii < maxFrameLatency; ++ii)
+		{
+			const VkResult result = vkCreateCommandPool(
+				  device
+				, &cpci
+				, allocatorCb
+				, &m_commandPool[ii]
+				);
+
+			if (VK_SUCCESS != result)
+			{
+				BX_TRACE("Create record thread error: vkCreateCommandPool failed %d: %s.", result, getName(result) );
+				return result;
+			}
+		}
+
+		return VK_SUCCESS;
 	}
 
-	void OcclusionQueryVK::end()
+	void RecordThreadVK::shutdown()
 	{
-		BGFX_PROFILER_SCOPE("OcclusionQueryVK::end", kColorFrame);
+		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
+		const VkDevice device = s_renderVK->m_device;
 
-		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_FRAME_LATENCY; ++ii)
+		{
+			// Command buffers are freed together with command pool.
+			if (VK_NULL_HANDLE != m_commandPool[ii])
+			{
+				vkDestroyCommandPool(device, m_commandPool[ii], allocatorCb);
+				m_commandPool[ii] = VK_NULL_HANDLE;
+			}
 
-		const OcclusionQueryHandle handle = m_handle[m_control.m_current];
-		vkCmdEndQuery(commandBuffer, m_queryPool, handle.idx);
+			m_commandBuffer[ii].clear();
+		}
 
-		m_control.commit(1);
+		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_UNIFORMS; ++ii)
+		{
+			if (NULL != m_uniforms[ii])
+			{
+				bx::free(g_allocator, m_uniforms[ii]);
+				m_uniforms[ii]    = NULL;
+				m_uniformSize[ii] = 0;
+			}
+		}
+
+		bx::free(g_allocator, m_fsScratch);
+		bx::free(g_allocator, m_vsScratch);
+		m_fsScratch   = NULL;
+		m_vsScratch   = NULL;
+		m_scratchSize = 0;
+
+		m_state.m_vsScratch = NULL;
+		m_state.m_fsScratch = NULL;
 	}
 
-	void OcclusionQueryVK::flush(Frame* _render)
+	void RecordThreadVK::begin(uint32_t _frameInFlight, void* const* _uniforms, const uint32_t* _uniformSize, uint32_t _scratchSize)
 	{
-		BGFX_PROFILER_SCOPE("OcclusionQueryVK::flush", kColorFrame);
+		m_frameInFlight     = _frameInFlight;
+		m_numCommandBuffers = 0;
 
-		if (0 < m_control.getNumUsed() )
+		// Command buffers of this frame in flight are not used by GPU anymore.
+		VK_CHECK(vkResetCommandPool(s_renderVK->m_device, m_commandPool[m_frameInFlight], 0) );
+
+		for (uint32_t ii = 0; ii < BGFX_CONFIG_MAX_UNIFORMS; ++ii)
 		{
-			VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+			const uint32_t size = _uniformSize[ii];
 
-			const uint32_t size = m_control.m_size;
+			if (m_uniformSize[ii] != size)
+			{
+				bx::free(g_allocator, m_uniforms[ii]);
+				m_uniforms[ii]    = 0 < size ? bx::alloc(g_allocator, size) : NULL;
+				m_uniformSize[ii] = size;
+			}
 
-			// need to copy each result individually because VK_QUERY_RESULT_WAIT_BIT causes
-			// vkWaitForFences to hang indefinitely if we copy all results (including unavailable ones)
-			for (uint32_t ii = 0, num = m_control.getNumUsed(); ii < num; ++ii)
+			if (0 < size)
 			{
-				const OcclusionQueryHandle& handle = m_handle[(m_control.m_read + ii) % size];
-				if (isValid(handle) )
-				{
-					vkCmdCopyQueryPoolResults(
-						  commandBuffer
-						, m_queryPool
-						, handle.idx
-						, 1
-						, m_readback
-						, handle.idx * sizeof(uint32_t)
-						, sizeof(uint32_t)
-						, VK_QUERY_RESULT_WAIT_BIT
-						);
-				}
+				bx::memCopy(m_uniforms[ii], _uniforms[ii], size);
 			}
+		}
 
-			setMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
-			s_renderVK->kick(true);
+		// Scratch only grows, it's sized to the largest uniform block of
+		// all shaders created so far.
+		if (m_scratchSize < _scratchSize)
+		{
+			m_fsScratch   = (uint8_t*)bx::realloc(g_allocator, m_fsScratch, _scratchSize);
+			m_vsScratch   = (uint8_t*)bx::realloc(g_allocator, m_vsScratch, _scratchSize);
+			m_scratchSize = _scratchSize;
 
-			commandBuffer = s_renderVK->m_commandBuffer;
+			m_state.m_vsScratch = m_vsScratch;
+			m_state.m_fsScratch = m_fsScratch;
+		}
 
-			// resetting in the new command buffer prevents a false positive validation layer error
-			const uint32_t count = BX_COUNTOF(m_handle);
-			vkCmdResetQueryPool(commandBuffer, m_queryPool, 0, count);
+		bx::memSet(&m_slab, 0, sizeof(m_slab) );
 
-			resolve(_render);
-		}
+		m_uniformCacheItem = 0;
+		m_resetViewState   = true;
+
+		m_state.resetStats();
 	}
 
-	void OcclusionQueryVK::resolve(Frame* _render)
+	VkCommandBuffer RecordThreadVK::alloc()
 	{
-		while (0 != m_control.getNumUsed() )
+		stl::vector<VkCommandBuffer>& commandBuffers = m_commandBuffer[m_frameInFlight];
+
+		if (m_numCommandBuffers == commandBuffers.size() )
 		{
-			OcclusionQueryHandle handle = m_handle[m_control.m_read];
-			if (isValid(handle) )
-			{
-				_render->m_occlusion[handle.idx] = m_queryResult[handle.idx];
-			}
-			m_control.consume(1);
+			VkCommandBufferAllocateInfo cbai;
+			cbai.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			cbai.pNext = NULL;
+			cbai.commandPool = m_commandPool[m_frameInFlight];
+			cbai.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+			cbai.commandBufferCount = 1;
+
+			VkCommandBuffer commandBuffer;
+			VK_CHECK(vkAllocateCommandBuffers(s_renderVK->m_device, &cbai, &commandBuffer) );
+
+			commandBuffers.push_back(commandBuffer);
 		}
+
+		return commandBuffers[m_numCommandBuffers++];
 	}
 
-	void OcclusionQueryVK::invalidate(OcclusionQueryHandle _handle)
+	VkResult CommandRecorderVK::init(uint32_t _numThreads)
 	{
-		const uint32_t size = m_control.m_size;
+		m_numJobs  = 0;
+		m_nextJob  = 0;
+		m_active   = false;
+		m_exit     = false;
 
-		for (uint32_t ii = 0, num = m_control.getNumUsed(); ii < num; ++ii)
+		bx::memSet(m_thread, 0, sizeof(m_thread) );
+
+#if BX_CONFIG_SUPPORTS_THREADING
+		const uint32_t numThreads = bx::min<uint32_t>(_numThreads, BGFX_CONFIG_MAX_RECORD_THREADS);
+
+		for (uint32_t ii = 0; ii < numThreads; ++ii)
 		{
-			OcclusionQueryHandle& handle = m_handle[(m_control.m_read + ii) % size];
-			if (handle.idx == _handle.idx)
+			RecordThreadVK* thread = BX_NEW(g_allocator, RecordThreadVK);
+			m_thread[ii] = thread;
+
+			const VkResult result = thread->init(this);
+
+			if (VK_SUCCESS != result)
 			{
-				handle.idx = bgfx::kInvalidHandle;
+				thread->shutdown();
+				bx::deleteObject(g_allocator, thread);
+				m_thread[ii] = NULL;
+
+				shutdown();
+				return result;
 			}
-		}
-	}
 
-	void ReadbackVK::create(VkImage _image, uint32_t _width, uint32_t _height, TextureFormat::Enum _format)
-	{
-		m_image  = _image;
-		m_width  = _width;
-		m_height = _height;
-		m_format = _format;
-	}
+			m_worker[ii].init(threadFunc, thread, 0, "bgfx - record thread");
+			++m_numThreads;
+		}
+#else
+		BX_UNUSED(_numThreads);
+#endif // BX_CONFIG_SUPPORTS_THREADING
 
-	void ReadbackVK::destroy()
-	{
-		m_image = VK_NULL_HANDLE;
+		return VK_SUCCESS;
 	}
 
-	uint32_t ReadbackVK::pitch(uint8_t _mip) const
+	void CommandRecorderVK::shutdown()
 	{
-		uint32_t mipWidth = bx::uint32_max(1, m_width >> _mip);
-		uint8_t bpp = bimg::getBitsPerPixel(bimg::TextureFormat::Enum(m_format) );
-		return mipWidth * bpp / 8;
+#if BX_CONFIG_SUPPORTS_THREADING
+		if (0 < m_numThreads)
+		{
+			{
+				bx::MutexScope scope(m_mutex);
+				m_exit = true;
+			}
+
+			for (uint32_t ii = 0; ii < m_numThreads; ++ii)
+			{
+				m_workSem.post();
+			}
+
+			for (uint32_t ii = 0; ii < m_numThreads; ++ii)
+			{
+				m_worker[ii].shutdown();
+
+				m_thread[ii]->shutdown();
+				bx::deleteObject(g_allocator, m_thread[ii]);
+				m_thread[ii] = NULL;
+			}
+		}
+#endif // BX_CONFIG_SUPPORTS_THREADING
+
+		m_numThreads = 0;
 	}
 
-	void ReadbackVK::copyImageToBuffer(VkCommandBuffer _commandBuffer, VkBuffer _buffer, VkImageLayout _layout, VkImageAspectFlags _aspect, uint8_t _mip) const
+	void CommandRecorderVK::begin(Frame* _render, RecordJobVK* _jobs, uint32_t _numJobs, void* const* _uniforms, const uint32_t* _uniformSize)
 	{
-		BGFX_PROFILER_SCOPE("ReadbackVK::copyImageToBuffer", kColorFrame);
-
-		uint32_t mipWidth  = bx::uint32_max(1, m_width  >> _mip);
-		uint32_t mipHeight = bx::uint32_max(1, m_height >> _mip);
+		BX_ASSERT(!m_active, "Command recorder is already active!");
 
-		setImageMemoryBarrier(
-			  _commandBuffer
-			, m_image
-			, _aspect
-			, _layout
-			, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-			, _mip
-			, 1
-			, 0
-			, 1
-			);
+		m_frame        = _render;
+		m_job          = _jobs;
+		m_numJobs      = _numJobs;
+		m_nextJob      = 0;
+		m_numDoneWaits = 0;
 
-		VkBufferImageCopy bic;
-		bic.bufferOffset = 0;
-		bic.bufferRowLength   = mipWidth;
-		bic.bufferImageHeight = mipHeight;
-		bic.imageSubresource.aspectMask     = _aspect;
-		bic.imageSubresource.mipLevel       = _mip;
-		bic.imageSubresource.baseArrayLayer = 0;
-		bic.imageSubresource.layerCount     = 1;
-		bic.imageOffset = { 0, 0, 0 };
-		bic.imageExtent = { mipWidth, mipHeight, 1 };
+		const uint32_t frameInFlight = s_renderVK->m_cmd.m_currentFrameInFlight;
 
-		vkCmdCopyImageToBuffer(
-			  _commandBuffer
-			, m_image
-			, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-			, _buffer
-			, 1
-			, &bic
-			);
+		for (uint32_t ii = 0; ii < m_numThreads; ++ii)
+		{
+			m_thread[ii]->begin(frameInFlight, _uniforms, _uniformSize, s_renderVK->m_maxUniformSize);
+		}
 
-		// Make changes to the buffer visible to the host
-		setMemoryBarrier(
-			_commandBuffer
-			, VK_PIPELINE_STAGE_TRANSFER_BIT
-			, VK_PIPELINE_STAGE_HOST_BIT
-			);
+		m_active = true;
 
-		setImageMemoryBarrier(
-			  _commandBuffer
-			, m_image
-			, _aspect
-			, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-			, _layout
-			, _mip
-			, 1
-			, 0
-			, 1
-			);
+#if BX_CONFIG_SUPPORTS_THREADING
+		for (uint32_t ii = 0; ii < m_numThreads; ++ii)
+		{
+			m_workSem.post();
+		}
+#endif // BX_CONFIG_SUPPORTS_THREADING
 	}
 
-	void ReadbackVK::readback(VkDeviceMemory _memory, VkDeviceSize _offset, void* _data, uint8_t _mip) const
+	VkCommandBuffer CommandRecorderVK::wait(const RecordJobVK& _job)
 	{
-		BGFX_PROFILER_SCOPE("ReadbackVK::readback", kColorResource);
+		BGFX_PROFILER_SCOPE("CommandRecorderVK::wait", kColorWait);
 
-		if (m_image == VK_NULL_HANDLE)
+#if BX_CONFIG_SUPPORTS_THREADING
+		for (;;)
 		{
-			return;
+			{
+				bx::MutexScope scope(m_mutex);
+
+				if (_job.m_done)
+				{
+					break;
+				}
+			}
+
+			// Done semaphore is posted once per finished job.
+			m_doneSem.wait();
+			++m_numDoneWaits;
 		}
+#endif // BX_CONFIG_SUPPORTS_THREADING
 
-		const uint32_t mipHeight = bx::uint32_max(1, m_height >> _mip);
-		const uint32_t rowPitch = pitch(_mip);
+		return _job.m_commandBuffer;
+	}
 
-		const uint8_t* src;
-		VK_CHECK(vkMapMemory(s_renderVK->m_device, _memory, 0, VK_WHOLE_SIZE, 0, (void**)&src) );
-		src += _offset;
+	void CommandRecorderVK::end()
+	{
+#if BX_CONFIG_SUPPORTS_THREADING
+		for (; m_numDoneWaits < m_numJobs; ++m_numDoneWaits)
+		{
+			m_doneSem.wait();
+		}
 
-		bx::gather(_data, src, rowPitch, rowPitch, mipHeight);
+		for (uint32_t ii = 0; ii < m_numThreads; ++ii)
+		{
+			m_idleSem.wait();
+		}
+#endif // BX_CONFIG_SUPPORTS_THREADING
 
-		vkUnmapMemory(s_renderVK->m_device, _memory);
+		m_active  = false;
+		m_frame   = NULL;
+		m_job     = NULL;
+		m_numJobs = 0;
 	}
 
-	VkResult TextureVK::create(VkCommandBuffer _commandBuffer, uint32_t _width, uint32_t _height, uint64_t _flags, VkFormat _format)
+	int32_t CommandRecorderVK::threadFunc(bx::Thread* /*_self*/, void* _userData)
 	{
-		BGFX_PROFILER_SCOPE("TextureVK::create", kColorResource);
-
-		BX_ASSERT(0 != (_flags & BGFX_TEXTURE_RT_MASK), "");
-		_flags |= BGFX_TEXTURE_RT_WRITE_ONLY;
+		BGFX_PROFILER_SET_CURRENT_THREAD_NAME("bgfx - Record Thread");
 
-		m_flags     = _flags;
-		m_width     = _width;
-		m_height    = _height;
-		m_depth     = 1;
-		m_numLayers = 1;
-		m_requestedFormat = uint8_t(bimg::TextureFormat::Count);
-		m_textureFormat   = uint8_t(bimg::TextureFormat::Count);
-		m_format = _format;
-		m_components = { VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY };
-		m_aspectFlags = getAspectMask(m_format);
-		m_sampler = s_msaa[bx::uint32_satsub( (m_flags & BGFX_TEXTURE_RT_MSAA_MASK) >> BGFX_TEXTURE_RT_MSAA_SHIFT, 1)];
-		m_type = VK_IMAGE_VIEW_TYPE_2D;
-		m_numMips = 1;
-		m_numSides = 1;
+#if BX_CONFIG_SUPPORTS_THREADING
+		s_recordThread = true;
 
-		VkResult result = createImages(_commandBuffer);
+		RecordThreadVK* thread = (RecordThreadVK*)_userData;
+		CommandRecorderVK* recorder = thread->m_recorder;
 
-		if (VK_SUCCESS == result)
+		for (;;)
 		{
-			const VkImageLayout layout = 0 != (m_aspectFlags & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT) )
-				? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
-				: VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
-				;
-			setImageMemoryBarrier(_commandBuffer, layout);
+			recorder->m_workSem.wait();
+
+			{
+				bx::MutexScope scope(recorder->m_mutex);
+
+				if (recorder->m_exit)
+				{
+					break;
+				}
+			}
+
+			for (;;)
+			{
+				RecordJobVK* job;
+
+				{
+					bx::MutexScope scope(recorder->m_mutex);
+
+					if (recorder->m_nextJob == recorder->m_numJobs)
+					{
+						break;
+					}
+
+					job = &recorder->m_job[recorder->m_nextJob++];
+				}
+
+				s_renderVK->recordJob(*thread, recorder->m_frame, *job);
+
+				{
+					bx::MutexScope scope(recorder->m_mutex);
+					job->m_done = true;
+				}
+
+				recorder->m_doneSem.post();
+			}
+
+			recorder->m_idleSem.post();
 		}
+#else
+		BX_UNUSED(_userData);
+#endif // BX_CONFIG_SUPPORTS_THREADING
 
-		return result;
+		return bx::kExitSuccess;
 	}
 
-	VkResult TextureVK::createImages(VkCommandBuffer _commandBuffer)
+	VkResult TimerQueryVK::init()
 	{
-		BGFX_PROFILER_SCOPE("TextureVK::createImages", kColorResource);
-
+		BGFX_PROFILER_SCOPE("TimerQueryVK::init", kColorFrame);
 		VkResult result = VK_SUCCESS;
 
-		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
 		const VkDevice device = s_renderVK->m_device;
+		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
 
-		if (m_sampler.Count > 1)
-		{
-			BX_ASSERT(VK_IMAGE_VIEW_TYPE_3D != m_type, "Can't create multisample 3D image.");
-			BX_ASSERT(m_numMips <= 1, "Can't create multisample image with mip chain.");
-		}
+		const uint32_t count = m_control.m_size * 2;
 
-		// create texture and allocate its device memory
-		VkImageCreateInfo ici;
-		ici.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-		ici.pNext = NULL;
-		ici.flags = 0
-			| (VK_IMAGE_VIEW_TYPE_CUBE == m_type
-				? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT
-				: 0
-				)
-			| (VK_IMAGE_VIEW_TYPE_3D == m_type
-				? VK_IMAGE_CREATE_2D_ARRAY_COMPATIBLE_BIT_KHR
-				: 0
-				)
-			;
-		ici.pQueueFamilyIndices   = NULL;
-		ici.queueFamilyIndexCount = 0;
-		ici.initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED;
-		ici.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
-		ici.usage                 = 0
-			| VK_IMAGE_USAGE_TRANSFER_SRC_BIT
-			| VK_IMAGE_USAGE_TRANSFER_DST_BIT
-			| VK_IMAGE_USAGE_SAMPLED_BIT
-			| (m_flags & BGFX_TEXTURE_RT_MASK
-				? (m_aspectFlags & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)
-					? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
-					: VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
-					)
-				: 0
-				)
-			| (m_flags & BGFX_TEXTURE_COMPUTE_WRITE ? VK_IMAGE_USAGE_STORAGE_BIT : 0)
-			;
-		ici.format        = m_format;
-		ici.samples       = m_sampler.Sample;
-		ici.mipLevels     = m_numMips;
-		ici.arrayLayers   = m_numSides;
-		ici.extent.width  = m_width;
-		ici.extent.height = m_height;
-		ici.extent.depth  = m_depth;
-		ici.imageType     = VK_IMAGE_VIEW_TYPE_3D == m_type
-			? VK_IMAGE_TYPE_3D
-			: VK_IMAGE_TYPE_2D
-			;
-		ici.tiling        = VK_IMAGE_TILING_OPTIMAL;
+		VkQueryPoolCreateInfo qpci;
+		qpci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		qpci.pNext = NULL;
+		qpci.flags = 0;
+		qpci.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		qpci.queryCount = count;
+		qpci.pipelineStatistics = 0;
+
+		result = vkCreateQueryPool(device, &qpci, s_renderVK->m_allocatorCb, &m_queryPool);
 
-		result = vkCreateImage(device, &ici, allocatorCb, &m_textureImage);
 		if (VK_SUCCESS != result)
 		{
-			BX_TRACE("Create texture image error: vkCreateImage failed %d: %s.", result, getName(result) );
+			BX_TRACE("Create timer query error: vkCreateQueryPool failed %d: %s.", result, getName(result) );
 			return result;
 		}
 
-		VkMemoryRequirements imageMemReq;
-		vkGetImageMemoryRequirements(device, m_textureImage, &imageMemReq);
+		vkCmdResetQueryPool(commandBuffer, m_queryPool, 0, count);
+
+		const uint32_t size = count * sizeof(uint64_t);
+		result = s_renderVK->createReadbackBuffer(size, &m_readback, &m_readbackMemory);
 
-		result = s_renderVK->allocateMemory(&imageMemReq, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &m_textureDeviceMem, false);
 		if (VK_SUCCESS != result)
 		{
-			BX_TRACE("Create texture image error: allocateMemory failed %d: %s.", result, getName(result) );
 			return result;
 		}
 
-		result = vkBindImageMemory(device, m_textureImage, m_textureDeviceMem.mem, m_textureDeviceMem.offset);
+		result = vkMapMemory(device, m_readbackMemory.mem, m_readbackMemory.offset, VK_WHOLE_SIZE, 0, (void**)&m_queryResult);
+
 		if (VK_SUCCESS != result)
 		{
-			BX_TRACE("Create texture image error: vkBindImageMemory failed %d: %s.", result, getName(result) );
+			BX_TRACE("Create timer query error: vkMapMemory failed %d: %s.", result, getName(result) );
 			return result;
 		}
 
-		m_sampledLayout = m_flags & BGFX_TEXTURE_COMPUTE_WRITE
-			? VK_IMAGE_LAYOUT_GENERAL
-			: VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-			;
-
-		const bool needResolve = true
-			&& 1 < m_sampler.Count
-			&& 0 != (ici.usage & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT)
-			&& 0 == (m_flags & BGFX_TEXTURE_MSAA_SAMPLE)
-			&& 0 == (m_flags & BGFX_TEXTURE_RT_WRITE_ONLY)
-			;
+		m_frequency = uint64_t(1000000000.0 / double(s_renderVK->m_deviceProperties.properties.limits.timestampPeriod) );
 
-		if (needResolve)
+		for (uint32_t ii = 0; ii < BX_COUNTOF(m_result); ++ii)
 		{
-			VkImageCreateInfo ici_resolve = ici;
-			ici_resolve.samples = s_msaa[0].Sample;
-			ici_resolve.usage &= ~VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
-			ici_resolve.flags &= ~VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+			m_result[ii].reset();
+		}
 
-			result = vkCreateImage(device, &ici_resolve, allocatorCb, &m_singleMsaaImage);
-			if (VK_SUCCESS != result)
-			{
-				BX_TRACE("Create texture image error: vkCreateImage failed %d: %s.", result, getName(result) );
-				return result;
-			}
+		m_control.reset();
 
-			VkMemoryRequirements imageMemReq_resolve;
-			vkGetImageMemoryRequirements(device, m_singleMsaaImage, &imageMemReq_resolve);
+		return result;
+	}
 
-			result = s_renderVK->allocateMemory(&imageMemReq_resolve, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &m_singleMsaaDeviceMem, false);
-			if (VK_SUCCESS != result)
-			{
-				BX_TRACE("Create texture image error: allocateMemory failed %d: %s.", result, getName(result) );
-				return result;
-			}
+	void TimerQueryVK::shutdown()
+	{
+		vkDestroy(m_queryPool);
+		vkDestroy(m_readback);
+		vkUnmapMemory(s_renderVK->m_device, m_readbackMemory.mem);
+		s_renderVK->recycleMemory(m_readbackMemory);
+	}
 
-			result = vkBindImageMemory(device, m_singleMsaaImage, m_singleMsaaDeviceMem.mem, m_singleMsaaDeviceMem.offset);
-			if (VK_SUCCESS != result)
-			{
-				BX_TRACE("Create texture image error: vkBindImageMemory failed %d: %s.", result, getName(result) );
-				return result;
-			}
+	uint32_t TimerQueryVK::begin(uint32_t _resultIdx, uint32_t _frameNum)
+	{
+		BGFX_PROFILER_SCOPE("TimerQueryVK::begin", kColorFrame);
 
-			setImageMemoryBarrier(_commandBuffer, m_sampledLayout, true);
+		while (0 == m_control.reserve(1) )
+		{
+			m_control.consume(1);
 		}
 
-		return result;
+		Result& result = m_result[_resultIdx];
+		++result.m_pending;
+
+		const uint32_t idx = m_control.m_current;
+		Query& query = m_query[idx];
+		query.m_resultIdx = _resultIdx;
+		query.m_ready     = false;
+		query.m_frameNum  = _frameNum;
+
+		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+		const uint32_t offset = idx * 2 + 0;
+
+		vkCmdResetQueryPool(commandBuffer, m_queryPool, offset, 2);
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, offset + 0);
+
+		m_control.commit(1);
+
+		return idx;
 	}
 
-	void* TextureVK::create(VkCommandBuffer _commandBuffer, const Memory* _mem, uint64_t _flags, uint8_t _skip)
+	void TimerQueryVK::end(uint32_t _idx)
 	{
-		BGFX_PROFILER_SCOPE("TextureVK::create", kColorResource);
+		BGFX_PROFILER_SCOPE("TimerQueryVK::end", kColorFrame);
 
-		bimg::ImageContainer imageContainer;
+		Query& query = m_query[_idx];
+		query.m_ready = true;
+		query.m_completed = s_renderVK->m_cmd.m_submitted + s_renderVK->m_maxFrameLatency;
 
-		if (bimg::imageParse(imageContainer, _mem->data, _mem->size) )
-		{
-			const bimg::ImageBlockInfo& blockInfo = bimg::getBlockInfo(imageContainer.m_format);
-			const uint8_t startLod = bx::min<uint8_t>(_skip, imageContainer.m_numMips - 1);
+		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+		const uint32_t offset = _idx * 2 + 0;
 
-			bimg::TextureInfo ti;
-			bimg::imageGetSize(
-				  &ti
-				, uint16_t(imageContainer.m_width  >> startLod)
-				, uint16_t(imageContainer.m_height >> startLod)
-				, uint16_t(imageContainer.m_depth  >> startLod)
-				, imageContainer.m_cubeMap
-				, 1 < imageContainer.m_numMips
-				, imageContainer.m_numLayers
-				, imageContainer.m_format
-				);
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, offset + 1);
 
-			ti.numMips = bx::min<uint8_t>(imageContainer.m_numMips - startLod, ti.numMips);
+		vkCmdCopyQueryPoolResults(
+			  commandBuffer
+			, m_queryPool
+			, offset
+			, 2
+			, m_readback
+			, offset * sizeof(uint64_t)
+			, sizeof(uint64_t)
+			, VK_QUERY_RESULT_WAIT_BIT | VK_QUERY_RESULT_64_BIT
+			);
 
-			m_flags     = _flags;
-			m_width     = ti.width;
-			m_height    = ti.height;
-			m_depth     = ti.depth;
-			m_numLayers = ti.numLayers;
-			m_requestedFormat = uint8_t(imageContainer.m_format);
-			m_textureFormat   = uint8_t(getViableTextureFormat(imageContainer) );
-			m_format = bimg::isDepth(bimg::TextureFormat::Enum(m_textureFormat) )
-				? s_textureFormat[m_textureFormat].m_fmtDsv
-				: (m_flags & BGFX_TEXTURE_SRGB) ? s_textureFormat[m_textureFormat].m_fmtSrgb : s_textureFormat[m_textureFormat].m_fmt
-				;
-			m_components = s_textureFormat[m_textureFormat].m_mapping;
+		setMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
 
-			const bool convert = m_textureFormat != m_requestedFormat;
-			const uint8_t bpp = bimg::getBitsPerPixel(bimg::TextureFormat::Enum(m_textureFormat) );
+		while (update() )
+		{
+		}
+	}
 
-			m_aspectFlags = getAspectMask(m_format);
-			m_sampler = s_msaa[bx::uint32_satsub( (m_flags & BGFX_TEXTURE_RT_MSAA_MASK) >> BGFX_TEXTURE_RT_MSAA_SHIFT, 1)];
+	bool TimerQueryVK::update()
+	{
+		if (0 != m_control.getNumUsed() )
+		{
+			uint32_t idx = m_control.m_read;
+			Query& query = m_query[idx];
 
-			if (imageContainer.m_cubeMap)
-			{
-				m_type = imageContainer.m_numLayers > 1
-					? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY
-					: VK_IMAGE_VIEW_TYPE_CUBE
-					;
-			}
-			else if (imageContainer.m_depth > 1)
-			{
-				m_type = VK_IMAGE_VIEW_TYPE_3D;
-			}
-			else if (imageContainer.m_numLayers > 1)
+			if (!query.m_ready)
 			{
-				m_type = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+				return false;
 			}
-			else
+
+			if (query.m_completed > s_renderVK->m_cmd.m_submitted)
 			{
-				m_type = VK_IMAGE_VIEW_TYPE_2D;
+				return false;
 			}
 
-			m_numMips = ti.numMips;
-			m_numSides = ti.numLayers * (imageContainer.m_cubeMap ? 6 : 1);
-			const uint16_t numSides = ti.numLayers * (imageContainer.m_cubeMap ? 6 : 1);
-			const uint32_t numSrd = numSides * ti.numMips;
+			m_control.consume(1);
 
-			uint32_t kk = 0;
+			Result& result = m_result[query.m_resultIdx];
+			--result.m_pending;
+			result.m_frameNum = query.m_frameNum;
 
-			const bool compressed = bimg::isCompressed(bimg::TextureFormat::Enum(m_textureFormat) );
-			const bool swizzle = TextureFormat::BGRA8 == m_textureFormat && 0 != (m_flags & BGFX_TEXTURE_COMPUTE_WRITE);
+			uint32_t offset = idx * 2;
+			result.m_begin  = m_queryResult[offset+0];
+			result.m_end    = m_queryResult[offset+1];
 
-			const bool writeOnly    = 0 != (m_flags & BGFX_TEXTURE_RT_WRITE_ONLY);
-			const bool computeWrite = 0 != (m_flags & BGFX_TEXTURE_COMPUTE_WRITE);
-			const bool renderTarget = 0 != (m_flags & BGFX_TEXTURE_RT_MASK);
-			const bool blit         = 0 != (m_flags & BGFX_TEXTURE_BLIT_DST);
+			return true;
+		}
 
-			BX_UNUSED(swizzle, writeOnly, computeWrite, renderTarget, blit);
+		return false;
+	}
 
-			BX_TRACE(
-				  "Texture %3d: %s (requested: %s), %dx%dx%d%s RT[%c], BO[%c], CW[%c]%s."
-				, (int)(this - s_renderVK->m_textures)
-				, getName( (TextureFormat::Enum)m_textureFormat)
-				, getName( (TextureFormat::Enum)m_requestedFormat)
-				, ti.width
-				, ti.height
-				, ti.depth
-				, imageContainer.m_cubeMap ? "x6" : ""
-				, renderTarget ? 'x' : ' '
-				, writeOnly ? 'x' : ' '
-				, computeWrite ? 'x' : ' '
-				, swizzle ? " (swizzle BGRA8 -> RGBA8)" : ""
-				);
+	VkResult OcclusionQueryVK::init()
+	{
+		BGFX_PROFILER_SCOPE("OcclusionQueryVK::init", kColorFrame);
 
-			VK_CHECK(createImages(_commandBuffer) );
+		VkResult result = VK_SUCCESS;
 
-			// decode images
-			struct ImageInfo
-			{
-				uint8_t* data;
-				uint32_t width;
-				uint32_t height;
-				uint32_t depth;
-				uint32_t pitch;
-				uint32_t slice;
-				uint32_t size;
-				uint32_t mipLevel;
-				uint32_t layer;
-			};
+		const VkDevice device = s_renderVK->m_device;
+		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
 
-			ImageInfo* imageInfos = (ImageInfo*)bx::alloc(g_allocator, sizeof(ImageInfo) * numSrd);
-			bx::memSet(imageInfos, 0, sizeof(ImageInfo) * numSrd);
-			uint32_t alignment = 1; // tightly aligned buffer
+		const uint32_t count = BX_COUNTOF(m_handle);
 
-			for (uint16_t side = 0; side < numSides; ++side)
-			{
-				for (uint8_t lod = 0; lod < ti.numMips; ++lod)
-				{
-					bimg::ImageMip mip;
+		VkQueryPoolCreateInfo qpci;
+		qpci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		qpci.pNext = NULL;
+		qpci.flags = 0;
+		qpci.queryType = VK_QUERY_TYPE_OCCLUSION;
+		qpci.queryCount = count;
+		qpci.pipelineStatistics = 0;
 
-					if (bimg::imageGetRawData(imageContainer, side, lod + startLod, _mem->data, _mem->size, mip) )
-					{
-						if (convert)
-						{
-							const uint32_t pitch = bx::strideAlign(bx::max<uint32_t>(mip.m_width, 4) * bpp / 8, alignment);
-							const uint32_t slice = bx::strideAlign(bx::max<uint32_t>(mip.m_height, 4) * pitch, alignment);
-							const uint32_t size  = slice * mip.m_depth;
+		result = vkCreateQueryPool(device, &qpci, s_renderVK->m_allocatorCb, &m_queryPool);
 
-							uint8_t* temp = (uint8_t*)bx::alloc(g_allocator, size);
-							bimg::imageDecodeToBgra8(
-								  g_allocator
-								, temp
-								, mip.m_data
-								, mip.m_width
-								, mip.m_height
-								, pitch
-								, mip.m_format
-								);
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("Create occlusion query error: vkCreateQueryPool failed %d: %s.", result, getName(result) );
+			return result;
+		}
 
-							imageInfos[kk].data     = temp;
-							imageInfos[kk].width    = mip.m_width;
-							imageInfos[kk].height   = mip.m_height;
-							imageInfos[kk].depth    = mip.m_depth;
-							imageInfos[kk].pitch    = pitch;
-							imageInfos[kk].slice    = slice;
-							imageInfos[kk].size     = size;
-							imageInfos[kk].mipLevel = lod;
-							imageInfos[kk].layer    = side;
-						}
-						else if (compressed)
-						{
-							const uint32_t pitch = bx::strideAlign( (mip.m_width / blockInfo.blockWidth) * mip.m_blockSize, alignment);
-							const uint32_t slice = bx::strideAlign( (mip.m_height / blockInfo.blockHeight) * pitch, alignment);
-							const uint32_t size  = slice * mip.m_depth;
+		vkCmdResetQueryPool(commandBuffer, m_queryPool, 0, count);
 
-							uint8_t* temp = (uint8_t*)bx::alloc(g_allocator, size);
-							bimg::imageCopy(
-								  temp
-								, mip.m_height / blockInfo.blockHeight
-								, (mip.m_width / blockInfo.blockWidth) * mip.m_blockSize
-								, mip.m_depth
-								, mip.m_data
-								, pitch
-								);
+		// Each frame in flight has its own region of readback buffer, results
+		// are read back once command buffer of that frame in flight is reused.
+		const uint32_t size = count * BGFX_CONFIG_MAX_FRAME_LATENCY * sizeof(uint32_t);
+		result = s_renderVK->createReadbackBuffer(size, &m_readback, &m_readbackMemory);
 
-							imageInfos[kk].data     = temp;
-							imageInfos[kk].width    = mip.m_width;
-							imageInfos[kk].height   = mip.m_height;
-							imageInfos[kk].depth    = mip.m_depth;
-							imageInfos[kk].pitch    = pitch;
-							imageInfos[kk].slice    = slice;
-							imageInfos[kk].size     = size;
-							imageInfos[kk].mipLevel = lod;
-							imageInfos[kk].layer    = side;
-						}
-						else
-						{
-							const uint32_t pitch = bx::strideAlign(mip.m_width * mip.m_bpp / 8, alignment);
-							const uint32_t slice = bx::strideAlign(mip.m_height * pitch, alignment);
-							const uint32_t size  = slice * mip.m_depth;
+		if (VK_SUCCESS != result)
+		{
+			return result;
+		}
 
-							uint8_t* temp = (uint8_t*)bx::alloc(g_allocator, size);
-							bimg::imageCopy(
-								  temp
-								, mip.m_height
-								, mip.m_width * mip.m_bpp / 8
-								, mip.m_depth
-								, mip.m_data
-								, pitch
-								);
+		result = vkMapMemory(device, m_readbackMemory.mem, m_readbackMemory.offset, VK_WHOLE_SIZE, 0, (void**)&m_queryResult);
 
-							imageInfos[kk].data     = temp;
-							imageInfos[kk].width    = mip.m_width;
-							imageInfos[kk].height   = mip.m_height;
-							imageInfos[kk].depth    = mip.m_depth;
-							imageInfos[kk].pitch    = pitch;
-							imageInfos[kk].slice    = slice;
-							imageInfos[kk].size     = size;
-							imageInfos[kk].mipLevel = lod;
-							imageInfos[kk].layer    = side;
-						}
-					}
-					++kk;
-				}
-			}
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("Create occlusion query error: vkMapMemory failed %d: %s.", result, getName(result) );
+			return result;
+		}
 
-			uint32_t totalMemSize = 0;
-			VkBufferImageCopy* bufferCopyInfo = (VkBufferImageCopy*)bx::alloc(g_allocator, sizeof(VkBufferImageCopy) * numSrd);
+		bx::memSet(m_numPending, 0, sizeof(m_numPending) );
 
-			for (uint32_t ii = 0; ii < numSrd; ++ii)
-			{
-				const uint32_t idealWidth  = bx::max<uint32_t>(1, m_width  >> imageInfos[ii].mipLevel);
-				const uint32_t idealHeight = bx::max<uint32_t>(1, m_height >> imageInfos[ii].mipLevel);
-				bufferCopyInfo[ii].bufferOffset      = totalMemSize;
-				bufferCopyInfo[ii].bufferRowLength   = 0; // assume that image data are tightly aligned
-				bufferCopyInfo[ii].bufferImageHeight = 0; // assume that image data are tightly aligned
-				bufferCopyInfo[ii].imageSubresource.aspectMask     = m_aspectFlags;
-				bufferCopyInfo[ii].imageSubresource.mipLevel       = imageInfos[ii].mipLevel;
-				bufferCopyInfo[ii].imageSubresource.baseArrayLayer = imageInfos[ii].layer;
-				bufferCopyInfo[ii].imageSubresource.layerCount     = 1;
-				bufferCopyInfo[ii].imageOffset = { 0, 0, 0 };
-				bufferCopyInfo[ii].imageExtent = { idealWidth, idealHeight, imageInfos[ii].depth };
-				totalMemSize += imageInfos[ii].size;
-			}
+		m_control.reset();
 
-			if (totalMemSize > 0)
-			{
-				const VkDevice device = s_renderVK->m_device;
-				const bimg::ImageBlockInfo &dstBlockInfo = bimg::getBlockInfo(bimg::TextureFormat::Enum(m_textureFormat) );
+		return result;
+	}
 
-				StagingBufferVK stagingBuffer = s_renderVK->allocFromScratchStagingBuffer(totalMemSize, dstBlockInfo.blockSize);
+	void OcclusionQueryVK::shutdown()
+	{
+		vkDestroy(m_queryPool);
+		vkDestroy(m_readback);
+		vkUnmapMemory(s_renderVK->m_device, m_readbackMemory.mem);
+		s_renderVK->recycleMemory(m_readbackMemory);
+	}
 
-				uint8_t* mappedMemory;
+	void OcclusionQueryVK::begin(OcclusionQueryHandle _handle)
+	{
+		BGFX_PROFILER_SCOPE("OcclusionQueryVK::shutdown", kColorFrame);
 
-				if (!stagingBuffer.m_isFromScratch)
-				{
-					VK_CHECK(vkMapMemory(
-						  device
-						, stagingBuffer.m_deviceMem.mem
-						, stagingBuffer.m_deviceMem.offset
-						, totalMemSize
-						, 0
-						, (void**)&mappedMemory
-						) );
-				}
-				else
-				{
-					mappedMemory = stagingBuffer.m_data;
-				}
+		m_control.reserve(1);
 
-				// copy image to staging buffer
-				for (uint32_t ii = 0; ii < numSrd; ++ii)
-				{
-					bx::memCopy(mappedMemory, imageInfos[ii].data, imageInfos[ii].size);
-					mappedMemory += imageInfos[ii].size;
-					bufferCopyInfo[ii].bufferOffset += stagingBuffer.m_offset;
-					BX_ASSERT(
-						  bx::uint32_mod(bx::narrowCast<uint32_t>(bufferCopyInfo[ii].bufferOffset), dstBlockInfo.blockSize) == 0
-						, "Alignment for subimage %u is not aligned correctly (%u)."
-						, ii, bufferCopyInfo[ii].bufferOffset, dstBlockInfo.blockSize
-						);
-				}
+		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
 
-				if (!stagingBuffer.m_isFromScratch)
-				{
-					vkUnmapMemory(device, stagingBuffer.m_deviceMem.mem);
-				}
+		m_handle[m_control.m_current] = _handle;
+		vkCmdBeginQuery(commandBuffer, m_queryPool, _handle.idx, 0);
+	}
 
-				copyBufferToTexture(_commandBuffer, stagingBuffer.m_buffer, numSrd, bufferCopyInfo);
+	void OcclusionQueryVK::end()
+	{
+		BGFX_PROFILER_SCOPE("OcclusionQueryVK::end", kColorFrame);
 
-				if (!stagingBuffer.m_isFromScratch)
-				{
-					s_renderVK->release(stagingBuffer.m_buffer);
-					s_renderVK->recycleMemory(stagingBuffer.m_deviceMem);
-				}
-			}
-			else
-			{
-				setImageMemoryBarrier(_commandBuffer, m_sampledLayout);
-			}
+		const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
 
-			bx::free(g_allocator, bufferCopyInfo);
+		const OcclusionQueryHandle handle = m_handle[m_control.m_current];
+		vkCmdEndQuery(commandBuffer, m_queryPool, handle.idx);
 
-			for (uint32_t ii = 0; ii < numSrd; ++ii)
+		m_control.commit(1);
+	}
+
+	void OcclusionQueryVK::flush(Frame* _render)
+	{
+		BGFX_PROFILER_SCOPE("OcclusionQueryVK::flush", kColorFrame);
+
+		const uint32_t frameInFlight = s_renderVK->m_cmd.m_currentFrameInFlight;
+
+		// Command buffer of this frame in flight is reused, which means results
+		// copied into its readback region are available without waiting.
+		resolve(_render, frameInFlight);
+
+		if (0 < m_control.getNumUsed() )
+		{
+			const VkCommandBuffer commandBuffer = s_renderVK->m_commandBuffer;
+
+			const uint32_t count  = BX_COUNTOF(m_handle);
+			const uint32_t offset = frameInFlight * count;
+
+			OcclusionQueryHandle* pending = m_pending[frameInFlight];
+			uint32_t numPending = 0;
+
+			// need to copy each result individually because VK_QUERY_RESULT_WAIT_BIT causes
+			// GPU to hang indefinitely if we copy all results (including unavailable ones)
+			while (0 != m_control.getNumUsed() )
 			{
-				bx::free(g_allocator, imageInfos[ii].data);
+				const OcclusionQueryHandle handle = m_handle[m_control.m_read];
+				if (isValid(handle) )
+				{
+					vkCmdCopyQueryPoolResults(
+						  commandBuffer
+						, m_queryPool
+						, handle.idx
+						, 1
+						, m_readback
+						, (offset + handle.idx) * sizeof(uint32_t)
+						, sizeof(uint32_t)
+						, VK_QUERY_RESULT_WAIT_BIT
+						);
+
+					pending[numPending++] = handle;
+				}
+
+				m_control.consume(1);
 			}
 
-			bx::free(g_allocator, imageInfos);
+			m_numPending[frameInFlight] = numPending;
 
-			m_readback.create(m_textureImage, m_width, m_height, TextureFormat::Enum(m_textureFormat) );
-		}
+			setMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+			vkCmdResetQueryPool(commandBuffer, m_queryPool, 0, count);
 
-		return m_directAccessPtr;
+			setMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+		}
 	}
 
-	void TextureVK::destroy()
+	void OcclusionQueryVK::resolve(Frame* _render, uint32_t _frameInFlight)
 	{
-		BGFX_PROFILER_SCOPE("TextureVK::destroy", kColorResource);
-
-		m_readback.destroy();
-
-		if (VK_NULL_HANDLE != m_textureImage)
-		{
-			s_renderVK->release(m_textureImage);
-			s_renderVK->recycleMemory(m_textureDeviceMem);
-		}
+		const uint32_t* queryResult = &m_queryResult[_frameInFlight * BX_COUNTOF(m_handle)];
+		const OcclusionQueryHandle* pending = m_pending[_frameInFlight];
 
-		if (VK_NULL_HANDLE != m_singleMsaaImage)
+		for (uint32_t ii = 0, num = m_numPending[_frameInFlight]; ii < num; ++ii)
 		{
-			s_renderVK->release(m_singleMsaaImage);
-			s_renderVK->recycleMemory(m_singleMsaaDeviceMem);
+			const OcclusionQueryHandle handle = pending[ii];
+			if (isValid(handle) )
+			{
+				_render->m_occlusion[handle.idx] = int32_t(queryResult[handle.idx]);
+			}
 		}
 
-		m_aspectFlags = VK_IMAGE_ASPECT_NONE;
-		m_currentImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		m_currentSingleMsaaImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		m_numPending[_frameInFlight] = 0;
 	}
 
-	void TextureVK::update(VkCommandBuffer _commandBuffer, uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem)
+	void OcclusionQueryVK::invalidate(OcclusionQueryHandle _handle)
 	{
-		BGFX_PROFILER_SCOPE("TextureVK::update", kColorResource);
+		const uint32_t size = m_control.m_size;
 
-		const uint32_t bpp = bimg::getBitsPerPixel(bimg::TextureFormat::Enum(m_textureFormat) );
-		const bimg::ImageBlockInfo& blockInfo = bimg::getBlockInfo(bimg::TextureFormat::Enum(m_textureFormat) );
-		uint32_t rectpitch = _rect.m_width * bpp / 8;
-		uint32_t slicepitch = rectpitch * _rect.m_height;
-		uint32_t align = blockInfo.blockSize;
-		if (bimg::isCompressed(bimg::TextureFormat::Enum(m_textureFormat) ) )
+		for (uint32_t ii = 0, num = m_control.getNumUsed(); ii < num; ++ii)
 		{
-			rectpitch  = (_rect.m_width  / blockInfo.blockWidth ) * blockInfo.blockSize;
-			slicepitch = (_rect.m_height / blockInfo.blockHeight) * rectpitch;
+			OcclusionQueryHandle& handle = m_handle[(m_control.m_read + ii) % size];
+			if (handle.idx == _handle.idx)
+			{
+				handle.idx = bgfx::kInvalidHandle;
+			}
 		}
-		const uint32_t srcpitch = UINT16_MAX == _pitch ? rectpitch : _pitch;
-		const uint32_t size     = UINT16_MAX == _pitch ? slicepitch  * _depth: _rect.m_height * _pitch * _depth;
-		const bool convert = m_textureFormat != m_requestedFormat;
-
-		VkBufferImageCopy region;
-		region.bufferOffset      = 0;
-		region.bufferRowLength   = (_pitch == UINT16_MAX ? 0 : _pitch * 8 / bpp);
-		region.bufferImageHeight = 0;
-		region.imageSubresource.aspectMask     = m_aspectFlags;
-		region.imageSubresource.mipLevel       = _mip;
-		region.imageSubresource.baseArrayLayer = 0;
-		region.imageSubresource.layerCount     = 1;
-		region.imageOffset = { _rect.m_x,     _rect.m_y,      0      };
-		region.imageExtent = { _rect.m_width, _rect.m_height, _depth };
-
-		uint8_t* data = _mem->data;
-		uint8_t* temp = NULL;
 
-		if (convert)
+		for (uint32_t frame = 0; frame < BGFX_CONFIG_MAX_FRAME_LATENCY; ++frame)
 		{
-			temp = (uint8_t*)bx::alloc(g_allocator, slicepitch);
-			bimg::imageDecodeToBgra8(g_allocator, temp, data, _rect.m_width, _rect.m_height, srcpitch, bimg::TextureFormat::Enum(m_requestedFormat) );
-			data = temp;
-
-			region.imageExtent =
+			for (uint32_t ii = 0, num = m_numPending[frame]; ii < num; ++ii)
 			{
-				bx::max(1u, m_width  >> _mip),
-				bx::max(1u, m_height >> _mip),
-				_depth,
-			};
+				OcclusionQueryHandle& handle = m_pending[frame][ii];
+				if (handle.idx == _handle.idx)
+				{
+					handle.idx = bgfx::kInvalidHandle;
+				}
+			}
+		}
+	}
+
+	void ReadbackVK::create(VkImage _image, uint32_t _width, uint32_t _height, TextureFormat::Enum _format)
+	{
+		m_image  = _image;
+		m_width  = _width;
+		m_height = _height;
+		m_format = _format;
+	}
+
+	void ReadbackVK::destroy()
+	{
+		m_image = VK_NULL_HANDLE;
+	}
+
+	uint32_t ReadbackVK::pitch(uint8_t _mip) const
+	{
+		uint32_t mipWidth = bx::uint32_max(1, m_width >> _mip);
+		uint8_t bpp = bimg::getBitsPerPixel(bimg::TextureFormat::Enum(m_format) );
+		return mipWidth * bpp / 8;
+	}
+
+	void ReadbackVK::copyImageToBuffer(VkCommandBuffer _commandBuffer, VkBuffer _buffer, VkImageLayout _layout, VkImageAspectFlags _aspect, uint8_t _mip) const
+	{
+		BGFX_PROFILER_SCOPE("ReadbackVK::copyImageToBuffer", kColorFrame);
+
+		uint32_t mipWidth  = bx::uint32_max(1, m_width  >> _mip);
+		uint32_t mipHeight = bx::uint32_max(1, m_height >> _mip);
+
+		setImageMemoryBarrier(
+			  _commandBuffer
+			, m_image
+			, _aspect
+			, _layout
+			, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+			, _mip
+			, 1
+			, 0
+			, 1
+			);
+
+		VkBufferImageCopy bic;
+		bic.bufferOffset = 0;
+		bic.bufferRowLength   = mipWidth;
+		bic.bufferImageHeight = mipHeight;
+		bic.imageSubresource.aspectMask     = _aspect;
+		bic.imageSubresource.mipLevel       = _mip;
+		bic.imageSubresource.baseArrayLayer = 0;
+		bic.imageSubresource.layerCount     = 1;
+		bic.imageOffset = { 0, 0, 0 };
+		bic.imageExtent = { mipWidth, mipHeight, 1 };
+
+		vkCmdCopyImageToBuffer(
+			  _commandBuffer
+			, m_image
+			, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+			, _buffer
+			, 1
+			, &bic
+			);
+
+		// Make changes to the buffer visible to the host
+		setMemoryBarrier(
+			_commandBuffer
+			, VK_PIPELINE_STAGE_TRANSFER_BIT
+			, VK_PIPELINE_STAGE_HOST_BIT
+			);
+
+		setImageMemoryBarrier(
+			  _commandBuffer
+			, m_image
+			, _aspect
+			, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+			, _layout
+			, _mip
+			, 1
+			, 0
+			, 1
+			);
+	}
+
+	void ReadbackVK::readback(VkDeviceMemory _memory, VkDeviceSize _offset, void* _data, uint8_t _mip) const
+	{
+		BGFX_PROFILER_SCOPE("ReadbackVK::readback", kColorResource);
+
+		if (m_image == VK_NULL_HANDLE)
+		{
+			return;
+		}
+
+		const uint32_t mipHeight = bx::uint32_max(1, m_height >> _mip);
+		const uint32_t rowPitch = pitch(_mip);
+
+		const uint8_t* src;
+		VK_CHECK(vkMapMemory(s_renderVK->m_device, _memory, 0, VK_WHOLE_SIZE, 0, (void**)&src) );
+		src += _offset;
+
+		bx::gather(_data, src, rowPitch, rowPitch, mipHeight);
+
+		vkUnmapMemory(s_renderVK->m_device, _memory);
+	}
+
+	VkResult TextureVK::create(VkCommandBuffer _commandBuffer, uint32_t _width, uint32_t _height, uint64_t _flags, VkFormat _format)
+	{
+		BGFX_PROFILER_SCOPE("TextureVK::create", kColorResource);
+
+		BX_ASSERT(0 != (_flags & BGFX_TEXTURE_RT_MASK), "");
+		_flags |= BGFX_TEXTURE_RT_WRITE_ONLY;
+
+		m_flags     = _flags;
+		m_width     = _width;
+		m_height    = _height;
+		m_depth     = 1;
+		m_numLayers = 1;
+		m_requestedFormat = uint8_t(bimg::TextureFormat::Count);
+		m_textureFormat   = uint8_t(bimg::TextureFormat::Count);
+		m_format = _format;
+		m_components = { VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY, VK_COMPONENT_SWIZZLE_IDENTITY };
+		m_aspectFlags = getAspectMask(m_format);
+		m_sampler = s_msaa[bx::uint32_satsub( (m_flags & BGFX_TEXTURE_RT_MSAA_MASK) >> BGFX_TEXTURE_RT_MSAA_SHIFT, 1)];
+		m_type = VK_IMAGE_VIEW_TYPE_2D;
+		m_numMips = 1;
+		m_numSides = 1;
+
+		VkResult result = createImages(_commandBuffer);
+
+		if (VK_SUCCESS == result)
+		{
+			const VkImageLayout layout = 0 != (m_aspectFlags & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT) )
+				? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+				: VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+				;
+			setImageMemoryBarrier(_commandBuffer, layout);
+		}
+
+		return result;
+	}
+
+	VkResult TextureVK::createImages(VkCommandBuffer _commandBuffer)
+	{
+		BGFX_PROFILER_SCOPE("TextureVK::createImages", kColorResource);
+
+		VkResult result = VK_SUCCESS;
+
+		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
+		const VkDevice device = s_renderVK->m_device;
+
+		if (m_sampler.Count > 1)
+		{
+			BX_ASSERT(VK_IMAGE_VIEW_TYPE_3D != m_type, "Can't create multisample 3D image.");
+			BX_ASSERT(m_numMips <= 1, "Can't create multisample image with mip chain.");
+		}
+
+		// create texture and allocate its device memory
+		VkImageCreateInfo ici;
+		ici.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		ici.pNext = NULL;
+		ici.flags = 0
+			| (VK_IMAGE_VIEW_TYPE_CUBE == m_type
+				? VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT
+				: 0
+				)
+			| (VK_IMAGE_VIEW_TYPE_3D == m_type
+				? VK_IMAGE_CREATE_2D_ARRAY_COMPATIBLE_BIT_KHR
+				: 0
+				)
+			;
+		ici.pQueueFamilyIndices   = NULL;
+		ici.queueFamilyIndexCount = 0;
+		ici.initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED;
+		ici.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
+		ici.usage                 = 0
+			| VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+			| VK_IMAGE_USAGE_TRANSFER_DST_BIT
+			| VK_IMAGE_USAGE_SAMPLED_BIT
+			| (m_flags & BGFX_TEXTURE_RT_MASK
+				? (m_aspectFlags & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT)
+					? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT
+					: VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+					)
+				: 0
+				)
+			| (m_flags & BGFX_TEXTURE_COMPUTE_WRITE ? VK_IMAGE_USAGE_STORAGE_BIT : 0)
+			;
+		ici.format        = m_format;
+		ici.samples       = m_sampler.Sample;
+		ici.mipLevels     = m_numMips;
+		ici.arrayLayers   = m_numSides;
+		ici.extent.width  = m_width;
+		ici.extent.height = m_height;
+		ici.extent.depth  = m_depth;
+		ici.imageType     = VK_IMAGE_VIEW_TYPE_3D == m_type
+			? VK_IMAGE_TYPE_3D
+			: VK_IMAGE_TYPE_2D
+			;
+		ici.tiling        = VK_IMAGE_TILING_OPTIMAL;
+
+		result = vkCreateImage(device, &ici, allocatorCb, &m_textureImage);
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("Create texture image error: vkCreateImage failed %d: %s.", result, getName(result) );
+			return result;
+		}
+
+		VkMemoryRequirements imageMemReq;
+		vkGetImageMemoryRequirements(device, m_textureImage, &imageMemReq);
+
+		result = s_renderVK->allocateMemory(&imageMemReq, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &m_textureDeviceMem, false);
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("Create texture image error: allocateMemory failed %d: %s.", result, getName(result) );
+			return result;
+		}
+
+		result = vkBindImageMemory(device, m_textureImage, m_textureDeviceMem.mem, m_textureDeviceMem.offset);
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("Create texture image error: vkBindImageMemory failed %d: %s.", result, getName(result) );
+			return result;
+		}
+
+		m_sampledLayout = m_flags & BGFX_TEXTURE_COMPUTE_WRITE
+			? VK_IMAGE_LAYOUT_GENERAL
+			: VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+			;
+
+		const bool needResolve = true
+			&& 1 < m_sampler.Count
+			&& 0 != (ici.usage & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT)
+			&& 0 == (m_flags & BGFX_TEXTURE_MSAA_SAMPLE)
+			&& 0 == (m_flags & BGFX_TEXTURE_RT_WRITE_ONLY)
+			;
+
+		if (needResolve)
+		{
+			VkImageCreateInfo ici_resolve = ici;
+			ici_resolve.samples = s_msaa[0].Sample;
+			ici_resolve.usage &= ~VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+			ici_resolve.flags &= ~VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+
+			result = vkCreateImage(device, &ici_resolve, allocatorCb, &m_singleMsaaImage);
+			if (VK_SUCCESS != result)
+			{
+				BX_TRACE("Create texture image error: vkCreateImage failed %d: %s.", result, getName(result) );
+				return result;
+			}
+
+			VkMemoryRequirements imageMemReq_resolve;
+			vkGetImageMemoryRequirements(device, m_singleMsaaImage, &imageMemReq_resolve);
+
+			result = s_renderVK->allocateMemory(&imageMemReq_resolve, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &m_singleMsaaDeviceMem, false);
+			if (VK_SUCCESS != result)
+			{
+				BX_TRACE("Create texture image error: allocateMemory failed %d: %s.", result, getName(result) );
+				return result;
+			}
+
+			result = vkBindImageMemory(device, m_singleMsaaImage, m_singleMsaaDeviceMem.mem, m_singleMsaaDeviceMem.offset);
+			if (VK_SUCCESS != result)
+			{
+				BX_TRACE("Create texture image error: vkBindImageMemory failed %d: %s.", result, getName(result) );
+				return result;
+			}
+
+			setImageMemoryBarrier(_commandBuffer, m_sampledLayout, true);
+		}
+
+		return result;
+	}
+
+	void* TextureVK::create(VkCommandBuffer _commandBuffer, const Memory* _mem, uint64_t _flags, uint8_t _skip)
+	{
+		BGFX_PROFILER_SCOPE("TextureVK::create", kColorResource);
+
+		bimg::ImageContainer imageContainer;
+
+		if (bimg::imageParse(imageContainer, _mem->data, _mem->size) )
+		{
+			const bimg::ImageBlockInfo& blockInfo = bimg::getBlockInfo(imageContainer.m_format);
+			const uint8_t startLod = bx::min<uint8_t>(_skip, imageContainer.m_numMips - 1);
+
+			bimg::TextureInfo ti;
+			bimg::imageGetSize(
+				  &ti
+				, uint16_t(imageContainer.m_width  >> startLod)
+				, uint16_t(imageContainer.m_height >> startLod)
+				, uint16_t(imageContainer.m_depth  >> startLod)
+				, imageContainer.m_cubeMap
+				, 1 < imageContainer.m_numMips
+				, imageContainer.m_numLayers
+				, imageContainer.m_format
+				);
+
+			ti.numMips = bx::min<uint8_t>(imageContainer.m_numMips - startLod, ti.numMips);
+
+			m_flags     = _flags;
+			m_width     = ti.width;
+			m_height    = ti.height;
+			m_depth     = ti.depth;
+			m_numLayers = ti.numLayers;
+			m_requestedFormat = uint8_t(imageContainer.m_format);
+			m_textureFormat   = uint8_t(getViableTextureFormat(imageContainer) );
+			m_format = bimg::isDepth(bimg::TextureFormat::Enum(m_textureFormat) )
+				? s_textureFormat[m_textureFormat].m_fmtDsv
+				: (m_flags & BGFX_TEXTURE_SRGB) ? s_textureFormat[m_textureFormat].m_fmtSrgb : s_textureFormat[m_textureFormat].m_fmt
+				;
+			m_components = s_textureFormat[m_textureFormat].m_mapping;
+
+			const bool convert = m_textureFormat != m_requestedFormat;
+			const uint8_t bpp = bimg::getBitsPerPixel(bimg::TextureFormat::Enum(m_textureFormat) );
+
+			m_aspectFlags = getAspectMask(m_format);
+			m_sampler = s_msaa[bx::uint32_satsub( (m_flags & BGFX_TEXTURE_RT_MSAA_MASK) >> BGFX_TEXTURE_RT_MSAA_SHIFT, 1)];
+
+			if (imageContainer.m_cubeMap)
+			{
+				m_type = imageContainer.m_numLayers > 1
+					? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY
+					: VK_IMAGE_VIEW_TYPE_CUBE
+					;
+			}
+			else if (imageContainer.m_depth > 1)
+			{
+				m_type = VK_IMAGE_VIEW_TYPE_3D;
+			}
+			else if (imageContainer.m_numLayers > 1)
+			{
+				m_type = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+			}
+			else
+			{
+				m_type = VK_IMAGE_VIEW_TYPE_2D;
+			}
+
+			m_numMips = ti.numMips;
+			m_numSides = ti.numLayers * (imageContainer.m_cubeMap ? 6 : 1);
+			const uint16_t numSides = ti.numLayers * (imageContainer.m_cubeMap ? 6 : 1);
+			const uint32_t numSrd = numSides * ti.numMips;
+
+			uint32_t kk = 0;
+
+			const bool compressed = bimg::isCompressed(bimg::TextureFormat::Enum(m_textureFormat) );
+			const bool swizzle = TextureFormat::BGRA8 == m_textureFormat && 0 != (m_flags & BGFX_TEXTURE_COMPUTE_WRITE);
+
+			const bool writeOnly    = 0 != (m_flags & BGFX_TEXTURE_RT_WRITE_ONLY);
+			const bool computeWrite = 0 != (m_flags & BGFX_TEXTURE_COMPUTE_WRITE);
+			const bool renderTarget = 0 != (m_flags & BGFX_TEXTURE_RT_MASK);
+			const bool blit         = 0 != (m_flags & BGFX_TEXTURE_BLIT_DST);
+
+			BX_UNUSED(swizzle, writeOnly, computeWrite, renderTarget, blit);
+
+			BX_TRACE(
+				  "Texture %3d: %s (requested: %s), %dx%dx%d%s RT[%c], BO[%c], CW[%c]%s."
+				, (int)(this - s_renderVK->m_textures)
+				, getName( (TextureFormat::Enum)m_textureFormat)
+				, getName( (TextureFormat::Enum)m_requestedFormat)
+				, ti.width
+				, ti.height
+				, ti.depth
+				, imageContainer.m_cubeMap ? "x6" : ""
+				, renderTarget ? 'x' : ' '
+				, writeOnly ? 'x' : ' '
+				, computeWrite ? 'x' : ' '
+				, swizzle ? " (swizzle BGRA8 -> RGBA8)" : ""
+				);
+
+			VK_CHECK(createImages(_commandBuffer) );
+
+			// decode images
+			struct ImageInfo
+			{
+				uint8_t* data;
+				uint32_t width;
+				uint32_t height;
+				uint32_t depth;
+				uint32_t pitch;
+				uint32_t slice;
+				uint32_t size;
+				uint32_t mipLevel;
+				uint32_t layer;
+			};
+
+			ImageInfo* imageInfos = (ImageInfo*)bx::alloc(g_allocator, sizeof(ImageInfo) * numSrd);
+			bx::memSet(imageInfos, 0, sizeof(ImageInfo) * numSrd);
+			uint32_t alignment = 1; // tightly aligned buffer
+
+			for (uint16_t side = 0; side < numSides; ++side)
+			{
+				for (uint8_t lod = 0; lod < ti.numMips; ++lod)
+				{
+					bimg::ImageMip mip;
+
+					if (bimg::imageGetRawData(imageContainer, side, lod + startLod, _mem->data, _mem->size, mip) )
+					{
+						if (convert)
+						{
+							const uint32_t pitch = bx::strideAlign(bx::max<uint32_t>(mip.m_width, 4) * bpp / 8, alignment);
+							const uint32_t slice = bx::strideAlign(bx::max<uint32_t>(mip.m_height, 4) * pitch, alignment);
+							const uint32_t size  = slice * mip.m_depth;
+
+							uint8_t* temp = (uint8_t*)bx::alloc(g_allocator, size);
+							bimg::imageDecodeToBgra8(
+								  g_allocator
+								, temp
+								, mip.m_data
+								, mip.m_width
+								, mip.m_height
+								, pitch
+								, mip.m_format
+								);
+
+							imageInfos[kk].data     = temp;
+							imageInfos[kk].width    = mip.m_width;
+							imageInfos[kk].height   = mip.m_height;
+							imageInfos[kk].depth    = mip.m_depth;
+							imageInfos[kk].pitch    = pitch;
+							imageInfos[kk].slice    = slice;
+							imageInfos[kk].size     = size;
+							imageInfos[kk].mipLevel = lod;
+							imageInfos[kk].layer    = side;
+						}
+						else if (compressed)
+						{
+							const uint32_t pitch = bx::strideAlign( (mip.m_width / blockInfo.blockWidth) * mip.m_blockSize, alignment);
+							const uint32_t slice = bx::strideAlign( (mip.m_height / blockInfo.blockHeight) * pitch, alignment);
+							const uint32_t size  = slice * mip.m_depth;
+
+							uint8_t* temp = (uint8_t*)bx::alloc(g_allocator, size);
+							bimg::imageCopy(
+								  temp
+								, mip.m_height / blockInfo.blockHeight
+								, (mip.m_width / blockInfo.blockWidth) * mip.m_blockSize
+								, mip.m_depth
+								, mip.m_data
+								, pitch
+								);
+
+							imageInfos[kk].data     = temp;
+							imageInfos[kk].width    = mip.m_width;
+							imageInfos[kk].height   = mip.m_height;
+							imageInfos[kk].depth    = mip.m_depth;
+							imageInfos[kk].pitch    = pitch;
+							imageInfos[kk].slice    = slice;
+							imageInfos[kk].size     = size;
+							imageInfos[kk].mipLevel = lod;
+							imageInfos[kk].layer    = side;
+						}
+						else
+						{
+							const uint32_t pitch = bx::strideAlign(mip.m_width * mip.m_bpp / 8, alignment);
+							const uint32_t slice = bx::strideAlign(mip.m_height * pitch, alignment);
+							const uint32_t size  = slice * mip.m_depth;
+
+							uint8_t* temp = (uint8_t*)bx::alloc(g_allocator, size);
+							bimg::imageCopy(
+								  temp
+								, mip.m_height
+								, mip.m_width * mip.m_bpp / 8
+								, mip.m_depth
+								, mip.m_data
+								, pitch
+								);
+
+							imageInfos[kk].data     = temp;
+							imageInfos[kk].width    = mip.m_width;
+							imageInfos[kk].height   = mip.m_height;
+							imageInfos[kk].depth    = mip.m_depth;
+							imageInfos[kk].pitch    = pitch;
+							imageInfos[kk].slice    = slice;
+							imageInfos[kk].size     = size;
+							imageInfos[kk].mipLevel = lod;
+							imageInfos[kk].layer    = side;
+						}
+					}
+					++kk;
+				}
+			}
+
+			uint32_t totalMemSize = 0;
+			VkBufferImageCopy* bufferCopyInfo = (VkBufferImageCopy*)bx::alloc(g_allocator, sizeof(VkBufferImageCopy) * numSrd);
+
+			for (uint32_t ii = 0; ii < numSrd; ++ii)
+			{
+				const uint32_t idealWidth  = bx::max<uint32_t>(1, m_width  >> imageInfos[ii].mipLevel);
+				const uint32_t idealHeight = bx::max<uint32_t>(1, m_height >> imageInfos[ii].mipLevel);
+				bufferCopyInfo[ii].bufferOffset      = totalMemSize;
+				bufferCopyInfo[ii].bufferRowLength   = 0; // assume that image data are tightly aligned
+				bufferCopyInfo[ii].bufferImageHeight = 0; // assume that image data are tightly aligned
+				bufferCopyInfo[ii].imageSubresource.aspectMask     = m_aspectFlags;
+				bufferCopyInfo[ii].imageSubresource.mipLevel       = imageInfos[ii].mipLevel;
+				bufferCopyInfo[ii].imageSubresource.baseArrayLayer = imageInfos[ii].layer;
+				bufferCopyInfo[ii].imageSubresource.layerCount     = 1;
+				bufferCopyInfo[ii].imageOffset = { 0, 0, 0 };
+				bufferCopyInfo[ii].imageExtent = { idealWidth, idealHeight, imageInfos[ii].depth };
+				totalMemSize += imageInfos[ii].size;
+			}
+
+			if (totalMemSize > 0)
+			{
+				const VkDevice device = s_renderVK->m_device;
+				const bimg::ImageBlockInfo &dstBlockInfo = bimg::getBlockInfo(bimg::TextureFormat::Enum(m_textureFormat) );
+
+				StagingBufferVK stagingBuffer = s_renderVK->allocFromScratchStagingBuffer(totalMemSize, dstBlockInfo.blockSize);
+
+				uint8_t* mappedMemory;
+
+				if (!stagingBuffer.m_isFromScratch)
+				{
+					VK_CHECK(vkMapMemory(
+						  device
+						, stagingBuffer.m_deviceMem.mem
+						, stagingBuffer.m_deviceMem.offset
+						, totalMemSize
+						, 0
+						, (void**)&mappedMemory
+						) );
+				}
+				else
+				{
+					mappedMemory = stagingBuffer.m_data;
+				}
+
+				// copy image to staging buffer
+				for (uint32_t ii = 0; ii < numSrd; ++ii)
+				{
+					bx::memCopy(mappedMemory, imageInfos[ii].data, imageInfos[ii].size);
+					mappedMemory += imageInfos[ii].size;
+					bufferCopyInfo[ii].bufferOffset += stagingBuffer.m_offset;
+					BX_ASSERT(
+						  bx::uint32_mod(bx::narrowCast<uint32_t>(bufferCopyInfo[ii].bufferOffset), dstBlockInfo.blockSize) == 0
+						, "Alignment for subimage %u is not aligned correctly (%u)."
+						, ii, bufferCopyInfo[ii].bufferOffset, dstBlockInfo.blockSize
+						);
+				}
+
+				if (!stagingBuffer.m_isFromScratch)
+				{
+					vkUnmapMemory(device, stagingBuffer.m_deviceMem.mem);
+				}
+
+				copyBufferToTexture(_commandBuffer, stagingBuffer.m_buffer, numSrd, bufferCopyInfo);
+
+				if (!stagingBuffer.m_isFromScratch)
+				{
+					s_renderVK->release(stagingBuffer.m_buffer);
+					s_renderVK->recycleMemory(stagingBuffer.m_deviceMem);
+				}
+			}
+			else
+			{
+				setImageMemoryBarrier(_commandBuffer, m_sampledLayout);
+			}
+
+			bx::free(g_allocator, bufferCopyInfo);
+
+			for (uint32_t ii = 0; ii < numSrd; ++ii)
+			{
+				bx::free(g_allocator, imageInfos[ii].data);
+			}
+
+			bx::free(g_allocator, imageInfos);
+
+			m_readback.create(m_textureImage, m_width, m_height, TextureFormat::Enum(m_textureFormat) );
+		}
+
+		return m_directAccessPtr;
+	}
+
+	void TextureVK::destroy()
+	{
+		BGFX_PROFILER_SCOPE("TextureVK::destroy", kColorResource);
+
+		m_readback.destroy();
+
+		if (VK_NULL_HANDLE != m_textureImage)
+		{
+			s_renderVK->release(m_textureImage);
+			s_renderVK->recycleMemory(m_textureDeviceMem);
+		}
+
+		if (VK_NULL_HANDLE != m_singleMsaaImage)
+		{
+			s_renderVK->release(m_singleMsaaImage);
+			s_renderVK->recycleMemory(m_singleMsaaDeviceMem);
+		}
+
+		m_aspectFlags = VK_IMAGE_ASPECT_NONE;
+		m_currentImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		m_currentSingleMsaaImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		m_uploadPending = false;
+	}
+
+	void TextureVK::update(VkCommandBuffer _commandBuffer, uint8_t _side, uint8_t _mip, const Rect& _rect, uint16_t _z, uint16_t _depth, uint16_t _pitch, const Memory* _mem)
+	{
+		BGFX_PROFILER_SCOPE("TextureVK::update", kColorResource);
+
+		const uint32_t bpp = bimg::getBitsPerPixel(bimg::TextureFormat::Enum(m_textureFormat) );
+		const bimg::ImageBlockInfo& blockInfo = bimg::getBlockInfo(bimg::TextureFormat::Enum(m_textureFormat) );
+		uint32_t rectpitch = _rect.m_width * bpp / 8;
+		uint32_t slicepitch = rectpitch * _rect.m_height;
+		uint32_t align = m_uploadPending
+			? bx::uint32_lcm(blockInfo.blockSize, 4) // Buffer offset on upload queue must be multiple of 4.
+			: blockInfo.blockSize
+			;
+		if (bimg::isCompressed(bimg::TextureFormat::Enum(m_textureFormat) ) )
+		{
+			rectpitch  = (_rect.m_width  / blockInfo.blockWidth ) * blockInfo.blockSize;
+			slicepitch = (_rect.m_height / blockInfo.blockHeight) * rectpitch;
+		}
+		const uint32_t srcpitch = UINT16_MAX == _pitch ? rectpitch : _pitch;
+		const uint32_t size     = UINT16_MAX == _pitch ? slicepitch  * _depth: _rect.m_height * _pitch * _depth;
+		const bool convert = m_textureFormat != m_requestedFormat;
+
+		VkBufferImageCopy region;
+		region.bufferOffset      = 0;
+		region.bufferRowLength   = (_pitch == UINT16_MAX ? 0 : _pitch * 8 / bpp);
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask     = m_aspectFlags;
+		region.imageSubresource.mipLevel       = _mip;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount     = 1;
+		region.imageOffset = { _rect.m_x,     _rect.m_y,      0      };
+		region.imageExtent = { _rect.m_width, _rect.m_height, _depth };
+
+		uint8_t* data = _mem->data;
+		uint8_t* temp = NULL;
+
+		if (convert)
+		{
+			temp = (uint8_t*)bx::alloc(g_allocator, slicepitch);
+			bimg::imageDecodeToBgra8(g_allocator, temp, data, _rect.m_width, _rect.m_height, srcpitch, bimg::TextureFormat::Enum(m_requestedFormat) );
+			data = temp;
+
+			region.imageExtent =
+			{
+				bx::max(1u, m_width  >> _mip),
+				bx::max(1u, m_height >> _mip),
+				_depth,
+			};
 		}
 
 		StagingBufferVK stagingBuffer = s_renderVK->allocFromScratchStagingBuffer(size, align, data);
@@ -6814,2166 +8723,3281 @@ retry:
 				"Alignment for image (mip %u, z %u) is not aligned correctly (%u).",
 				_mip, _z, region.bufferOffset, align);
 
-		if (VK_IMAGE_VIEW_TYPE_3D == m_type)
+		if (VK_IMAGE_VIEW_TYPE_3D == m_type)
+		{
+			region.imageOffset.z = _z;
+		}
+		else if (VK_IMAGE_VIEW_TYPE_CUBE == m_type
+		||       VK_IMAGE_VIEW_TYPE_CUBE_ARRAY == m_type)
+		{
+			region.imageSubresource.baseArrayLayer = _z * 6 + _side;
+		}
+		else
+		{
+			region.imageSubresource.baseArrayLayer = _z;
+		}
+
+		copyBufferToTexture(_commandBuffer, stagingBuffer.m_buffer, 1, &region);
+
+		if (!stagingBuffer.m_isFromScratch)
+		{
+			s_renderVK->release(stagingBuffer.m_buffer);
+			s_renderVK->recycleMemory(stagingBuffer.m_deviceMem);
+		}
+
+		if (NULL != temp)
+		{
+			bx::free(g_allocator, temp);
+		}
+	}
+
+	void TextureVK::resolve(VkCommandBuffer _commandBuffer, uint8_t _resolve, uint32_t _layer, uint32_t _numLayers, uint32_t _mip)
+	{
+		BGFX_PROFILER_SCOPE("TextureVK::resolve", kColorResource);
+
+		const bool needResolve = VK_NULL_HANDLE != m_singleMsaaImage;
+
+		const bool needMipGen = true
+			&& !needResolve
+			&& 0 != (m_flags & BGFX_TEXTURE_RT_MASK)
+			&& 0 == (m_flags & BGFX_TEXTURE_RT_WRITE_ONLY)
+			&& (_mip + 1) < m_numMips
+			&& 0 != (_resolve & BGFX_RESOLVE_AUTO_GEN_MIPS)
+			;
+
+		const VkImageLayout oldLayout = m_currentImageLayout;
+		const VkImageLayout oldSingleMsaaLayout = m_currentSingleMsaaImageLayout;
+
+		const uint32_t numLayers = false
+			|| m_type == VK_IMAGE_VIEW_TYPE_CUBE
+			|| m_type == VK_IMAGE_VIEW_TYPE_CUBE_ARRAY
+			? m_numSides
+			: _numLayers
+			;
+
+		if (needResolve)
+		{
+			setImageMemoryBarrier(_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+			setImageMemoryBarrier(_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true);
+
+			VkImageResolve resolve;
+			resolve.srcOffset.x = 0;
+			resolve.srcOffset.y = 0;
+			resolve.srcOffset.z = 0;
+			resolve.dstOffset.x = 0;
+			resolve.dstOffset.y = 0;
+			resolve.dstOffset.z = 0;
+			resolve.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+			resolve.srcSubresource.mipLevel       = _mip;
+			resolve.srcSubresource.baseArrayLayer = _layer;
+			resolve.srcSubresource.layerCount     = numLayers;
+			resolve.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+			resolve.dstSubresource.mipLevel       = _mip;
+			resolve.dstSubresource.baseArrayLayer = _layer;
+			resolve.dstSubresource.layerCount     = numLayers;
+			resolve.extent.width  = m_width;
+			resolve.extent.height = m_height;
+			resolve.extent.depth  = 1;
+
+			vkCmdResolveImage(
+				  _commandBuffer
+				, m_textureImage
+				, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+				, m_singleMsaaImage
+				, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+				, 1
+				, &resolve
+				);
+		}
+
+		if (needMipGen)
+		{
+			BGFX_PROFILER_SCOPE("Resolve - Generate Mipmaps", kColorResource);
+
+			setImageMemoryBarrier(_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+			int32_t mipWidth  = bx::max<int32_t>(int32_t(m_width)  >> _mip, 1);
+			int32_t mipHeight = bx::max<int32_t>(int32_t(m_height) >> _mip, 1);
+
+			const VkFilter filter = bimg::isDepth(bimg::TextureFormat::Enum(m_textureFormat) )
+				? VK_FILTER_NEAREST
+				: VK_FILTER_LINEAR
+				;
+
+			VkImageBlit blit;
+			blit.srcOffsets[0] = { 0, 0, 0 };
+			blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
+			blit.srcSubresource.aspectMask     = m_aspectFlags;
+			blit.srcSubresource.mipLevel       = 0;
+			blit.srcSubresource.baseArrayLayer = _layer;
+			blit.srcSubresource.layerCount     = numLayers;
+			blit.dstOffsets[0] = { 0, 0, 0 };
+			blit.dstOffsets[1] = { mipWidth, mipHeight, 1 };
+			blit.dstSubresource.aspectMask     = m_aspectFlags;
+			blit.dstSubresource.mipLevel       = 0;
+			blit.dstSubresource.baseArrayLayer = _layer;
+			blit.dstSubresource.layerCount     = numLayers;
+
+			for (uint32_t i = _mip + 1; i < m_numMips; i++)
+			{
+				BGFX_PROFILER_SCOPE("Mipmap", kColorResource);
+
+				blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
+				blit.srcSubresource.mipLevel = i - 1;
+
+				mipWidth  = bx::uint32_max(mipWidth  >> 1, 1);
+				mipHeight = bx::uint32_max(mipHeight >> 1, 1);
+
+				blit.dstOffsets[1] = { mipWidth, mipHeight, 1 };
+				blit.dstSubresource.mipLevel = i;
+
+				vk::setImageMemoryBarrier(
+					  _commandBuffer
+					, m_textureImage
+					, m_aspectFlags
+					, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+					, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+					, blit.srcSubresource.mipLevel
+					, 1
+					, _layer
+					, numLayers
+					);
+
+				vkCmdBlitImage(
+					  _commandBuffer
+					, m_textureImage
+					, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+					, m_textureImage
+					, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+					, 1
+					, &blit
+					, filter
+					);
+			}
+
+			vk::setImageMemoryBarrier(
+				  _commandBuffer
+				, m_textureImage
+				, m_aspectFlags
+				, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+				, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+				, _mip
+				, m_numMips - _mip - 1
+				, _layer
+				, numLayers
+				);
+		}
+
+		setImageMemoryBarrier(_commandBuffer, oldLayout);
+		setImageMemoryBarrier(_commandBuffer, oldSingleMsaaLayout, true);
+	}
+
+	void TextureVK::copyBufferToTexture(VkCommandBuffer _commandBuffer, VkBuffer _stagingBuffer, uint32_t _bufferImageCopyCount, VkBufferImageCopy* _bufferImageCopy)
+	{
+		BGFX_PROFILER_SCOPE("TextureVK::copyBufferToTexture", kColorResource);
+
+		UploadQueueVK& upload = s_renderVK->m_upload;
+
+		if (upload.isOpen() )
+		{
+			const bimg::ImageBlockInfo& blockInfo = bimg::getBlockInfo(bimg::TextureFormat::Enum(m_textureFormat) );
+
+			bool aligned = true;
+			uint32_t size = 0;
+
+			for (uint32_t ii = 0; ii < _bufferImageCopyCount; ++ii)
+			{
+				const VkBufferImageCopy& bic = _bufferImageCopy[ii];
+				aligned &= 0 == (bic.bufferOffset & 3);
+				size += 0
+					+ bx::max<uint32_t>(1, (bic.imageExtent.width  + blockInfo.blockWidth  - 1) / blockInfo.blockWidth )
+					* bx::max<uint32_t>(1, (bic.imageExtent.height + blockInfo.blockHeight - 1) / blockInfo.blockHeight)
+					* bic.imageExtent.depth
+					* bic.imageSubresource.layerCount
+					* blockInfo.blockSize
+					;
+			}
+
+			// Image that was never used by graphics queue can be uploaded on
+			// upload queue. Transfer only queue can't copy depth/stencil aspect.
+			if (!m_uploadPending
+			&&  aligned
+			&&  VK_IMAGE_LAYOUT_UNDEFINED == m_currentImageLayout
+			&&  VK_IMAGE_ASPECT_COLOR_BIT == m_aspectFlags
+			&&  0 == (m_flags & BGFX_TEXTURE_RT_MASK) )
+			{
+				m_uploadPending = upload.claim(*this);
+			}
+
+			if (m_uploadPending)
+			{
+				BX_ASSERT(aligned, "Buffer offset on upload queue must be multiple of 4.");
+				upload.copyBufferToImage(*this, _stagingBuffer, _bufferImageCopyCount, _bufferImageCopy, size);
+				return;
+			}
+		}
+
+		const VkImageLayout oldLayout = m_currentImageLayout == VK_IMAGE_LAYOUT_UNDEFINED
+			? m_sampledLayout
+			: m_currentImageLayout
+			;
+
+		setImageMemoryBarrier(_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+		bimg::TextureFormat::Enum format = bimg::TextureFormat::Enum(m_textureFormat);
+		const bimg::ImageBlockInfo& blockInfo = bimg::getBlockInfo(format);
+		for (uint32_t ii = 0; ii < _bufferImageCopyCount; ++ii)
+		{
+			BX_ASSERT(
+				  bx::uint32_mod(bx::narrowCast<uint32_t>(_bufferImageCopy[ii].bufferOffset), blockInfo.blockSize) == 0
+				, "Misaligned texture of type %s to offset %u, which is not a multiple of %u."
+				, bimg::getName(format), _bufferImageCopy[ii].bufferOffset, blockInfo.blockSize
+				);
+		}
+		BX_UNUSED(blockInfo);
+
+		vkCmdCopyBufferToImage(
+			  _commandBuffer
+			, _stagingBuffer
+			, m_textureImage
+			, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+			, _bufferImageCopyCount
+			, _bufferImageCopy
+			);
+
+		setImageMemoryBarrier(_commandBuffer, oldLayout);
+	}
+
+	VkImageLayout TextureVK::setImageMemoryBarrier(VkCommandBuffer _commandBuffer, VkImageLayout _newImageLayout, bool _singleMsaaImage)
+	{
+		if (_singleMsaaImage && VK_NULL_HANDLE == m_singleMsaaImage)
+		{
+			return VK_IMAGE_LAYOUT_UNDEFINED;
+		}
+
+		VkImageLayout& currentLayout = _singleMsaaImage
+			? m_currentSingleMsaaImageLayout
+			: m_currentImageLayout
+			;
+
+		const VkImageLayout oldLayout = currentLayout;
+
+		if (currentLayout == _newImageLayout)
+		{
+			return oldLayout;
+		}
+
+		const VkImage image = _singleMsaaImage
+			? m_singleMsaaImage
+			: m_textureImage
+			;
+
+		vk::setImageMemoryBarrier(
+			  _commandBuffer
+			, image
+			, m_aspectFlags
+			, currentLayout
+			, _newImageLayout
+			);
+
+		currentLayout = _newImageLayout;
+		return oldLayout;
+	}
+
+	VkResult TextureVK::createView(uint32_t _layer, uint32_t _numLayers, uint32_t _mip, uint32_t _numMips, VkImageViewType _type, VkImageAspectFlags _aspectMask, bool _renderTarget, ::VkImageView* _view) const
+	{
+		VkResult result = VK_SUCCESS;
+
+		if (VK_IMAGE_VIEW_TYPE_3D == m_type)
+		{
+			BX_ASSERT(false
+				  || !_renderTarget
+				  || !(m_aspectFlags & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT) )
+				, "3D image can't be a depth attachment"
+			);
+		}
+
+		if (VK_IMAGE_VIEW_TYPE_CUBE       == _type
+		||  VK_IMAGE_VIEW_TYPE_CUBE_ARRAY == _type)
+		{
+			BX_ASSERT(_numLayers % 6 == 0, "");
+			BX_ASSERT(
+				  VK_IMAGE_VIEW_TYPE_3D != m_type
+				, "3D image can't be aliased as a cube texture"
+				);
+		}
+
+		VkImageViewCreateInfo viewInfo;
+		viewInfo.sType      = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.pNext      = NULL;
+		viewInfo.flags      = 0;
+		viewInfo.image      = ( (VK_NULL_HANDLE != m_singleMsaaImage) && !_renderTarget)
+			? m_singleMsaaImage
+			: m_textureImage
+			;
+		viewInfo.viewType   = _type;
+		viewInfo.format     = m_format;
+		viewInfo.components = m_components;
+		viewInfo.subresourceRange.aspectMask     = m_aspectFlags & _aspectMask;
+		viewInfo.subresourceRange.baseMipLevel   = _mip;
+		viewInfo.subresourceRange.levelCount     = _numMips;
+		viewInfo.subresourceRange.baseArrayLayer = _layer;
+		viewInfo.subresourceRange.layerCount     = 1;
+
+		if (VK_IMAGE_VIEW_TYPE_2D != _type
+		&&  VK_IMAGE_VIEW_TYPE_3D != _type)
+		{
+			viewInfo.subresourceRange.layerCount = VK_IMAGE_VIEW_TYPE_CUBE == _type
+				? 6
+				: _numLayers
+				;
+		}
+
+		VkImageView view = VK_NULL_HANDLE;
+
+		result = vkCreateImageView(
+			  s_renderVK->m_device
+			, &viewInfo
+			, s_renderVK->m_allocatorCb
+			, &view
+			);
+
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("Create texture view error: vkCreateImageView failed %d: %s.", result, getName(result) );
+			return result;
+		}
+
+		*_view = view;
+
+		return result;
+	}
+
+	VkImageAspectFlags TextureVK::getAspectMask(VkFormat _format)
+	{
+		switch (_format)
+		{
+		case VK_FORMAT_S8_UINT:
+			return VK_IMAGE_ASPECT_STENCIL_BIT;
+
+		case VK_FORMAT_D16_UNORM:
+		case VK_FORMAT_X8_D24_UNORM_PACK32:
+		case VK_FORMAT_D32_SFLOAT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT;
+
+		case VK_FORMAT_D16_UNORM_S8_UINT:
+		case VK_FORMAT_D24_UNORM_S8_UINT:
+		case VK_FORMAT_D32_SFLOAT_S8_UINT:
+			return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+
+		default:
+			return VK_IMAGE_ASPECT_COLOR_BIT;
+		}
+	}
+
+	VkResult SwapChainVK::create(VkCommandBuffer _commandBuffer, void* _nwh, const Resolution& _resolution)
+	{
+		struct ErrorState
+		{
+			enum Enum
+			{
+				Default,
+				SurfaceCreated,
+				SwapChainCreated,
+				AttachmentsCreated
+			};
+		};
+
+		ErrorState::Enum errorState = ErrorState::Default;
+
+		VkResult result = VK_SUCCESS;
+
+		if (NULL == _nwh)
+		{
+			return result;
+		}
+
+		m_nwh = _nwh;
+		m_resolution = _resolution;
+
+		m_queue = s_renderVK->m_globalQueue;
+
+		result = createSurface();
+
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("Create swap chain error: creating surface failed %d: %s.", result, getName(result) );
+			goto error;
+		}
+
+		errorState = ErrorState::SurfaceCreated;
+
+		{
+			m_sci.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+			m_sci.pNext = NULL;
+			m_sci.flags = 0;
+			m_sci.imageArrayLayers      = 1;
+			m_sci.imageSharingMode      = VK_SHARING_MODE_EXCLUSIVE;
+			m_sci.queueFamilyIndexCount = 0;
+			m_sci.preTransform          = BX_ENABLED(BX_PLATFORM_NX)
+				? VK_SURFACE_TRANSFORM_INHERIT_BIT_KHR
+				: VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR
+				;
+			m_sci.oldSwapchain          = VK_NULL_HANDLE;
+
+			for (uint32_t ii = 0; ii < BX_COUNTOF(m_backBufferColorImageView); ++ii)
+			{
+				m_backBufferColorImage[ii]     = VK_NULL_HANDLE;
+				m_backBufferColorImageView[ii] = VK_NULL_HANDLE;
+				m_backBufferFrameBuffer[ii]    = VK_NULL_HANDLE;
+				m_backBufferFence[ii]          = VK_NULL_HANDLE;
+				m_presentDoneSemaphore[ii]     = VK_NULL_HANDLE;
+				m_renderDoneSemaphore[ii]      = VK_NULL_HANDLE;
+			}
+
+			m_lastImageRenderedSemaphore = VK_NULL_HANDLE;
+			m_lastImageAcquiredSemaphore = VK_NULL_HANDLE;
+
+			result = createSwapChain();
+
+			if (VK_SUCCESS != result)
+			{
+				BX_TRACE("Create swap chain error: creating swapchain and image views failed %d: %s", result, getName(result) );
+				goto error;
+			}
+		}
+
+		errorState = ErrorState::SwapChainCreated;
+
+		{
+			result = createAttachments(_commandBuffer);
+
+			if (VK_SUCCESS != result)
+			{
+				BX_TRACE("Create swap chain error: creating MSAA/depth attachments failed %d: %s.", result, getName(result) );
+				goto error;
+			}
+		}
+
+		errorState = ErrorState::AttachmentsCreated;
+
+		{
+			result = createFrameBuffer();
+
+			if (VK_SUCCESS != result)
+			{
+				BX_TRACE("Create swap chain error: creating frame buffers failed %d: %s.", result, getName(result) );
+				goto error;
+			}
+		}
+
+		return VK_SUCCESS;
+
+	error:
+		BX_TRACE("errorState %d", errorState);
+		switch (errorState)
+		{
+		case ErrorState::AttachmentsCreated:
+			releaseAttachments();
+			[[fallthrough]];
+
+		case ErrorState::SwapChainCreated:
+			releaseSwapChain();
+			[[fallthrough]];
+
+		case ErrorState::SurfaceCreated:
+			releaseSurface();
+			[[fallthrough]];
+
+		case ErrorState::Default:
+			break;
+		};
+
+		return VK_SUCCESS != result
+			? result
+			: VK_ERROR_INITIALIZATION_FAILED
+			;
+	}
+
+	void SwapChainVK::destroy()
+	{
+		if (VK_NULL_HANDLE != m_swapChain)
+		{
+			releaseFrameBuffer();
+			releaseAttachments();
+			releaseSwapChain();
+			releaseSurface();
+
+			// can't delay-delete the surface, since there can only be one swapchain per surface
+			// new framebuffer with the same window would get an error at swapchain creation
+			s_renderVK->kick(true);
+		}
+
+		m_nwh = NULL;
+	}
+
+	void SwapChainVK::update(VkCommandBuffer _commandBuffer, void* _nwh, const Resolution& _resolution)
+	{
+		BGFX_PROFILER_SCOPE("SwapChainVK::update", kColorFrame);
+
+		const VkPhysicalDevice physicalDevice = s_renderVK->m_physicalDevice;
+
+		m_lastImageRenderedSemaphore = VK_NULL_HANDLE;
+		m_lastImageAcquiredSemaphore = VK_NULL_HANDLE;
+
+		const uint64_t recreateSurfaceMask     = BGFX_RESET_HIDPI;
+		const uint64_t recreateSwapchainMask   = BGFX_RESET_VSYNC | BGFX_RESET_SRGB_BACKBUFFER;
+		const uint64_t recreateAttachmentsMask = BGFX_RESET_MSAA_MASK;
+
+		const bool recreateSurface = false
+			|| m_needToRecreateSurface
+			|| m_nwh != _nwh
+			|| (m_resolution.reset & recreateSurfaceMask) != (_resolution.reset & recreateSurfaceMask)
+			;
+
+		const bool recreateSwapchain = false
+			|| m_needToRecreateSwapchain
+			|| m_resolution.formatColor        != _resolution.formatColor
+			|| m_resolution.formatDepthStencil != _resolution.formatDepthStencil
+			|| m_resolution.width              != _resolution.width
+			|| m_resolution.height             != _resolution.height
+			|| (m_resolution.reset & recreateSwapchainMask) != (_resolution.reset & recreateSwapchainMask)
+			|| recreateSurface
+			;
+
+		const bool recreateAttachments = false
+			|| (m_resolution.reset & recreateAttachmentsMask) != (_resolution.reset & recreateAttachmentsMask)
+			|| recreateSwapchain
+			;
+
+		m_nwh = _nwh;
+		m_resolution = _resolution;
+
+		if (recreateAttachments)
+		{
+			releaseFrameBuffer();
+			releaseAttachments();
+
+			if (recreateSwapchain)
+			{
+				releaseSwapChain();
+
+				if (recreateSurface)
+				{
+					m_sci.oldSwapchain = VK_NULL_HANDLE;
+					releaseSurface();
+					s_renderVK->kick(true);
+					_commandBuffer = s_renderVK->m_commandBuffer;
+
+					VkResult result = createSurface();
+					if (VK_SUCCESS != result)
+					{
+						BX_TRACE("Surface lost.");
+						return;
+					}
+				}
+
+				VkSurfaceCapabilitiesKHR surfaceCapabilities = {};
+				VkResult result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, m_surface, &surfaceCapabilities);
+
+				const uint32_t width = bx::clamp<uint32_t>(
+					  m_resolution.width
+					, surfaceCapabilities.minImageExtent.width
+					, surfaceCapabilities.maxImageExtent.width
+					);
+				const uint32_t height = bx::clamp<uint32_t>(
+					  m_resolution.height
+					, surfaceCapabilities.minImageExtent.height
+					, surfaceCapabilities.maxImageExtent.height
+					);
+
+				// swapchain can't have size 0
+				// on some platforms this happens when minimized
+				if (width  == 0
+				||  height == 0
+				||  VK_SUCCESS != result)
+				{
+					m_sci.oldSwapchain = VK_NULL_HANDLE;
+					s_renderVK->kick(true);
+					return;
+				}
+
+				VK_CHECK(createSwapChain() );
+			}
+
+			VK_CHECK(createAttachments(_commandBuffer) );
+			VK_CHECK(createFrameBuffer() );
+		}
+	}
+
+	VkResult SwapChainVK::createSurface()
+	{
+		BGFX_PROFILER_SCOPE("SwapChainVK::createSurface", kColorFrame);
+
+		VkResult result = VK_ERROR_EXTENSION_NOT_PRESENT;
+
+		const VkInstance instance = s_renderVK->m_instance;
+		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
+
+#if BX_PLATFORM_WINDOWS
+		{
+			if (NULL != vkCreateWin32SurfaceKHR)
+			{
+				VkWin32SurfaceCreateInfoKHR sci;
+				sci.sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR;
+				sci.pNext = NULL;
+				sci.flags     = 0;
+				sci.hinstance = (HINSTANCE)GetModuleHandle(NULL);
+				sci.hwnd      = (HWND)m_nwh;
+				result = vkCreateWin32SurfaceKHR(instance, &sci, allocatorCb, &m_surface);
+				BX_WARN(VK_SUCCESS == result, "vkCreateWin32SurfaceKHR failed %d: %s.", result, getName(result) );
+			}
+		}
+#elif BX_PLATFORM_ANDROID
+		{
+			if (NULL != vkCreateAndroidSurfaceKHR)
+			{
+				VkAndroidSurfaceCreateInfoKHR sci;
+				sci.sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR;
+				sci.pNext = NULL;
+				sci.flags = 0;
+				sci.window = (ANativeWindow*)m_nwh;
+				result = vkCreateAndroidSurfaceKHR(instance, &sci, allocatorCb, &m_surface);
+				BX_WARN(VK_SUCCESS == result, "vkCreateAndroidSurfaceKHR failed %d: %s.", result, getName(result) );
+			}
+		}
+#elif BX_PLATFORM_LINUX
+		{
+			if (g_platformData.type == bgfx::NativeWindowHandleType::Wayland)
+			{
+				if (s_extension[Extension::KHR_wayland_surface].m_supported
+				&&  NULL != vkCreateWaylandSurfaceKHR
+				   )
+				{
+					BX_TRACE("Attempting Wayland surface creation.");
+					VkWaylandSurfaceCreateInfoKHR sci;
+					sci.sType = VK_STRUCTURE_TYPE_WAYLAND_SURFACE_CREATE_INFO_KHR;
+					sci.pNext = NULL;
+					sci.flags = 0;
+					sci.display = (wl_display*)g_platformData.ndt;
+					sci.surface = (wl_surface*)m_nwh;
+					result = vkCreateWaylandSurfaceKHR(instance, &sci, allocatorCb, &m_surface);
+					BX_WARN(VK_SUCCESS == result, "vkCreateWaylandSurfaceKHR failed %d: %s.", result, getName(result) );
+				}
+			}
+			else
+			{
+				if (s_extension[Extension::KHR_xlib_surface].m_supported
+				&&  NULL != vkCreateXlibSurfaceKHR
+				   )
+				{
+					BX_TRACE("Attempting Xlib surface creation.");
+					VkXlibSurfaceCreateInfoKHR sci;
+					sci.sType = VK_STRUCTURE_TYPE_XLIB_SURFACE_CREATE_INFO_KHR;
+					sci.pNext = NULL;
+					sci.flags  = 0;
+					sci.dpy    = (Display*)g_platformData.ndt;
+					sci.window = (Window)m_nwh;
+					result = vkCreateXlibSurfaceKHR(instance, &sci, allocatorCb, &m_surface);
+					BX_WARN(VK_SUCCESS == result, "vkCreateXlibSurfaceKHR failed %d: %s.", result, getName(result) );
+				}
+
+				if (VK_SUCCESS != result
+				&&  s_extension[Extension::KHR_xcb_surface].m_supported
+				&&  NULL != vkCreateXcbSurfaceKHR
+				)
+				{
+					void* xcbdll = bx::dlopen("libX11-xcb.so.1");
+
+					if (NULL != xcbdll)
+					{
+						BX_TRACE("Attempting XCB surface creation.");
+						typedef xcb_connection_t* (*PFN_XGETXCBCONNECTION)(Display*);
+						PFN_XGETXCBCONNECTION XGetXCBConnection = (PFN_XGETXCBCONNECTION)bx::dlsym(xcbdll, "XGetXCBConnection");
+
+						VkXcbSurfaceCreateInfoKHR sci;
+						sci.sType      = VK_STRUCTURE_TYPE_XCB_SURFACE_CREATE_INFO_KHR;
+						sci.pNext      = NULL;
+						sci.flags      = 0;
+						sci.connection = XGetXCBConnection( (Display*)g_platformData.ndt);
+						sci.window     = bx::narrowCast<xcb_window_t>(uintptr_t(m_nwh) );
+						result = vkCreateXcbSurfaceKHR(instance, &sci, allocatorCb, &m_surface);
+						BX_WARN(VK_SUCCESS == result, "vkCreateXcbSurfaceKHR failed %d: %s.", result, getName(result) );
+
+						bx::dlclose(xcbdll);
+					}
+				}
+			}
+		}
+
+#elif BX_PLATFORM_OSX
 		{
-			region.imageOffset.z = _z;
+			if (NULL != vkCreateMacOSSurfaceMVK)
+			{
+				NSWindow* window    = (NSWindow*)(m_nwh);
+				CAMetalLayer* layer = (CAMetalLayer*)(m_nwh);
+
+				if ([window isKindOfClass:[NSWindow class]])
+				{
+					NSView *contentView = (NSView *)window.contentView;
+					layer               = [CAMetalLayer layer];
+
+					[contentView setWantsLayer : YES];
+					[contentView setLayer : layer];
+				}
+				else if ([layer isKindOfClass:[CAMetalLayer class]])
+				{
+					NSView *contentView = (NSView *)layer.delegate;
+					window              = contentView.window;
+				}
+				else
+				{
+					BX_WARN(0, "Unable to create MoltenVk surface. Please set platform data window to an NSWindow or CAMetalLayer");
+					return result;
+				}
+
+				if (m_resolution.reset & BGFX_RESET_HIDPI)
+				{
+					layer.contentsScale = [window backingScaleFactor];
+				}
+
+				VkMacOSSurfaceCreateInfoMVK sci;
+				sci.sType = VK_STRUCTURE_TYPE_MACOS_SURFACE_CREATE_INFO_MVK;
+				sci.pNext = NULL;
+				sci.flags = 0;
+				sci.pView = (__bridge void*)layer;
+				result = vkCreateMacOSSurfaceMVK(instance, &sci, allocatorCb, &m_surface);
+				BX_WARN(VK_SUCCESS == result, "vkCreateMacOSSurfaceMVK failed %d: %s.", result, getName(result) );
+			}
 		}
-		else if (VK_IMAGE_VIEW_TYPE_CUBE == m_type
-		||       VK_IMAGE_VIEW_TYPE_CUBE_ARRAY == m_type)
+#elif BX_PLATFORM_NX
+		if (NULL != vkCreateViSurfaceNN)
 		{
-			region.imageSubresource.baseArrayLayer = _z * 6 + _side;
+			VkViSurfaceCreateInfoNN sci;
+			sci.sType  = VK_STRUCTURE_TYPE_VI_SURFACE_CREATE_INFO_NN;
+			sci.pNext  = NULL;
+			sci.flags  = 0;
+			sci.window = m_nwh;
+			result = vkCreateViSurfaceNN(instance, &sci, allocatorCb, &m_surface);
+			BX_WARN(VK_SUCCESS == result, "vkCreateViSurfaceNN failed %d: %s.", result, getName(result) );
 		}
-		else
+#else
+#	error "Figure out KHR surface..."
+#endif // BX_PLATFORM_
+
+		m_needToRecreateSurface = false;
+
+		if (VK_SUCCESS != result)
 		{
-			region.imageSubresource.baseArrayLayer = _z;
+			BX_TRACE("Create surface error: vkCreate[Platform]SurfaceKHR failed %d: %s.", result, getName(result) );
+			return result;
+		}
+
+		const VkPhysicalDevice physicalDevice = s_renderVK->m_physicalDevice;
+		const uint32_t queueFamily = s_renderVK->m_globalQueueFamily;
+
+		VkBool32 surfaceSupported;
+		result = vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, queueFamily, m_surface, &surfaceSupported);
+
+		if (VK_SUCCESS != result
+		||  !surfaceSupported)
+		{
+			BX_TRACE("Create surface error: Presentation to the given surface not supported.");
+			return VK_ERROR_INITIALIZATION_FAILED;
+		}
+
+		return result;
+	}
+
+	void SwapChainVK::releaseSurface()
+	{
+		release(m_surface);
+	}
+
+	VkResult SwapChainVK::createSwapChain()
+	{
+		BGFX_PROFILER_SCOPE("SwapChainVK::createSwapchain", kColorFrame);
+
+		VkResult result = VK_SUCCESS;
+
+		const VkPhysicalDevice physicalDevice = s_renderVK->m_physicalDevice;
+		const VkDevice device = s_renderVK->m_device;
+		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
+
+		// Waiting for the device to be idle seems to get rid of VK_DEVICE_LOST
+		// upon resizing the window quickly. See:
+		//  - https://github.com/mpv-player/mpv/issues/8360
+		//  - https://github.com/bkaradzic/bgfx/issues/3227
+		result = vkDeviceWaitIdle(device);
+		BX_WARN(VK_SUCCESS == result, "Create swapchain error: vkDeviceWaitIdle() failed: %d: %s", result, getName(result) );
+
+		VkSurfaceCapabilitiesKHR surfaceCapabilities;
+		result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, m_surface, &surfaceCapabilities);
+
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("Create swapchain error: vkGetPhysicalDeviceSurfaceCapabilitiesKHR failed %d: %s.", result, getName(result) );
+			return result;
+		}
+
+		const uint32_t minSwapBufferCount = bx::max<uint32_t>(surfaceCapabilities.minImageCount, 2);
+		const uint32_t maxSwapBufferCount = surfaceCapabilities.maxImageCount == 0
+			? kMaxBackBuffers
+			: bx::min<uint32_t>(surfaceCapabilities.maxImageCount, kMaxBackBuffers)
+			;
+
+		if (minSwapBufferCount > maxSwapBufferCount)
+		{
+			BX_TRACE("Create swapchain error: Incompatible swapchain image count (min: %d, max: %d, MaxBackBuffers: %d)."
+				, minSwapBufferCount
+				, maxSwapBufferCount
+				, kMaxBackBuffers
+				);
+			return VK_ERROR_INITIALIZATION_FAILED;
+		}
+
+		const uint32_t swapBufferCount = bx::clamp<uint32_t>(m_resolution.numBackBuffers, minSwapBufferCount, maxSwapBufferCount);
+
+		const VkColorSpaceKHR surfaceColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+
+		const bool srgb = !!(m_resolution.reset & BGFX_RESET_SRGB_BACKBUFFER);
+		m_colorFormat = findSurfaceFormat(m_resolution.formatColor, surfaceColorSpace, srgb);
+		m_depthFormat = bgfx::TextureFormat::UnknownDepth;
+
+		if (TextureFormat::Count == m_colorFormat)
+		{
+			BX_TRACE("Create swapchain error: Unable to find surface format (srgb: %d).", srgb);
+			return VK_ERROR_INITIALIZATION_FAILED;
+		}
+
+		const VkFormat surfaceFormat = srgb
+			? s_textureFormat[m_colorFormat].m_fmtSrgb
+			: s_textureFormat[m_colorFormat].m_fmt
+			;
+
+		const uint32_t width = bx::clamp<uint32_t>(
+			  m_resolution.width
+			, surfaceCapabilities.minImageExtent.width
+			, surfaceCapabilities.maxImageExtent.width
+			);
+		const uint32_t height = bx::clamp<uint32_t>(
+			  m_resolution.height
+			, surfaceCapabilities.minImageExtent.height
+			, surfaceCapabilities.maxImageExtent.height
+			);
+		if (width != m_resolution.width || height != m_resolution.height)
+		{
+			BX_TRACE("Clamped swapchain resolution from %dx%d to %dx%d"
+					, m_resolution.width
+					, m_resolution.height
+					, width
+					, height
+					);
+		}
+
+		VkCompositeAlphaFlagBitsKHR compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+
+		if (surfaceCapabilities.supportedCompositeAlpha & VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR)
+		{
+			compositeAlpha = VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR;
+		}
+		else if (surfaceCapabilities.supportedCompositeAlpha & VK_COMPOSITE_ALPHA_PRE_MULTIPLIED_BIT_KHR)
+		{
+			compositeAlpha = VK_COMPOSITE_ALPHA_PRE_MULTIPLIED_BIT_KHR;
+		}
+		else if (surfaceCapabilities.supportedCompositeAlpha & VK_COMPOSITE_ALPHA_POST_MULTIPLIED_BIT_KHR)
+		{
+			compositeAlpha = VK_COMPOSITE_ALPHA_POST_MULTIPLIED_BIT_KHR;
 		}
 
-		copyBufferToTexture(_commandBuffer, stagingBuffer.m_buffer, 1, &region);
+		const VkImageUsageFlags imageUsageMask = 0
+			| VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+			| VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+			| VK_IMAGE_USAGE_TRANSFER_DST_BIT
+			;
+		const VkImageUsageFlags imageUsage = surfaceCapabilities.supportedUsageFlags & imageUsageMask;
+
+		m_supportsReadback      = 0 != (imageUsage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+		m_supportsManualResolve = 0 != (imageUsage & VK_IMAGE_USAGE_TRANSFER_DST_BIT);
 
-		if (!stagingBuffer.m_isFromScratch)
+		const bool vsync = !!(m_resolution.reset & BGFX_RESET_VSYNC);
+		uint32_t presentModeIdx = findPresentMode(vsync);
+		if (UINT32_MAX == presentModeIdx)
 		{
-			s_renderVK->release(stagingBuffer.m_buffer);
-			s_renderVK->recycleMemory(stagingBuffer.m_deviceMem);
+			BX_TRACE("Create swapchain error: Unable to find present mode (vsync: %d).", vsync);
+			return VK_ERROR_INITIALIZATION_FAILED;
 		}
 
-		if (NULL != temp)
+		m_sci.surface            = m_surface;
+		m_sci.minImageCount      = swapBufferCount;
+		m_sci.imageFormat        = surfaceFormat;
+		m_sci.imageColorSpace    = surfaceColorSpace;
+		m_sci.imageExtent.width  = width;
+		m_sci.imageExtent.height = height;
+		m_sci.imageUsage         = imageUsage;
+		m_sci.compositeAlpha     = compositeAlpha;
+		m_sci.presentMode        = s_presentMode[presentModeIdx].mode;
+		m_sci.clipped            = VK_FALSE;
+
+		result = vkCreateSwapchainKHR(device, &m_sci, allocatorCb, &m_swapChain);
+		if (VK_SUCCESS != result)
 		{
-			bx::free(g_allocator, temp);
+			BX_TRACE("Create swapchain error: vkCreateSwapchainKHR failed %d: %s.", result, getName(result) );
+			return result;
 		}
-	}
-
-	void TextureVK::resolve(VkCommandBuffer _commandBuffer, uint8_t _resolve, uint32_t _layer, uint32_t _numLayers, uint32_t _mip)
-	{
-		BGFX_PROFILER_SCOPE("TextureVK::resolve", kColorResource);
 
-		const bool needResolve = VK_NULL_HANDLE != m_singleMsaaImage;
+		m_sci.oldSwapchain = m_swapChain;
 
-		const bool needMipGen = true
-			&& !needResolve
-			&& 0 != (m_flags & BGFX_TEXTURE_RT_MASK)
-			&& 0 == (m_flags & BGFX_TEXTURE_RT_WRITE_ONLY)
-			&& (_mip + 1) < m_numMips
-			&& 0 != (_resolve & BGFX_RESOLVE_AUTO_GEN_MIPS)
-			;
+		result = vkGetSwapchainImagesKHR(device, m_swapChain, &m_numSwapChainImages, NULL);
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("Create swapchain error: vkGetSwapchainImagesKHR failed %d: %s.", result, getName(result) );
+			return result;
+		}
 
-		const VkImageLayout oldLayout = m_currentImageLayout;
-		const VkImageLayout oldSingleMsaaLayout = m_currentSingleMsaaImageLayout;
+		BX_TRACE("Create swapchain numSwapChainImages %d, minImageCount %d, BX_COUNTOF(m_backBufferColorImage) %d"
+			, m_numSwapChainImages
+			, m_sci.minImageCount
+			, BX_COUNTOF(m_backBufferColorImage)
+			);
 
-		const uint32_t numLayers = false
-			|| m_type == VK_IMAGE_VIEW_TYPE_CUBE
-			|| m_type == VK_IMAGE_VIEW_TYPE_CUBE_ARRAY
-			? m_numSides
-			: _numLayers
-			;
+		setDebugObjectName(device, m_swapChain, "m_swapChain");
 
-		if (needResolve)
+		if (m_numSwapChainImages < m_sci.minImageCount)
 		{
-			setImageMemoryBarrier(_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-			setImageMemoryBarrier(_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true);
-
-			VkImageResolve resolve;
-			resolve.srcOffset.x = 0;
-			resolve.srcOffset.y = 0;
-			resolve.srcOffset.z = 0;
-			resolve.dstOffset.x = 0;
-			resolve.dstOffset.y = 0;
-			resolve.dstOffset.z = 0;
-			resolve.srcSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-			resolve.srcSubresource.mipLevel       = _mip;
-			resolve.srcSubresource.baseArrayLayer = _layer;
-			resolve.srcSubresource.layerCount     = numLayers;
-			resolve.dstSubresource.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-			resolve.dstSubresource.mipLevel       = _mip;
-			resolve.dstSubresource.baseArrayLayer = _layer;
-			resolve.dstSubresource.layerCount     = numLayers;
-			resolve.extent.width  = m_width;
-			resolve.extent.height = m_height;
-			resolve.extent.depth  = 1;
-
-			vkCmdResolveImage(
-				  _commandBuffer
-				, m_textureImage
-				, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-				, m_singleMsaaImage
-				, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-				, 1
-				, &resolve
+			BX_TRACE("Create swapchain error: vkGetSwapchainImagesKHR: numSwapchainImages %d < minImageCount %d."
+				, m_numSwapChainImages
+				, m_sci.minImageCount
 				);
+			return VK_ERROR_INITIALIZATION_FAILED;
 		}
 
-		if (needMipGen)
+		if (m_numSwapChainImages > BX_COUNTOF(m_backBufferColorImage) )
 		{
-			BGFX_PROFILER_SCOPE("Resolve - Generate Mipmaps", kColorResource);
+			BX_TRACE("Create swapchain error: vkGetSwapchainImagesKHR: numSwapchainImages %d > countof(m_backBufferColorImage) %d."
+				, m_numSwapChainImages
+				, BX_COUNTOF(m_backBufferColorImage)
+				);
+			return VK_ERROR_INITIALIZATION_FAILED;
+		}
 
-			setImageMemoryBarrier(_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+		result = vkGetSwapchainImagesKHR(device, m_swapChain, &m_numSwapChainImages, &m_backBufferColorImage[0]);
+		if (VK_SUCCESS != result && VK_INCOMPLETE != result)
+		{
+			BX_TRACE("Create swapchain error: vkGetSwapchainImagesKHR failed %d: %s."
+				, result
+				, getName(result)
+				);
+			return result;
+		}
 
-			int32_t mipWidth  = bx::max<int32_t>(int32_t(m_width)  >> _mip, 1);
-			int32_t mipHeight = bx::max<int32_t>(int32_t(m_height) >> _mip, 1);
+		VkImageViewCreateInfo ivci;
+		ivci.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		ivci.pNext = NULL;
+		ivci.flags = 0;
+		ivci.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		ivci.format   = m_sci.imageFormat;
+		ivci.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+		ivci.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+		ivci.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+		ivci.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+		ivci.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
+		ivci.subresourceRange.baseMipLevel   = 0;
+		ivci.subresourceRange.levelCount     = 1;
+		ivci.subresourceRange.baseArrayLayer = 0;
+		ivci.subresourceRange.layerCount     = 1;
 
-			const VkFilter filter = bimg::isDepth(bimg::TextureFormat::Enum(m_textureFormat) )
-				? VK_FILTER_NEAREST
-				: VK_FILTER_LINEAR
-				;
+		for (uint32_t ii = 0; ii < m_numSwapChainImages; ++ii)
+		{
+			ivci.image = m_backBufferColorImage[ii];
 
-			VkImageBlit blit;
-			blit.srcOffsets[0] = { 0, 0, 0 };
-			blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-			blit.srcSubresource.aspectMask     = m_aspectFlags;
-			blit.srcSubresource.mipLevel       = 0;
-			blit.srcSubresource.baseArrayLayer = _layer;
-			blit.srcSubresource.layerCount     = numLayers;
-			blit.dstOffsets[0] = { 0, 0, 0 };
-			blit.dstOffsets[1] = { mipWidth, mipHeight, 1 };
-			blit.dstSubresource.aspectMask     = m_aspectFlags;
-			blit.dstSubresource.mipLevel       = 0;
-			blit.dstSubresource.baseArrayLayer = _layer;
-			blit.dstSubresource.layerCount     = numLayers;
+			result = vkCreateImageView(device, &ivci, allocatorCb, &m_backBufferColorImageView[ii]);
 
-			for (uint32_t i = _mip + 1; i < m_numMips; i++)
+			if (VK_SUCCESS != result)
 			{
-				BGFX_PROFILER_SCOPE("Mipmap", kColorResource);
-
-				blit.srcOffsets[1] = { mipWidth, mipHeight, 1 };
-				blit.srcSubresource.mipLevel = i - 1;
-
-				mipWidth  = bx::uint32_max(mipWidth  >> 1, 1);
-				mipHeight = bx::uint32_max(mipHeight >> 1, 1);
-
-				blit.dstOffsets[1] = { mipWidth, mipHeight, 1 };
-				blit.dstSubresource.mipLevel = i;
-
-				vk::setImageMemoryBarrier(
-					  _commandBuffer
-					, m_textureImage
-					, m_aspectFlags
-					, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-					, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-					, blit.srcSubresource.mipLevel
-					, 1
-					, _layer
-					, numLayers
-					);
-
-				vkCmdBlitImage(
-					  _commandBuffer
-					, m_textureImage
-					, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-					, m_textureImage
-					, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-					, 1
-					, &blit
-					, filter
-					);
+				BX_TRACE("Create swapchain error: vkCreateImageView failed %d: %s.", result, getName(result) );
+				return result;
 			}
 
-			vk::setImageMemoryBarrier(
-				  _commandBuffer
-				, m_textureImage
-				, m_aspectFlags
-				, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-				, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-				, _mip
-				, m_numMips - _mip - 1
-				, _layer
-				, numLayers
-				);
-		}
-
-		setImageMemoryBarrier(_commandBuffer, oldLayout);
-		setImageMemoryBarrier(_commandBuffer, oldSingleMsaaLayout, true);
-	}
+			setDebugObjectName(device, m_backBufferColorImageView[ii], "m_backBufferColorImageView[%d]", ii);
 
-	void TextureVK::copyBufferToTexture(VkCommandBuffer _commandBuffer, VkBuffer _stagingBuffer, uint32_t _bufferImageCopyCount, VkBufferImageCopy* _bufferImageCopy)
-	{
-		BGFX_PROFILER_SCOPE("TextureVK::copyBufferToTexture", kColorResource);
+			m_backBufferColorImageLayout[ii] = VK_IMAGE_LAYOUT_UNDEFINED;
+		}
 
-		const VkImageLayout oldLayout = m_currentImageLayout == VK_IMAGE_LAYOUT_UNDEFINED
-			? m_sampledLayout
-			: m_currentImageLayout
-			;
+		BX_TRACE("Successfully created swapchain (%dx%d) with %d images.", width, height, m_numSwapChainImages);
 
-		setImageMemoryBarrier(_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+		VkSemaphoreCreateInfo sci;
+		sci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		sci.pNext = NULL;
+		sci.flags = 0;
 
-		bimg::TextureFormat::Enum format = bimg::TextureFormat::Enum(m_textureFormat);
-		const bimg::ImageBlockInfo& blockInfo = bimg::getBlockInfo(format);
-		for (uint32_t ii = 0; ii < _bufferImageCopyCount; ++ii)
+		// We will make a fully filled pool of semaphores and cycle through those.
+		// This is to make sure we have enough, even in the case where there are
+		// more frames in flight than images on the swapchain.
+		for (uint32_t ii = 0; ii < kMaxBackBuffers; ++ii)
 		{
-			BX_ASSERT(
-				  bx::uint32_mod(bx::narrowCast<uint32_t>(_bufferImageCopy[ii].bufferOffset), blockInfo.blockSize) == 0
-				, "Misaligned texture of type %s to offset %u, which is not a multiple of %u."
-				, bimg::getName(format), _bufferImageCopy[ii].bufferOffset, blockInfo.blockSize
-				);
+			if (VK_SUCCESS != vkCreateSemaphore(device, &sci, allocatorCb, &m_presentDoneSemaphore[ii])
+			||  VK_SUCCESS != vkCreateSemaphore(device, &sci, allocatorCb, &m_renderDoneSemaphore[ii]) )
+			{
+				BX_TRACE("Create swapchain error: vkCreateSemaphore failed %d: %s.", result, getName(result) );
+				return result;
+			}
+
+			setDebugObjectName(device, m_presentDoneSemaphore[ii], "m_presentDoneSemaphore[%d]", ii);
+			setDebugObjectName(device, m_renderDoneSemaphore[ii], "m_renderDoneSemaphore[%d]", ii);
 		}
-		BX_UNUSED(blockInfo);
 
-		vkCmdCopyBufferToImage(
-			  _commandBuffer
-			, _stagingBuffer
-			, m_textureImage
-			, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-			, _bufferImageCopyCount
-			, _bufferImageCopy
-			);
+		m_backBufferColorIdx = 0;
+		m_currentSemaphore = 0;
 
-		setImageMemoryBarrier(_commandBuffer, oldLayout);
+		m_needPresent = false;
+		m_needToRecreateSwapchain = false;
+
+		return result;
 	}
 
-	VkImageLayout TextureVK::setImageMemoryBarrier(VkCommandBuffer _commandBuffer, VkImageLayout _newImageLayout, bool _singleMsaaImage)
+	void SwapChainVK::releaseSwapChain()
 	{
-		if (_singleMsaaImage && VK_NULL_HANDLE == m_singleMsaaImage)
-		{
-			return VK_IMAGE_LAYOUT_UNDEFINED;
-		}
+		BGFX_PROFILER_SCOPE("SwapChainVK::releaseSwapChain", kColorFrame);
 
-		VkImageLayout& currentLayout = _singleMsaaImage
-			? m_currentSingleMsaaImageLayout
-			: m_currentImageLayout
-			;
+		for (uint32_t ii = 0; ii < BX_COUNTOF(m_backBufferColorImageView); ++ii)
+		{
+			release(m_backBufferColorImageView[ii]);
 
-		const VkImageLayout oldLayout = currentLayout;
+			m_backBufferFence[ii] = VK_NULL_HANDLE;
+		}
 
-		if (currentLayout == _newImageLayout)
+		for (uint32_t ii = 0; ii < kMaxBackBuffers; ++ii)
 		{
-			return oldLayout;
+			release(m_presentDoneSemaphore[ii]);
+			release(m_renderDoneSemaphore[ii]);
 		}
 
-		const VkImage image = _singleMsaaImage
-			? m_singleMsaaImage
-			: m_textureImage
-			;
-
-		vk::setImageMemoryBarrier(
-			  _commandBuffer
-			, image
-			, m_aspectFlags
-			, currentLayout
-			, _newImageLayout
-			);
-
-		currentLayout = _newImageLayout;
-		return oldLayout;
+		release(m_swapChain);
 	}
 
-	VkResult TextureVK::createView(uint32_t _layer, uint32_t _numLayers, uint32_t _mip, uint32_t _numMips, VkImageViewType _type, VkImageAspectFlags _aspectMask, bool _renderTarget, ::VkImageView* _view) const
+	VkResult SwapChainVK::createAttachments(VkCommandBuffer _commandBuffer)
 	{
-		VkResult result = VK_SUCCESS;
+		BGFX_PROFILER_SCOPE("SwapChainVK::createAttachments", kColorFrame);
 
-		if (VK_IMAGE_VIEW_TYPE_3D == m_type)
-		{
-			BX_ASSERT(false
-				  || !_renderTarget
-				  || !(m_aspectFlags & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT) )
-				, "3D image can't be a depth attachment"
-			);
-		}
+		VkResult result = VK_SUCCESS;
 
-		if (VK_IMAGE_VIEW_TYPE_CUBE       == _type
-		||  VK_IMAGE_VIEW_TYPE_CUBE_ARRAY == _type)
-		{
-			BX_ASSERT(_numLayers % 6 == 0, "");
-			BX_ASSERT(
-				  VK_IMAGE_VIEW_TYPE_3D != m_type
-				, "3D image can't be aliased as a cube texture"
-				);
-		}
+		const uint32_t samplerIndex = (m_resolution.reset & BGFX_RESET_MSAA_MASK) >> BGFX_RESET_MSAA_SHIFT;
+		const uint64_t textureFlags = (uint64_t(samplerIndex + 1) << BGFX_TEXTURE_RT_MSAA_SHIFT) | BGFX_TEXTURE_RT | BGFX_TEXTURE_RT_WRITE_ONLY;
+		m_sampler = s_msaa[samplerIndex];
 
-		VkImageViewCreateInfo viewInfo;
-		viewInfo.sType      = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-		viewInfo.pNext      = NULL;
-		viewInfo.flags      = 0;
-		viewInfo.image      = ( (VK_NULL_HANDLE != m_singleMsaaImage) && !_renderTarget)
-			? m_singleMsaaImage
-			: m_textureImage
+		const uint16_t requiredCaps = m_sampler.Count > 1
+			? BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER_MSAA
+			: BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER
 			;
-		viewInfo.viewType   = _type;
-		viewInfo.format     = m_format;
-		viewInfo.components = m_components;
-		viewInfo.subresourceRange.aspectMask     = m_aspectFlags & _aspectMask;
-		viewInfo.subresourceRange.baseMipLevel   = _mip;
-		viewInfo.subresourceRange.levelCount     = _numMips;
-		viewInfo.subresourceRange.baseArrayLayer = _layer;
-		viewInfo.subresourceRange.layerCount     = 1;
 
-		if (VK_IMAGE_VIEW_TYPE_2D != _type
-		&&  VK_IMAGE_VIEW_TYPE_3D != _type)
+		if (bimg::isDepth(bimg::TextureFormat::Enum(m_resolution.formatDepthStencil) ) )
 		{
-			viewInfo.subresourceRange.layerCount = VK_IMAGE_VIEW_TYPE_CUBE == _type
-				? 6
-				: _numLayers
-				;
-		}
+			// the spec guarantees that at least one of D24S8 and D32FS8 is supported
+			VkFormat depthFormat = VK_FORMAT_D32_SFLOAT_S8_UINT;
 
-		VkImageView view = VK_NULL_HANDLE;
+			if (g_caps.formats[m_resolution.formatDepthStencil] & requiredCaps)
+			{
+				depthFormat = s_textureFormat[m_resolution.formatDepthStencil].m_fmtDsv;
+			}
+			else if (g_caps.formats[TextureFormat::D24S8] & requiredCaps)
+			{
+				depthFormat = s_textureFormat[TextureFormat::D24S8].m_fmtDsv;
+			}
 
-		result = vkCreateImageView(
-			  s_renderVK->m_device
-			, &viewInfo
-			, s_renderVK->m_allocatorCb
-			, &view
-			);
+			result = m_backBufferDepthStencil.create(
+				  _commandBuffer
+				, m_sci.imageExtent.width
+				, m_sci.imageExtent.height
+				, textureFlags
+				, depthFormat
+				);
 
-		if (VK_SUCCESS != result)
-		{
-			BX_TRACE("Create texture view error: vkCreateImageView failed %d: %s.", result, getName(result) );
-			return result;
-		}
+			if (VK_SUCCESS != result)
+			{
+				BX_TRACE("Create swapchain error: creating depth stencil image failed %d: %s.", result, getName(result) );
+				return result;
+			}
 
-		*_view = view;
+			result = m_backBufferDepthStencil.createView(0, 1, 0, 1
+				, VK_IMAGE_VIEW_TYPE_2D
+				, m_backBufferDepthStencil.m_aspectFlags
+				, true
+				, &m_backBufferDepthStencilImageView
+			);
 
-		return result;
-	}
+			if (VK_SUCCESS != result)
+			{
+				BX_TRACE("Create swapchain error: creating depth stencil image view failed %d: %s.", result, getName(result) );
+				return result;
+			}
 
-	VkImageAspectFlags TextureVK::getAspectMask(VkFormat _format)
-	{
-		switch (_format)
-		{
-		case VK_FORMAT_S8_UINT:
-			return VK_IMAGE_ASPECT_STENCIL_BIT;
+			if (m_sampler.Count > 1)
+			{
+				result = m_backBufferColorMsaa.create(
+					  _commandBuffer
+					, m_sci.imageExtent.width
+					, m_sci.imageExtent.height
+					, textureFlags
+					, m_sci.imageFormat
+					);
 
-		case VK_FORMAT_D16_UNORM:
-		case VK_FORMAT_X8_D24_UNORM_PACK32:
-		case VK_FORMAT_D32_SFLOAT:
-			return VK_IMAGE_ASPECT_DEPTH_BIT;
+				if (VK_SUCCESS != result)
+				{
+					BX_TRACE("Create swapchain error: creating MSAA color image failed %d: %s.", result, getName(result) );
+					return result;
+				}
 
-		case VK_FORMAT_D16_UNORM_S8_UINT:
-		case VK_FORMAT_D24_UNORM_S8_UINT:
-		case VK_FORMAT_D32_SFLOAT_S8_UINT:
-			return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+				result = m_backBufferColorMsaa.createView(0, 1, 0, 1
+					, VK_IMAGE_VIEW_TYPE_2D
+					, m_backBufferColorMsaa.m_aspectFlags
+					, true
+					, &m_backBufferColorMsaaImageView
+				);
 
-		default:
-			return VK_IMAGE_ASPECT_COLOR_BIT;
+				if (VK_SUCCESS != result)
+				{
+					BX_TRACE("Create swapchain error: creating MSAA color image view failed %d: %s.", result, getName(result) );
+					return result;
+				}
+			}
 		}
+
+		return result;
 	}
 
-	VkResult SwapChainVK::create(VkCommandBuffer _commandBuffer, void* _nwh, const Resolution& _resolution)
+	void SwapChainVK::releaseAttachments()
 	{
-		struct ErrorState
-		{
-			enum Enum
-			{
-				Default,
-				SurfaceCreated,
-				SwapChainCreated,
-				AttachmentsCreated
-			};
-		};
+		BGFX_PROFILER_SCOPE("SwapChainVK::releaseAttachments", kColorFrame);
 
-		ErrorState::Enum errorState = ErrorState::Default;
+		release(m_backBufferDepthStencilImageView);
+		release(m_backBufferColorMsaaImageView);
 
-		VkResult result = VK_SUCCESS;
+		m_backBufferDepthStencil.destroy();
+		m_backBufferColorMsaa.destroy();
+	}
 
-		if (NULL == _nwh)
-		{
-			return result;
-		}
+	VkResult SwapChainVK::createFrameBuffer()
+	{
+		BGFX_PROFILER_SCOPE("SwapChainVK::createFrameBuffer", kColorFrame);
 
-		m_nwh = _nwh;
-		m_resolution = _resolution;
+		VkResult result = VK_SUCCESS;
 
-		m_queue = s_renderVK->m_globalQueue;
+		const VkDevice device = s_renderVK->m_device;
+		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
 
-		result = createSurface();
+		VkRenderPass renderPass;
+		result = s_renderVK->getRenderPass(*this, &renderPass, 0);
 
 		if (VK_SUCCESS != result)
 		{
-			BX_TRACE("Create swap chain error: creating surface failed %d: %s.", result, getName(result) );
-			goto error;
+			return result;
 		}
 
-		errorState = ErrorState::SurfaceCreated;
-
+		for (uint32_t ii = 0; ii < m_numSwapChainImages; ++ii)
 		{
-			m_sci.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-			m_sci.pNext = NULL;
-			m_sci.flags = 0;
-			m_sci.imageArrayLayers      = 1;
-			m_sci.imageSharingMode      = VK_SHARING_MODE_EXCLUSIVE;
-			m_sci.queueFamilyIndexCount = 0;
-			m_sci.preTransform          = BX_ENABLED(BX_PLATFORM_NX)
-				? VK_SURFACE_TRANSFORM_INHERIT_BIT_KHR
-				: VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR
+			uint32_t numAttachments = 0;
+			::VkImageView attachments[3];
+
+			attachments[numAttachments++] = m_sampler.Count > 1
+				? m_backBufferColorMsaaImageView
+				: m_backBufferColorImageView[ii]
 				;
-			m_sci.oldSwapchain          = VK_NULL_HANDLE;
 
-			for (uint32_t ii = 0; ii < BX_COUNTOF(m_backBufferColorImageView); ++ii)
+			if (NULL != m_backBufferDepthStencilImageView)
 			{
-				m_backBufferColorImage[ii]     = VK_NULL_HANDLE;
-				m_backBufferColorImageView[ii] = VK_NULL_HANDLE;
-				m_backBufferFrameBuffer[ii]    = VK_NULL_HANDLE;
-				m_backBufferFence[ii]          = VK_NULL_HANDLE;
-				m_presentDoneSemaphore[ii]     = VK_NULL_HANDLE;
-				m_renderDoneSemaphore[ii]      = VK_NULL_HANDLE;
+				attachments[numAttachments++] = m_backBufferDepthStencilImageView;
+			}
+
+			if (m_sampler.Count > 1 && !m_supportsManualResolve)
+			{
+				attachments[numAttachments++] = m_backBufferColorImageView[ii];
 			}
 
-			m_lastImageRenderedSemaphore = VK_NULL_HANDLE;
-			m_lastImageAcquiredSemaphore = VK_NULL_HANDLE;
+			VkFramebufferCreateInfo fci;
+			fci.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+			fci.pNext = NULL;
+			fci.flags = 0;
+			fci.renderPass = renderPass;
+			fci.attachmentCount = numAttachments;
+			fci.pAttachments = attachments;
+			fci.width = m_sci.imageExtent.width;
+			fci.height = m_sci.imageExtent.height;
+			fci.layers = 1;
 
-			result = createSwapChain();
+			result = vkCreateFramebuffer(device, &fci, allocatorCb, &m_backBufferFrameBuffer[ii]);
 
 			if (VK_SUCCESS != result)
 			{
-				BX_TRACE("Create swap chain error: creating swapchain and image views failed %d: %s", result, getName(result) );
-				goto error;
+				return result;
 			}
 		}
 
-		errorState = ErrorState::SwapChainCreated;
+		return result;
+	}
 
+	void SwapChainVK::releaseFrameBuffer()
+	{
+		for (uint32_t ii = 0; ii < BX_COUNTOF(m_backBufferColorImageView); ++ii)
 		{
-			result = createAttachments(_commandBuffer);
-
-			if (VK_SUCCESS != result)
-			{
-				BX_TRACE("Create swap chain error: creating MSAA/depth attachments failed %d: %s.", result, getName(result) );
-				goto error;
-			}
+			release(m_backBufferFrameBuffer[ii]);
 		}
+	}
 
-		errorState = ErrorState::AttachmentsCreated;
+	uint32_t SwapChainVK::findPresentMode(bool _vsync)
+	{
+		BGFX_PROFILER_SCOPE("SwapChainVK::findPresentMode", kColorFrame);
 
-		{
-			result = createFrameBuffer();
+		VkResult result = VK_SUCCESS;
 
-			if (VK_SUCCESS != result)
-			{
-				BX_TRACE("Create swap chain error: creating frame buffers failed %d: %s.", result, getName(result) );
-				goto error;
-			}
-		}
+		const VkPhysicalDevice physicalDevice = s_renderVK->m_physicalDevice;
 
-		return VK_SUCCESS;
+		uint32_t numPresentModes;
+		result = vkGetPhysicalDeviceSurfacePresentModesKHR(
+			  physicalDevice
+			, m_surface
+			, &numPresentModes
+			, NULL
+			);
 
-	error:
-		BX_TRACE("errorState %d", errorState);
-		switch (errorState)
+		if (VK_SUCCESS != result)
 		{
-		case ErrorState::AttachmentsCreated:
-			releaseAttachments();
-			[[fallthrough]];
-
-		case ErrorState::SwapChainCreated:
-			releaseSwapChain();
-			[[fallthrough]];
+			BX_TRACE("findPresentMode error: vkGetPhysicalDeviceSurfacePresentModesKHR failed %d: %s.", result, getName(result) );
+			return UINT32_MAX;
+		}
 
-		case ErrorState::SurfaceCreated:
-			releaseSurface();
-			[[fallthrough]];
+		VkPresentModeKHR presentModes[16];
+		numPresentModes = bx::min<uint32_t>(numPresentModes, BX_COUNTOF(presentModes) );
+		result = vkGetPhysicalDeviceSurfacePresentModesKHR(
+			  physicalDevice
+			, m_surface
+			, &numPresentModes
+			, presentModes
+			);
 
-		case ErrorState::Default:
-			break;
-		};
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("findPresentMode error: vkGetPhysicalDeviceSurfacePresentModesKHR failed %d: %s.", result, getName(result) );
+			return UINT32_MAX;
+		}
 
-		return VK_SUCCESS != result
-			? result
-			: VK_ERROR_INITIALIZATION_FAILED
-			;
-	}
+		uint32_t idx = UINT32_MAX;
 
-	void SwapChainVK::destroy()
-	{
-		if (VK_NULL_HANDLE != m_swapChain)
+		for (uint32_t ii = 0; ii < BX_COUNTOF(s_presentMode) && UINT32_MAX == idx; ++ii)
 		{
-			releaseFrameBuffer();
-			releaseAttachments();
-			releaseSwapChain();
-			releaseSurface();
+			for (uint32_t jj = 0; jj < numPresentModes; ++jj)
+			{
+				const PresentMode& pm = s_presentMode[ii];
 
-			// can't delay-delete the surface, since there can only be one swapchain per surface
-			// new framebuffer with the same window would get an error at swapchain creation
-			s_renderVK->kick(true);
+				if (pm.mode  == presentModes[jj]
+				&&  pm.vsync == _vsync)
+				{
+					idx = ii;
+					break;
+				}
+			}
 		}
 
-		m_nwh = NULL;
+		if (UINT32_MAX == idx)
+		{
+			idx = 0;
+			BX_TRACE("Present mode not found! Defaulting to %s.", s_presentMode[idx].name);
+		}
+
+		return idx;
 	}
 
-	void SwapChainVK::update(VkCommandBuffer _commandBuffer, void* _nwh, const Resolution& _resolution)
+	TextureFormat::Enum SwapChainVK::findSurfaceFormat(TextureFormat::Enum _format, VkColorSpaceKHR _colorSpace, bool _srgb)
 	{
-		BGFX_PROFILER_SCOPE("SwapChainVK::update", kColorFrame);
+		BGFX_PROFILER_SCOPE("SwapChainVK::findSurfaceFormat", kColorFrame);
 
-		const VkPhysicalDevice physicalDevice = s_renderVK->m_physicalDevice;
+		VkResult result = VK_SUCCESS;
 
-		m_lastImageRenderedSemaphore = VK_NULL_HANDLE;
-		m_lastImageAcquiredSemaphore = VK_NULL_HANDLE;
+		TextureFormat::Enum selectedFormat = TextureFormat::Count;
 
-		const uint64_t recreateSurfaceMask     = BGFX_RESET_HIDPI;
-		const uint64_t recreateSwapchainMask   = BGFX_RESET_VSYNC | BGFX_RESET_SRGB_BACKBUFFER;
-		const uint64_t recreateAttachmentsMask = BGFX_RESET_MSAA_MASK;
+		const VkPhysicalDevice physicalDevice = s_renderVK->m_physicalDevice;
 
-		const bool recreateSurface = false
-			|| m_needToRecreateSurface
-			|| m_nwh != _nwh
-			|| (m_resolution.reset & recreateSurfaceMask) != (_resolution.reset & recreateSurfaceMask)
-			;
+		uint32_t numSurfaceFormats;
+		result = vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, m_surface, &numSurfaceFormats, NULL);
 
-		const bool recreateSwapchain = false
-			|| m_needToRecreateSwapchain
-			|| m_resolution.formatColor        != _resolution.formatColor
-			|| m_resolution.formatDepthStencil != _resolution.formatDepthStencil
-			|| m_resolution.width              != _resolution.width
-			|| m_resolution.height             != _resolution.height
-			|| (m_resolution.reset & recreateSwapchainMask) != (_resolution.reset & recreateSwapchainMask)
-			|| recreateSurface
-			;
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("findSurfaceFormat error: vkGetPhysicalDeviceSurfaceFormatsKHR failed %d: %s.", result, getName(result) );
+			return selectedFormat;
+		}
 
-		const bool recreateAttachments = false
-			|| (m_resolution.reset & recreateAttachmentsMask) != (_resolution.reset & recreateAttachmentsMask)
-			|| recreateSwapchain
-			;
+		VkSurfaceFormatKHR* surfaceFormats = (VkSurfaceFormatKHR*)bx::alloc(g_allocator, numSurfaceFormats * sizeof(VkSurfaceFormatKHR) );
+		result = vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, m_surface, &numSurfaceFormats, surfaceFormats);
 
-		m_nwh = _nwh;
-		m_resolution = _resolution;
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("findSurfaceFormat error: vkGetPhysicalDeviceSurfaceFormatsKHR failed %d: %s.", result, getName(result) );
+			bx::free(g_allocator, surfaceFormats);
+			return selectedFormat;
+		}
 
-		if (recreateAttachments)
+		const TextureFormat::Enum requestedFormats[] =
 		{
-			releaseFrameBuffer();
-			releaseAttachments();
+			_format,
+			TextureFormat::BGRA8,
+			TextureFormat::RGBA8,
+		};
 
-			if (recreateSwapchain)
-			{
-				releaseSwapChain();
+		for (uint32_t ii = 0; ii < BX_COUNTOF(requestedFormats) && TextureFormat::Count == selectedFormat; ++ii)
+		{
+			const TextureFormat::Enum requested = requestedFormats[ii];
+			const VkFormat requestedVkFormat = _srgb
+				? s_textureFormat[requested].m_fmtSrgb
+				: s_textureFormat[requested].m_fmt
+				;
 
-				if (recreateSurface)
+			for (uint32_t jj = 0; jj < numSurfaceFormats; jj++)
+			{
+				if (_colorSpace == surfaceFormats[jj].colorSpace
+				&&  requestedVkFormat == surfaceFormats[jj].format)
 				{
-					m_sci.oldSwapchain = VK_NULL_HANDLE;
-					releaseSurface();
-					s_renderVK->kick(true);
-					_commandBuffer = s_renderVK->m_commandBuffer;
-
-					VkResult result = createSurface();
-					if (VK_SUCCESS != result)
+					selectedFormat = requested;
+					if (0 != ii
+					&&  s_renderVK->m_swapChainFormats[_format] != selectedFormat)
 					{
-						BX_TRACE("Surface lost.");
-						return;
+						s_renderVK->m_swapChainFormats[_format] = selectedFormat;
+						BX_TRACE(
+							"findSurfaceFormat: Surface format %s not found! Defaulting to %s."
+							, bimg::getName(bimg::TextureFormat::Enum(_format) )
+							, bimg::getName(bimg::TextureFormat::Enum(selectedFormat) )
+							);
 					}
+					break;
 				}
-
-				VkSurfaceCapabilitiesKHR surfaceCapabilities = {};
-				VkResult result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, m_surface, &surfaceCapabilities);
-
-				const uint32_t width = bx::clamp<uint32_t>(
-					  m_resolution.width
-					, surfaceCapabilities.minImageExtent.width
-					, surfaceCapabilities.maxImageExtent.width
-					);
-				const uint32_t height = bx::clamp<uint32_t>(
-					  m_resolution.height
-					, surfaceCapabilities.minImageExtent.height
-					, surfaceCapabilities.maxImageExtent.height
-					);
-
-				// swapchain can't have size 0
-				// on some platforms this happens when minimized
-				if (width  == 0
-				||  height == 0
-				||  VK_SUCCESS != result)
-				{
-					m_sci.oldSwapchain = VK_NULL_HANDLE;
-					s_renderVK->kick(true);
-					return;
-				}
-
-				VK_CHECK(createSwapChain() );
 			}
-
-			VK_CHECK(createAttachments(_commandBuffer) );
-			VK_CHECK(createFrameBuffer() );
 		}
-	}
 
-	VkResult SwapChainVK::createSurface()
-	{
-		BGFX_PROFILER_SCOPE("SwapChainVK::createSurface", kColorFrame);
+		bx::free(g_allocator, surfaceFormats);
 
-		VkResult result = VK_ERROR_EXTENSION_NOT_PRESENT;
+		if (TextureFormat::Count == selectedFormat)
+		{
+			BX_TRACE("findSurfaceFormat error: No supported surface format found.");
+		}
+
+		return selectedFormat;
+	}
 
-		const VkInstance instance = s_renderVK->m_instance;
-		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
+	bool SwapChainVK::acquire(VkCommandBuffer _commandBuffer)
+	{
+		BGFX_PROFILER_SCOPE("SwapChainVK::acquire", kColorFrame);
 
-#if BX_PLATFORM_WINDOWS
+		if (VK_NULL_HANDLE == m_swapChain
+		||  m_needToRecreateSwapchain)
 		{
-			if (NULL != vkCreateWin32SurfaceKHR)
-			{
-				VkWin32SurfaceCreateInfoKHR sci;
-				sci.sType = VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR;
-				sci.pNext = NULL;
-				sci.flags     = 0;
-				sci.hinstance = (HINSTANCE)GetModuleHandle(NULL);
-				sci.hwnd      = (HWND)m_nwh;
-				result = vkCreateWin32SurfaceKHR(instance, &sci, allocatorCb, &m_surface);
-				BX_WARN(VK_SUCCESS == result, "vkCreateWin32SurfaceKHR failed %d: %s.", result, getName(result) );
-			}
+			return false;
 		}
-#elif BX_PLATFORM_ANDROID
+
+		if (!m_needPresent)
 		{
-			if (NULL != vkCreateAndroidSurfaceKHR)
+			const VkDevice device = s_renderVK->m_device;
+
+			m_lastImageAcquiredSemaphore = m_presentDoneSemaphore[m_currentSemaphore];
+			m_lastImageRenderedSemaphore = m_renderDoneSemaphore[m_currentSemaphore];
+			m_currentSemaphore = (m_currentSemaphore + 1) % kMaxBackBuffers;
+
+			VkResult result;
 			{
-				VkAndroidSurfaceCreateInfoKHR sci;
-				sci.sType = VK_STRUCTURE_TYPE_ANDROID_SURFACE_CREATE_INFO_KHR;
-				sci.pNext = NULL;
-				sci.flags = 0;
-				sci.window = (ANativeWindow*)m_nwh;
-				result = vkCreateAndroidSurfaceKHR(instance, &sci, allocatorCb, &m_surface);
-				BX_WARN(VK_SUCCESS == result, "vkCreateAndroidSurfaceKHR failed %d: %s.", result, getName(result) );
+				BGFX_PROFILER_SCOPE("vkAcquireNextImageKHR", kColorFrame);
+
+				result = vkAcquireNextImageKHR(
+					  device
+					, m_swapChain
+					, UINT64_MAX
+					, m_lastImageAcquiredSemaphore
+					, VK_NULL_HANDLE
+					, &m_backBufferColorIdx
+					);
 			}
-		}
-#elif BX_PLATFORM_LINUX
-		{
-			if (g_platformData.type == bgfx::NativeWindowHandleType::Wayland)
+
+
+			if (result != VK_SUCCESS)
 			{
-				if (s_extension[Extension::KHR_wayland_surface].m_supported
-				&&  NULL != vkCreateWaylandSurfaceKHR
-				   )
-				{
-					BX_TRACE("Attempting Wayland surface creation.");
-					VkWaylandSurfaceCreateInfoKHR sci;
-					sci.sType = VK_STRUCTURE_TYPE_WAYLAND_SURFACE_CREATE_INFO_KHR;
-					sci.pNext = NULL;
-					sci.flags = 0;
-					sci.display = (wl_display*)g_platformData.ndt;
-					sci.surface = (wl_surface*)m_nwh;
-					result = vkCreateWaylandSurfaceKHR(instance, &sci, allocatorCb, &m_surface);
-					BX_WARN(VK_SUCCESS == result, "vkCreateWaylandSurfaceKHR failed %d: %s.", result, getName(result) );
-				}
+				BX_TRACE("vkAcquireNextImageKHR(...): result = %s", getName(result) );
 			}
-			else
+
+			switch (result)
 			{
-				if (s_extension[Extension::KHR_xlib_surface].m_supported
-				&&  NULL != vkCreateXlibSurfaceKHR
-				   )
-				{
-					BX_TRACE("Attempting Xlib surface creation.");
-					VkXlibSurfaceCreateInfoKHR sci;
-					sci.sType = VK_STRUCTURE_TYPE_XLIB_SURFACE_CREATE_INFO_KHR;
-					sci.pNext = NULL;
-					sci.flags  = 0;
-					sci.dpy    = (Display*)g_platformData.ndt;
-					sci.window = (Window)m_nwh;
-					result = vkCreateXlibSurfaceKHR(instance, &sci, allocatorCb, &m_surface);
-					BX_WARN(VK_SUCCESS == result, "vkCreateXlibSurfaceKHR failed %d: %s.", result, getName(result) );
-				}
+			case VK_SUCCESS:
+				break;
 
-				if (VK_SUCCESS != result
-				&&  s_extension[Extension::KHR_xcb_surface].m_supported
-				&&  NULL != vkCreateXcbSurfaceKHR
-				)
-				{
-					void* xcbdll = bx::dlopen("libX11-xcb.so.1");
+			case VK_ERROR_SURFACE_LOST_KHR:
+				m_needToRecreateSurface = true;
+				m_needToRecreateSwapchain = true;
+				return false;
 
-					if (NULL != xcbdll)
-					{
-						BX_TRACE("Attempting XCB surface creation.");
-						typedef xcb_connection_t* (*PFN_XGETXCBCONNECTION)(Display*);
-						PFN_XGETXCBCONNECTION XGetXCBConnection = (PFN_XGETXCBCONNECTION)bx::dlsym(xcbdll, "XGetXCBConnection");
+			case VK_ERROR_OUT_OF_DATE_KHR:
+			case VK_SUBOPTIMAL_KHR:
+				m_needToRecreateSwapchain = true;
+				return false;
 
-						VkXcbSurfaceCreateInfoKHR sci;
-						sci.sType      = VK_STRUCTURE_TYPE_XCB_SURFACE_CREATE_INFO_KHR;
-						sci.pNext      = NULL;
-						sci.flags      = 0;
-						sci.connection = XGetXCBConnection( (Display*)g_platformData.ndt);
-						sci.window     = bx::narrowCast<xcb_window_t>(uintptr_t(m_nwh) );
-						result = vkCreateXcbSurfaceKHR(instance, &sci, allocatorCb, &m_surface);
-						BX_WARN(VK_SUCCESS == result, "vkCreateXcbSurfaceKHR failed %d: %s.", result, getName(result) );
+			default:
+				BX_ASSERT(VK_SUCCESS == result, "vkAcquireNextImageKHR(...); VK error 0x%x: %s", result, getName(result) );
+				return false;
+			}
 
-						bx::dlclose(xcbdll);
-					}
-				}
+			if (VK_NULL_HANDLE != m_backBufferFence[m_backBufferColorIdx])
+			{
+				BGFX_PROFILER_SCOPE("vkWaitForFences", kColorWait);
+
+				VK_CHECK(vkWaitForFences(
+					  device
+					, 1
+					, &m_backBufferFence[m_backBufferColorIdx]
+					, VK_TRUE
+					, UINT64_MAX
+					) );
 			}
+
+			transitionImage(_commandBuffer);
+
+			m_needPresent = true;
 		}
 
-#elif BX_PLATFORM_OSX
+		return true;
+	}
+
+	void SwapChainVK::present()
+	{
+		BGFX_PROFILER_SCOPE("SwapChainVk::present", kColorFrame);
+
+		if (VK_NULL_HANDLE != m_swapChain
+		&&  m_needPresent)
 		{
-			if (NULL != vkCreateMacOSSurfaceMVK)
+			VkPresentInfoKHR pi;
+			pi.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+			pi.pNext = NULL;
+			pi.waitSemaphoreCount = 1;
+			pi.pWaitSemaphores    = &m_lastImageRenderedSemaphore;
+			pi.swapchainCount     = 1;
+			pi.pSwapchains        = &m_swapChain;
+			pi.pImageIndices      = &m_backBufferColorIdx;
+			pi.pResults           = NULL;
+			VkResult result;
 			{
-				NSWindow* window    = (NSWindow*)(m_nwh);
-				CAMetalLayer* layer = (CAMetalLayer*)(m_nwh);
+				BGFX_PROFILER_SCOPE("vkQueuePresentHKR", kColorFrame);
 
-				if ([window isKindOfClass:[NSWindow class]])
-				{
-					NSView *contentView = (NSView *)window.contentView;
-					layer               = [CAMetalLayer layer];
+				result = vkQueuePresentKHR(m_queue, &pi);
+			}
 
-					[contentView setWantsLayer : YES];
-					[contentView setLayer : layer];
-				}
-				else if ([layer isKindOfClass:[CAMetalLayer class]])
-				{
-					NSView *contentView = (NSView *)layer.delegate;
-					window              = contentView.window;
-				}
-				else
-				{
-					BX_WARN(0, "Unable to create MoltenVk surface. Please set platform data window to an NSWindow or CAMetalLayer");
-					return result;
-				}
+			if (result != VK_SUCCESS)
+			{
+				BX_TRACE("vkQueuePresentKHR(...): result = %s", getName(result) );
+			}
 
-				if (m_resolution.reset & BGFX_RESET_HIDPI)
-				{
-					layer.contentsScale = [window backingScaleFactor];
-				}
+			switch (result)
+			{
+			case VK_ERROR_SURFACE_LOST_KHR:
+				m_needToRecreateSurface = true;
+				m_needToRecreateSwapchain = true;
+				break;
 
-				VkMacOSSurfaceCreateInfoMVK sci;
-				sci.sType = VK_STRUCTURE_TYPE_MACOS_SURFACE_CREATE_INFO_MVK;
-				sci.pNext = NULL;
-				sci.flags = 0;
-				sci.pView = (__bridge void*)layer;
-				result = vkCreateMacOSSurfaceMVK(instance, &sci, allocatorCb, &m_surface);
-				BX_WARN(VK_SUCCESS == result, "vkCreateMacOSSurfaceMVK failed %d: %s.", result, getName(result) );
-			}
-		}
-#elif BX_PLATFORM_NX
-		if (NULL != vkCreateViSurfaceNN)
-		{
-			VkViSurfaceCreateInfoNN sci;
-			sci.sType  = VK_STRUCTURE_TYPE_VI_SURFACE_CREATE_INFO_NN;
-			sci.pNext  = NULL;
-			sci.flags  = 0;
-			sci.window = m_nwh;
-			result = vkCreateViSurfaceNN(instance, &sci, allocatorCb, &m_surface);
-			BX_WARN(VK_SUCCESS == result, "vkCreateViSurfaceNN failed %d: %s.", result, getName(result) );
-		}
-#else
-#	error "Figure out KHR surface..."
-#endif // BX_PLATFORM_
+			case VK_ERROR_OUT_OF_DATE_KHR:
+			case VK_SUBOPTIMAL_KHR:
+				m_needToRecreateSwapchain = true;
+				break;
 
-		m_needToRecreateSurface = false;
+			default:
+				BX_ASSERT(VK_SUCCESS == result, "vkQueuePresentKHR(...); VK error 0x%x: %s", result, getName(result) );
+				break;
+			}
 
-		if (VK_SUCCESS != result)
-		{
-			BX_TRACE("Create surface error: vkCreate[Platform]SurfaceKHR failed %d: %s.", result, getName(result) );
-			return result;
+			m_needPresent = false;
+			m_lastImageRenderedSemaphore = VK_NULL_HANDLE;
 		}
+	}
 
-		const VkPhysicalDevice physicalDevice = s_renderVK->m_physicalDevice;
-		const uint32_t queueFamily = s_renderVK->m_globalQueueFamily;
+	void SwapChainVK::transitionImage(VkCommandBuffer _commandBuffer)
+	{
+		VkImageLayout& layout = m_backBufferColorImageLayout[m_backBufferColorIdx];
 
-		VkBool32 surfaceSupported;
-		result = vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, queueFamily, m_surface, &surfaceSupported);
+		const bool toPresent = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL == layout;
 
-		if (VK_SUCCESS != result
-		||  !surfaceSupported)
-		{
-			BX_TRACE("Create surface error: Presentation to the given surface not supported.");
-			return VK_ERROR_INITIALIZATION_FAILED;
-		}
+		const VkImageLayout newLayout = toPresent
+			? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+			: VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+			;
+
+		layout = toPresent ? layout : VK_IMAGE_LAYOUT_UNDEFINED;
 
-		return result;
+		setImageMemoryBarrier(
+			  _commandBuffer
+			, m_backBufferColorImage[m_backBufferColorIdx]
+			, VK_IMAGE_ASPECT_COLOR_BIT
+			, layout
+			, newLayout
+		);
+
+		layout = newLayout;
 	}
 
-	void SwapChainVK::releaseSurface()
+	void FrameBufferVK::create(uint8_t _num, const Attachment* _attachment)
 	{
-		release(m_surface);
+		BGFX_PROFILER_SCOPE("FrameBufferVK::create", kColorFrame);
+
+		m_numTh = _num;
+		bx::memCopy(m_attachment, _attachment, sizeof(Attachment) * _num);
+
+		postReset();
 	}
 
-	VkResult SwapChainVK::createSwapChain()
+	VkResult FrameBufferVK::create(uint16_t _denseIdx, void* _nwh, uint32_t _width, uint32_t _height, TextureFormat::Enum _colorFormat, TextureFormat::Enum _depthFormat)
 	{
-		BGFX_PROFILER_SCOPE("SwapChainVK::createSwapchain", kColorFrame);
+		BGFX_PROFILER_SCOPE("FrameBufferVK::create", kColorFrame);
 
 		VkResult result = VK_SUCCESS;
 
-		const VkPhysicalDevice physicalDevice = s_renderVK->m_physicalDevice;
-		const VkDevice device = s_renderVK->m_device;
-		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
+		Resolution resolution = s_renderVK->m_resolution;
+		resolution.formatColor        = TextureFormat::Count == _colorFormat ? resolution.formatColor        : _colorFormat;
+		resolution.formatDepthStencil = TextureFormat::Count == _depthFormat ? resolution.formatDepthStencil : _depthFormat;
+		resolution.width  = _width;
+		resolution.height = _height;
 
-		// Waiting for the device to be idle seems to get rid of VK_DEVICE_LOST
-		// upon resizing the window quickly. See:
-		//  - https://github.com/mpv-player/mpv/issues/8360
-		//  - https://github.com/bkaradzic/bgfx/issues/3227
-		result = vkDeviceWaitIdle(device);
-		BX_WARN(VK_SUCCESS == result, "Create swapchain error: vkDeviceWaitIdle() failed: %d: %s", result, getName(result) );
+		if (_denseIdx != UINT16_MAX)
+		{
+			resolution.reset &= ~BGFX_RESET_MSAA_MASK;
+		}
 
-		VkSurfaceCapabilitiesKHR surfaceCapabilities;
-		result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(physicalDevice, m_surface, &surfaceCapabilities);
+		result = m_swapChain.create(s_renderVK->m_commandBuffer, _nwh, resolution);
 
 		if (VK_SUCCESS != result)
 		{
-			BX_TRACE("Create swapchain error: vkGetPhysicalDeviceSurfaceCapabilitiesKHR failed %d: %s.", result, getName(result) );
 			return result;
 		}
 
-		const uint32_t minSwapBufferCount = bx::max<uint32_t>(surfaceCapabilities.minImageCount, 2);
-		const uint32_t maxSwapBufferCount = surfaceCapabilities.maxImageCount == 0
-			? kMaxBackBuffers
-			: bx::min<uint32_t>(surfaceCapabilities.maxImageCount, kMaxBackBuffers)
-			;
+		result = s_renderVK->getRenderPass(m_swapChain, &m_renderPass, 0);
 
-		if (minSwapBufferCount > maxSwapBufferCount)
+		if (VK_SUCCESS != result)
 		{
-			BX_TRACE("Create swapchain error: Incompatible swapchain image count (min: %d, max: %d, MaxBackBuffers: %d)."
-				, minSwapBufferCount
-				, maxSwapBufferCount
-				, kMaxBackBuffers
-				);
-			return VK_ERROR_INITIALIZATION_FAILED;
+			return result;
 		}
 
-		const uint32_t swapBufferCount = bx::clamp<uint32_t>(m_resolution.numBackBuffers, minSwapBufferCount, maxSwapBufferCount);
+		m_denseIdx = _denseIdx;
+		m_nwh      = _nwh;
+		m_width    = m_swapChain.m_sci.imageExtent.width;
+		m_height   = m_swapChain.m_sci.imageExtent.height;
+		m_sampler  = m_swapChain.m_sampler;
 
-		const VkColorSpaceKHR surfaceColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+		return result;
+	}
 
-		const bool srgb = !!(m_resolution.reset & BGFX_RESET_SRGB_BACKBUFFER);
-		m_colorFormat = findSurfaceFormat(m_resolution.formatColor, surfaceColorSpace, srgb);
-		m_depthFormat = bgfx::TextureFormat::UnknownDepth;
+	VkRenderPass FrameBufferVK::getRenderPass(uint16_t _clearFlags) const
+	{
+		VkRenderPass renderPass;
 
-		if (TextureFormat::Count == m_colorFormat)
+		if (m_numTh > 0)
 		{
-			BX_TRACE("Create swapchain error: Unable to find surface format (srgb: %d).", srgb);
-			return VK_ERROR_INITIALIZATION_FAILED;
+			VK_CHECK(s_renderVK->getRenderPass(m_numTh, m_attachment, &renderPass, _clearFlags) );
 		}
-
-		const VkFormat surfaceFormat = srgb
-			? s_textureFormat[m_colorFormat].m_fmtSrgb
-			: s_textureFormat[m_colorFormat].m_fmt
-			;
-
-		const uint32_t width = bx::clamp<uint32_t>(
-			  m_resolution.width
-			, surfaceCapabilities.minImageExtent.width
-			, surfaceCapabilities.maxImageExtent.width
-			);
-		const uint32_t height = bx::clamp<uint32_t>(
-			  m_resolution.height
-			, surfaceCapabilities.minImageExtent.height
-			, surfaceCapabilities.maxImageExtent.height
-			);
-		if (width != m_resolution.width || height != m_resolution.height)
+		else
 		{
-			BX_TRACE("Clamped swapchain resolution from %dx%d to %dx%d"
-					, m_resolution.width
-					, m_resolution.height
-					, width
-					, height
-					);
+			VK_CHECK(s_renderVK->getRenderPass(m_swapChain, &renderPass, _clearFlags) );
 		}
 
-		VkCompositeAlphaFlagBitsKHR compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+		return renderPass;
+	}
 
-		if (surfaceCapabilities.supportedCompositeAlpha & VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR)
-		{
-			compositeAlpha = VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR;
-		}
-		else if (surfaceCapabilities.supportedCompositeAlpha & VK_COMPOSITE_ALPHA_PRE_MULTIPLIED_BIT_KHR)
-		{
-			compositeAlpha = VK_COMPOSITE_ALPHA_PRE_MULTIPLIED_BIT_KHR;
-		}
-		else if (surfaceCapabilities.supportedCompositeAlpha & VK_COMPOSITE_ALPHA_POST_MULTIPLIED_BIT_KHR)
+	void FrameBufferVK::preReset()
+	{
+		BGFX_PROFILER_SCOPE("FrameBufferVK::preReset", kColorFrame);
+
+		if (VK_NULL_HANDLE != m_framebuffer)
 		{
-			compositeAlpha = VK_COMPOSITE_ALPHA_POST_MULTIPLIED_BIT_KHR;
-		}
+			s_renderVK->release(m_framebuffer);
 
-		const VkImageUsageFlags imageUsageMask = 0
-			| VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
-			| VK_IMAGE_USAGE_TRANSFER_SRC_BIT
-			| VK_IMAGE_USAGE_TRANSFER_DST_BIT
-			;
-		const VkImageUsageFlags imageUsage = surfaceCapabilities.supportedUsageFlags & imageUsageMask;
+			for (uint8_t ii = 0; ii < m_numTh; ++ii)
+			{
+				s_renderVK->release(m_textureImageViews[ii]);
+			}
+		}
+	}
 
-		m_supportsReadback      = 0 != (imageUsage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
-		m_supportsManualResolve = 0 != (imageUsage & VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+	void FrameBufferVK::postReset()
+	{
+		BGFX_PROFILER_SCOPE("FrameBufferVK::postReset", kColorFrame);
 
-		const bool vsync = !!(m_resolution.reset & BGFX_RESET_VSYNC);
-		uint32_t presentModeIdx = findPresentMode(vsync);
-		if (UINT32_MAX == presentModeIdx)
+		if (m_numTh > 0)
 		{
-			BX_TRACE("Create swapchain error: Unable to find present mode (vsync: %d).", vsync);
-			return VK_ERROR_INITIALIZATION_FAILED;
-		}
+			const VkDevice device = s_renderVK->m_device;
+			const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
 
-		m_sci.surface            = m_surface;
-		m_sci.minImageCount      = swapBufferCount;
-		m_sci.imageFormat        = surfaceFormat;
-		m_sci.imageColorSpace    = surfaceColorSpace;
-		m_sci.imageExtent.width  = width;
-		m_sci.imageExtent.height = height;
-		m_sci.imageUsage         = imageUsage;
-		m_sci.compositeAlpha     = compositeAlpha;
-		m_sci.presentMode        = s_presentMode[presentModeIdx].mode;
-		m_sci.clipped            = VK_FALSE;
+			VK_CHECK(s_renderVK->getRenderPass(m_numTh, m_attachment, &m_renderPass, 0) );
 
-		result = vkCreateSwapchainKHR(device, &m_sci, allocatorCb, &m_swapChain);
-		if (VK_SUCCESS != result)
-		{
-			BX_TRACE("Create swapchain error: vkCreateSwapchainKHR failed %d: %s.", result, getName(result) );
-			return result;
-		}
+			m_depth = BGFX_INVALID_HANDLE;
+			m_num = 0;
 
-		m_sci.oldSwapchain = m_swapChain;
+			for (uint8_t ii = 0; ii < m_numTh; ++ii)
+			{
+				const Attachment& at = m_attachment[ii];
+				const TextureVK& texture = s_renderVK->m_textures[at.handle.idx];
+				VK_CHECK(texture.createView(
+					  at.layer
+					, at.numLayers
+					, at.mip
+					, 1
+					, at.numLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D
+					, texture.m_aspectFlags
+					, true
+					, &m_textureImageViews[ii]
+					) );
 
-		result = vkGetSwapchainImagesKHR(device, m_swapChain, &m_numSwapChainImages, NULL);
-		if (VK_SUCCESS != result)
-		{
-			BX_TRACE("Create swapchain error: vkGetSwapchainImagesKHR failed %d: %s.", result, getName(result) );
-			return result;
-		}
+				if (texture.m_aspectFlags & VK_IMAGE_ASPECT_COLOR_BIT)
+				{
+					m_texture[m_num] = at.handle;
+					m_num++;
+				}
+				else if (texture.m_aspectFlags & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT) )
+				{
+					m_depth = at.handle;
+				}
+			}
 
-		BX_TRACE("Create swapchain numSwapChainImages %d, minImageCount %d, BX_COUNTOF(m_backBufferColorImage) %d"
-			, m_numSwapChainImages
-			, m_sci.minImageCount
-			, BX_COUNTOF(m_backBufferColorImage)
-			);
+			const TextureVK& firstTexture = s_renderVK->m_textures[m_attachment[0].handle.idx];
+			m_width  = bx::uint32_max(firstTexture.m_width  >> m_attachment[0].mip, 1);
+			m_height = bx::uint32_max(firstTexture.m_height >> m_attachment[0].mip, 1);
+			m_sampler = firstTexture.m_sampler;
 
-		setDebugObjectName(device, m_swapChain, "m_swapChain");
+			VkFramebufferCreateInfo fci;
+			fci.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+			fci.pNext = NULL;
+			fci.flags = 0;
+			fci.renderPass      = m_renderPass;
+			fci.attachmentCount = m_numTh;
+			fci.pAttachments    = &m_textureImageViews[0];
+			fci.width  = m_width;
+			fci.height = m_height;
+			fci.layers = m_attachment[0].numLayers;
 
-		if (m_numSwapChainImages < m_sci.minImageCount)
-		{
-			BX_TRACE("Create swapchain error: vkGetSwapchainImagesKHR: numSwapchainImages %d < minImageCount %d."
-				, m_numSwapChainImages
-				, m_sci.minImageCount
-				);
-			return VK_ERROR_INITIALIZATION_FAILED;
-		}
+			VK_CHECK(vkCreateFramebuffer(device, &fci, allocatorCb, &m_framebuffer) );
 
-		if (m_numSwapChainImages > BX_COUNTOF(m_backBufferColorImage) )
-		{
-			BX_TRACE("Create swapchain error: vkGetSwapchainImagesKHR: numSwapchainImages %d > countof(m_backBufferColorImage) %d."
-				, m_numSwapChainImages
-				, BX_COUNTOF(m_backBufferColorImage)
-				);
-			return VK_ERROR_INITIALIZATION_FAILED;
+			m_currentFramebuffer = m_framebuffer;
 		}
+	}
 
-		result = vkGetSwapchainImagesKHR(device, m_swapChain, &m_numSwapChainImages, &m_backBufferColorImage[0]);
-		if (VK_SUCCESS != result && VK_INCOMPLETE != result)
+	void FrameBufferVK::update(VkCommandBuffer _commandBuffer, const Resolution& _resolution)
+	{
+		BGFX_PROFILER_SCOPE("FrameBufferVK::update", kColorResource);
+
+		m_swapChain.update(_commandBuffer, m_nwh, _resolution);
+		VK_CHECK(s_renderVK->getRenderPass(m_swapChain, &m_renderPass, 0) );
+		// Don't believe the passed Resolution, as the Vulkan driver might have
+		// specified another resolution, which we had to obey.
+		m_width   = m_swapChain.m_sci.imageExtent.width;
+		m_height  = m_swapChain.m_sci.imageExtent.height;
+		m_sampler = m_swapChain.m_sampler;
+	}
+
+	void FrameBufferVK::resolve()
+	{
+		if (!m_needResolve)
 		{
-			BX_TRACE("Create swapchain error: vkGetSwapchainImagesKHR failed %d: %s."
-				, result
-				, getName(result)
-				);
-			return result;
+			return;
 		}
 
-		VkImageViewCreateInfo ivci;
-		ivci.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-		ivci.pNext = NULL;
-		ivci.flags = 0;
-		ivci.viewType = VK_IMAGE_VIEW_TYPE_2D;
-		ivci.format   = m_sci.imageFormat;
-		ivci.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-		ivci.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-		ivci.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
-		ivci.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
-		ivci.subresourceRange.aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT;
-		ivci.subresourceRange.baseMipLevel   = 0;
-		ivci.subresourceRange.levelCount     = 1;
-		ivci.subresourceRange.baseArrayLayer = 0;
-		ivci.subresourceRange.layerCount     = 1;
+		BGFX_PROFILER_SCOPE("FrameBufferVK::resolve", kColorFrame);
 
-		for (uint32_t ii = 0; ii < m_numSwapChainImages; ++ii)
+		if (NULL == m_nwh)
 		{
-			ivci.image = m_backBufferColorImage[ii];
-
-			result = vkCreateImageView(device, &ivci, allocatorCb, &m_backBufferColorImageView[ii]);
-
-			if (VK_SUCCESS != result)
+			for (uint32_t ii = 0; ii < m_numTh; ++ii)
 			{
-				BX_TRACE("Create swapchain error: vkCreateImageView failed %d: %s.", result, getName(result) );
-				return result;
+				const Attachment& at = m_attachment[ii];
+
+				if (isValid(at.handle) )
+				{
+					TextureVK& texture = s_renderVK->m_textures[at.handle.idx];
+					texture.resolve(s_renderVK->m_commandBuffer, at.resolve, at.layer, at.numLayers, at.mip);
+				}
 			}
+		}
+		else if (isRenderable()
+		&&       m_sampler.Count > 1
+		&&       m_swapChain.m_supportsManualResolve)
+		{
+			m_swapChain.m_backBufferColorMsaa.m_singleMsaaImage = m_swapChain.m_backBufferColorImage[m_swapChain.m_backBufferColorIdx];
+			m_swapChain.m_backBufferColorMsaa.m_currentSingleMsaaImageLayout = m_swapChain.m_backBufferColorImageLayout[m_swapChain.m_backBufferColorIdx];
 
-			setDebugObjectName(device, m_backBufferColorImageView[ii], "m_backBufferColorImageView[%d]", ii);
+			m_swapChain.m_backBufferColorMsaa.resolve(s_renderVK->m_commandBuffer, 0, 0, 1, 0);
 
-			m_backBufferColorImageLayout[ii] = VK_IMAGE_LAYOUT_UNDEFINED;
+			m_swapChain.m_backBufferColorMsaa.m_singleMsaaImage = VK_NULL_HANDLE;
+			m_swapChain.m_backBufferColorMsaa.m_currentSingleMsaaImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 		}
 
-		BX_TRACE("Successfully created swapchain (%dx%d) with %d images.", width, height, m_numSwapChainImages);
+		m_needResolve = false;
+	}
 
-		VkSemaphoreCreateInfo sci;
-		sci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-		sci.pNext = NULL;
-		sci.flags = 0;
+	uint16_t FrameBufferVK::destroy()
+	{
+		BGFX_PROFILER_SCOPE("FrameBufferVK::destroy", kColorFrame);
 
-		// We will make a fully filled pool of semaphores and cycle through those.
-		// This is to make sure we have enough, even in the case where there are
-		// more frames in flight than images on the swapchain.
-		for (uint32_t ii = 0; ii < kMaxBackBuffers; ++ii)
-		{
-			if (VK_SUCCESS != vkCreateSemaphore(device, &sci, allocatorCb, &m_presentDoneSemaphore[ii])
-			||  VK_SUCCESS != vkCreateSemaphore(device, &sci, allocatorCb, &m_renderDoneSemaphore[ii]) )
-			{
-				BX_TRACE("Create swapchain error: vkCreateSemaphore failed %d: %s.", result, getName(result) );
-				return result;
-			}
+		preReset();
 
-			setDebugObjectName(device, m_presentDoneSemaphore[ii], "m_presentDoneSemaphore[%d]", ii);
-			setDebugObjectName(device, m_renderDoneSemaphore[ii], "m_renderDoneSemaphore[%d]", ii);
+		if (NULL != m_nwh)
+		{
+			m_swapChain.destroy();
+			m_nwh = NULL;
+			m_needPresent = false;
 		}
 
-		m_backBufferColorIdx = 0;
-		m_currentSemaphore = 0;
+		m_numTh = 0;
+		m_num = 0;
+		m_depth = BGFX_INVALID_HANDLE;
 
-		m_needPresent = false;
-		m_needToRecreateSwapchain = false;
+		m_needResolve = false;
 
-		return result;
+		uint16_t denseIdx = m_denseIdx;
+		m_denseIdx = UINT16_MAX;
+		return denseIdx;
 	}
 
-	void SwapChainVK::releaseSwapChain()
+	bool FrameBufferVK::acquire(VkCommandBuffer _commandBuffer)
 	{
-		BGFX_PROFILER_SCOPE("SwapChainVK::releaseSwapChain", kColorFrame);
-
-		for (uint32_t ii = 0; ii < BX_COUNTOF(m_backBufferColorImageView); ++ii)
-		{
-			release(m_backBufferColorImageView[ii]);
+		BGFX_PROFILER_SCOPE("FrameBufferVK::acquire", kColorFrame);
 
-			m_backBufferFence[ii] = VK_NULL_HANDLE;
-		}
+		bool acquired = true;
 
-		for (uint32_t ii = 0; ii < kMaxBackBuffers; ++ii)
+		if (NULL != m_nwh)
 		{
-			release(m_presentDoneSemaphore[ii]);
-			release(m_renderDoneSemaphore[ii]);
+			acquired = m_swapChain.acquire(_commandBuffer);
+			m_needPresent = m_swapChain.m_needPresent;
+			m_currentFramebuffer = m_swapChain.m_backBufferFrameBuffer[m_swapChain.m_backBufferColorIdx];
 		}
 
-		release(m_swapChain);
+		m_needResolve = true;
+
+		return acquired;
 	}
 
-	VkResult SwapChainVK::createAttachments(VkCommandBuffer _commandBuffer)
+	void FrameBufferVK::present()
 	{
-		BGFX_PROFILER_SCOPE("SwapChainVK::createAttachments", kColorFrame);
-
-		VkResult result = VK_SUCCESS;
+		BGFX_PROFILER_SCOPE("FrameBufferVK::present", kColorFrame);
 
-		const uint32_t samplerIndex = (m_resolution.reset & BGFX_RESET_MSAA_MASK) >> BGFX_RESET_MSAA_SHIFT;
-		const uint64_t textureFlags = (uint64_t(samplerIndex + 1) << BGFX_TEXTURE_RT_MSAA_SHIFT) | BGFX_TEXTURE_RT | BGFX_TEXTURE_RT_WRITE_ONLY;
-		m_sampler = s_msaa[samplerIndex];
+		m_swapChain.present();
+		m_needPresent = false;
+	}
 
-		const uint16_t requiredCaps = m_sampler.Count > 1
-			? BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER_MSAA
-			: BGFX_CAPS_FORMAT_TEXTURE_FRAMEBUFFER
+	bool FrameBufferVK::isRenderable() const
+	{
+		return false
+			|| (NULL == m_nwh)
+			|| m_swapChain.m_needPresent
 			;
+	}
 
-		if (bimg::isDepth(bimg::TextureFormat::Enum(m_resolution.formatDepthStencil) ) )
-		{
-			// the spec guarantees that at least one of D24S8 and D32FS8 is supported
-			VkFormat depthFormat = VK_FORMAT_D32_SFLOAT_S8_UINT;
+	VkResult CommandQueueVK::init(uint32_t _queueFamily, VkQueue _queue)
+	{
+		m_queueFamily         = _queueFamily;
+		m_queue               = _queue;
+		m_activeCommandBuffer = VK_NULL_HANDLE;
+		m_consumeIndex        = 0;
 
-			if (g_caps.formats[m_resolution.formatDepthStencil] & requiredCaps)
-			{
-				depthFormat = s_textureFormat[m_resolution.formatDepthStencil].m_fmtDsv;
-			}
-			else if (g_caps.formats[TextureFormat::D24S8] & requiredCaps)
-			{
-				depthFormat = s_textureFormat[TextureFormat::D24S8].m_fmtDsv;
-			}
+		return reset();
+	}
 
-			result = m_backBufferDepthStencil.create(
-				  _commandBuffer
-				, m_sci.imageExtent.width
-				, m_sci.imageExtent.height
-				, textureFlags
-				, depthFormat
+	VkResult CommandQueueVK::reset()
+	{
+		shutdown();
+
+		m_currentFrameInFlight = 0;
+		m_consumeIndex         = 0;
+
+		m_numSignalSemaphores = 0;
+		m_numWaitSemaphores   = 0;
+
+		m_activeCommandBuffer = VK_NULL_HANDLE;
+		m_currentFence        = VK_NULL_HANDLE;
+		m_completedFence      = VK_NULL_HANDLE;
+
+		m_submitted = 0;
+
+		VkCommandPoolCreateInfo cpci;
+		cpci.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		cpci.pNext = NULL;
+		cpci.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+		cpci.queueFamilyIndex = m_queueFamily;
+
+		VkCommandBufferAllocateInfo cbai;
+		cbai.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		cbai.pNext = NULL;
+		cbai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		cbai.commandBufferCount = 1;
+
+		VkFenceCreateInfo fci;
+		fci.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		fci.pNext = NULL;
+		fci.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+		VkResult result = VK_SUCCESS;
+
+		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
+		const VkDevice device = s_renderVK->m_device;
+
+		for (uint32_t ii = 0, maxFrameLatency = s_renderVK->m_maxFrameLatency; ii < maxFrameLatency; ++ii)
+		{
+			result = vkCreateCommandPool(
+				  device
+				, &cpci
+				, allocatorCb
+				, &m_commandList[ii].m_commandPool
 				);
 
 			if (VK_SUCCESS != result)
 			{
-				BX_TRACE("Create swapchain error: creating depth stencil image failed %d: %s.", result, getName(result) );
+				BX_TRACE("Create command queue error: vkCreateCommandPool failed %d: %s.", result, getName(result) );
 				return result;
 			}
 
-			result = m_backBufferDepthStencil.createView(0, 1, 0, 1
-				, VK_IMAGE_VIEW_TYPE_2D
-				, m_backBufferDepthStencil.m_aspectFlags
-				, true
-				, &m_backBufferDepthStencilImageView
-			);
+			cbai.commandPool = m_commandList[ii].m_commandPool;
+
+			result = vkAllocateCommandBuffers(
+				  device
+				, &cbai
+				, &m_commandList[ii].m_commandBuffer
+				);
 
 			if (VK_SUCCESS != result)
 			{
-				BX_TRACE("Create swapchain error: creating depth stencil image view failed %d: %s.", result, getName(result) );
+				BX_TRACE("Create command queue error: vkAllocateCommandBuffers failed %d: %s.", result, getName(result) );
 				return result;
 			}
 
-			if (m_sampler.Count > 1)
-			{
-				result = m_backBufferColorMsaa.create(
-					  _commandBuffer
-					, m_sci.imageExtent.width
-					, m_sci.imageExtent.height
-					, textureFlags
-					, m_sci.imageFormat
-					);
-
-				if (VK_SUCCESS != result)
-				{
-					BX_TRACE("Create swapchain error: creating MSAA color image failed %d: %s.", result, getName(result) );
-					return result;
-				}
-
-				result = m_backBufferColorMsaa.createView(0, 1, 0, 1
-					, VK_IMAGE_VIEW_TYPE_2D
-					, m_backBufferColorMsaa.m_aspectFlags
-					, true
-					, &m_backBufferColorMsaaImageView
-				);
-
-				if (VK_SUCCESS != result)
-				{
-					BX_TRACE("Create swapchain error: creating MSAA color image view failed %d: %s.", result, getName(result) );
-					return result;
-				}
+			result = vkCreateFence(
+				  device
+				, &fci
+				, allocatorCb
+				, &m_commandList[ii].m_fence
+				);
+
+			if (VK_SUCCESS != result)
+			{
+				BX_TRACE("Create command queue error: vkCreateFence failed %d: %s.", result, getName(result) );
+				return result;
 			}
 		}
 
 		return result;
 	}
 
-	void SwapChainVK::releaseAttachments()
+	void CommandQueueVK::shutdown()
 	{
-		BGFX_PROFILER_SCOPE("SwapChainVK::releaseAttachments", kColorFrame);
-
-		release(m_backBufferDepthStencilImageView);
-		release(m_backBufferColorMsaaImageView);
+		kick(true);
+		finish(true);
 
-		m_backBufferDepthStencil.destroy();
-		m_backBufferColorMsaa.destroy();
+		for (uint32_t ii = 0, maxFrameLatency = s_renderVK->m_maxFrameLatency; ii < maxFrameLatency; ++ii)
+		{
+			vkDestroy(m_commandList[ii].m_fence);
+			m_commandList[ii].m_commandBuffer = VK_NULL_HANDLE;
+			vkDestroy(m_commandList[ii].m_commandPool);
+		}
 	}
 
-	VkResult SwapChainVK::createFrameBuffer()
+	VkResult CommandQueueVK::alloc(VkCommandBuffer* _outCommandBuffer)
 	{
-		BGFX_PROFILER_SCOPE("SwapChainVK::createFrameBuffer", kColorFrame);
+		BGFX_PROFILER_SCOPE("CommandQueueVK::alloc", kColorResource);
 
 		VkResult result = VK_SUCCESS;
 
-		const VkDevice device = s_renderVK->m_device;
-		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
-
-		VkRenderPass renderPass;
-		result = s_renderVK->getRenderPass(*this, &renderPass, 0);
-
-		if (VK_SUCCESS != result)
+		if (m_activeCommandBuffer == VK_NULL_HANDLE)
 		{
-			return result;
-		}
+			const VkDevice device = s_renderVK->m_device;
+			CommandList& commandList = m_commandList[m_currentFrameInFlight];
 
-		for (uint32_t ii = 0; ii < m_numSwapChainImages; ++ii)
-		{
-			uint32_t numAttachments = 0;
-			::VkImageView attachments[3];
+			{
+				BGFX_PROFILER_SCOPE("vkWaitForFences", kColorWait);
 
-			attachments[numAttachments++] = m_sampler.Count > 1
-				? m_backBufferColorMsaaImageView
-				: m_backBufferColorImageView[ii]
-				;
+				result = vkWaitForFences(device, 1, &commandList.m_fence, VK_TRUE, UINT64_MAX);
+			}
 
-			if (NULL != m_backBufferDepthStencilImageView)
+			if (VK_SUCCESS != result)
 			{
-				attachments[numAttachments++] = m_backBufferDepthStencilImageView;
+				BX_TRACE("Allocate command buffer error: vkWaitForFences failed %d: %s.", result, getName(result) );
+				return result;
 			}
 
-			if (m_sampler.Count > 1 && !m_supportsManualResolve)
+			result = vkResetCommandPool(device, commandList.m_commandPool, 0);
+
+			if (VK_SUCCESS != result)
 			{
-				attachments[numAttachments++] = m_backBufferColorImageView[ii];
+				BX_TRACE("Allocate command buffer error: vkResetCommandPool failed %d: %s.", result, getName(result) );
+				return result;
 			}
 
-			VkFramebufferCreateInfo fci;
-			fci.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-			fci.pNext = NULL;
-			fci.flags = 0;
-			fci.renderPass = renderPass;
-			fci.attachmentCount = numAttachments;
-			fci.pAttachments = attachments;
-			fci.width = m_sci.imageExtent.width;
-			fci.height = m_sci.imageExtent.height;
-			fci.layers = 1;
+			VkCommandBufferBeginInfo cbi;
+			cbi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+			cbi.pNext = NULL;
+			cbi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+			cbi.pInheritanceInfo = NULL;
 
-			result = vkCreateFramebuffer(device, &fci, allocatorCb, &m_backBufferFrameBuffer[ii]);
+			result = vkBeginCommandBuffer(commandList.m_commandBuffer, &cbi);
 
 			if (VK_SUCCESS != result)
 			{
+				BX_TRACE("Allocate command buffer error: vkBeginCommandBuffer failed %d: %s.", result, getName(result) );
 				return result;
 			}
+
+			m_activeCommandBuffer = commandList.m_commandBuffer;
+			m_currentFence = commandList.m_fence;
+		}
+
+		if (NULL != _outCommandBuffer)
+		{
+			*_outCommandBuffer = m_activeCommandBuffer;
 		}
 
 		return result;
 	}
 
-	void SwapChainVK::releaseFrameBuffer()
+	void CommandQueueVK::addWaitSemaphore(VkSemaphore _semaphore, VkPipelineStageFlags _waitFlags)
 	{
-		for (uint32_t ii = 0; ii < BX_COUNTOF(m_backBufferColorImageView); ++ii)
-		{
-			release(m_backBufferFrameBuffer[ii]);
-		}
+		BX_ASSERT(m_numWaitSemaphores < BX_COUNTOF(m_waitSemaphores), "Too many wait semaphores.");
+
+		m_waitSemaphores[m_numWaitSemaphores]      = _semaphore;
+		m_waitSemaphoreStages[m_numWaitSemaphores] = _waitFlags;
+		m_numWaitSemaphores++;
 	}
 
-	uint32_t SwapChainVK::findPresentMode(bool _vsync)
+	void CommandQueueVK::addSignalSemaphore(VkSemaphore _semaphore)
 	{
-		BGFX_PROFILER_SCOPE("SwapChainVK::findPresentMode", kColorFrame);
-
-		VkResult result = VK_SUCCESS;
+		BX_ASSERT(m_numSignalSemaphores < BX_COUNTOF(m_signalSemaphores), "Too many signal semaphores.");
 
-		const VkPhysicalDevice physicalDevice = s_renderVK->m_physicalDevice;
+		m_signalSemaphores[m_numSignalSemaphores] = _semaphore;
+		m_numSignalSemaphores++;
+	}
 
-		uint32_t numPresentModes;
-		result = vkGetPhysicalDeviceSurfacePresentModesKHR(
-			  physicalDevice
-			, m_surface
-			, &numPresentModes
-			, NULL
-			);
+	void CommandQueueVK::kick(bool _wait)
+	{
+		BGFX_PROFILER_SCOPE("CommandQueueVK::kick", kColorDraw);
 
-		if (VK_SUCCESS != result)
+		if (VK_NULL_HANDLE != m_activeCommandBuffer)
 		{
-			BX_TRACE("findPresentMode error: vkGetPhysicalDeviceSurfacePresentModesKHR failed %d: %s.", result, getName(result) );
-			return UINT32_MAX;
-		}
+			const VkDevice device = s_renderVK->m_device;
 
-		VkPresentModeKHR presentModes[16];
-		numPresentModes = bx::min<uint32_t>(numPresentModes, BX_COUNTOF(presentModes) );
-		result = vkGetPhysicalDeviceSurfacePresentModesKHR(
-			  physicalDevice
-			, m_surface
-			, &numPresentModes
-			, presentModes
-			);
+			setMemoryBarrier(
+				  m_activeCommandBuffer
+				, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
+				, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
+				);
 
-		if (VK_SUCCESS != result)
-		{
-			BX_TRACE("findPresentMode error: vkGetPhysicalDeviceSurfacePresentModesKHR failed %d: %s.", result, getName(result) );
-			return UINT32_MAX;
-		}
+			VK_CHECK(vkEndCommandBuffer(m_activeCommandBuffer) );
 
-		uint32_t idx = UINT32_MAX;
+			m_completedFence = m_currentFence;
+			m_currentFence = VK_NULL_HANDLE;
+
+			VK_CHECK(vkResetFences(device, 1, &m_completedFence) );
+
+			VkSubmitInfo si;
+			si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			si.pNext = NULL;
+			si.waitSemaphoreCount    = m_numWaitSemaphores;
+			si.pWaitSemaphores       = &m_waitSemaphores[0];
+			si.pWaitDstStageMask     = m_waitSemaphoreStages;
+			si.commandBufferCount    = 1;
+			si.pCommandBuffers       = &m_activeCommandBuffer;
+			si.signalSemaphoreCount  = m_numSignalSemaphores;
+			si.pSignalSemaphores     = &m_signalSemaphores[0];
+
+			m_numWaitSemaphores   = 0;
+			m_numSignalSemaphores = 0;
 
-		for (uint32_t ii = 0; ii < BX_COUNTOF(s_presentMode) && UINT32_MAX == idx; ++ii)
-		{
-			for (uint32_t jj = 0; jj < numPresentModes; ++jj)
 			{
-				const PresentMode& pm = s_presentMode[ii];
+				BGFX_PROFILER_SCOPE("vkQueueSubmit", kColorDraw);
 
-				if (pm.mode  == presentModes[jj]
-				&&  pm.vsync == _vsync)
-				{
-					idx = ii;
-					break;
-				}
+				VK_CHECK(vkQueueSubmit(m_queue, 1, &si, m_completedFence) );
 			}
-		}
 
-		if (UINT32_MAX == idx)
-		{
-			idx = 0;
-			BX_TRACE("Present mode not found! Defaulting to %s.", s_presentMode[idx].name);
-		}
+			if (_wait)
+			{
+				BGFX_PROFILER_SCOPE("vkWaitForFences", kColorWait);
 
-		return idx;
+				VK_CHECK(vkWaitForFences(device, 1, &m_completedFence, VK_TRUE, UINT64_MAX) );
+			}
+
+			m_activeCommandBuffer = VK_NULL_HANDLE;
+
+			m_currentFrameInFlight = (m_currentFrameInFlight + 1) % s_renderVK->m_maxFrameLatency;
+			m_submitted++;
+		}
 	}
 
-	TextureFormat::Enum SwapChainVK::findSurfaceFormat(TextureFormat::Enum _format, VkColorSpaceKHR _colorSpace, bool _srgb)
+	void CommandQueueVK::finish(bool _finishAll)
 	{
-		BGFX_PROFILER_SCOPE("SwapChainVK::findSurfaceFormat", kColorFrame);
-
-		VkResult result = VK_SUCCESS;
+		BGFX_PROFILER_SCOPE("CommandQueueVK::finish", kColorDraw);
 
-		TextureFormat::Enum selectedFormat = TextureFormat::Count;
+		if (_finishAll)
+		{
+			for (uint32_t ii = 0, maxFrameLatency = s_renderVK->m_maxFrameLatency; ii < maxFrameLatency; ++ii)
+			{
+				consume();
+			}
 
-		const VkPhysicalDevice physicalDevice = s_renderVK->m_physicalDevice;
+			m_consumeIndex = m_currentFrameInFlight;
+		}
+		else
+		{
+			consume();
+		}
+	}
 
-		uint32_t numSurfaceFormats;
-		result = vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, m_surface, &numSurfaceFormats, NULL);
+	bool CommandQueueVK::isComplete(uint64_t _submitted, uint32_t _frameInFlight, bool _wait)
+	{
+		if (_submitted >= m_submitted)
+		{
+			return false;
+		}
 
-		if (VK_SUCCESS != result)
+		// Command buffer of this frame in flight was reused, and its fence
+		// was waited on before that.
+		if (_submitted + s_renderVK->m_maxFrameLatency <= m_submitted)
 		{
-			BX_TRACE("findSurfaceFormat error: vkGetPhysicalDeviceSurfaceFormatsKHR failed %d: %s.", result, getName(result) );
-			return selectedFormat;
+			return true;
 		}
 
-		VkSurfaceFormatKHR* surfaceFormats = (VkSurfaceFormatKHR*)bx::alloc(g_allocator, numSurfaceFormats * sizeof(VkSurfaceFormatKHR) );
-		result = vkGetPhysicalDeviceSurfaceFormatsKHR(physicalDevice, m_surface, &numSurfaceFormats, surfaceFormats);
+		const VkDevice device = s_renderVK->m_device;
+		const VkFence fence = m_commandList[_frameInFlight].m_fence;
 
-		if (VK_SUCCESS != result)
+		if (_wait)
 		{
-			BX_TRACE("findSurfaceFormat error: vkGetPhysicalDeviceSurfaceFormatsKHR failed %d: %s.", result, getName(result) );
-			bx::free(g_allocator, surfaceFormats);
-			return selectedFormat;
+			BGFX_PROFILER_SCOPE("vkWaitForFences", kColorWait);
+
+			VK_CHECK(vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX) );
+			return true;
 		}
 
-		const TextureFormat::Enum requestedFormats[] =
-		{
-			_format,
-			TextureFormat::BGRA8,
-			TextureFormat::RGBA8,
-		};
+		return VK_SUCCESS == vkGetFenceStatus(device, fence);
+	}
+
+	void CommandQueueVK::release(uint64_t _handle, VkObjectType _type)
+	{
+		Resource resource;
+		resource.m_type = _type;
+		resource.m_handle = _handle;
+		m_release[m_currentFrameInFlight].push_back(resource);
+	}
+
+	void CommandQueueVK::recycleMemory(DeviceMemoryAllocationVK _mem)
+	{
+		m_recycleAllocs[m_currentFrameInFlight].push_back(_mem);
+	}
+
+	void CommandQueueVK::consume()
+	{
+		BGFX_PROFILER_SCOPE("CommandQueueVK::consume", kColorResource);
 
-		for (uint32_t ii = 0; ii < BX_COUNTOF(requestedFormats) && TextureFormat::Count == selectedFormat; ++ii)
-		{
-			const TextureFormat::Enum requested = requestedFormats[ii];
-			const VkFormat requestedVkFormat = _srgb
-				? s_textureFormat[requested].m_fmtSrgb
-				: s_textureFormat[requested].m_fmt
-				;
+		m_consumeIndex = (m_consumeIndex + 1) % s_renderVK->m_maxFrameLatency;
 
-			for (uint32_t jj = 0; jj < numSurfaceFormats; jj++)
+		for (DeviceMemoryAllocationVK& alloc : m_recycleAllocs[m_consumeIndex])
+		{
+			if (UINT16_MAX != alloc.page)
 			{
-				if (_colorSpace == surfaceFormats[jj].colorSpace
-				&&  requestedVkFormat == surfaceFormats[jj].format)
-				{
-					selectedFormat = requested;
-					if (0 != ii
-					&&  s_renderVK->m_swapChainFormats[_format] != selectedFormat)
-					{
-						s_renderVK->m_swapChainFormats[_format] = selectedFormat;
-						BX_TRACE(
-							"findSurfaceFormat: Surface format %s not found! Defaulting to %s."
-							, bimg::getName(bimg::TextureFormat::Enum(_format) )
-							, bimg::getName(bimg::TextureFormat::Enum(selectedFormat) )
-							);
-					}
-					break;
-				}
+				s_renderVK->m_memoryAllocator.free(alloc);
+			}
+			else
+			{
+				s_renderVK->m_memoryLru.recycle(alloc);
 			}
 		}
 
-		bx::free(g_allocator, surfaceFormats);
+		m_recycleAllocs[m_consumeIndex].clear();
 
-		if (TextureFormat::Count == selectedFormat)
+		for (const Resource& resource : m_release[m_consumeIndex])
 		{
-			BX_TRACE("findSurfaceFormat error: No supported surface format found.");
+			switch (resource.m_type)
+			{
+			case VK_OBJECT_TYPE_BUFFER:                destroy<VkBuffer             >(resource.m_handle); break;
+			case VK_OBJECT_TYPE_IMAGE_VIEW:            destroy<VkImageView          >(resource.m_handle); break;
+			case VK_OBJECT_TYPE_IMAGE:                 destroy<VkImage              >(resource.m_handle); break;
+			case VK_OBJECT_TYPE_FRAMEBUFFER:           destroy<VkFramebuffer        >(resource.m_handle); break;
+			case VK_OBJECT_TYPE_PIPELINE_LAYOUT:       destroy<VkPipelineLayout     >(resource.m_handle); break;
+			case VK_OBJECT_TYPE_PIPELINE:              destroy<VkPipeline           >(resource.m_handle); break;
+			case VK_OBJECT_TYPE_DESCRIPTOR_SET:        destroy<VkDescriptorSet      >(resource.m_handle); break;
+			case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT: destroy<VkDescriptorSetLayout>(resource.m_handle); break;
+			case VK_OBJECT_TYPE_RENDER_PASS:           destroy<VkRenderPass         >(resource.m_handle); break;
+			case VK_OBJECT_TYPE_SAMPLER:               destroy<VkSampler            >(resource.m_handle); break;
+			case VK_OBJECT_TYPE_SEMAPHORE:             destroy<VkSemaphore          >(resource.m_handle); break;
+			case VK_OBJECT_TYPE_SURFACE_KHR:           destroy<VkSurfaceKHR         >(resource.m_handle); break;
+			case VK_OBJECT_TYPE_SWAPCHAIN_KHR:         destroy<VkSwapchainKHR       >(resource.m_handle); break;
+			case VK_OBJECT_TYPE_DEVICE_MEMORY:         destroy<VkDeviceMemory       >(resource.m_handle); break;
+			default:
+				BX_ASSERT(false, "Invalid resource type: %d", resource.m_type);
+				break;
+			}
 		}
 
-		return selectedFormat;
+		m_release[m_consumeIndex].clear();
 	}
 
-	bool SwapChainVK::acquire(VkCommandBuffer _commandBuffer)
+	VkResult UploadQueueVK::init(uint32_t _queueFamily, VkQueue _queue)
 	{
-		BGFX_PROFILER_SCOPE("SwapChainVK::acquire", kColorFrame);
+		m_commandBuffer  = VK_NULL_HANDLE;
+		m_queueFamily[0] = s_renderVK->m_globalQueueFamily;
+		m_queueFamily[1] = _queueFamily;
+		m_size     = 0;
+		m_waitTime = 0;
 
-		if (VK_NULL_HANDLE == m_swapChain
-		||  m_needToRecreateSwapchain)
+		for (uint32_t ii = 0; ii < BX_COUNTOF(m_semaphore); ++ii)
 		{
-			return false;
+			m_semaphore[ii] = VK_NULL_HANDLE;
 		}
 
-		if (!m_needPresent)
-		{
-			const VkDevice device = s_renderVK->m_device;
+		m_enabled = true;
 
-			m_lastImageAcquiredSemaphore = m_presentDoneSemaphore[m_currentSemaphore];
-			m_lastImageRenderedSemaphore = m_renderDoneSemaphore[m_currentSemaphore];
-			m_currentSemaphore = (m_currentSemaphore + 1) % kMaxBackBuffers;
+		VkResult result = m_cmd.init(_queueFamily, _queue);
 
-			VkResult result;
-			{
-				BGFX_PROFILER_SCOPE("vkAcquireNextImageKHR", kColorFrame);
+		if (VK_SUCCESS != result)
+		{
+			BX_TRACE("Create upload queue error: creating command queue failed %d: %s.", result, getName(result) );
+			return result;
+		}
 
-				result = vkAcquireNextImageKHR(
-					  device
-					, m_swapChain
-					, UINT64_MAX
-					, m_lastImageAcquiredSemaphore
-					, VK_NULL_HANDLE
-					, &m_backBufferColorIdx
-					);
-			}
+		VkSemaphoreCreateInfo sci;
+		sci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		sci.pNext = NULL;
+		sci.flags = 0;
 
+		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
+		const VkDevice device = s_renderVK->m_device;
 
-			if (result != VK_SUCCESS)
-			{
-				BX_TRACE("vkAcquireNextImageKHR(...): result = %s", getName(result) );
-			}
+		for (uint32_t ii = 0, maxFrameLatency = s_renderVK->m_maxFrameLatency; ii < maxFrameLatency; ++ii)
+		{
+			result = vkCreateSemaphore(device, &sci, allocatorCb, &m_semaphore[ii]);
 
-			switch (result)
+			if (VK_SUCCESS != result)
 			{
-			case VK_SUCCESS:
-				break;
+				BX_TRACE("Create upload queue error: vkCreateSemaphore failed %d: %s.", result, getName(result) );
+				return result;
+			}
+		}
 
-			case VK_ERROR_SURFACE_LOST_KHR:
-				m_needToRecreateSurface = true;
-				m_needToRecreateSwapchain = true;
-				return false;
+		open();
 
-			case VK_ERROR_OUT_OF_DATE_KHR:
-			case VK_SUBOPTIMAL_KHR:
-				m_needToRecreateSwapchain = true;
-				return false;
+		return result;
+	}
 
-			default:
-				BX_ASSERT(VK_SUCCESS == result, "vkAcquireNextImageKHR(...); VK error 0x%x: %s", result, getName(result) );
-				return false;
-			}
+	void UploadQueueVK::shutdown()
+	{
+		if (m_enabled)
+		{
+			m_cmd.shutdown();
+			m_commandBuffer = VK_NULL_HANDLE;
 
-			if (VK_NULL_HANDLE != m_backBufferFence[m_backBufferColorIdx])
+			for (uint32_t ii = 0; ii < BX_COUNTOF(m_semaphore); ++ii)
 			{
-				BGFX_PROFILER_SCOPE("vkWaitForFences", kColorWait);
-
-				VK_CHECK(vkWaitForFences(
-					  device
-					, 1
-					, &m_backBufferFence[m_backBufferColorIdx]
-					, VK_TRUE
-					, UINT64_MAX
-					) );
+				vkDestroy(m_semaphore[ii]);
 			}
 
-			transitionImage(_commandBuffer);
+			m_buffers.clear();
+			m_textures.clear();
 
-			m_needPresent = true;
+			m_enabled = false;
+			m_open    = false;
 		}
-
-		return true;
 	}
 
-	void SwapChainVK::present()
+	void UploadQueueVK::setSharingMode(VkBufferCreateInfo& _bci) const
 	{
-		BGFX_PROFILER_SCOPE("SwapChainVk::present", kColorFrame);
+		if (m_enabled)
+		{
+			// Staging memory is written by host, and read by both queues.
+			_bci.sharingMode           = VK_SHARING_MODE_CONCURRENT;
+			_bci.queueFamilyIndexCount = BX_COUNTOF(m_queueFamily);
+			_bci.pQueueFamilyIndices   = m_queueFamily;
+		}
+	}
 
-		if (VK_NULL_HANDLE != m_swapChain
-		&&  m_needPresent)
+	VkCommandBuffer UploadQueueVK::alloc()
+	{
+		if (VK_NULL_HANDLE == m_commandBuffer)
 		{
-			VkPresentInfoKHR pi;
-			pi.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-			pi.pNext = NULL;
-			pi.waitSemaphoreCount = 1;
-			pi.pWaitSemaphores    = &m_lastImageRenderedSemaphore;
-			pi.swapchainCount     = 1;
-			pi.pSwapchains        = &m_swapChain;
-			pi.pImageIndices      = &m_backBufferColorIdx;
-			pi.pResults           = NULL;
-			VkResult result;
-			{
-				BGFX_PROFILER_SCOPE("vkQueuePresentHKR", kColorFrame);
+			const int64_t start = bx::getHPCounter();
 
-				result = vkQueuePresentKHR(m_queue, &pi);
-			}
+			VK_CHECK(m_cmd.alloc(&m_commandBuffer) );
 
-			if (result != VK_SUCCESS)
-			{
-				BX_TRACE("vkQueuePresentKHR(...): result = %s", getName(result) );
-			}
+			m_waitTime += bx::getHPCounter() - start;
+		}
 
-			switch (result)
-			{
-			case VK_ERROR_SURFACE_LOST_KHR:
-				m_needToRecreateSurface = true;
-				m_needToRecreateSwapchain = true;
-				break;
+		return m_commandBuffer;
+	}
 
-			case VK_ERROR_OUT_OF_DATE_KHR:
-			case VK_SUBOPTIMAL_KHR:
-				m_needToRecreateSwapchain = true;
-				break;
+	bool UploadQueueVK::claim(BufferVK& _buffer)
+	{
+		if (!m_open)
+		{
+			return false;
+		}
 
-			default:
-				BX_ASSERT(VK_SUCCESS == result, "vkQueuePresentKHR(...); VK error 0x%x: %s", result, getName(result) );
-				break;
-			}
+		Buffer buffer;
+		buffer.m_buffer = &_buffer;
+		buffer.m_handle = _buffer.m_buffer;
+		m_buffers.push_back(buffer);
 
-			m_needPresent = false;
-			m_lastImageRenderedSemaphore = VK_NULL_HANDLE;
-		}
+		return true;
 	}
 
-	void SwapChainVK::transitionImage(VkCommandBuffer _commandBuffer)
+	bool UploadQueueVK::claim(TextureVK& _texture)
 	{
-		VkImageLayout& layout = m_backBufferColorImageLayout[m_backBufferColorIdx];
+		if (!m_open)
+		{
+			return false;
+		}
 
-		const bool toPresent = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL == layout;
+		VkImageMemoryBarrier imb;
+		imb.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		imb.pNext = NULL;
+		imb.srcAccessMask = 0;
+		imb.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		imb.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imb.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		imb.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imb.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imb.image = _texture.m_textureImage;
+		imb.subresourceRange.aspectMask     = _texture.m_aspectFlags;
+		imb.subresourceRange.baseMipLevel   = 0;
+		imb.subresourceRange.levelCount     = VK_REMAINING_MIP_LEVELS;
+		imb.subresourceRange.baseArrayLayer = 0;
+		imb.subresourceRange.layerCount     = VK_REMAINING_ARRAY_LAYERS;
 
-		const VkImageLayout newLayout = toPresent
-			? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
-			: VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
-			;
+		vkCmdPipelineBarrier(
+			  alloc()
+			, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT
+			, VK_PIPELINE_STAGE_TRANSFER_BIT
+			, 0
+			, 0
+			, NULL
+			, 0
+			, NULL
+			, 1
+			, &imb
+			);
 
-		layout = toPresent ? layout : VK_IMAGE_LAYOUT_UNDEFINED;
+		_texture.m_currentImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
 
-		setImageMemoryBarrier(
-			  _commandBuffer
-			, m_backBufferColorImage[m_backBufferColorIdx]
-			, VK_IMAGE_ASPECT_COLOR_BIT
-			, layout
-			, newLayout
-		);
+		Texture texture;
+		texture.m_texture = &_texture;
+		texture.m_handle  = _texture.m_textureImage;
+		m_textures.push_back(texture);
 
-		layout = newLayout;
+		return true;
 	}
 
-	void FrameBufferVK::create(uint8_t _num, const Attachment* _attachment)
+	void UploadQueueVK::copyBuffer(BufferVK& _buffer, VkBuffer _stagingBuffer, const VkBufferCopy& _region)
 	{
-		BGFX_PROFILER_SCOPE("FrameBufferVK::create", kColorFrame);
+		const VkCommandBuffer commandBuffer = alloc();
 
-		m_numTh = _num;
-		bx::memCopy(m_attachment, _attachment, sizeof(Attachment) * _num);
+		vkCmdCopyBuffer(commandBuffer, _stagingBuffer, _buffer.m_buffer, 1, &_region);
 
-		postReset();
+		setMemoryBarrier(
+			  commandBuffer
+			, VK_PIPELINE_STAGE_TRANSFER_BIT
+			, VK_PIPELINE_STAGE_TRANSFER_BIT
+			);
+
+		m_size += uint32_t(_region.size);
 	}
 
-	VkResult FrameBufferVK::create(uint16_t _denseIdx, void* _nwh, uint32_t _width, uint32_t _height, TextureFormat::Enum _colorFormat, TextureFormat::Enum _depthFormat)
+	void UploadQueueVK::copyBufferToImage(TextureVK& _texture, VkBuffer _stagingBuffer, uint32_t _bufferImageCopyCount, const VkBufferImageCopy* _bufferImageCopy, uint32_t _size)
 	{
-		BGFX_PROFILER_SCOPE("FrameBufferVK::create", kColorFrame);
+		const VkCommandBuffer commandBuffer = alloc();
 
-		VkResult result = VK_SUCCESS;
+		vkCmdCopyBufferToImage(
+			  commandBuffer
+			, _stagingBuffer
+			, _texture.m_textureImage
+			, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+			, _bufferImageCopyCount
+			, _bufferImageCopy
+			);
 
-		Resolution resolution = s_renderVK->m_resolution;
-		resolution.formatColor        = TextureFormat::Count == _colorFormat ? resolution.formatColor        : _colorFormat;
-		resolution.formatDepthStencil = TextureFormat::Count == _depthFormat ? resolution.formatDepthStencil : _depthFormat;
-		resolution.width  = _width;
-		resolution.height = _height;
+		setMemoryBarrier(
+			  commandBuffer
+			, VK_PIPELINE_STAGE_TRANSFER_BIT
+			, VK_PIPELINE_STAGE_TRANSFER_BIT
+			);
+
+		m_size += _size;
+	}
+
+	void UploadQueueVK::open()
+	{
+		m_open = m_enabled;
+	}
 
-		if (_denseIdx != UINT16_MAX)
+	void UploadQueueVK::close(VkCommandBuffer _commandBuffer, CommandQueueVK& _cmd)
+	{
+		if (!m_open)
 		{
-			resolution.reset &= ~BGFX_RESET_MSAA_MASK;
+			return;
 		}
 
-		result = m_swapChain.create(s_renderVK->m_commandBuffer, _nwh, resolution);
+		m_open = false;
 
-		if (VK_SUCCESS != result)
+		if (VK_NULL_HANDLE == m_commandBuffer)
 		{
-			return result;
+			return;
 		}
 
-		result = s_renderVK->getRenderPass(m_swapChain, &m_renderPass, 0);
+		BGFX_PROFILER_SCOPE("UploadQueueVK::close", kColorResource);
 
-		if (VK_SUCCESS != result)
+		m_releaseBuffers.clear();
+		m_acquireBuffers.clear();
+		m_releaseImages.clear();
+		m_acquireImages.clear();
+
+		// Release ownership on upload queue, and acquire it on graphics queue.
+		// Resources destroyed since upload was recorded are skipped.
+		for (const Buffer& buffer : m_buffers)
 		{
-			return result;
-		}
+			BufferVK& bufferVK = *buffer.m_buffer;
 
-		m_denseIdx = _denseIdx;
-		m_nwh      = _nwh;
-		m_width    = m_swapChain.m_sci.imageExtent.width;
-		m_height   = m_swapChain.m_sci.imageExtent.height;
-		m_sampler  = m_swapChain.m_sampler;
+			if (!bufferVK.m_uploadPending
+			||  bufferVK.m_buffer != buffer.m_handle)
+			{
+				continue;
+			}
 
-		return result;
-	}
+			VkBufferMemoryBarrier bmb;
+			bmb.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+			bmb.pNext = NULL;
+			bmb.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			bmb.dstAccessMask = 0;
+			bmb.srcQueueFamilyIndex = m_cmd.m_queueFamily;
+			bmb.dstQueueFamilyIndex = _cmd.m_queueFamily;
+			bmb.buffer = buffer.m_handle;
+			bmb.offset = 0;
+			bmb.size   = VK_WHOLE_SIZE;
+			m_releaseBuffers.push_back(bmb);
 
-	VkRenderPass FrameBufferVK::getRenderPass(uint16_t _clearFlags) const
-	{
-		VkRenderPass renderPass;
+			bmb.srcAccessMask = 0;
+			bmb.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+			m_acquireBuffers.push_back(bmb);
 
-		if (m_numTh > 0)
-		{
-			VK_CHECK(s_renderVK->getRenderPass(m_numTh, m_attachment, &renderPass, _clearFlags) );
-		}
-		else
-		{
-			VK_CHECK(s_renderVK->getRenderPass(m_swapChain, &renderPass, _clearFlags) );
+			bufferVK.m_uploadPending = false;
 		}
 
-		return renderPass;
-	}
-
-	void FrameBufferVK::preReset()
-	{
-		BGFX_PROFILER_SCOPE("FrameBufferVK::preReset", kColorFrame);
-
-		if (VK_NULL_HANDLE != m_framebuffer)
+		for (const Texture& texture : m_textures)
 		{
-			s_renderVK->release(m_framebuffer);
+			TextureVK& textureVK = *texture.m_texture;
 
-			for (uint8_t ii = 0; ii < m_numTh; ++ii)
+			if (!textureVK.m_uploadPending
+			||  textureVK.m_textureImage != texture.m_handle)
 			{
-				s_renderVK->release(m_textureImageViews[ii]);
+				continue;
 			}
-		}
-	}
 
-	void FrameBufferVK::postReset()
-	{
-		BGFX_PROFILER_SCOPE("FrameBufferVK::postReset", kColorFrame);
+			VkImageMemoryBarrier imb;
+			imb.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			imb.pNext = NULL;
+			imb.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			imb.dstAccessMask = 0;
+			imb.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			imb.newLayout = textureVK.m_sampledLayout;
+			imb.srcQueueFamilyIndex = m_cmd.m_queueFamily;
+			imb.dstQueueFamilyIndex = _cmd.m_queueFamily;
+			imb.image = texture.m_handle;
+			imb.subresourceRange.aspectMask     = textureVK.m_aspectFlags;
+			imb.subresourceRange.baseMipLevel   = 0;
+			imb.subresourceRange.levelCount     = VK_REMAINING_MIP_LEVELS;
+			imb.subresourceRange.baseArrayLayer = 0;
+			imb.subresourceRange.layerCount     = VK_REMAINING_ARRAY_LAYERS;
+			m_releaseImages.push_back(imb);
 
-		if (m_numTh > 0)
-		{
-			const VkDevice device = s_renderVK->m_device;
-			const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
+			imb.srcAccessMask = 0;
+			imb.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+			m_acquireImages.push_back(imb);
 
-			VK_CHECK(s_renderVK->getRenderPass(m_numTh, m_attachment, &m_renderPass, 0) );
+			textureVK.m_currentImageLayout = textureVK.m_sampledLayout;
+			textureVK.m_uploadPending = false;
+		}
 
-			m_depth = BGFX_INVALID_HANDLE;
-			m_num = 0;
+		m_buffers.clear();
+		m_textures.clear();
 
-			for (uint8_t ii = 0; ii < m_numTh; ++ii)
-			{
-				const Attachment& at = m_attachment[ii];
-				const TextureVK& texture = s_renderVK->m_textures[at.handle.idx];
-				VK_CHECK(texture.createView(
-					  at.layer
-					, at.numLayers
-					, at.mip
-					, 1
-					, at.numLayers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D
-					, texture.m_aspectFlags
-					, true
-					, &m_textureImageViews[ii]
-					) );
+		if (!m_releaseBuffers.empty()
+		||  !m_releaseImages.empty() )
+		{
+			vkCmdPipelineBarrier(
+				  m_commandBuffer
+				, VK_PIPELINE_STAGE_TRANSFER_BIT
+				, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT
+				, 0
+				, 0
+				, NULL
+				, uint32_t(m_releaseBuffers.size() )
+				, m_releaseBuffers.data()
+				, uint32_t(m_releaseImages.size() )
+				, m_releaseImages.data()
+				);
 
-				if (texture.m_aspectFlags & VK_IMAGE_ASPECT_COLOR_BIT)
-				{
-					m_texture[m_num] = at.handle;
-					m_num++;
-				}
-				else if (texture.m_aspectFlags & (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT) )
-				{
-					m_depth = at.handle;
-				}
-			}
+			vkCmdPipelineBarrier(
+				  _commandBuffer
+				, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT
+				, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
+				, 0
+				, 0
+				, NULL
+				, uint32_t(m_acquireBuffers.size() )
+				, m_acquireBuffers.data()
+				, uint32_t(m_acquireImages.size() )
+				, m_acquireImages.data()
+				);
+		}
 
-			const TextureVK& firstTexture = s_renderVK->m_textures[m_attachment[0].handle.idx];
-			m_width  = bx::uint32_max(firstTexture.m_width  >> m_attachment[0].mip, 1);
-			m_height = bx::uint32_max(firstTexture.m_height >> m_attachment[0].mip, 1);
-			m_sampler = firstTexture.m_sampler;
+		// Graphics queue waits on upload before executing any of its
+		// commands, staging memory and deferred releases stay owned by
+		// graphics queue frame.
+		const VkSemaphore semaphore = m_semaphore[m_cmd.m_currentFrameInFlight];
 
-			VkFramebufferCreateInfo fci;
-			fci.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-			fci.pNext = NULL;
-			fci.flags = 0;
-			fci.renderPass      = m_renderPass;
-			fci.attachmentCount = m_numTh;
-			fci.pAttachments    = &m_textureImageViews[0];
-			fci.width  = m_width;
-			fci.height = m_height;
-			fci.layers = m_attachment[0].numLayers;
+		m_cmd.addSignalSemaphore(semaphore);
+		m_cmd.kick();
+		m_cmd.finish();
 
-			VK_CHECK(vkCreateFramebuffer(device, &fci, allocatorCb, &m_framebuffer) );
+		m_commandBuffer = VK_NULL_HANDLE;
 
-			m_currentFramebuffer = m_framebuffer;
-		}
+		_cmd.addWaitSemaphore(semaphore, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
 	}
 
-	void FrameBufferVK::update(VkCommandBuffer _commandBuffer, const Resolution& _resolution)
+	void RendererContextVK::submitBlit(BlitState& _bs, uint16_t _view)
 	{
-		BGFX_PROFILER_SCOPE("FrameBufferVK::update", kColorResource);
+		BGFX_PROFILER_SCOPE("RendererContextVK::submitBlit", kColorFrame);
 
-		m_swapChain.update(_commandBuffer, m_nwh, _resolution);
-		VK_CHECK(s_renderVK->getRenderPass(m_swapChain, &m_renderPass, 0) );
-		// Don't believe the passed Resolution, as the Vulkan driver might have
-		// specified another resolution, which we had to obey.
-		m_width   = m_swapChain.m_sci.imageExtent.width;
-		m_height  = m_swapChain.m_sci.imageExtent.height;
-		m_sampler = m_swapChain.m_sampler;
-	}
+		const uint16_t firstItem = _bs.m_item;
+		const uint32_t maxItems  = _bs.m_frame->m_numBlitItems - firstItem;
 
-	void FrameBufferVK::resolve()
-	{
-		if (!m_needResolve)
+		if (m_maxBlitLayouts < maxItems*2)
 		{
-			return;
+			m_maxBlitLayouts = maxItems*2;
+			m_blitLayouts    = (VkImageLayout*)bx::realloc(g_allocator, m_blitLayouts, m_maxBlitLayouts*sizeof(VkImageLayout) );
 		}
 
-		BGFX_PROFILER_SCOPE("FrameBufferVK::resolve", kColorFrame);
+		VkImageLayout* srcLayouts = m_blitLayouts;
+		VkImageLayout* dstLayouts = &m_blitLayouts[maxItems];
 
-		if (NULL == m_nwh)
-		{
-			for (uint32_t ii = 0; ii < m_numTh; ++ii)
-			{
-				const Attachment& at = m_attachment[ii];
+		BlitState bs0 = _bs;
 
-				if (isValid(at.handle) )
-				{
-					TextureVK& texture = s_renderVK->m_textures[at.handle.idx];
-					texture.resolve(s_renderVK->m_commandBuffer, at.resolve, at.layer, at.numLayers, at.mip);
-				}
-			}
-		}
-		else if (isRenderable()
-		&&       m_sampler.Count > 1
-		&&       m_swapChain.m_supportsManualResolve)
+		while (bs0.hasItem(_view) )
 		{
-			m_swapChain.m_backBufferColorMsaa.m_singleMsaaImage = m_swapChain.m_backBufferColorImage[m_swapChain.m_backBufferColorIdx];
-			m_swapChain.m_backBufferColorMsaa.m_currentSingleMsaaImageLayout = m_swapChain.m_backBufferColorImageLayout[m_swapChain.m_backBufferColorIdx];
+			const uint16_t item = bs0.m_item - firstItem;
 
-			m_swapChain.m_backBufferColorMsaa.resolve(s_renderVK->m_commandBuffer, 0, 0, 1, 0);
+			const BlitItem& blit = bs0.advance();
 
-			m_swapChain.m_backBufferColorMsaa.m_singleMsaaImage = VK_NULL_HANDLE;
-			m_swapChain.m_backBufferColorMsaa.m_currentSingleMsaaImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			TextureVK& src = m_textures[blit.m_src.idx];
+			TextureVK& dst = m_textures[blit.m_dst.idx];
+
+			srcLayouts[item] = VK_NULL_HANDLE != src.m_singleMsaaImage ? src.m_currentSingleMsaaImageLayout : src.m_currentImageLayout;
+			dstLayouts[item] = dst.m_currentImageLayout;
 		}
 
-		m_needResolve = false;
-	}
+		bs0 = _bs;
 
-	uint16_t FrameBufferVK::destroy()
-	{
-		BGFX_PROFILER_SCOPE("FrameBufferVK::destroy", kColorFrame);
+		while (bs0.hasItem(_view) )
+		{
+			const BlitItem& blit = bs0.advance();
 
-		preReset();
+			TextureVK& src = m_textures[blit.m_src.idx];
+			TextureVK& dst = m_textures[blit.m_dst.idx];
 
-		if (NULL != m_nwh)
-		{
-			m_swapChain.destroy();
-			m_nwh = NULL;
-			m_needPresent = false;
-		}
+			src.setImageMemoryBarrier(
+				  m_commandBuffer
+				, blit.m_src.idx == blit.m_dst.idx ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
+				, VK_NULL_HANDLE != src.m_singleMsaaImage
+				);
 
-		m_numTh = 0;
-		m_num = 0;
-		m_depth = BGFX_INVALID_HANDLE;
+			if (blit.m_src.idx != blit.m_dst.idx)
+			{
+				dst.setImageMemoryBarrier(m_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+			}
 
-		m_needResolve = false;
+			const uint16_t srcSamples = VK_NULL_HANDLE != src.m_singleMsaaImage ? 1 : src.m_sampler.Count;
+			const uint16_t dstSamples = dst.m_sampler.Count;
+			BX_UNUSED(srcSamples, dstSamples);
 
-		uint16_t denseIdx = m_denseIdx;
-		m_denseIdx = UINT16_MAX;
-		return denseIdx;
-	}
+			BX_ASSERT(
+				  srcSamples == dstSamples
+				, "Mismatching texture sample count (%d != %d)."
+				, srcSamples
+				, dstSamples
+				);
 
-	bool FrameBufferVK::acquire(VkCommandBuffer _commandBuffer)
-	{
-		BGFX_PROFILER_SCOPE("FrameBufferVK::acquire", kColorFrame);
+			VkImageCopy copyInfo;
+			copyInfo.srcSubresource.aspectMask     = src.m_aspectFlags;
+			copyInfo.srcSubresource.mipLevel       = blit.m_srcMip;
+			copyInfo.srcSubresource.baseArrayLayer = 0;
+			copyInfo.srcSubresource.layerCount     = 1;
+			copyInfo.srcOffset.x = blit.m_srcX;
+			copyInfo.srcOffset.y = blit.m_srcY;
+			copyInfo.srcOffset.z = 0;
+			copyInfo.dstSubresource.aspectMask     = dst.m_aspectFlags;
+			copyInfo.dstSubresource.mipLevel       = blit.m_dstMip;
+			copyInfo.dstSubresource.baseArrayLayer = 0;
+			copyInfo.dstSubresource.layerCount     = 1;
+			copyInfo.dstOffset.x = blit.m_dstX;
+			copyInfo.dstOffset.y = blit.m_dstY;
+			copyInfo.dstOffset.z = 0;
+			copyInfo.extent.width  = blit.m_width;
+			copyInfo.extent.height = blit.m_height;
+			copyInfo.extent.depth  = 1;
 
-		bool acquired = true;
+			const uint32_t depth = bx::max<uint32_t>(1, blit.m_depth);
 
-		if (NULL != m_nwh)
-		{
-			acquired = m_swapChain.acquire(_commandBuffer);
-			m_needPresent = m_swapChain.m_needPresent;
-			m_currentFramebuffer = m_swapChain.m_backBufferFrameBuffer[m_swapChain.m_backBufferColorIdx];
-		}
+			if (VK_IMAGE_VIEW_TYPE_3D == src.m_type)
+			{
+				BX_ASSERT(VK_IMAGE_VIEW_TYPE_3D == dst.m_type, "Can't blit between 2D and 3D image.");
+
+				copyInfo.srcOffset.z  = blit.m_srcZ;
+				copyInfo.dstOffset.z  = blit.m_dstZ;
+				copyInfo.extent.depth = depth;
+			}
+			else
+			{
+				copyInfo.srcSubresource.baseArrayLayer = blit.m_srcZ;
+				copyInfo.dstSubresource.baseArrayLayer = blit.m_dstZ;
+				copyInfo.srcSubresource.layerCount = depth;
+				copyInfo.dstSubresource.layerCount = depth;
+			}
+
+			vkCmdCopyImage(
+				  m_commandBuffer
+				, VK_NULL_HANDLE != src.m_singleMsaaImage ? src.m_singleMsaaImage : src.m_textureImage
+				, VK_NULL_HANDLE != src.m_singleMsaaImage ? src.m_currentSingleMsaaImageLayout : src.m_currentImageLayout
+				, dst.m_textureImage
+				, dst.m_currentImageLayout
+				, 1
+				, &copyInfo
+				);
 
-		m_needResolve = true;
+			setMemoryBarrier(
+				  m_commandBuffer
+				, VK_PIPELINE_STAGE_TRANSFER_BIT
+				, VK_PIPELINE_STAGE_TRANSFER_BIT
+				);
+		}
 
-		return acquired;
-	}
+		while (_bs.hasItem(_view) )
+		{
+			const uint16_t item = _bs.m_item - firstItem;
 
-	void FrameBufferVK::present()
-	{
-		BGFX_PROFILER_SCOPE("FrameBufferVK::present", kColorFrame);
+			const BlitItem& blit = _bs.advance();
 
-		m_swapChain.present();
-		m_needPresent = false;
-	}
+			TextureVK& src = m_textures[blit.m_src.idx];
+			TextureVK& dst = m_textures[blit.m_dst.idx];
 
-	bool FrameBufferVK::isRenderable() const
-	{
-		return false
-			|| (NULL == m_nwh)
-			|| m_swapChain.m_needPresent
-			;
+			src.setImageMemoryBarrier(m_commandBuffer, srcLayouts[item], VK_NULL_HANDLE != src.m_singleMsaaImage);
+			dst.setImageMemoryBarrier(m_commandBuffer, dstLayouts[item]);
+		}
 	}
 
-	VkResult CommandQueueVK::init(uint32_t _queueFamily, VkQueue _queue)
+	void RendererContextVK::submitUniformCache(UniformCacheState& _ucs, uint16_t _view)
 	{
-		m_queueFamily         = _queueFamily;
-		m_queue               = _queue;
-		m_activeCommandBuffer = VK_NULL_HANDLE;
-		m_consumeIndex        = 0;
+		while (_ucs.hasItem(_view) )
+		{
+			const UniformCacheItem& uci = _ucs.advance();
 
-		return reset();
+			bx::memCopy(m_uniforms[uci.m_handle], &_ucs.m_frame->m_uniformCacheFrame.m_data[uci.m_offset], uci.m_size);
+		}
 	}
 
-	VkResult CommandQueueVK::reset()
+	void RendererContextVK::writeUniformScratch(RecordStateVK& _state, ChunkedScratchBufferOffset& _outSbo, uint32_t _vsSize, uint32_t _fsSize)
 	{
-		shutdown();
-
-		m_currentFrameInFlight = 0;
-		m_consumeIndex         = 0;
-
-		m_numSignalSemaphores = 0;
-		m_numWaitSemaphores   = 0;
+		ChunkedScratchBufferVK& uniformScratchBuffer = m_uniformScratchBuffer;
 
-		m_activeCommandBuffer = VK_NULL_HANDLE;
-		m_currentFence        = VK_NULL_HANDLE;
-		m_completedFence      = VK_NULL_HANDLE;
+		if (NULL == _state.m_slab)
+		{
+			CommandRecorderScopeVK scope(m_recorder);
+			uniformScratchBuffer.write(_outSbo, _state.m_vsScratch, _vsSize, _state.m_fsScratch, _fsSize);
+			return;
+		}
 
-		m_submitted = 0;
+		while (!uniformScratchBuffer.write(*_state.m_slab, _outSbo, _state.m_vsScratch, _vsSize, _state.m_fsScratch, _fsSize) )
+		{
+			const uint32_t size = 0
+				+ bx::strideAlign(_vsSize, uniformScratchBuffer.m_align)
+				+ bx::strideAlign(_fsSize, uniformScratchBuffer.m_align)
+				;
 
-		VkCommandPoolCreateInfo cpci;
-		cpci.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-		cpci.pNext = NULL;
-		cpci.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-		cpci.queueFamilyIndex = m_queueFamily;
+			CommandRecorderScopeVK scope(m_recorder);
+			uniformScratchBuffer.allocSlab(*_state.m_slab, size);
+		}
+	}
 
-		VkCommandBufferAllocateInfo cbai;
-		cbai.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		cbai.pNext = NULL;
-		cbai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		cbai.commandBufferCount = 1;
+	void RendererContextVK::recordDraw(RecordStateVK& _state, ViewState& _viewState, Frame* _render, uint16_t _view, ProgramHandle _program, const RenderItem& _renderItem, const RenderBind& _renderBind)
+	{
+		const uint64_t f0 = BGFX_STATE_BLEND_FACTOR;
+		const uint64_t f1 = BGFX_STATE_BLEND_INV_FACTOR;
+		const uint64_t f2 = BGFX_STATE_BLEND_FACTOR<<4;
+		const uint64_t f3 = BGFX_STATE_BLEND_INV_FACTOR<<4;
 
-		VkFenceCreateInfo fci;
-		fci.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fci.pNext = NULL;
-		fci.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+		const VkCommandBuffer commandBuffer = _state.m_commandBuffer;
 
-		VkResult result = VK_SUCCESS;
+		const RenderDraw& draw = _renderItem.draw;
+		RenderDraw& currentState = _state.m_currentState;
 
-		const VkAllocationCallbacks* allocatorCb = s_renderVK->m_allocatorCb;
-		const VkDevice device = s_renderVK->m_device;
+		_state.update(*_render->m_uniformBuffer[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
 
-		for (uint32_t ii = 0, maxFrameLatency = s_renderVK->m_maxFrameLatency; ii < maxFrameLatency; ++ii)
+		const bool hasOcclusionQuery = 0 != (draw.m_stateFlags & BGFX_STATE_INTERNAL_OCCLUSION_QUERY);
 		{
-			result = vkCreateCommandPool(
-				  device
-				, &cpci
-				, allocatorCb
-				, &m_commandList[ii].m_commandPool
-				);
+			const bool occluded = true
+				&& isValid(draw.m_occlusionQuery)
+				&& !hasOcclusionQuery
+				&& !isVisible(_render, draw.m_occlusionQuery, 0 != (draw.m_submitFlags & BGFX_SUBMIT_INTERNAL_OCCLUSION_VISIBLE) )
+				;
 
-			if (VK_SUCCESS != result)
+			if (occluded
+			||  !_state.m_isFrameBufferValid
+			||  0 == draw.m_streamMask
+			||  _render->m_frameCache.isZeroArea(_state.m_viewScissorRect, draw.m_scissor) )
 			{
-				BX_TRACE("Create command queue error: vkCreateCommandPool failed %d: %s.", result, getName(result) );
-				return result;
+				return;
 			}
+		}
 
-			cbai.commandPool = m_commandList[ii].m_commandPool;
-
-			result = vkAllocateCommandBuffers(
-				  device
-				, &cbai
-				, &m_commandList[ii].m_commandBuffer
-				);
+		const uint64_t changedFlags = currentState.m_stateFlags ^ draw.m_stateFlags;
+		currentState.m_stateFlags = draw.m_stateFlags;
 
-			if (VK_SUCCESS != result)
-			{
-				BX_TRACE("Create command queue error: vkAllocateCommandBuffers failed %d: %s.", result, getName(result) );
-				return result;
-			}
+		if (0 != draw.m_streamMask)
+		{
+			const bool bindAttribs = hasVertexStreamChanged(currentState, draw);
 
-			result = vkCreateFence(
-				  device
-				, &fci
-				, allocatorCb
-				, &m_commandList[ii].m_fence
-				);
+			currentState.m_streamMask         = draw.m_streamMask;
+			currentState.m_instanceDataBuffer = draw.m_instanceDataBuffer;
+			currentState.m_instanceDataOffset = draw.m_instanceDataOffset;
+			currentState.m_instanceDataStride = draw.m_instanceDataStride;
 
-			if (VK_SUCCESS != result)
+			const VertexLayout* layouts[BGFX_CONFIG_MAX_VERTEX_STREAMS];
+			VkBuffer streamBuffers[BGFX_CONFIG_MAX_VERTEX_STREAMS + 1];
+			VkDeviceSize streamOffsets[BGFX_CONFIG_MAX_VERTEX_STREAMS + 1];
+			uint8_t numStreams = 0;
+			uint32_t numVertices = draw.m_numVertices;
+			if (UINT8_MAX != draw.m_streamMask)
 			{
-				BX_TRACE("Create command queue error: vkCreateFence failed %d: %s.", result, getName(result) );
-				return result;
-			}
-		}
-
-		return result;
-	}
-
-	void CommandQueueVK::shutdown()
-	{
-		kick(true);
-		finish(true);
+				for (BitMaskToIndexIteratorT it(draw.m_streamMask)
+					; !it.isDone()
+					; it.next(), numStreams++
+					)
+				{
+					const uint8_t idx = it.idx;
 
-		for (uint32_t ii = 0, maxFrameLatency = s_renderVK->m_maxFrameLatency; ii < maxFrameLatency; ++ii)
-		{
-			vkDestroy(m_commandList[ii].m_fence);
-			m_commandList[ii].m_commandBuffer = VK_NULL_HANDLE;
-			vkDestroy(m_commandList[ii].m_commandPool);
-		}
-	}
+					currentState.m_stream[idx] = draw.m_stream[idx];
 
-	VkResult CommandQueueVK::alloc(VkCommandBuffer* _outCommandBuffer)
-	{
-		BGFX_PROFILER_SCOPE("CommandQueueVK::alloc", kColorResource);
+					const VertexBufferHandle handle = draw.m_stream[idx].m_handle;
+					const VertexBufferVK& vb = m_vertexBuffers[handle.idx];
+					const uint16_t decl = isValid(draw.m_stream[idx].m_layoutHandle)
+						? draw.m_stream[idx].m_layoutHandle.idx
+						: vb.m_layoutHandle.idx
+						;
+					const VertexLayout& layout = m_vertexLayouts[decl];
+					const uint32_t stride = layout.m_stride;
 
-		VkResult result = VK_SUCCESS;
+					streamBuffers[numStreams] = m_vertexBuffers[handle.idx].m_buffer;
+					streamOffsets[numStreams] = draw.m_stream[idx].m_startVertex * stride;
+					layouts[numStreams]       = &layout;
 
-		if (m_activeCommandBuffer == VK_NULL_HANDLE)
-		{
-			const VkDevice device = s_renderVK->m_device;
-			CommandList& commandList = m_commandList[m_currentFrameInFlight];
+					numVertices = bx::uint32_min(UINT32_MAX == draw.m_numVertices
+						? vb.m_size/stride
+						: draw.m_numVertices
+						, numVertices
+						);
+				}
+			}
 
+			if (bindAttribs)
 			{
-				BGFX_PROFILER_SCOPE("vkWaitForFences", kColorWait);
+				uint32_t numVertexBuffers = numStreams;
 
-				result = vkWaitForFences(device, 1, &commandList.m_fence, VK_TRUE, UINT64_MAX);
+				if (isValid(draw.m_instanceDataBuffer) )
+				{
+					streamOffsets[numVertexBuffers] = draw.m_instanceDataOffset;
+					streamBuffers[numVertexBuffers] = m_vertexBuffers[draw.m_instanceDataBuffer.idx].m_buffer;
+					numVertexBuffers++;
+				}
+
+				if (0 < numVertexBuffers)
+				{
+					vkCmdBindVertexBuffers(
+						  commandBuffer
+						, 0
+						, numVertexBuffers
+						, &streamBuffers[0]
+						, streamOffsets
+						);
+				}
 			}
 
-			if (VK_SUCCESS != result)
+			const VkPipeline pipeline =
+				getPipeline(draw.m_stateFlags
+					, draw.m_stencil
+					, numStreams
+					, layouts
+					, _program
+					, uint8_t(draw.m_instanceDataStride/16)
+					, _state.m_fbh
+					, !m_asyncPipelineCompile
+					);
+
+			if (VK_NULL_HANDLE == pipeline)
 			{
-				BX_TRACE("Allocate command buffer error: vkWaitForFences failed %d: %s.", result, getName(result) );
-				return result;
+				// Pipeline is still being compiled in background. Force
+				// constants to be committed by next draw call, since
+				// uniforms of this draw call were already updated.
+				_state.m_currentProgram = BGFX_INVALID_HANDLE;
+				++_state.m_numDrawSkipped;
+				return;
 			}
 
-			result = vkResetCommandPool(device, commandList.m_commandPool, 0);
-
-			if (VK_SUCCESS != result)
+			if (_state.m_currentPipeline != pipeline)
 			{
-				BX_TRACE("Allocate command buffer error: vkResetCommandPool failed %d: %s.", result, getName(result) );
-				return result;
+				_state.m_currentPipeline = pipeline;
+				vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 			}
 
-			VkCommandBufferBeginInfo cbi;
-			cbi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-			cbi.pNext = NULL;
-			cbi.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-			cbi.pInheritanceInfo = NULL;
+			setDynamicState(
+				  commandBuffer
+				, _state.m_dynamicState
+				, _state.m_dynamicStencil
+				, draw.m_stateFlags
+				, draw.m_stencil
+				);
 
-			result = vkBeginCommandBuffer(commandList.m_commandBuffer, &cbi);
+			const bool hasStencil = 0 != draw.m_stencil;
 
-			if (VK_SUCCESS != result)
+			if (hasStencil
+			&&  currentState.m_stencil != draw.m_stencil)
 			{
-				BX_TRACE("Allocate command buffer error: vkBeginCommandBuffer failed %d: %s.", result, getName(result) );
-				return result;
-			}
-
-			m_activeCommandBuffer = commandList.m_commandBuffer;
-			m_currentFence = commandList.m_fence;
-		}
+				currentState.m_stencil = draw.m_stencil;
 
-		if (NULL != _outCommandBuffer)
-		{
-			*_outCommandBuffer = m_activeCommandBuffer;
-		}
+				const uint32_t fstencil = unpackStencil(0, draw.m_stencil);
+				const uint32_t ref = (fstencil&BGFX_STENCIL_FUNC_REF_MASK)>>BGFX_STENCIL_FUNC_REF_SHIFT;
+				vkCmdSetStencilReference(commandBuffer, VK_STENCIL_FRONT_AND_BACK, ref);
+			}
 
-		return result;
-	}
+			const bool hasFactor = 0
+				|| f0 == (draw.m_stateFlags & f0)
+				|| f1 == (draw.m_stateFlags & f1)
+				|| f2 == (draw.m_stateFlags & f2)
+				|| f3 == (draw.m_stateFlags & f3)
+				;
 
-	void CommandQueueVK::addWaitSemaphore(VkSemaphore _semaphore, VkPipelineStageFlags _waitFlags)
-	{
-		BX_ASSERT(m_numWaitSemaphores < BX_COUNTOF(m_waitSemaphores), "Too many wait semaphores.");
+			if (hasFactor
+			&&  _state.m_blendFactor != draw.m_rgba)
+			{
+				_state.m_blendFactor = draw.m_rgba;
 
-		m_waitSemaphores[m_numWaitSemaphores]      = _semaphore;
-		m_waitSemaphoreStages[m_numWaitSemaphores] = _waitFlags;
-		m_numWaitSemaphores++;
-	}
+				float bf[4];
+				bf[0] = ( (draw.m_rgba>>24)     )/255.0f;
+				bf[1] = ( (draw.m_rgba>>16)&0xff)/255.0f;
+				bf[2] = ( (draw.m_rgba>> 8)&0xff)/255.0f;
+				bf[3] = ( (draw.m_rgba    )&0xff)/255.0f;
+				vkCmdSetBlendConstants(commandBuffer, bf);
+			}
 
-	void CommandQueueVK::addSignalSemaphore(VkSemaphore _semaphore)
-	{
-		BX_ASSERT(m_numSignalSemaphores < BX_COUNTOF(m_signalSemaphores), "Too many signal semaphores.");
+			const uint16_t scissor = draw.m_scissor;
 
-		m_signalSemaphores[m_numSignalSemaphores] = _semaphore;
-		m_numSignalSemaphores++;
-	}
+			if (currentState.m_scissor != scissor)
+			{
+				currentState.m_scissor = scissor;
 
-	void CommandQueueVK::kick(bool _wait)
-	{
-		BGFX_PROFILER_SCOPE("CommandQueueVK::kick", kColorDraw);
+				if (UINT16_MAX == scissor)
+				{
+					if (_state.m_restoreScissor
+					||  _state.m_viewHasScissor)
+					{
+						_state.m_restoreScissor = false;
+						VkRect2D rc;
+						rc.offset.x      = _state.m_viewScissorRect.m_x;
+						rc.offset.y      = _state.m_viewScissorRect.m_y;
+						rc.extent.width  = _state.m_viewScissorRect.m_width;
+						rc.extent.height = _state.m_viewScissorRect.m_height;
+						vkCmdSetScissor(commandBuffer, 0, 1, &rc);
+					}
+				}
+				else
+				{
+					_state.m_restoreScissor = true;
+					Rect scissorRect;
+					scissorRect.setIntersect(_state.m_viewScissorRect, _render->m_frameCache.m_rectCache.m_cache[scissor]);
+
+					VkRect2D rc;
+					rc.offset.x      = scissorRect.m_x;
+					rc.offset.y      = scissorRect.m_y;
+					rc.extent.width  = scissorRect.m_width;
+					rc.extent.height = scissorRect.m_height;
+					vkCmdSetScissor(commandBuffer, 0, 1, &rc);
+				}
+			}
 
-		if (VK_NULL_HANDLE != m_activeCommandBuffer)
-		{
-			const VkDevice device = s_renderVK->m_device;
+			bool constantsChanged = false;
+			if (draw.m_uniformBegin < draw.m_uniformEnd
+			||  _state.m_currentProgram.idx != _program.idx
+			||  BGFX_STATE_ALPHA_REF_MASK & changedFlags)
+			{
+				_state.m_currentProgram = _program;
+				ProgramVK& program = m_program[_state.m_currentProgram.idx];
 
-			setMemoryBarrier(
-				  m_activeCommandBuffer
-				, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
-				, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
-				);
+				UniformBuffer* vcb = program.m_vsh->m_constantBuffer;
+				if (NULL != vcb)
+				{
+					_state.commit(*vcb);
+				}
 
-			VK_CHECK(vkEndCommandBuffer(m_activeCommandBuffer) );
+				if (NULL != program.m_fsh)
+				{
+					UniformBuffer* fcb = program.m_fsh->m_constantBuffer;
+					if (NULL != fcb)
+					{
+						_state.commit(*fcb);
+					}
+				}
 
-			m_completedFence = m_currentFence;
-			m_currentFence = VK_NULL_HANDLE;
+				_state.m_hasPredefined = 0 < program.m_numPredefined;
+				constantsChanged = true;
+			}
 
-			VK_CHECK(vkResetFences(device, 1, &m_completedFence) );
+			const ProgramVK& program = m_program[_state.m_currentProgram.idx];
 
-			VkSubmitInfo si;
-			si.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-			si.pNext = NULL;
-			si.waitSemaphoreCount    = m_numWaitSemaphores;
-			si.pWaitSemaphores       = &m_waitSemaphores[0];
-			si.pWaitDstStageMask     = m_waitSemaphoreStages;
-			si.commandBufferCount    = 1;
-			si.pCommandBuffers       = &m_activeCommandBuffer;
-			si.signalSemaphoreCount  = m_numSignalSemaphores;
-			si.pSignalSemaphores     = &m_signalSemaphores[0];
+			if (_state.m_hasPredefined)
+			{
+				uint32_t ref = (draw.m_stateFlags & BGFX_STATE_ALPHA_REF_MASK) >> BGFX_STATE_ALPHA_REF_SHIFT;
+				_viewState.m_alphaRef = ref / 255.0f;
+				_viewState.setPredefined<4>(&_state, _view, program, _render, draw);
+			}
 
-			m_numWaitSemaphores   = 0;
-			m_numSignalSemaphores = 0;
+			if (program.m_pushConstants
+			&& (constantsChanged || _state.m_hasPredefined) )
+			{
+				program.pushConstants(commandBuffer, _state.m_vsScratch, _state.m_fsScratch);
+			}
 
+			if (VK_NULL_HANDLE != program.m_descriptorSetLayout)
 			{
-				BGFX_PROFILER_SCOPE("vkQueueSubmit", kColorDraw);
+				ChunkedScratchBufferOffset sbo;
 
-				VK_CHECK(vkQueueSubmit(m_queue, 1, &si, m_completedFence) );
+				const uint32_t vsSize = program.m_vsh->m_size;
+				const uint32_t fsSize = NULL != program.m_fsh ? program.m_fsh->m_size : 0;
+				uint32_t numOffsets = 0;
+
+				if (true
+				&& (constantsChanged || _state.m_hasPredefined)
+				&& (0 < vsSize || 0 < fsSize)
+				   )
+				{
+					writeUniformScratch(_state, sbo, vsSize, fsSize);
+					numOffsets = (0 < vsSize) + (0 < fsSize);
+				}
+
+				bx::HashMurmur2A hash;
+				hash.begin();
+				hash.add(program.m_descriptorSetLayout);
+				hash.add(_renderBind.m_bind, sizeof(_renderBind.m_bind) );
+				hash.add(sbo.buffer);
+				hash.add(vsSize);
+				hash.add(fsSize);
+				const uint32_t bindHash = hash.end();
+
+				if (_state.m_currentBindHash != bindHash)
+				{
+					_state.m_currentBindHash = bindHash;
+
+					_state.m_currentDescriptorSet = getDescriptorSet(
+						  program
+						, _renderBind
+						, sbo.buffer
+						, _render->m_colorPalette
+						);
+
+					++_state.m_numDescriptorSets;
+				}
+
+				vkCmdBindDescriptorSets(
+					  commandBuffer
+					, VK_PIPELINE_BIND_POINT_GRAPHICS
+					, program.m_pipelineLayout
+					, 0
+					, 1
+					, &_state.m_currentDescriptorSet
+					, numOffsets
+					, sbo.offsets
+					);
 			}
 
-			if (_wait)
+			VkBuffer bufferIndirect = VK_NULL_HANDLE;
+			VkBuffer bufferNumIndirect = VK_NULL_HANDLE;
+			uint32_t numDrawIndirect = 0;
+			uint32_t bufferOffsetIndirect = 0;
+			uint32_t bufferNumOffsetIndirect = 0;
+			if (isValid(draw.m_indirectBuffer) )
 			{
-				BGFX_PROFILER_SCOPE("vkWaitForFences", kColorWait);
+				const VertexBufferVK& vb = m_vertexBuffers[draw.m_indirectBuffer.idx];
+				bufferIndirect = vb.m_buffer;
+				numDrawIndirect = UINT32_MAX == draw.m_numIndirect
+					? vb.m_size / BGFX_CONFIG_DRAW_INDIRECT_STRIDE
+					: draw.m_numIndirect
+					;
+				bufferOffsetIndirect = draw.m_startIndirect * BGFX_CONFIG_DRAW_INDIRECT_STRIDE;
 
-				VK_CHECK(vkWaitForFences(device, 1, &m_completedFence, VK_TRUE, UINT64_MAX) );
+				if (isValid(draw.m_numIndirectBuffer) )
+				{
+					bufferNumIndirect = m_indexBuffers[draw.m_numIndirectBuffer.idx].m_buffer;
+					bufferNumOffsetIndirect = draw.m_numIndirectIndex * sizeof(uint32_t);
+				}
 			}
 
-			m_activeCommandBuffer = VK_NULL_HANDLE;
+			if (hasOcclusionQuery)
+			{
+				m_occlusionQuery.begin(draw.m_occlusionQuery);
+			}
 
-			m_currentFrameInFlight = (m_currentFrameInFlight + 1) % s_renderVK->m_maxFrameLatency;
-			m_submitted++;
-		}
-	}
+			const uint8_t primIndex = uint8_t( (draw.m_stateFlags & BGFX_STATE_PT_MASK) >> BGFX_STATE_PT_SHIFT);
+			const PrimInfo& prim = s_primInfo[primIndex];
 
-	void CommandQueueVK::finish(bool _finishAll)
-	{
-		BGFX_PROFILER_SCOPE("CommandQueueVK::finish", kColorDraw);
+			uint32_t numPrimsSubmitted = 0;
+			uint32_t numIndices = 0;
 
-		if (_finishAll)
-		{
-			for (uint32_t ii = 0, maxFrameLatency = s_renderVK->m_maxFrameLatency; ii < maxFrameLatency; ++ii)
+			if (!isValid(draw.m_indexBuffer) )
 			{
-				consume();
+				numPrimsSubmitted = numVertices / prim.m_div - prim.m_sub;
+
+				if (isValid(draw.m_indirectBuffer) )
+				{
+					if (isValid(draw.m_numIndirectBuffer) )
+					{
+						vkCmdDrawIndirectCountKHR(
+							  commandBuffer
+							, bufferIndirect
+							, bufferOffsetIndirect
+							, bufferNumIndirect
+							, bufferNumOffsetIndirect
+							, numDrawIndirect
+							, BGFX_CONFIG_DRAW_INDIRECT_STRIDE
+							);
+					}
+					else
+					{
+						vkCmdDrawIndirect(
+							  commandBuffer
+							, bufferIndirect
+							, bufferOffsetIndirect
+							, numDrawIndirect
+							, BGFX_CONFIG_DRAW_INDIRECT_STRIDE
+							);
+					}
+				}
+				else
+				{
+					vkCmdDraw(
+						  commandBuffer
+						, numVertices
+						, draw.m_numInstances
+						, 0
+						, 0
+						);
+				}
 			}
+			else
+			{
+				const bool isIndex16          = draw.isIndex16();
+				const uint32_t indexSize      = isIndex16 ? 2 : 4;
+				const VkIndexType indexFormat = isIndex16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+				const BufferVK& ib            = m_indexBuffers[draw.m_indexBuffer.idx];
 
-			m_consumeIndex = m_currentFrameInFlight;
-		}
-		else
-		{
-			consume();
-		}
-	}
+				numIndices = UINT32_MAX == draw.m_numIndices
+					? ib.m_size / indexSize
+					: draw.m_numIndices
+					;
 
-	void CommandQueueVK::release(uint64_t _handle, VkObjectType _type)
-	{
-		Resource resource;
-		resource.m_type = _type;
-		resource.m_handle = _handle;
-		m_release[m_currentFrameInFlight].push_back(resource);
-	}
+				numPrimsSubmitted = numIndices / prim.m_div - prim.m_sub;
 
-	void CommandQueueVK::recycleMemory(DeviceMemoryAllocationVK _mem)
-	{
-		m_recycleAllocs[m_currentFrameInFlight].push_back(_mem);
-	}
+				if (currentState.m_indexBuffer.idx != draw.m_indexBuffer.idx
+				||  _state.m_currentIndexFormat != indexFormat)
+				{
+					currentState.m_indexBuffer = draw.m_indexBuffer;
+					_state.m_currentIndexFormat = indexFormat;
 
-	void CommandQueueVK::consume()
-	{
-		BGFX_PROFILER_SCOPE("CommandQueueVK::consume", kColorResource);
+					vkCmdBindIndexBuffer(
+						  commandBuffer
+						, m_indexBuffers[draw.m_indexBuffer.idx].m_buffer
+						, 0
+						, indexFormat
+						);
+				}
 
-		m_consumeIndex = (m_consumeIndex + 1) % s_renderVK->m_maxFrameLatency;
+				if (isValid(draw.m_indirectBuffer) )
+				{
+					if (isValid(draw.m_numIndirectBuffer) )
+					{
+						vkCmdDrawIndexedIndirectCountKHR(
+							  commandBuffer
+							, bufferIndirect
+							, bufferOffsetIndirect
+							, bufferNumIndirect
+							, bufferNumOffsetIndirect
+							, numDrawIndirect
+							, BGFX_CONFIG_DRAW_INDIRECT_STRIDE
+							);
+					}
+					else
+					{
+						vkCmdDrawIndexedIndirect(
+							  commandBuffer
+							, bufferIndirect
+							, bufferOffsetIndirect
+							, numDrawIndirect
+							, BGFX_CONFIG_DRAW_INDIRECT_STRIDE
+							);
+					}
+				}
+				else
+				{
+					vkCmdDrawIndexed(
+						  commandBuffer
+						, numIndices
+						, draw.m_numInstances
+						, draw.m_startIndex
+						, 0
+						, 0
+						);
+				}
+			}
 
-		for (DeviceMemoryAllocationVK& alloc : m_recycleAllocs[m_consumeIndex])
-		{
-			s_renderVK->m_memoryLru.recycle(alloc);
-		}
+			uint32_t numPrimsRendered  = numPrimsSubmitted*draw.m_numInstances;
 
-		m_recycleAllocs[m_consumeIndex].clear();
+			_state.m_numPrimsSubmitted[primIndex] += numPrimsSubmitted;
+			_state.m_numPrimsRendered[primIndex]  += numPrimsRendered;
+			_state.m_numInstances[primIndex]      += draw.m_numInstances;
+			_state.m_numIndices                   += numIndices;
 
-		for (const Resource& resource : m_release[m_consumeIndex])
-		{
-			switch (resource.m_type)
+			if (hasOcclusionQuery)
 			{
-			case VK_OBJECT_TYPE_BUFFER:                destroy<VkBuffer             >(resource.m_handle); break;
-			case VK_OBJECT_TYPE_IMAGE_VIEW:            destroy<VkImageView          >(resource.m_handle); break;
-			case VK_OBJECT_TYPE_IMAGE:                 destroy<VkImage              >(resource.m_handle); break;
-			case VK_OBJECT_TYPE_FRAMEBUFFER:           destroy<VkFramebuffer        >(resource.m_handle); break;
-			case VK_OBJECT_TYPE_PIPELINE_LAYOUT:       destroy<VkPipelineLayout     >(resource.m_handle); break;
-			case VK_OBJECT_TYPE_PIPELINE:              destroy<VkPipeline           >(resource.m_handle); break;
-			case VK_OBJECT_TYPE_DESCRIPTOR_SET:        destroy<VkDescriptorSet      >(resource.m_handle); break;
-			case VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT: destroy<VkDescriptorSetLayout>(resource.m_handle); break;
-			case VK_OBJECT_TYPE_RENDER_PASS:           destroy<VkRenderPass         >(resource.m_handle); break;
-			case VK_OBJECT_TYPE_SAMPLER:               destroy<VkSampler            >(resource.m_handle); break;
-			case VK_OBJECT_TYPE_SEMAPHORE:             destroy<VkSemaphore          >(resource.m_handle); break;
-			case VK_OBJECT_TYPE_SURFACE_KHR:           destroy<VkSurfaceKHR         >(resource.m_handle); break;
-			case VK_OBJECT_TYPE_SWAPCHAIN_KHR:         destroy<VkSwapchainKHR       >(resource.m_handle); break;
-			case VK_OBJECT_TYPE_DEVICE_MEMORY:         destroy<VkDeviceMemory       >(resource.m_handle); break;
-			default:
-				BX_ASSERT(false, "Invalid resource type: %d", resource.m_type);
-				break;
+				m_occlusionQuery.end();
 			}
 		}
-
-		m_release[m_consumeIndex].clear();
 	}
 
-	void RendererContextVK::submitBlit(BlitState& _bs, uint16_t _view)
+	uint32_t RendererContextVK::prepareRecordJobs(Frame* _render)
 	{
-		BGFX_PROFILER_SCOPE("RendererContextVK::submitBlit", kColorFrame);
+		if (0 == m_recorder.getNumThreads() )
+		{
+			return 0;
+		}
 
-		VkImageLayout srcLayouts[BGFX_CONFIG_MAX_BLIT_ITEMS];
-		VkImageLayout dstLayouts[BGFX_CONFIG_MAX_BLIT_ITEMS];
+		BGFX_PROFILER_SCOPE("RendererContextVK::prepareRecordJobs", kColorFrame);
 
-		BlitState bs0 = _bs;
+		uint32_t numJobs = 0;
+		SortKey key;
 
-		while (bs0.hasItem(_view) )
+		for (uint32_t item = 0, numItems = _render->m_numRenderItems; item < numItems;)
 		{
-			uint16_t item = bs0.m_item;
+			key.decode(_render->m_sortKeys[item], _render->m_viewRemap);
 
-			const BlitItem& blit = bs0.advance();
+			const uint32_t itemBegin = item;
+			const uint16_t view      = key.m_view;
+			bool canRecord = true;
 
-			TextureVK& src = m_textures[blit.m_src.idx];
-			TextureVK& dst = m_textures[blit.m_dst.idx];
+			for (; item < numItems; ++item)
+			{
+				const bool isCompute = key.decode(_render->m_sortKeys[item], _render->m_viewRemap);
 
-			srcLayouts[item] = VK_NULL_HANDLE != src.m_singleMsaaImage ? src.m_currentSingleMsaaImageLayout : src.m_currentImageLayout;
-			dstLayouts[item] = dst.m_currentImageLayout;
-		}
+				if (key.m_view != view)
+				{
+					break;
+				}
 
-		bs0 = _bs;
+				// Compute dispatches need barriers outside of render pass, and
+				// occlusion queries can be issued only by render thread.
+				canRecord = canRecord
+					&& !isCompute
+					&& !isValid(_render->m_renderItem[_render->m_sortValues[item] ].draw.m_occlusionQuery)
+					;
+			}
 
-		while (bs0.hasItem(_view) )
-		{
-			const BlitItem& blit = bs0.advance();
+			if (!canRecord
+			||  item - itemBegin < BGFX_CONFIG_RENDERER_VULKAN_MIN_RECORD_DRAWS)
+			{
+				continue;
+			}
 
-			TextureVK& src = m_textures[blit.m_src.idx];
-			TextureVK& dst = m_textures[blit.m_dst.idx];
+			const View& rv = _render->m_view[view];
 
-			src.setImageMemoryBarrier(
-				  m_commandBuffer
-				, blit.m_src.idx == blit.m_dst.idx ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL
-				, VK_NULL_HANDLE != src.m_singleMsaaImage
-				);
+			const FrameBufferVK& fb = isValid(rv.m_fbh)
+				? m_frameBuffers[rv.m_fbh.idx]
+				: m_backBuffer
+				;
 
-			if (blit.m_src.idx != blit.m_dst.idx)
+			if (BX_ENABLED(BGFX_CONFIG_DEBUG)
+			&&  NULL == fb.m_nwh)
 			{
-				dst.setImageMemoryBarrier(m_commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+				// Record threads can't check image layouts. While view is
+				// recorded only attachments of its frame buffer are not in
+				// sampled layout, so check that none of them is sampled.
+				for (uint32_t ii = itemBegin; ii < item; ++ii)
+				{
+					key.decode(_render->m_sortKeys[ii], _render->m_viewRemap);
+
+					const ProgramVK& program = m_program[key.m_program.idx];
+					const RenderBind& renderBind = _render->m_renderItemBind[_render->m_sortValues[ii] ];
+
+					for (uint32_t stage = 0; stage < BGFX_CONFIG_MAX_TEXTURE_SAMPLERS; ++stage)
+					{
+						const Binding& bind = renderBind.m_bind[stage];
+
+						if (kInvalidHandle == bind.m_idx
+						|| !isValid(program.m_bindInfo[stage].uniformHandle)
+						|| (Binding::Texture != bind.m_type && Binding::Image != bind.m_type) )
+						{
+							continue;
+						}
+
+						bool isAttachment = fb.m_depth.idx == bind.m_idx;
+						for (uint8_t jj = 0; jj < fb.m_num && !isAttachment; ++jj)
+						{
+							isAttachment = fb.m_texture[jj].idx == bind.m_idx;
+						}
+
+						BX_ASSERT(!isAttachment, "Mismatching image layout. Texture currently used as a framebuffer attachment?");
+					}
+				}
 			}
 
-			const uint16_t srcSamples = VK_NULL_HANDLE != src.m_singleMsaaImage ? 1 : src.m_sampler.Count;
-			const uint16_t dstSamples = dst.m_sampler.Count;
-			BX_UNUSED(srcSamples, dstSamples);
+			Rect rect = rv.m_rect;
+			rect.m_width  = bx::min(rect.m_width,  bx::narrowCast<uint16_t>(fb.m_width)  - rect.m_x);
+			rect.m_height = bx::min(rect.m_height, bx::narrowCast<uint16_t>(fb.m_height) - rect.m_y);
 
-			BX_ASSERT(
-				  srcSamples == dstSamples
-				, "Mismatching texture sample count (%d != %d)."
-				, srcSamples
-				, dstSamples
-				);
+			RecordJobVK& job = m_recordJob[numJobs++];
+			job.m_itemBegin     = itemBegin;
+			job.m_itemEnd       = item;
+			job.m_renderPass    = fb.getRenderPass(rv.m_clear.m_flags);
+			job.m_fbh           = rv.m_fbh;
+			job.m_rect          = rect;
+			job.m_view          = view;
+			job.m_commandBuffer = VK_NULL_HANDLE;
+			job.m_done          = false;
+		}
 
-			VkImageCopy copyInfo;
-			copyInfo.srcSubresource.aspectMask     = src.m_aspectFlags;
-			copyInfo.srcSubresource.mipLevel       = blit.m_srcMip;
-			copyInfo.srcSubresource.baseArrayLayer = 0;
-			copyInfo.srcSubresource.layerCount     = 1;
-			copyInfo.srcOffset.x = blit.m_srcX;
-			copyInfo.srcOffset.y = blit.m_srcY;
-			copyInfo.srcOffset.z = 0;
-			copyInfo.dstSubresource.aspectMask     = dst.m_aspectFlags;
-			copyInfo.dstSubresource.mipLevel       = blit.m_dstMip;
-			copyInfo.dstSubresource.baseArrayLayer = 0;
-			copyInfo.dstSubresource.layerCount     = 1;
-			copyInfo.dstOffset.x = blit.m_dstX;
-			copyInfo.dstOffset.y = blit.m_dstY;
-			copyInfo.dstOffset.z = 0;
-			copyInfo.extent.width  = blit.m_width;
-			copyInfo.extent.height = blit.m_height;
-			copyInfo.extent.depth  = 1;
+		return numJobs;
+	}
 
-			const uint32_t depth = bx::max<uint32_t>(1, blit.m_depth);
+	void RendererContextVK::recordJob(RecordThreadVK& _thread, Frame* _render, RecordJobVK& _job)
+	{
+		BGFX_PROFILER_SCOPE("RendererContextVK::recordJob", kColorView);
 
-			if (VK_IMAGE_VIEW_TYPE_3D == src.m_type)
-			{
-				BX_ASSERT(VK_IMAGE_VIEW_TYPE_3D == dst.m_type, "Can't blit between 2D and 3D image.");
+		if (_thread.m_resetViewState)
+		{
+			_thread.m_resetViewState = false;
+			_thread.m_viewState.reset(_render);
+		}
 
-				copyInfo.srcOffset.z  = blit.m_srcZ;
-				copyInfo.dstOffset.z  = blit.m_dstZ;
-				copyInfo.extent.depth = depth;
-			}
-			else
+		// Record thread uniforms start from values at the beginning of frame,
+		// only view uniforms up to this view are applied.
+		const UniformCacheFrame& ucf = _render->m_uniformCacheFrame;
+
+		for (UniformCacheKey ucKey; _thread.m_uniformCacheItem < ucf.m_numItems; ++_thread.m_uniformCacheItem)
+		{
+			ucKey.decode(ucf.m_keys[_thread.m_uniformCacheItem]);
+
+			if (ucKey.m_view > _job.m_view)
 			{
-				copyInfo.srcSubresource.baseArrayLayer = blit.m_srcZ;
-				copyInfo.dstSubresource.baseArrayLayer = blit.m_dstZ;
-				copyInfo.srcSubresource.layerCount = depth;
-				copyInfo.dstSubresource.layerCount = depth;
+				break;
 			}
 
-			vkCmdCopyImage(
-				  m_commandBuffer
-				, VK_NULL_HANDLE != src.m_singleMsaaImage ? src.m_singleMsaaImage : src.m_textureImage
-				, VK_NULL_HANDLE != src.m_singleMsaaImage ? src.m_currentSingleMsaaImageLayout : src.m_currentImageLayout
-				, dst.m_textureImage
-				, dst.m_currentImageLayout
-				, 1
-				, &copyInfo
-				);
-
-			setMemoryBarrier(
-				  m_commandBuffer
-				, VK_PIPELINE_STAGE_TRANSFER_BIT
-				, VK_PIPELINE_STAGE_TRANSFER_BIT
-				);
+			bx::memCopy(_thread.m_uniforms[ucKey.m_handle], &ucf.m_data[ucKey.m_offset], ucKey.m_size);
 		}
 
-		while (_bs.hasItem(_view) )
-		{
-			uint16_t item = _bs.m_item;
+		const VkCommandBuffer commandBuffer = _thread.alloc();
 
-			const BlitItem& blit = _bs.advance();
+		VkCommandBufferInheritanceInfo cbii;
+		cbii.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		cbii.pNext = NULL;
+		cbii.renderPass  = _job.m_renderPass;
+		cbii.subpass     = 0;
+		cbii.framebuffer = VK_NULL_HANDLE;
+		cbii.occlusionQueryEnable = VK_FALSE;
+		cbii.queryFlags  = 0;
+		cbii.pipelineStatistics = 0;
 
-			TextureVK& src = m_textures[blit.m_src.idx];
-			TextureVK& dst = m_textures[blit.m_dst.idx];
+		VkCommandBufferBeginInfo cbbi;
+		cbbi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		cbbi.pNext = NULL;
+		cbbi.flags = 0
+			| VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+			| VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT
+			;
+		cbbi.pInheritanceInfo = &cbii;
+		VK_CHECK(vkBeginCommandBuffer(commandBuffer, &cbbi) );
+
+		const View& rv = _render->m_view[_job.m_view];
+		const Rect& rect = _job.m_rect;
+
+		RecordStateVK& state = _thread.m_state;
+		state.m_commandBuffer = commandBuffer;
+		state.m_fbh           = _job.m_fbh;
+		state.reset();
+
+		// Render thread drops secondary command buffer when frame buffer is
+		// not renderable.
+		state.m_isFrameBufferValid = true;
+
+		Rect scissorRect = rv.m_scissor;
+		state.m_viewHasScissor  = !scissorRect.isZero();
+		state.m_viewScissorRect = state.m_viewHasScissor ? scissorRect : rv.m_rect;
+
+		ViewState& viewState = _thread.m_viewState;
+		viewState.m_rect = rv.m_rect;
+
+		// Dynamic state is not inherited from primary command buffer.
+		VkViewport vp;
+		vp.x        =  float(rect.m_x);
+		vp.y        =  float(rect.m_y + rect.m_height);
+		vp.width    =  float(rect.m_width);
+		vp.height   = -float(rect.m_height);
+		vp.minDepth = 0.0f;
+		vp.maxDepth = 1.0f;
+		vkCmdSetViewport(commandBuffer, 0, 1, &vp);
+
+		VkRect2D rc;
+		rc.offset.x      = state.m_viewScissorRect.m_x;
+		rc.offset.y      = state.m_viewScissorRect.m_y;
+		rc.extent.width  = state.m_viewScissorRect.m_width;
+		rc.extent.height = state.m_viewScissorRect.m_height;
+		vkCmdSetScissor(commandBuffer, 0, 1, &rc);
+
+		if (m_variableRateShadingSupported)
+		{
+			VkFragmentShadingRateCombinerOpKHR combinerOp[] =
+			{
+				VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR,
+				VK_FRAGMENT_SHADING_RATE_COMBINER_OP_KEEP_KHR
+			};
 
-			src.setImageMemoryBarrier(m_commandBuffer, srcLayouts[item], VK_NULL_HANDLE != src.m_singleMsaaImage);
-			dst.setImageMemoryBarrier(m_commandBuffer, dstLayouts[item]);
+			vkCmdSetFragmentShadingRateKHR(
+				  commandBuffer
+				, &s_shadingRate[rv.m_shadingRate].fragmentSize
+				, combinerOp
+				);
 		}
-	}
 
-	void RendererContextVK::submitUniformCache(UniformCacheState& _ucs, uint16_t _view)
-	{
-		while (_ucs.hasItem(_view) )
+		SortKey key;
+
+		for (uint32_t item = _job.m_itemBegin; item < _job.m_itemEnd; ++item)
 		{
-			const UniformCacheItem& uci = _ucs.advance();
+			key.decode(_render->m_sortKeys[item], _render->m_viewRemap);
 
-			bx::memCopy(m_uniforms[uci.m_handle], &_ucs.m_frame->m_uniformCacheFrame.m_data[uci.m_offset], uci.m_size);
+			const uint32_t itemIdx = _render->m_sortValues[item];
+
+			recordDraw(
+				  state
+				, viewState
+				, _render
+				, _job.m_view
+				, key.m_program
+				, _render->m_renderItem[itemIdx]
+				, _render->m_renderItemBind[itemIdx]
+				);
 		}
+
+		VK_CHECK(vkEndCommandBuffer(commandBuffer) );
+
+		_job.m_commandBuffer = commandBuffer;
 	}
 
 	void RendererContextVK::submit(Frame* _render, ClearQuad& _clearQuad, TextVideoMemBlitter& _textVideoMemBlitter)
@@ -8995,6 +12019,12 @@ retry:
 		int64_t timeBegin = bx::getHPCounter();
 		int64_t captureElapsed = 0;
 
+		// Hand resources uploaded by this frame's commands to graphics queue
+		// before any draw can reference them.
+		m_upload.close(m_commandBuffer, m_cmd);
+
+		finishPipelines(false);
+
 		uint32_t frameQueryIdx = UINT32_MAX;
 
 		if (m_timerQuerySupport)
@@ -9020,10 +12050,16 @@ retry:
 
 		_render->sort();
 
-		RenderDraw currentState;
-		currentState.clear();
-		currentState.m_stateFlags = BGFX_STATE_NONE;
-		currentState.m_stencil    = packStencil(BGFX_STENCIL_NONE, BGFX_STENCIL_NONE);
+		RecordStateVK state;
+		state.m_commandBuffer = m_commandBuffer;
+		state.m_fbh           = m_fbh;
+		state.m_uniforms      = m_uniforms;
+		state.m_vsScratch     = m_vsScratch;
+		state.m_fsScratch     = m_fsScratch;
+		state.m_slab          = NULL;
+		state.m_isFrameBufferValid = false;
+		state.reset();
+		state.resetStats();
 
 		static ViewState viewState;
 		viewState.reset(_render);
@@ -9031,13 +12067,6 @@ retry:
 		bool wireframe = !!(_render->m_debug&BGFX_DEBUG_WIREFRAME);
 		setDebugWireframe(wireframe);
 
-		ProgramHandle currentProgram = BGFX_INVALID_HANDLE;
-		bool hasPredefined = false;
-		VkPipeline currentPipeline = VK_NULL_HANDLE;
-		VkDescriptorSet currentDescriptorSet = VK_NULL_HANDLE;
-		uint32_t currentBindHash = 0;
-		uint32_t descriptorSetCount = 0;
-		VkIndexType currentIndexFormat = VK_INDEX_TYPE_MAX_ENUM;
 		SortKey key;
 		uint16_t view = UINT16_MAX;
 		FrameBufferHandle fbh = { BGFX_CONFIG_MAX_FRAME_BUFFERS };
@@ -9045,27 +12074,10 @@ retry:
 		UniformCacheState ucs(_render);
 		BlitState bs(_render);
 
-		uint64_t blendFactor = UINT64_MAX;
-
-		bool wasCompute     = false;
-		bool viewHasScissor = false;
-		bool restoreScissor = false;
-		Rect viewScissorRect;
-		viewScissorRect.clear();
+		bool wasCompute = false;
 
-		bool isFrameBufferValid = false;
-
-		uint32_t statsNumPrimsSubmitted[BX_COUNTOF(s_primInfo)] = {};
-		uint32_t statsNumPrimsRendered[BX_COUNTOF(s_primInfo)] = {};
-		uint32_t statsNumInstances[BX_COUNTOF(s_primInfo)] = {};
-		uint32_t statsNumIndices = 0;
 		uint32_t statsKeyType[2] = {};
 
-		const uint64_t f0 = BGFX_STATE_BLEND_FACTOR;
-		const uint64_t f1 = BGFX_STATE_BLEND_INV_FACTOR;
-		const uint64_t f2 = BGFX_STATE_BLEND_FACTOR<<4;
-		const uint64_t f3 = BGFX_STATE_BLEND_INV_FACTOR<<4;
-
 		VkDescriptorPool& descriptorPool = m_descriptorPool[m_cmd.m_currentFrameInFlight];
 		vkResetDescriptorPool(m_device, descriptorPool, 0);
 
@@ -9101,6 +12113,14 @@ retry:
 		{
 			viewState.m_rect = _render->m_view[0].m_rect;
 
+			const uint32_t numJobs = prepareRecordJobs(_render);
+			uint32_t jobIdx = 0;
+
+			if (0 < numJobs)
+			{
+				m_recorder.begin(_render, m_recordJob, numJobs, m_uniforms, m_uniformSize);
+			}
+
 			int32_t numItems = _render->m_numRenderItems;
 			for (int32_t item = 0; item < numItems;)
 			{
@@ -9121,8 +12141,8 @@ retry:
 				if (viewChanged)
 				{
 					view = key.m_view;
-					currentProgram = BGFX_INVALID_HANDLE;
-					hasPredefined = false;
+					state.m_currentProgram = BGFX_INVALID_HANDLE;
+					state.m_hasPredefined  = false;
 
 					if (_render->m_view[view].m_fbh.idx != fbh.idx)
 					{
@@ -9135,6 +12155,11 @@ retry:
 						fbh = _render->m_view[view].m_fbh;
 						setFrameBuffer(fbh);
 					}
+
+					// Command buffer is replaced when swap chain is recreated
+					// while acquiring back buffer.
+					state.m_commandBuffer = m_commandBuffer;
+					state.m_fbh           = m_fbh;
 				}
 
 				if (!isCompute
@@ -9143,10 +12168,21 @@ retry:
 					if (wasCompute)
 					{
 						wasCompute = false;
-						currentBindHash = 0;
+						state.m_currentBindHash = 0;
+					}
+
+					RecordJobVK* job = NULL;
+
+					if (jobIdx < numJobs
+					&&  m_recordJob[jobIdx].m_itemBegin == uint32_t(item-1) )
+					{
+						job = &m_recordJob[jobIdx++];
 					}
 
+					// Secondary command buffers can be executed only from render
+					// pass that was started specifically for them.
 					if (beginRenderPass && (false
+					||  NULL != job
 					||  _render->m_view[view].m_fbh.idx != fbh.idx
 					|| !_render->m_view[view].m_rect.isEqual(viewState.m_rect)
 					   ) )
@@ -9180,18 +12216,23 @@ retry:
 						: m_backBuffer
 						;
 
-					isFrameBufferValid = fb.isRenderable();
+					state.m_isFrameBufferValid = fb.isRenderable();
 
-					if (isFrameBufferValid)
+					if (state.m_isFrameBufferValid)
 					{
-						VkRenderPass renderPass = fb.getRenderPass(_render->m_view[view].m_clear.m_flags);
+						VkRenderPass renderPass;
+
+						{
+							CommandRecorderScopeVK scope(m_recorder);
+							renderPass = fb.getRenderPass(_render->m_view[view].m_clear.m_flags);
+						}
 
 						viewState.m_rect = _render->m_view[view].m_rect;
 						Rect rect        = _render->m_view[view].m_rect;
 						Rect scissorRect = _render->m_view[view].m_scissor;
-						viewHasScissor  = !scissorRect.isZero();
-						viewScissorRect = viewHasScissor ? scissorRect : rect;
-						restoreScissor = false;
+						state.m_viewHasScissor  = !scissorRect.isZero();
+						state.m_viewScissorRect = state.m_viewHasScissor ? scissorRect : rect;
+						state.m_restoreScissor  = false;
 
 						// Clamp the rect to what's valid according to Vulkan.
 						rect.m_width  = bx::min(rect.m_width,  bx::narrowCast<uint16_t>(fb.m_width)  - rect.m_x);
@@ -9224,10 +12265,10 @@ retry:
 						vkCmdSetViewport(m_commandBuffer, 0, 1, &vp);
 
 						VkRect2D rc;
-						rc.offset.x      = viewScissorRect.m_x;
-						rc.offset.y      = viewScissorRect.m_y;
-						rc.extent.width  = viewScissorRect.m_width;
-						rc.extent.height = viewScissorRect.m_height;
+						rc.offset.x      = state.m_viewScissorRect.m_x;
+						rc.offset.y      = state.m_viewScissorRect.m_y;
+						rc.extent.width  = state.m_viewScissorRect.m_width;
+						rc.extent.height = state.m_viewScissorRect.m_height;
 						vkCmdSetScissor(m_commandBuffer, 0, 1, &rc);
 
 						if (!beginRenderPass)
@@ -9321,7 +12362,13 @@ retry:
 							rpbi.clearValueCount = mrt;
 							rpbi.pClearValues = clearValues;
 
-							vkCmdBeginRenderPass(m_commandBuffer, &rpbi, VK_SUBPASS_CONTENTS_INLINE);
+							vkCmdBeginRenderPass(
+								  m_commandBuffer
+								, &rpbi
+								, NULL == job
+									? VK_SUBPASS_CONTENTS_INLINE
+									: VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+								);
 							beginRenderPass = true;
 						}
 						else
@@ -9330,13 +12377,14 @@ retry:
 							if (BGFX_CLEAR_NONE != clr.m_flags)
 							{
 								Rect clearRect = rect;
-								clearRect.setIntersect(rect, viewScissorRect);
+								clearRect.setIntersect(rect, state.m_viewScissorRect);
 								clearQuad(clearRect, clr, _render->m_colorPalette);
 
 							}
 						}
 
-						if (m_variableRateShadingSupported)
+						if (m_variableRateShadingSupported
+						&&  NULL == job)
 						{
 							VkFragmentShadingRateCombinerOpKHR combinerOp[] =
 							{
@@ -9351,6 +12399,26 @@ retry:
 								);
 						}
 					}
+
+					if (NULL != job)
+					{
+						const VkCommandBuffer commandBuffer = m_recorder.wait(*job);
+
+						if (state.m_isFrameBufferValid)
+						{
+							vkCmdExecuteCommands(m_commandBuffer, 1, &commandBuffer);
+							vkCmdEndRenderPass(m_commandBuffer);
+							beginRenderPass = false;
+						}
+
+						// Primary command buffer state is undefined after executing
+						// secondary command buffers.
+						state.reset();
+
+						statsKeyType[0] += job->m_itemEnd - job->m_itemBegin - 1;
+						item = int32_t(job->m_itemEnd);
+						continue;
+					}
 				}
 
 				if (isCompute)
@@ -9358,7 +12426,7 @@ retry:
 					if (!wasCompute)
 					{
 						wasCompute = true;
-						currentBindHash = 0;
+						state.m_currentBindHash = 0;
 
 						BGFX_VK_PROFILER_END();
 						setViewType(view, "C");
@@ -9383,39 +12451,45 @@ retry:
 
 					const VkPipeline pipeline = getPipeline(key.m_program);
 
-					if (currentPipeline != pipeline)
+					if (state.m_currentPipeline != pipeline)
 					{
-						currentPipeline = pipeline;
+						state.m_currentPipeline = pipeline;
 						vkCmdBindPipeline(m_commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
 					}
 
 					bool constantsChanged = false;
 
 					if (compute.m_uniformBegin < compute.m_uniformEnd
-					||  currentProgram.idx != key.m_program.idx)
+					||  state.m_currentProgram.idx != key.m_program.idx)
 					{
-						rendererUpdateUniforms(this, _render->m_uniformBuffer[compute.m_uniformIdx], compute.m_uniformBegin, compute.m_uniformEnd);
+						state.update(*_render->m_uniformBuffer[compute.m_uniformIdx], compute.m_uniformBegin, compute.m_uniformEnd);
 
-						currentProgram = key.m_program;
-						ProgramVK& program = m_program[currentProgram.idx];
+						state.m_currentProgram = key.m_program;
+						ProgramVK& program = m_program[state.m_currentProgram.idx];
 
 						UniformBuffer* vcb = program.m_vsh->m_constantBuffer;
 
 						if (NULL != vcb)
 						{
-							commit(*vcb);
+							state.commit(*vcb);
 						}
 
-						hasPredefined = 0 < program.m_numPredefined;
+						state.m_hasPredefined = 0 < program.m_numPredefined;
 						constantsChanged = true;
 					}
 
-					const ProgramVK& program = m_program[currentProgram.idx];
+					const ProgramVK& program = m_program[state.m_currentProgram.idx];
 
 					if (constantsChanged
-					||  hasPredefined)
+					||  state.m_hasPredefined)
+					{
+						viewState.setPredefined<4>(&state, view, program, _render, compute);
+					}
+
+					if (program.m_pushConstants
+					&& (constantsChanged || state.m_hasPredefined) )
 					{
-						viewState.setPredefined<4>(this, view, program, _render, compute);
+						program.pushConstants(m_commandBuffer, state.m_vsScratch, NULL);
 					}
 
 					if (VK_NULL_HANDLE != program.m_descriptorSetLayout)
@@ -9426,11 +12500,11 @@ retry:
 						uint32_t numOffsets = 0;
 
 						if (constantsChanged
-						||  hasPredefined)
+						||  state.m_hasPredefined)
 						{
 							if (vsSize > 0)
 							{
-								uniformScratchBuffer.write(sbo, m_vsScratch, vsSize);
+								writeUniformScratch(state, sbo, vsSize, 0);
 								numOffsets = 1;
 							}
 						}
@@ -9444,18 +12518,18 @@ retry:
 						hash.add(0);
 						const uint32_t bindHash = hash.end();
 
-						if (currentBindHash != bindHash)
+						if (state.m_currentBindHash != bindHash)
 						{
-							currentBindHash = bindHash;
+							state.m_currentBindHash = bindHash;
 
-							currentDescriptorSet = getDescriptorSet(
+							state.m_currentDescriptorSet = getDescriptorSet(
 								  program
 								, renderBind
 								, sbo.buffer
 								, _render->m_colorPalette
 							);
 
-							descriptorSetCount++;
+							++state.m_numDescriptorSets;
 						}
 
 						vkCmdBindDescriptorSets(
@@ -9464,7 +12538,7 @@ retry:
 							, program.m_pipelineLayout
 							, 0
 							, 1
-							, &currentDescriptorSet
+							, &state.m_currentDescriptorSet
 							, numOffsets
 							, sbo.offsets
 							);
@@ -9494,419 +12568,16 @@ retry:
 					continue;
 				}
 
-				const RenderDraw& draw = renderItem.draw;
-
-				rendererUpdateUniforms(this, _render->m_uniformBuffer[draw.m_uniformIdx], draw.m_uniformBegin, draw.m_uniformEnd);
-
-				const bool hasOcclusionQuery = 0 != (draw.m_stateFlags & BGFX_STATE_INTERNAL_OCCLUSION_QUERY);
-				{
-					const bool occluded = true
-						&& isValid(draw.m_occlusionQuery)
-						&& !hasOcclusionQuery
-						&& !isVisible(_render, draw.m_occlusionQuery, 0 != (draw.m_submitFlags & BGFX_SUBMIT_INTERNAL_OCCLUSION_VISIBLE) )
-						;
-
-					if (occluded
-					||  !isFrameBufferValid
-					||  0 == draw.m_streamMask
-					||  _render->m_frameCache.isZeroArea(viewScissorRect, draw.m_scissor) )
-					{
-						continue;
-					}
-				}
+				recordDraw(state, viewState, _render, view, key.m_program, renderItem, renderBind);
+			}
 
-				const uint64_t changedFlags = currentState.m_stateFlags ^ draw.m_stateFlags;
-				currentState.m_stateFlags = draw.m_stateFlags;
+			if (0 < numJobs)
+			{
+				m_recorder.end();
 
-				if (0 != draw.m_streamMask)
+				for (uint32_t ii = 0, num = m_recorder.getNumThreads(); ii < num; ++ii)
 				{
-					const bool bindAttribs = hasVertexStreamChanged(currentState, draw);
-
-					currentState.m_streamMask         = draw.m_streamMask;
-					currentState.m_instanceDataBuffer = draw.m_instanceDataBuffer;
-					currentState.m_instanceDataOffset = draw.m_instanceDataOffset;
-					currentState.m_instanceDataStride = draw.m_instanceDataStride;
-
-					const VertexLayout* layouts[BGFX_CONFIG_MAX_VERTEX_STREAMS];
-					VkBuffer streamBuffers[BGFX_CONFIG_MAX_VERTEX_STREAMS + 1];
-					VkDeviceSize streamOffsets[BGFX_CONFIG_MAX_VERTEX_STREAMS + 1];
-					uint8_t numStreams = 0;
-					uint32_t numVertices = draw.m_numVertices;
-					if (UINT8_MAX != draw.m_streamMask)
-					{
-						for (BitMaskToIndexIteratorT it(draw.m_streamMask)
-							; !it.isDone()
-							; it.next(), numStreams++
-							)
-						{
-							const uint8_t idx = it.idx;
-
-							currentState.m_stream[idx] = draw.m_stream[idx];
-
-							const VertexBufferHandle handle = draw.m_stream[idx].m_handle;
-							const VertexBufferVK& vb = m_vertexBuffers[handle.idx];
-							const uint16_t decl = isValid(draw.m_stream[idx].m_layoutHandle)
-								? draw.m_stream[idx].m_layoutHandle.idx
-								: vb.m_layoutHandle.idx
-								;
-							const VertexLayout& layout = m_vertexLayouts[decl];
-							const uint32_t stride = layout.m_stride;
-
-							streamBuffers[numStreams] = m_vertexBuffers[handle.idx].m_buffer;
-							streamOffsets[numStreams] = draw.m_stream[idx].m_startVertex * stride;
-							layouts[numStreams]       = &layout;
-
-							numVertices = bx::uint32_min(UINT32_MAX == draw.m_numVertices
-								? vb.m_size/stride
-								: draw.m_numVertices
-								, numVertices
-								);
-						}
-					}
-
-					if (bindAttribs)
-					{
-						uint32_t numVertexBuffers = numStreams;
-
-						if (isValid(draw.m_instanceDataBuffer) )
-						{
-							streamOffsets[numVertexBuffers] = draw.m_instanceDataOffset;
-							streamBuffers[numVertexBuffers] = m_vertexBuffers[draw.m_instanceDataBuffer.idx].m_buffer;
-							numVertexBuffers++;
-						}
-
-						if (0 < numVertexBuffers)
-						{
-							vkCmdBindVertexBuffers(
-								  m_commandBuffer
-								, 0
-								, numVertexBuffers
-								, &streamBuffers[0]
-								, streamOffsets
-								);
-						}
-					}
-
-					const VkPipeline pipeline =
-						getPipeline(draw.m_stateFlags
-							, draw.m_stencil
-							, numStreams
-							, layouts
-							, key.m_program
-							, uint8_t(draw.m_instanceDataStride/16)
-							);
-
-					if (currentPipeline != pipeline)
-					{
-						currentPipeline = pipeline;
-						vkCmdBindPipeline(m_commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
-					}
-
-					const bool hasStencil = 0 != draw.m_stencil;
-
-					if (hasStencil
-					&&  currentState.m_stencil != draw.m_stencil)
-					{
-						currentState.m_stencil = draw.m_stencil;
-
-						const uint32_t fstencil = unpackStencil(0, draw.m_stencil);
-						const uint32_t ref = (fstencil&BGFX_STENCIL_FUNC_REF_MASK)>>BGFX_STENCIL_FUNC_REF_SHIFT;
-						vkCmdSetStencilReference(m_commandBuffer, VK_STENCIL_FRONT_AND_BACK, ref);
-					}
-
-					const bool hasFactor = 0
-						|| f0 == (draw.m_stateFlags & f0)
-						|| f1 == (draw.m_stateFlags & f1)
-						|| f2 == (draw.m_stateFlags & f2)
-						|| f3 == (draw.m_stateFlags & f3)
-						;
-
-					if (hasFactor
-					&&  blendFactor != draw.m_rgba)
-					{
-						blendFactor = draw.m_rgba;
-
-						float bf[4];
-						bf[0] = ( (draw.m_rgba>>24)     )/255.0f;
-						bf[1] = ( (draw.m_rgba>>16)&0xff)/255.0f;
-						bf[2] = ( (draw.m_rgba>> 8)&0xff)/255.0f;
-						bf[3] = ( (draw.m_rgba    )&0xff)/255.0f;
-						vkCmdSetBlendConstants(m_commandBuffer, bf);
-					}
-
-					const uint16_t scissor = draw.m_scissor;
-
-					if (currentState.m_scissor != scissor)
-					{
-						currentState.m_scissor = scissor;
-
-						if (UINT16_MAX == scissor)
-						{
-							if (restoreScissor
-							||  viewHasScissor)
-							{
-								restoreScissor = false;
-								VkRect2D rc;
-								rc.offset.x      = viewScissorRect.m_x;
-								rc.offset.y      = viewScissorRect.m_y;
-								rc.extent.width  = viewScissorRect.m_width;
-								rc.extent.height = viewScissorRect.m_height;
-								vkCmdSetScissor(m_commandBuffer, 0, 1, &rc);
-							}
-						}
-						else
-						{
-							restoreScissor = true;
-							Rect scissorRect;
-							scissorRect.setIntersect(viewScissorRect, _render->m_frameCache.m_rectCache.m_cache[scissor]);
-
-							VkRect2D rc;
-							rc.offset.x      = scissorRect.m_x;
-							rc.offset.y      = scissorRect.m_y;
-							rc.extent.width  = scissorRect.m_width;
-							rc.extent.height = scissorRect.m_height;
-							vkCmdSetScissor(m_commandBuffer, 0, 1, &rc);
-						}
-					}
-
-					bool constantsChanged = false;
-					if (draw.m_uniformBegin < draw.m_uniformEnd
-					||  currentProgram.idx != key.m_program.idx
-					||  BGFX_STATE_ALPHA_REF_MASK & changedFlags)
-					{
-						currentProgram = key.m_program;
-						ProgramVK& program = m_program[currentProgram.idx];
-
-						UniformBuffer* vcb = program.m_vsh->m_constantBuffer;
-						if (NULL != vcb)
-						{
-							commit(*vcb);
-						}
-
-						if (NULL != program.m_fsh)
-						{
-							UniformBuffer* fcb = program.m_fsh->m_constantBuffer;
-							if (NULL != fcb)
-							{
-								commit(*fcb);
-							}
-						}
-
-						hasPredefined = 0 < program.m_numPredefined;
-						constantsChanged = true;
-					}
-
-					const ProgramVK& program = m_program[currentProgram.idx];
-
-					if (hasPredefined)
-					{
-						uint32_t ref = (draw.m_stateFlags & BGFX_STATE_ALPHA_REF_MASK) >> BGFX_STATE_ALPHA_REF_SHIFT;
-						viewState.m_alphaRef = ref / 255.0f;
-						viewState.setPredefined<4>(this, view, program, _render, draw);
-					}
-
-					if (VK_NULL_HANDLE != program.m_descriptorSetLayout)
-					{
-						ChunkedScratchBufferOffset sbo;
-
-						const uint32_t vsSize = program.m_vsh->m_size;
-						const uint32_t fsSize = NULL != program.m_fsh ? program.m_fsh->m_size : 0;
-						uint32_t numOffsets = 0;
-
-						if (true
-						&& (constantsChanged || hasPredefined)
-						&& (0 < vsSize || 0 < fsSize)
-						   )
-						{
-							uniformScratchBuffer.write(sbo, m_vsScratch, vsSize, m_fsScratch, fsSize);
-							numOffsets = (0 < vsSize) + (0 < fsSize);
-						}
-
-						bx::HashMurmur2A hash;
-						hash.begin();
-						hash.add(program.m_descriptorSetLayout);
-						hash.add(renderBind.m_bind, sizeof(renderBind.m_bind) );
-						hash.add(sbo.buffer);
-						hash.add(vsSize);
-						hash.add(fsSize);
-						const uint32_t bindHash = hash.end();
-
-						if (currentBindHash != bindHash)
-						{
-							currentBindHash = bindHash;
-
-							currentDescriptorSet = getDescriptorSet(
-								  program
-								, renderBind
-								, sbo.buffer
-								, _render->m_colorPalette
-								);
-
-							descriptorSetCount++;
-						}
-
-						vkCmdBindDescriptorSets(
-							  m_commandBuffer
-							, VK_PIPELINE_BIND_POINT_GRAPHICS
-							, program.m_pipelineLayout
-							, 0
-							, 1
-							, &currentDescriptorSet
-							, numOffsets
-							, sbo.offsets
-							);
-					}
-
-					VkBuffer bufferIndirect = VK_NULL_HANDLE;
-					VkBuffer bufferNumIndirect = VK_NULL_HANDLE;
-					uint32_t numDrawIndirect = 0;
-					uint32_t bufferOffsetIndirect = 0;
-					uint32_t bufferNumOffsetIndirect = 0;
-					if (isValid(draw.m_indirectBuffer) )
-					{
-						const VertexBufferVK& vb = m_vertexBuffers[draw.m_indirectBuffer.idx];
-						bufferIndirect = vb.m_buffer;
-						numDrawIndirect = UINT32_MAX == draw.m_numIndirect
-							? vb.m_size / BGFX_CONFIG_DRAW_INDIRECT_STRIDE
-							: draw.m_numIndirect
-							;
-						bufferOffsetIndirect = draw.m_startIndirect * BGFX_CONFIG_DRAW_INDIRECT_STRIDE;
-
-						if (isValid(draw.m_numIndirectBuffer) )
-						{
-							bufferNumIndirect = m_indexBuffers[draw.m_numIndirectBuffer.idx].m_buffer;
-							bufferNumOffsetIndirect = draw.m_numIndirectIndex * sizeof(uint32_t);
-						}
-					}
-
-					if (hasOcclusionQuery)
-					{
-						m_occlusionQuery.begin(draw.m_occlusionQuery);
-					}
-
-					const uint8_t primIndex = uint8_t( (draw.m_stateFlags & BGFX_STATE_PT_MASK) >> BGFX_STATE_PT_SHIFT);
-					const PrimInfo& prim = s_primInfo[primIndex];
-
-					uint32_t numPrimsSubmitted = 0;
-					uint32_t numIndices = 0;
-
-					if (!isValid(draw.m_indexBuffer) )
-					{
-						numPrimsSubmitted = numVertices / prim.m_div - prim.m_sub;
-
-						if (isValid(draw.m_indirectBuffer) )
-						{
-							if (isValid(draw.m_numIndirectBuffer) )
-							{
-								vkCmdDrawIndirectCountKHR(
-									  m_commandBuffer
-									, bufferIndirect
-									, bufferOffsetIndirect
-									, bufferNumIndirect
-									, bufferNumOffsetIndirect
-									, numDrawIndirect
-									, BGFX_CONFIG_DRAW_INDIRECT_STRIDE
-									);
-							}
-							else
-							{
-								vkCmdDrawIndirect(
-									  m_commandBuffer
-									, bufferIndirect
-									, bufferOffsetIndirect
-									, numDrawIndirect
-									, BGFX_CONFIG_DRAW_INDIRECT_STRIDE
-									);
-							}
-						}
-						else
-						{
-							vkCmdDraw(
-								  m_commandBuffer
-								, numVertices
-								, draw.m_numInstances
-								, 0
-								, 0
-								);
-						}
-					}
-					else
-					{
-						const bool isIndex16          = draw.isIndex16();
-						const uint32_t indexSize      = isIndex16 ? 2 : 4;
-						const VkIndexType indexFormat = isIndex16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
-						const BufferVK& ib            = m_indexBuffers[draw.m_indexBuffer.idx];
-
-						numIndices = UINT32_MAX == draw.m_numIndices
-							? ib.m_size / indexSize
-							: draw.m_numIndices
-							;
-
-						numPrimsSubmitted = numIndices / prim.m_div - prim.m_sub;
-
-						if (currentState.m_indexBuffer.idx != draw.m_indexBuffer.idx
-						||  currentIndexFormat != indexFormat)
-						{
-							currentState.m_indexBuffer = draw.m_indexBuffer;
-							currentIndexFormat = indexFormat;
-
-							vkCmdBindIndexBuffer(
-								  m_commandBuffer
-								, m_indexBuffers[draw.m_indexBuffer.idx].m_buffer
-								, 0
-								, indexFormat
-								);
-						}
-
-						if (isValid(draw.m_indirectBuffer) )
-						{
-							if (isValid(draw.m_numIndirectBuffer) )
-							{
-								vkCmdDrawIndexedIndirectCountKHR(
-									  m_commandBuffer
-									, bufferIndirect
-									, bufferOffsetIndirect
-									, bufferNumIndirect
-									, bufferNumOffsetIndirect
-									, numDrawIndirect
-									, BGFX_CONFIG_DRAW_INDIRECT_STRIDE
-									);
-							}
-							else
-							{
-								vkCmdDrawIndexedIndirect(
-									  m_commandBuffer
-									, bufferIndirect
-									, bufferOffsetIndirect
-									, numDrawIndirect
-									, BGFX_CONFIG_DRAW_INDIRECT_STRIDE
-									);
-							}
-						}
-						else
-						{
-							vkCmdDrawIndexed(
-								  m_commandBuffer
-								, numIndices
-								, draw.m_numInstances
-								, draw.m_startIndex
-								, 0
-								, 0
-								);
-						}
-					}
-
-					uint32_t numPrimsRendered  = numPrimsSubmitted*draw.m_numInstances;
-
-					statsNumPrimsSubmitted[primIndex] += numPrimsSubmitted;
-					statsNumPrimsRendered[primIndex]  += numPrimsRendered;
-					statsNumInstances[primIndex]      += draw.m_numInstances;
-					statsNumIndices                   += numIndices;
-
-					if (hasOcclusionQuery)
-					{
-						m_occlusionQuery.end();
-					}
+					state.addStats(m_recorder.getThread(ii)->m_state);
 				}
 			}
 
@@ -9997,6 +12668,12 @@ retry:
 				}
 			}
 		}
+		else
+		{
+			// Without memory budget extension only memory allocated by
+			// renderer is known.
+			gpuMemoryUsed = int64_t(m_memoryAllocator.getReserved() ) + m_dedicatedMemorySize;
+		}
 
 		Stats& perfStats = _render->m_perfStats;
 		perfStats.cpuTimeBegin  = timeBegin;
@@ -10011,9 +12688,24 @@ retry:
 		perfStats.numBlit       = _render->m_numBlitItems;
 		perfStats.maxGpuLatency = maxGpuLatency;
 		perfStats.gpuFrameNum   = result.m_frameNum;
-		bx::memCopy(perfStats.numPrims, statsNumPrimsRendered, sizeof(perfStats.numPrims) );
+		bx::memCopy(perfStats.numPrims, state.m_numPrimsRendered, sizeof(perfStats.numPrims) );
 		perfStats.gpuMemoryMax  = gpuMemoryAvailable;
 		perfStats.gpuMemoryUsed = gpuMemoryUsed;
+		perfStats.pipelineCompileTime  = m_pipelineCompileTime;
+		perfStats.numPipelinesCompiled = m_numPipelinesCompiled;
+		perfStats.numPipelinesPending  = m_pipelineJobs.getNumElements();
+		perfStats.numDrawSkipped       = state.m_numDrawSkipped;
+		perfStats.numDescriptorSetsReused  = m_numDescriptorSetsReused;
+		perfStats.numDescriptorSetsCreated = m_numDescriptorSetsCreated;
+		perfStats.uploadWaitTime       = m_upload.m_waitTime;
+		perfStats.uploadSize           = m_upload.m_size;
+
+		m_pipelineCompileTime  = 0;
+		m_numPipelinesCompiled = 0;
+		m_numDescriptorSetsReused  = 0;
+		m_numDescriptorSetsCreated = 0;
+		m_upload.m_waitTime = 0;
+		m_upload.m_size     = 0;
 
 		if (_render->m_debug & (BGFX_DEBUG_IFH|BGFX_DEBUG_STATS) )
 		{
@@ -10049,6 +12741,27 @@ retry:
 					, getName(pdp.deviceType)
 					);
 
+				{
+					char used[16];
+					bx::prettify(used, BX_COUNTOF(used), m_memoryAllocator.getUsed() );
+
+					char reserved[16];
+					bx::prettify(reserved, BX_COUNTOF(reserved), m_memoryAllocator.getReserved() );
+
+					char dedicated[16];
+					bx::prettify(dedicated, BX_COUNTOF(dedicated), m_dedicatedMemorySize);
+
+					const uint64_t reservedSize = m_memoryAllocator.getReserved();
+
+					tvm.printf(0, pos++, 0x8f, " Pages: %3d, Used: %12s / %12s (%3d%% free), Dedicated: %12s"
+						, m_memoryAllocator.getNumPages()
+						, used
+						, reserved
+						, 0 == reservedSize ? 0 : int32_t( (reservedSize - m_memoryAllocator.getUsed() ) * 100 / reservedSize)
+						, dedicated
+						);
+				}
+
 				if (0 <= gpuMemoryAvailable && 0 <= gpuMemoryUsed)
 				{
 					for (uint32_t ii = 0; ii < m_memoryProperties.memoryHeapCount; ++ii)
@@ -10106,9 +12819,9 @@ retry:
 				{
 					tvm.printf(10, pos++, 0x8b, "   %9s: %7d (#inst: %5d), submitted: %7d "
 						, getName(Topology::Enum(ii) )
-						, statsNumPrimsRendered[ii]
-						, statsNumInstances[ii]
-						, statsNumPrimsSubmitted[ii]
+						, state.m_numPrimsRendered[ii]
+						, state.m_numInstances[ii]
+						, state.m_numPrimsSubmitted[ii]
 						);
 				}
 
@@ -10117,7 +12830,7 @@ retry:
 					tvm.printf(tvm.m_width-27, 0, 0x4f, " [F11 - RenderDoc capture] ");
 				}
 
-				tvm.printf(10, pos++, 0x8b, "      Indices: %7d ", statsNumIndices);
+				tvm.printf(10, pos++, 0x8b, "      Indices: %7d ", state.m_numIndices);
 				tvm.printf(10, pos++, 0x8b, "     DVB size: %7d ", _render->m_vboffset);
 				tvm.printf(10, pos++, 0x8b, "     DIB size: %7d ", _render->m_iboffset);
 
@@ -10125,12 +12838,14 @@ retry:
 				tvm.printf(10, pos++, 0x8b, " Occlusion queries: %3d ", m_occlusionQuery.m_control.getNumUsed() );
 
 				pos++;
-				tvm.printf(10, pos++, 0x8b, " State cache:             ");
-				tvm.printf(10, pos++, 0x8b, " PSO    | DSL    |  DS    ");
-				tvm.printf(10, pos++, 0x8b, " %6d | %6d | %6d "
+				tvm.printf(10, pos++, 0x8b, " State cache:                                 ");
+				tvm.printf(10, pos++, 0x8b, " PSO    | DSL    |  DS    | DS cache | DS hit ");
+				tvm.printf(10, pos++, 0x8b, " %6d | %6d | %6d | %8d | %5.1f%% "
 					, m_pipelineStateCache.getCount()
 					, m_descriptorSetLayoutCache.getCount()
-					, descriptorSetCount
+					, state.m_numDescriptorSets
+					, m_descriptorSetCache.getCount()
+					, 0 == state.m_numDescriptorSets ? 0.0 : double(perfStats.numDescriptorSetsReused) * 100.0 / double(state.m_numDescriptorSets)
 					);
 				pos++;
 
@@ -10144,6 +12859,21 @@ retry:
 					tvm.printf(10, pos++, 0x8b, "Uniform scratch size: %s / %s.", strUsed, strTotal);
 				}
 
+				if (m_upload.isEnabled() )
+				{
+					char strSize[64];
+					bx::prettify(strSize, sizeof(strSize), perfStats.uploadSize);
+
+					char strRate[64];
+					bx::prettify(strRate, sizeof(strRate), uint64_t(double(perfStats.uploadSize) * freq / double(bx::max<int64_t>(frameTime, 1) ) ) );
+
+					tvm.printf(10, pos++, 0x8b, "Upload queue: %s (%s/s), wait %7.4f [ms]."
+						, strSize
+						, strRate
+						, double(perfStats.uploadWaitTime)*toMs
+						);
+				}
+
 				pos++;
 				double captureMs = double(captureElapsed)*toMs;
 				tvm.printf(10, pos++, 0x8b, "     Capture: %7.4f [ms] ", captureMs);
@@ -10193,6 +12923,17 @@ retry:
 			{
 				fb.resolve();
 
+				for (uint8_t jj = 0, num = _render->m_numScreenShots; jj < num; ++jj)
+				{
+					const ScreenShot& screenShot = _render->m_screenShot[jj];
+
+					if (screenShot.handle.idx == m_windows[ii].idx
+					&&  isSwapChainReadable(fb.m_swapChain) )
+					{
+						readSwapChain(fb.m_swapChain, screenShot.filePath.getCPtr() );
+					}
+				}
+
 				fb.m_swapChain.transitionImage(m_commandBuffer);
 
 				m_cmd.addWaitSemaphore(fb.m_swapChain.m_lastImageAcquiredSemaphore, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
@@ -10204,6 +12945,9 @@ retry:
 		}
 
 		kick();
+
+		++m_readbackFrame;
+		processReadbacks(false);
 	}
 
 } /* namespace vk */ } // namespace bgfx
@@ -170,11 +170,13 @@
 			VK_IMPORT_DEVICE_FUNC(false, vkQueueWaitIdle);                            \
 			VK_IMPORT_DEVICE_FUNC(false, vkDeviceWaitIdle);                           \
 			VK_IMPORT_DEVICE_FUNC(false, vkWaitForFences);                            \
+			VK_IMPORT_DEVICE_FUNC(false, vkGetFenceStatus);                           \
 			VK_IMPORT_DEVICE_FUNC(false, vkBeginCommandBuffer);                       \
 			VK_IMPORT_DEVICE_FUNC(false, vkEndCommandBuffer);                         \
 			VK_IMPORT_DEVICE_FUNC(false, vkCmdPipelineBarrier);                       \
 			VK_IMPORT_DEVICE_FUNC(false, vkCmdBeginRenderPass);                       \
 			VK_IMPORT_DEVICE_FUNC(false, vkCmdEndRenderPass);                         \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdExecuteCommands);                       \
 			VK_IMPORT_DEVICE_FUNC(false, vkCmdSetViewport);                           \
 			VK_IMPORT_DEVICE_FUNC(false, vkCmdDraw);                                  \
 			VK_IMPORT_DEVICE_FUNC(false, vkCmdDrawIndexed);                           \
@@ -187,6 +189,7 @@
 			VK_IMPORT_DEVICE_FUNC(false, vkCmdSetBlendConstants);                     \
 			VK_IMPORT_DEVICE_FUNC(false, vkCmdSetScissor);                            \
 			VK_IMPORT_DEVICE_FUNC(false, vkCmdBindDescriptorSets);                    \
+			VK_IMPORT_DEVICE_FUNC(false, vkCmdPushConstants);                         \
 			VK_IMPORT_DEVICE_FUNC(false, vkCmdBindIndexBuffer);                       \
 			VK_IMPORT_DEVICE_FUNC(false, vkCmdBindVertexBuffers);                     \
 			VK_IMPORT_DEVICE_FUNC(false, vkCmdClearColorImage);                       \
@@ -225,6 +228,15 @@
 			VK_IMPORT_DEVICE_FUNC(true,  vkCmdDrawIndexedIndirectCountKHR);           \
 			/* VK_KHR_fragment_shading_rate */                                        \
 			VK_IMPORT_DEVICE_FUNC(true, vkCmdSetFragmentShadingRateKHR);              \
+			/* VK_EXT_extended_dynamic_state */                                       \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdSetCullModeEXT);                        \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdSetFrontFaceEXT);                       \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdSetPrimitiveTopologyEXT);               \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdSetDepthTestEnableEXT);                 \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdSetDepthWriteEnableEXT);                \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdSetDepthCompareOpEXT);                  \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdSetStencilTestEnableEXT);               \
+			VK_IMPORT_DEVICE_FUNC(true,  vkCmdSetStencilOpEXT);                       \
 
 #define VK_DESTROY                                \
 			VK_DESTROY_FUNC(Buffer);              \
@@ -336,15 +348,15 @@ VK_DESTROY_FUNC(DescriptorSet);
 		void add(uint64_t _key, Ty _value)
 		{
 			invalidate(_key);
-			m_hashMap.insert(stl::make_pair(_key, _value) );
+			m_hashMap.insert(_key, _value);
 		}
 
 		Ty find(uint64_t _key)
 		{
-			typename HashMap::iterator it = m_hashMap.find(_key);
-			if (it != m_hashMap.end() )
+			Ty* it = m_hashMap.find(_key);
+			if (NULL != it)
 			{
-				return it->second;
+				return *it;
 			}
 
 			return 0;
@@ -352,31 +364,36 @@ VK_DESTROY_FUNC(DescriptorSet);
 
 		void invalidate(uint64_t _key)
 		{
-			typename HashMap::iterator it = m_hashMap.find(_key);
-			if (it != m_hashMap.end() )
+			Ty* it = m_hashMap.find(_key);
+			if (NULL != it)
 			{
-				release(it->second);
-				m_hashMap.erase(it);
+				release(*it);
+				m_hashMap.removeByKey(_key);
 			}
 		}
 
 		void invalidate()
 		{
-			for (typename HashMap::iterator it = m_hashMap.begin(), itEnd = m_hashMap.end(); it != itEnd; ++it)
+			for (uint32_t ii = 0, capacity = m_hashMap.getCapacity(); ii < capacity; ++ii)
 			{
-				release(it->second);
+				if (!m_hashMap.isValid(ii) )
+				{
+					continue;
+				}
+
+				release(m_hashMap.getValueAt(ii) );
 			}
 
-			m_hashMap.clear();
+			m_hashMap.reset();
 		}
 
 		uint32_t getCount() const
 		{
-			return uint32_t(m_hashMap.size() );
+			return m_hashMap.getNumElements();
 		}
 
 	private:
-		typedef stl::unordered_map<uint64_t, Ty> HashMap;
+		typedef FlatHashMapT<uint64_t, Ty> HashMap;
 		HashMap m_hashMap;
 	};
 
@@ -386,6 +403,7 @@ VK_DESTROY_FUNC(DescriptorSet);
 			, offset(0)
 			, size(0)
 			, memoryTypeIndex(0)
+			, page(UINT16_MAX)
 		{
 		}
 
@@ -393,6 +411,7 @@ VK_DESTROY_FUNC(DescriptorSet);
 		uint32_t offset;
 		uint32_t size;
 		int32_t memoryTypeIndex;
+		uint16_t page; //!< Device memory page, or UINT16_MAX when memory is not sub-allocated.
 	};
 
 	struct MemoryLruVK
@@ -414,6 +433,58 @@ VK_DESTROY_FUNC(DescriptorSet);
 		void evictAll();
 	};
 
+	/** Sub-allocates device memory from large per memory type pages. Offsets
+	 * and sizes are aligned to bufferImageGranularity, so buffers and images
+	 * can share the same page. Allocations larger than half of page size are
+	 * not handled, and should get their own device memory allocation.
+	 */
+	struct DeviceMemoryAllocatorVK
+	{
+		DeviceMemoryAllocatorVK()
+			: m_granularity(1)
+			, m_used(0)
+			, m_reserved(0)
+		{
+			bx::memSet(m_page, 0, sizeof(m_page) );
+			bx::memSet(m_pageSize, 0, sizeof(m_pageSize) );
+		}
+
+		void init(const VkPhysicalDeviceMemoryProperties& _memoryProperties, uint32_t _granularity);
+		void shutdown();
+		bool alloc(const VkMemoryRequirements& _requirements, int32_t _memoryTypeIndex, DeviceMemoryAllocationVK* _alloc);
+		void free(const DeviceMemoryAllocationVK& _alloc);
+
+		uint64_t getUsed() const
+		{
+			return m_used;
+		}
+
+		uint64_t getReserved() const
+		{
+			return m_reserved;
+		}
+
+		uint16_t getNumPages() const
+		{
+			return m_pageHandle.getNumHandles();
+		}
+
+	private:
+		struct Page
+		{
+			VkDeviceMemory mem;
+			int32_t memoryTypeIndex;
+			NonLocalAllocator allocator;
+		};
+
+		Page* m_page[BGFX_CONFIG_MAX_DEVICE_MEMORY_PAGES];
+		bx::HandleAllocT<BGFX_CONFIG_MAX_DEVICE_MEMORY_PAGES> m_pageHandle;
+		uint32_t m_pageSize[VK_MAX_MEMORY_TYPES];
+		uint32_t m_granularity;
+		uint64_t m_used;
+		uint64_t m_reserved;
+	};
+
 	/** A Buffer used for moving data from main memory to GPU memory.
 	 * This can either be an independently allocated memory region, or a sub-region
 	 * of the scratch staging buffer for the frame-in-flight.
@@ -468,6 +539,14 @@ VK_DESTROY_FUNC(DescriptorSet);
 		uint32_t chunkIdx;
 	};
 
+	struct ChunkedScratchBufferSlab
+	{
+		VkBuffer buffer;
+		uint8_t* data;
+		uint32_t offset;
+		uint32_t size;
+	};
+
 	struct ChunkedScratchBufferVK
 	{
 		ChunkedScratchBufferVK()
@@ -484,6 +563,9 @@ VK_DESTROY_FUNC(DescriptorSet);
 
 		void write(ChunkedScratchBufferOffset& _outSbo, const void* _vsData, uint32_t _vsSize, const void* _fsData = NULL, uint32_t _fsSize = 0);
 
+		void allocSlab(ChunkedScratchBufferSlab& _outSlab, uint32_t _minSize);
+		bool write(ChunkedScratchBufferSlab& _slab, ChunkedScratchBufferOffset& _outSbo, const void* _vsData, uint32_t _vsSize, const void* _fsData = NULL, uint32_t _fsSize = 0) const;
+
 		void begin();
 		void end();
 
@@ -516,6 +598,7 @@ VK_DESTROY_FUNC(DescriptorSet);
 			, m_size(0)
 			, m_flags(BGFX_BUFFER_NONE)
 			, m_dynamic(false)
+			, m_uploadPending(false)
 		{
 		}
 
@@ -528,6 +611,7 @@ VK_DESTROY_FUNC(DescriptorSet);
 		uint32_t m_size;
 		uint16_t m_flags;
 		bool m_dynamic;
+		bool m_uploadPending;
 	};
 
 	typedef BufferVK IndexBufferVK;
@@ -612,6 +696,8 @@ VK_DESTROY_FUNC(DescriptorSet);
 		uint16_t m_numBindings;
 		VkDescriptorSetLayoutBinding m_bindings[2 * BGFX_CONFIG_MAX_TEXTURE_SAMPLERS + 1];
 
+		VkPushConstantRange m_pushConstantRange;
+
 		bool m_oldBindingModel;
 	};
 
@@ -622,12 +708,15 @@ VK_DESTROY_FUNC(DescriptorSet);
 			, m_fsh(NULL)
 			, m_descriptorSetLayout(VK_NULL_HANDLE)
 			, m_pipelineLayout(VK_NULL_HANDLE)
+			, m_pushConstants(false)
 		{
 		}
 
 		void create(const ShaderVK* _vsh, const ShaderVK* _fsh);
 		void destroy();
 
+		void pushConstants(VkCommandBuffer _commandBuffer, const uint8_t* _vsData, const uint8_t* _fsData) const;
+
 		const ShaderVK* m_vsh;
 		const ShaderVK* m_fsh;
 
@@ -641,6 +730,304 @@ VK_DESTROY_FUNC(DescriptorSet);
 
 		VkDescriptorSetLayout m_descriptorSetLayout;
 		VkPipelineLayout m_pipelineLayout;
+
+		bool m_pushConstants;
+	};
+
+	// Descriptor sets keyed by their content. Each entry keeps textures and
+	// buffers it references, so that when one of them is destroyed only
+	// descriptor sets using it are evicted.
+	struct DescriptorSetCacheVK
+	{
+		static uint32_t makeResource(uint8_t _type, uint16_t _idx)
+		{
+			return (uint32_t(_type) << 16) | _idx;
+		}
+
+		VkDescriptorSet* find(uint64_t _hash, const void* _key, uint32_t _keySize);
+		void add(uint64_t _hash, const void* _key, uint32_t _keySize, VkDescriptorSet _descriptorSet, const uint32_t* _resource, uint8_t _num);
+		void invalidate(uint32_t _resource);
+		void invalidate();
+
+		uint32_t getCount() const
+		{
+			return m_hashMap.getNumElements();
+		}
+
+	private:
+		void remove(uint16_t _handle);
+
+		struct Data
+		{
+			uint64_t m_hash;
+			void*    m_key;
+			uint32_t m_keySize;
+			VkDescriptorSet m_descriptorSet;
+			uint32_t m_resource[BGFX_CONFIG_MAX_TEXTURE_SAMPLERS];
+			uint8_t  m_numResources;
+		};
+
+		typedef FlatHashMapT<uint64_t, uint16_t> HashMap;
+		HashMap m_hashMap;
+		bx::HandleAllocLruT<BGFX_CONFIG_RENDERER_VULKAN_MAX_CACHED_DESCRIPTOR_SETS> m_alloc;
+		Data m_data[BGFX_CONFIG_RENDERER_VULKAN_MAX_CACHED_DESCRIPTOR_SETS];
+	};
+
+	struct PipelineJobVK
+	{
+		VkPipelineColorBlendAttachmentState blendAttachmentState[BGFX_CONFIG_MAX_FRAME_BUFFER_ATTACHMENTS];
+		VkPipelineColorBlendStateCreateInfo colorBlendState;
+		VkPipelineInputAssemblyStateCreateInfo inputAssemblyState;
+		VkPipelineRasterizationStateCreateInfo rasterizationState;
+		VkPipelineRasterizationConservativeStateCreateInfoEXT conservativeRasterizationState;
+		VkPipelineRasterizationLineStateCreateInfoEXT lineRasterizationState;
+		VkPipelineDepthStencilStateCreateInfo depthStencilState;
+		VkVertexInputBindingDescription inputBinding[BGFX_CONFIG_MAX_VERTEX_STREAMS + 1];
+		VkVertexInputAttributeDescription inputAttrib[Attrib::Count + BGFX_CONFIG_MAX_INSTANCE_DATA_COUNT];
+		VkPipelineVertexInputStateCreateInfo vertexInputState;
+		VkPipelineDynamicStateCreateInfo dynamicState;
+		VkPipelineShaderStageCreateInfo shaderStages[2];
+		VkPipelineViewportStateCreateInfo viewportState;
+		VkPipelineMultisampleStateCreateInfo multisampleState;
+		VkGraphicsPipelineCreateInfo graphicsPipeline;
+
+		PipelineJobVK* m_next;
+		const ProgramVK* m_program;
+		void*    m_cacheData;
+		uint32_t m_cacheSize;
+		uint32_t m_hash;
+		VkPipelineCache m_cache;
+		VkPipeline m_pipeline;
+		int64_t m_time;
+	};
+
+	struct PipelineCompilerVK
+	{
+		PipelineCompilerVK()
+			: m_workHead(NULL)
+			, m_workTail(NULL)
+			, m_doneHead(NULL)
+			, m_numThreads(0)
+			, m_exit(false)
+		{
+		}
+
+		void init(uint32_t _numThreads);
+		void shutdown();
+		void push(PipelineJobVK* _job);
+		PipelineJobVK* pop(bool _wait);
+
+		uint32_t getNumThreads() const
+		{
+			return m_numThreads;
+		}
+
+	private:
+		static int32_t threadFunc(bx::Thread* _self, void* _userData);
+
+		PipelineJobVK* m_workHead;
+		PipelineJobVK* m_workTail;
+		PipelineJobVK* m_doneHead;
+		uint32_t m_numThreads;
+		bool m_exit;
+
+#if BX_CONFIG_SUPPORTS_THREADING
+		bx::Mutex     m_mutex;
+		bx::Semaphore m_workSem;
+		bx::Semaphore m_doneSem;
+		bx::Thread    m_thread[BGFX_CONFIG_MAX_PIPELINE_THREADS];
+#endif // BX_CONFIG_SUPPORTS_THREADING
+	};
+
+	struct RecordStateVK
+	{
+		void reset();
+		void resetStats();
+		void addStats(const RecordStateVK& _state);
+
+		void update(const UniformBuffer& _uniformBuffer, uint32_t _begin, uint32_t _end);
+		void commit(const UniformBuffer& _uniformBuffer);
+
+		void setShaderUniform(uint8_t _flags, uint32_t _regIndex, const void* _val, uint32_t _numRegs);
+
+		void setShaderUniform4f(uint8_t _flags, uint32_t _regIndex, const void* _val, uint32_t _numRegs)
+		{
+			setShaderUniform(_flags, _regIndex, _val, _numRegs);
+		}
+
+		void setShaderUniform4x4f(uint8_t _flags, uint32_t _regIndex, const void* _val, uint32_t _numRegs)
+		{
+			setShaderUniform(_flags, _regIndex, _val, _numRegs);
+		}
+
+		VkCommandBuffer m_commandBuffer;
+		FrameBufferHandle m_fbh;
+
+		void* const* m_uniforms;
+		uint8_t* m_vsScratch;
+		uint8_t* m_fsScratch;
+		ChunkedScratchBufferSlab* m_slab;
+
+		RenderDraw m_currentState;
+		ProgramHandle m_currentProgram;
+		VkPipeline m_currentPipeline;
+		VkDescriptorSet m_currentDescriptorSet;
+		uint32_t m_currentBindHash;
+		VkIndexType m_currentIndexFormat;
+		uint64_t m_blendFactor;
+		uint64_t m_dynamicState;
+		uint64_t m_dynamicStencil;
+		Rect m_viewScissorRect;
+		bool m_hasPredefined;
+		bool m_viewHasScissor;
+		bool m_restoreScissor;
+		bool m_isFrameBufferValid;
+
+		uint32_t m_numPrimsSubmitted[Topology::Count];
+		uint32_t m_numPrimsRendered[Topology::Count];
+		uint32_t m_numInstances[Topology::Count];
+		uint32_t m_numIndices;
+		uint32_t m_numDrawSkipped;
+		uint32_t m_numDescriptorSets;
+	};
+
+	struct RecordJobVK
+	{
+		uint32_t m_itemBegin;
+		uint32_t m_itemEnd;
+		VkRenderPass m_renderPass;
+		FrameBufferHandle m_fbh;
+		Rect m_rect;
+		uint16_t m_view;
+		VkCommandBuffer m_commandBuffer;
+		bool m_done;
+	};
+
+	struct CommandRecorderVK;
+
+	struct RecordThreadVK
+	{
+		RecordThreadVK();
+
+		VkResult init(CommandRecorderVK* _recorder);
+		void shutdown();
+		void begin(uint32_t _frameInFlight, void* const* _uniforms, const uint32_t* _uniformSize, uint32_t _scratchSize);
+		VkCommandBuffer alloc();
+
+		CommandRecorderVK* m_recorder;
+
+		RecordStateVK m_state;
+		ViewState m_viewState;
+		ChunkedScratchBufferSlab m_slab;
+
+		uint32_t m_uniformCacheItem;
+		bool m_resetViewState;
+
+		VkCommandPool m_commandPool[BGFX_CONFIG_MAX_FRAME_LATENCY];
+		stl::vector<VkCommandBuffer> m_commandBuffer[BGFX_CONFIG_MAX_FRAME_LATENCY];
+		uint32_t m_frameInFlight;
+		uint32_t m_numCommandBuffers;
+
+		void* m_uniforms[BGFX_CONFIG_MAX_UNIFORMS];
+		uint32_t m_uniformSize[BGFX_CONFIG_MAX_UNIFORMS];
+		uint8_t* m_fsScratch;
+		uint8_t* m_vsScratch;
+		uint32_t m_scratchSize;
+	};
+
+	struct CommandRecorderVK
+	{
+		CommandRecorderVK()
+			: m_frame(NULL)
+			, m_job(NULL)
+			, m_numJobs(0)
+			, m_nextJob(0)
+			, m_numDoneWaits(0)
+			, m_numThreads(0)
+			, m_active(false)
+			, m_exit(false)
+		{
+		}
+
+		VkResult init(uint32_t _numThreads);
+		void shutdown();
+		void begin(Frame* _render, RecordJobVK* _jobs, uint32_t _numJobs, void* const* _uniforms, const uint32_t* _uniformSize);
+		VkCommandBuffer wait(const RecordJobVK& _job);
+		void end();
+
+		void lock()
+		{
+#if BX_CONFIG_SUPPORTS_THREADING
+			if (m_active)
+			{
+				m_mutex.lock();
+			}
+#endif // BX_CONFIG_SUPPORTS_THREADING
+		}
+
+		void unlock()
+		{
+#if BX_CONFIG_SUPPORTS_THREADING
+			if (m_active)
+			{
+				m_mutex.unlock();
+			}
+#endif // BX_CONFIG_SUPPORTS_THREADING
+		}
+
+		uint32_t getNumThreads() const
+		{
+			return m_numThreads;
+		}
+
+		bool isActive() const
+		{
+			return m_active;
+		}
+
+		RecordThreadVK* getThread(uint32_t _idx)
+		{
+			return m_thread[_idx];
+		}
+
+	private:
+		static int32_t threadFunc(bx::Thread* _self, void* _userData);
+
+		Frame* m_frame;
+		RecordJobVK* m_job;
+		uint32_t m_numJobs;
+		uint32_t m_nextJob;
+		uint32_t m_numDoneWaits;
+		uint32_t m_numThreads;
+		bool m_active;
+		bool m_exit;
+
+		RecordThreadVK* m_thread[BGFX_CONFIG_MAX_RECORD_THREADS];
+
+#if BX_CONFIG_SUPPORTS_THREADING
+		bx::Mutex     m_mutex;
+		bx::Semaphore m_workSem;
+		bx::Semaphore m_doneSem;
+		bx::Semaphore m_idleSem;
+		bx::Thread    m_worker[BGFX_CONFIG_MAX_RECORD_THREADS];
+#endif // BX_CONFIG_SUPPORTS_THREADING
+	};
+
+	struct CommandRecorderScopeVK
+	{
+		CommandRecorderScopeVK(CommandRecorderVK& _recorder)
+			: m_recorder(_recorder)
+		{
+			m_recorder.lock();
+		}
+
+		~CommandRecorderScopeVK()
+		{
+			m_recorder.unlock();
+		}
+
+	private:
+		CommandRecorderVK& m_recorder;
 	};
 
 	struct TimerQueryVK
@@ -704,10 +1091,12 @@ VK_DESTROY_FUNC(DescriptorSet);
 		void begin(OcclusionQueryHandle _handle);
 		void end();
 		void flush(Frame* _render);
-		void resolve(Frame* _render);
+		void resolve(Frame* _render, uint32_t _frameInFlight);
 		void invalidate(OcclusionQueryHandle _handle);
 
 		OcclusionQueryHandle m_handle[BGFX_CONFIG_MAX_OCCLUSION_QUERIES];
+		OcclusionQueryHandle m_pending[BGFX_CONFIG_MAX_FRAME_LATENCY][BGFX_CONFIG_MAX_OCCLUSION_QUERIES];
+		uint32_t m_numPending[BGFX_CONFIG_MAX_FRAME_LATENCY];
 
 		VkBuffer m_readback;
 		DeviceMemoryAllocationVK m_readbackMemory;
@@ -730,6 +1119,29 @@ VK_DESTROY_FUNC(DescriptorSet);
 		TextureFormat::Enum  m_format;
 	};
 
+	struct ReadbackRequestVK
+	{
+		enum Enum
+		{
+			Texture,
+			ScreenShot,
+			Capture,
+
+			Count
+		};
+
+		ReadbackVK m_readback;
+		VkBuffer m_buffer;
+		DeviceMemoryAllocationVK m_memory;
+		uint64_t m_submitted;     //!< Submit index of command buffer that contains copy.
+		uint32_t m_frameInFlight; //!< Frame in flight of command buffer that contains copy.
+		uint32_t m_deadline;      //!< Frame by which data must be delivered, or UINT32_MAX.
+		void* m_data;
+		uint8_t m_mip;
+		Enum m_type;
+		bx::FilePath m_filePath;
+	};
+
 	struct TextureVK
 	{
 		TextureVK()
@@ -743,6 +1155,7 @@ VK_DESTROY_FUNC(DescriptorSet);
 			, m_singleMsaaImage(VK_NULL_HANDLE)
 			, m_singleMsaaDeviceMem()
 			, m_currentSingleMsaaImageLayout(VK_IMAGE_LAYOUT_UNDEFINED)
+			, m_uploadPending(false)
 		{
 		}
 
@@ -790,6 +1203,8 @@ VK_DESTROY_FUNC(DescriptorSet);
 
 		ReadbackVK m_readback;
 
+		bool m_uploadPending;
+
 	private:
 		VkResult createImages(VkCommandBuffer _commandBuffer);
 		static VkImageAspectFlags getAspectMask(VkFormat _format);
@@ -942,6 +1357,7 @@ VK_DESTROY_FUNC(DescriptorSet);
 		void addSignalSemaphore(VkSemaphore _semaphore);
 		void kick(bool _wait = false);
 		void finish(bool _finishAll = false);
+		bool isComplete(uint64_t _submitted, uint32_t _frameInFlight, bool _wait = false);
 
 		void release(uint64_t _handle, VkObjectType _type);
 		void recycleMemory(DeviceMemoryAllocationVK _mem);
@@ -995,6 +1411,67 @@ VK_DESTROY_FUNC(DescriptorSet);
 		}
 	};
 
+	struct UploadQueueVK
+	{
+		UploadQueueVK()
+			: m_commandBuffer(VK_NULL_HANDLE)
+			, m_size(0)
+			, m_waitTime(0)
+			, m_enabled(false)
+			, m_open(false)
+		{
+		}
+
+		VkResult init(uint32_t _queueFamily, VkQueue _queue);
+		void shutdown();
+
+		bool isEnabled() const { return m_enabled; }
+		bool isOpen() const { return m_open; }
+		void setSharingMode(VkBufferCreateInfo& _bci) const;
+
+		bool claim(BufferVK& _buffer);
+		bool claim(TextureVK& _texture);
+		void copyBuffer(BufferVK& _buffer, VkBuffer _stagingBuffer, const VkBufferCopy& _region);
+		void copyBufferToImage(TextureVK& _texture, VkBuffer _stagingBuffer, uint32_t _bufferImageCopyCount, const VkBufferImageCopy* _bufferImageCopy, uint32_t _size);
+
+		void open();
+		void close(VkCommandBuffer _commandBuffer, CommandQueueVK& _cmd);
+
+		CommandQueueVK  m_cmd;
+		VkCommandBuffer m_commandBuffer;
+		VkSemaphore     m_semaphore[BGFX_CONFIG_MAX_FRAME_LATENCY];
+		uint32_t        m_queueFamily[2];
+
+		struct Buffer
+		{
+			BufferVK* m_buffer;
+			::VkBuffer m_handle;
+		};
+
+		struct Texture
+		{
+			TextureVK* m_texture;
+			::VkImage m_handle;
+		};
+
+		stl::vector<Buffer>  m_buffers;
+		stl::vector<Texture> m_textures;
+
+		stl::vector<VkBufferMemoryBarrier> m_releaseBuffers;
+		stl::vector<VkBufferMemoryBarrier> m_acquireBuffers;
+		stl::vector<VkImageMemoryBarrier>  m_releaseImages;
+		stl::vector<VkImageMemoryBarrier>  m_acquireImages;
+
+		uint32_t m_size;
+		int64_t  m_waitTime;
+
+		bool m_enabled;
+		bool m_open;
+
+	private:
+		VkCommandBuffer alloc();
+	};
+
 } /* namespace bgfx */ } // namespace vk
 
 #endif // BGFX_RENDERER_VK_H_HEADER_GUARD
@@ -17,6 +17,11 @@ namespace bgfx
 	constexpr uint8_t kSpirvBindShift       = 2;
 	constexpr uint8_t kSpirvSamplerShift    = 16;
 
+	// Push constant space is split between vertex and fragment stage, so that
+	// both fit into minimum maxPushConstantsSize guaranteed by Vulkan.
+	constexpr uint8_t kSpirvPushConstantSize           = 128;
+	constexpr uint8_t kSpirvPushConstantFragmentOffset = 64;
+
 	constexpr uint8_t kSpirvOldVertexBinding    = 0;
 	constexpr uint8_t kSpirvOldFragmentBinding  = 48;
 	constexpr uint8_t kSpirvOldFragmentShift    = 48;
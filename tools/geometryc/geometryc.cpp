@@ -95,6 +95,15 @@ struct Primitive
 
 typedef stl::vector<Primitive> PrimitiveArray;
 
+struct Meshlet
+{
+	uint32_t m_startIndex;
+	uint32_t m_numIndices;
+	meshopt_Bounds m_bounds;
+};
+
+typedef stl::vector<Meshlet> MeshletArray;
+
 struct Axis
 {
 	enum Enum
@@ -152,22 +161,31 @@ struct Mesh
 
 static uint32_t s_obbSteps = 17;
 
-constexpr uint32_t kChunkVertexBuffer           = BX_MAKEFOURCC('V', 'B', ' ', 0x1);
-constexpr uint32_t kChunkVertexBufferCompressed = BX_MAKEFOURCC('V', 'B', 'C', 0x0);
-constexpr uint32_t kChunkIndexBuffer            = BX_MAKEFOURCC('I', 'B', ' ', 0x0);
-constexpr uint32_t kChunkIndexBufferCompressed  = BX_MAKEFOURCC('I', 'B', 'C', 0x1);
-constexpr uint32_t kChunkPrimitive              = BX_MAKEFOURCC('P', 'R', 'I', 0x0);
-
-void optimizeVertexCache(uint16_t* _indices, uint32_t _numIndices, uint32_t _numVertices)
+constexpr uint32_t kChunkVertexBuffer             = BX_MAKEFOURCC('V', 'B', ' ', 0x1);
+constexpr uint32_t kChunkVertexBuffer32           = BX_MAKEFOURCC('V', 'B', ' ', 0x2);
+constexpr uint32_t kChunkVertexBufferCompressed   = BX_MAKEFOURCC('V', 'B', 'C', 0x0);
+constexpr uint32_t kChunkVertexBufferCompressed32 = BX_MAKEFOURCC('V', 'B', 'C', 0x1);
+constexpr uint32_t kChunkIndexBuffer              = BX_MAKEFOURCC('I', 'B', ' ', 0x0);
+constexpr uint32_t kChunkIndexBuffer32            = BX_MAKEFOURCC('I', 'B', ' ', 0x1);
+constexpr uint32_t kChunkIndexBufferCompressed    = BX_MAKEFOURCC('I', 'B', 'C', 0x1);
+constexpr uint32_t kChunkIndexBufferCompressed32  = BX_MAKEFOURCC('I', 'B', 'C', 0x2);
+constexpr uint32_t kChunkMeshlet                  = BX_MAKEFOURCC('M', 'S', 'H', 0x0);
+constexpr uint32_t kChunkPrimitive                = BX_MAKEFOURCC('P', 'R', 'I', 0x0);
+
+constexpr uint32_t kMeshletMaxVertices  = 64;
+constexpr uint32_t kMeshletMaxTriangles = 124;
+constexpr float    kMeshletConeWeight   = 0.25f;
+
+void optimizeVertexCache(uint32_t* _indices, uint32_t _numIndices, uint32_t _numVertices)
 {
-	uint16_t* newIndexList = new uint16_t[_numIndices];
+	uint32_t* newIndexList = new uint32_t[_numIndices];
 	meshopt_optimizeVertexCache(newIndexList, _indices, _numIndices, _numVertices);
-	bx::memCopy(_indices, newIndexList, _numIndices * 2);
+	bx::memCopy(_indices, newIndexList, _numIndices * sizeof(uint32_t) );
 	delete[] newIndexList;
 }
 
 uint32_t optimizeVertexFetch(
-	  uint16_t* _indices
+	  uint32_t* _indices
 	, uint32_t _numIndices
 	, uint8_t* _vertexData
 	, uint32_t _numVertices
@@ -182,11 +200,96 @@ uint32_t optimizeVertexFetch(
 	return uint32_t(vertexCount);
 }
 
+uint32_t buildMeshlets(
+	  MeshletArray& _meshlets
+	, PrimitiveArray& _primitives
+	, uint32_t* _indices
+	, uint32_t _numIndices
+	, const uint8_t* _vertexData
+	, uint32_t _numVertices
+	, uint16_t _stride
+	)
+{
+	const float* positions = (const float*)_vertexData;
+
+	uint32_t* newIndexList = new uint32_t[_numIndices];
+	uint32_t numIndices = 0;
+
+	for (PrimitiveArray::iterator primIt = _primitives.begin(); primIt != _primitives.end(); ++primIt)
+	{
+		Primitive& prim = *primIt;
+
+		const uint32_t* indices = &_indices[prim.m_startIndex];
+
+		const size_t maxMeshlets = meshopt_buildMeshletsBound(prim.m_numIndices, kMeshletMaxVertices, kMeshletMaxTriangles);
+		meshopt_Meshlet* meshlets  = new meshopt_Meshlet[maxMeshlets];
+		uint32_t* meshletVertices  = new uint32_t[prim.m_numIndices];
+		uint8_t*  meshletTriangles = new uint8_t[prim.m_numIndices];
+
+		const size_t numMeshlets = meshopt_buildMeshlets(
+			  meshlets
+			, meshletVertices
+			, meshletTriangles
+			, indices
+			, prim.m_numIndices
+			, positions
+			, _numVertices
+			, _stride
+			, kMeshletMaxVertices
+			, kMeshletMaxTriangles
+			, kMeshletConeWeight
+			);
+
+		const uint32_t startIndex = numIndices;
+
+		// Expand meshlet local triangles back to vertex buffer indices, so each meshlet is
+		// contiguous index buffer range that can be drawn without mesh shaders.
+		for (size_t ii = 0; ii < numMeshlets; ++ii)
+		{
+			const meshopt_Meshlet& ml = meshlets[ii];
+			const uint32_t* mlVertices  = &meshletVertices[ml.vertex_offset];
+			const uint8_t*  mlTriangles = &meshletTriangles[ml.triangle_offset];
+
+			Meshlet meshlet;
+			meshlet.m_startIndex = numIndices;
+			meshlet.m_numIndices = ml.triangle_count*3;
+			meshlet.m_bounds     = meshopt_computeMeshletBounds(
+				  mlVertices
+				, mlTriangles
+				, ml.triangle_count
+				, positions
+				, _numVertices
+				, _stride
+				);
+
+			for (uint32_t jj = 0, num = ml.triangle_count*3; jj < num; ++jj)
+			{
+				newIndexList[numIndices++] = mlVertices[mlTriangles[jj] ];
+			}
+
+			_meshlets.push_back(meshlet);
+		}
+
+		prim.m_startIndex = startIndex;
+		prim.m_numIndices = numIndices - startIndex;
+
+		delete [] meshletTriangles;
+		delete [] meshletVertices;
+		delete [] meshlets;
+	}
+
+	bx::memCopy(_indices, newIndexList, numIndices * sizeof(uint32_t) );
+	delete [] newIndexList;
+
+	return numIndices;
+}
+
 void writeCompressedIndices(
 	  bx::WriterI* _writer
-	, const uint16_t* _indices
+	, const uint32_t* _indices
 	, uint32_t _numIndices
 	, uint32_t _numVertices
+	, uint32_t _indexSize
 	, bx::Error* _err
 	)
 {
@@ -196,9 +299,9 @@ void writeCompressedIndices(
 	size_t compressedSize = meshopt_encodeIndexBuffer(compressedIndices, maxSize, _indices, _numIndices);
 
 	bx::printf("Indices uncompressed: %10d, compressed: %10d, ratio: %0.2f%%\n"
-		, _numIndices*2
+		, _numIndices*_indexSize
 		, (uint32_t)compressedSize
-		, 100.0f - float(compressedSize ) / float(_numIndices*2)*100.0f
+		, 100.0f - float(compressedSize ) / float(_numIndices*_indexSize)*100.0f
 		);
 
 	bx::write(_writer, (uint32_t)compressedSize, _err);
@@ -232,7 +335,7 @@ void writeCompressedVertices(
 	free(compressedVertices);
 }
 
-void calcTangents(void* _vertices, uint16_t _numVertices, bgfx::VertexLayout _layout, const uint16_t* _indices, uint32_t _numIndices)
+void calcTangents(void* _vertices, uint32_t _numVertices, bgfx::VertexLayout _layout, const uint32_t* _indices, uint32_t _numIndices)
 {
 	struct PosTexcoord
 	{
@@ -255,7 +358,7 @@ void calcTangents(void* _vertices, uint16_t _numVertices, bgfx::VertexLayout _la
 
 	for (uint32_t ii = 0, num = _numIndices/3; ii < num; ++ii)
 	{
-		const uint16_t* indices = &_indices[ii*3];
+		const uint32_t* indices = &_indices[ii*3];
 		uint32_t i0 = indices[0];
 		uint32_t i1 = indices[1];
 		uint32_t i2 = indices[2];
@@ -366,11 +469,13 @@ void write(
 	, const uint8_t* _vertices
 	, uint32_t _numVertices
 	, const bgfx::VertexLayout& _layout
-	, const uint16_t* _indices
+	, const uint32_t* _indices
 	, uint32_t _numIndices
 	, bool _compress
+	, bool _index32
 	, const stl::string& _material
 	, const PrimitiveArray& _primitives
+	, const MeshletArray& _meshlets
 	, bx::Error* _err
 	)
 {
@@ -381,37 +486,91 @@ void write(
 
 	if (_compress)
 	{
-		write(_writer, kChunkVertexBufferCompressed, _err);
+		write(_writer, _index32 ? kChunkVertexBufferCompressed32 : kChunkVertexBufferCompressed, _err);
 		write(_writer, _vertices, _numVertices, stride, _err);
 
 		write(_writer, _layout);
 
-		write(_writer, uint16_t(_numVertices), _err);
+		if (_index32)
+		{
+			write(_writer, _numVertices, _err);
+		}
+		else
+		{
+			write(_writer, uint16_t(_numVertices), _err);
+		}
+
 		writeCompressedVertices(_writer, _vertices, _numVertices, uint16_t(stride), _err);
 	}
 	else
 	{
-		write(_writer, kChunkVertexBuffer, _err);
+		write(_writer, _index32 ? kChunkVertexBuffer32 : kChunkVertexBuffer, _err);
 		write(_writer, _vertices, _numVertices, stride, _err);
 
 		write(_writer, _layout, _err);
 
-		write(_writer, uint16_t(_numVertices), _err);
+		if (_index32)
+		{
+			write(_writer, _numVertices, _err);
+		}
+		else
+		{
+			write(_writer, uint16_t(_numVertices), _err);
+		}
+
 		write(_writer, _vertices, _numVertices*stride, _err);
 	}
 
+	const uint32_t indexSize = _index32 ? sizeof(uint32_t) : sizeof(uint16_t);
+
 	if (_compress)
 	{
-		write(_writer, kChunkIndexBufferCompressed, _err);
+		write(_writer, _index32 ? kChunkIndexBufferCompressed32 : kChunkIndexBufferCompressed, _err);
 		write(_writer, _numIndices, _err);
 
-		writeCompressedIndices(_writer, _indices, _numIndices, _numVertices, _err);
+		writeCompressedIndices(_writer, _indices, _numIndices, _numVertices, indexSize, _err);
+	}
+	else if (_index32)
+	{
+		write(_writer, kChunkIndexBuffer32, _err);
+		write(_writer, _numIndices, _err);
+		write(_writer, _indices, _numIndices*indexSize, _err);
 	}
 	else
 	{
+		uint16_t* indices = new uint16_t[_numIndices];
+		for (uint32_t ii = 0; ii < _numIndices; ++ii)
+		{
+			indices[ii] = uint16_t(_indices[ii]);
+		}
+
 		write(_writer, kChunkIndexBuffer, _err);
 		write(_writer, _numIndices, _err);
-		write(_writer, _indices, _numIndices*2, _err);
+		write(_writer, indices, _numIndices*indexSize, _err);
+
+		delete [] indices;
+	}
+
+	if (!_meshlets.empty() )
+	{
+		write(_writer, kChunkMeshlet, _err);
+		write(_writer, uint32_t(_meshlets.size() ), _err);
+
+		for (MeshletArray::const_iterator meshletIt = _meshlets.begin(); meshletIt != _meshlets.end(); ++meshletIt)
+		{
+			const Meshlet& meshlet = *meshletIt;
+			write(_writer, meshlet.m_startIndex, _err);
+			write(_writer, meshlet.m_numIndices, _err);
+
+			bx::Sphere sphere;
+			sphere.center = bx::load<bx::Vec3>(meshlet.m_bounds.center);
+			sphere.radius = meshlet.m_bounds.radius;
+			write(_writer, sphere, _err);
+
+			write(_writer, meshlet.m_bounds.cone_apex,   sizeof(meshlet.m_bounds.cone_apex),   _err);
+			write(_writer, meshlet.m_bounds.cone_axis,   sizeof(meshlet.m_bounds.cone_axis),   _err);
+			write(_writer, meshlet.m_bounds.cone_cutoff, _err);
+		}
 	}
 
 	write(_writer, kChunkPrimitive, _err);
@@ -962,6 +1121,8 @@ void help(const char* _error = NULL)
 		  "      --tangent            Calculate tangent vectors. (packing mode is the same as normal)\n"
 		  "      --barycentric        Adds barycentric vertex attribute. (Packed in bgfx::Attrib::Color1)\n"
 		  "  -c, --compress           Compress indices.\n"
+		  "      --index32            Output 32-bit indices, primitives are not split at 65535 vertices.\n"
+		  "      --meshlet            Reorder indices into meshlets, and output meshlet bounds and normal cones.\n"
 		  "      --[l/r]h-up+[y/z]	  Coordinate system. Defaults to '--lh-up+y' — Left-Handed +Y is up.\n"
 
 		  "\n"
@@ -1015,6 +1176,8 @@ int main(int _argc, const char* _argv[])
 	}
 
 	bool compress = cmdLine.hasArg('c', "compress");
+	bool index32  = cmdLine.hasArg("index32");
+	bool meshlet  = cmdLine.hasArg("meshlet");
 
 	cmdLine.hasArg(s_obbSteps, '\0', "obb");
 	s_obbSteps = bx::uint32_min(bx::uint32_max(s_obbSteps, 1), 90);
@@ -1218,7 +1381,7 @@ int main(int _argc, const char* _argv[])
 
 	uint32_t stride = layout.getStride();
 	uint8_t* vertexData = new uint8_t[mesh.m_triangles.size() * 3 * stride];
-	uint16_t* indexData = new uint16_t[mesh.m_triangles.size() * 3];
+	uint32_t* indexData = new uint32_t[mesh.m_triangles.size() * 3];
 	int32_t numVertices = 0;
 	int32_t numIndices = 0;
 
@@ -1227,9 +1390,13 @@ int main(int _argc, const char* _argv[])
 	int32_t writtenIndices = 0;
 
 	uint8_t* vertices = vertexData;
-	uint16_t* indices = indexData;
+	uint32_t* indices = indexData;
 
-	const uint32_t tableSize = 65536 * 2;
+	const uint32_t maxVertices = index32 ? UINT32_MAX : 65533;
+	const uint32_t tableSize   = index32
+		? bx::uint32_nextpow2(bx::uint32_max(65536, uint32_t(mesh.m_triangles.size() * 3) ) ) * 2
+		: 65536 * 2
+		;
 	const uint32_t hashmod = tableSize - 1;
 	uint32_t* table = new uint32_t[tableSize];
 	bx::memSet(table, 0xff, tableSize * sizeof(uint32_t) );
@@ -1237,6 +1404,7 @@ int main(int _argc, const char* _argv[])
 	stl::string material = mesh.m_groups.empty() ? "" : mesh.m_groups.begin()->m_material;
 
 	PrimitiveArray primitives;
+	MeshletArray meshlets;
 
 	bx::FileWriter writer;
 	if (!bx::open(&writer, outFilePath) )
@@ -1268,7 +1436,7 @@ int main(int _argc, const char* _argv[])
 		{
 			if (0 != bx::strCmp(material.c_str(), groupIt->m_material.c_str() )
 			||  sentinel
-			||  65533 <= numVertices)
+			||  maxVertices <= uint32_t(numVertices) )
 			{
 				prim.m_numVertices = numVertices - prim.m_startVertex;
 				prim.m_numIndices  = numIndices  - prim.m_startIndex;
@@ -1280,7 +1448,7 @@ int main(int _argc, const char* _argv[])
 
 				if (hasTangent)
 				{
-					calcTangents(vertexData, uint16_t(numVertices), layout, indexData, numIndices);
+					calcTangents(vertexData, numVertices, layout, indexData, numIndices);
 				}
 
 				triReorderElapsed -= bx::getHPCounter();
@@ -1293,6 +1461,11 @@ int main(int _argc, const char* _argv[])
 
 				numVertices = optimizeVertexFetch(indexData, numIndices, vertexData, numVertices, uint16_t(stride) );
 
+				if (meshlet)
+				{
+					numIndices = buildMeshlets(meshlets, primitives, indexData, numIndices, vertexData, numVertices, uint16_t(stride) );
+				}
+
 				triReorderElapsed += bx::getHPCounter();
 
 				if (0 < numVertices
@@ -1305,12 +1478,15 @@ int main(int _argc, const char* _argv[])
 						, indexData
 						, numIndices
 						, compress
+						, index32
 						, material
 						, primitives
+						, meshlets
 						, &err
 						);
 				}
 				primitives.clear();
+				meshlets.clear();
 
 				bx::memSet(table, 0xff, tableSize * sizeof(uint32_t) );
 
@@ -1411,7 +1587,7 @@ int main(int _argc, const char* _argv[])
 					exit(bx::kExitFailure);
 				}
 
-				*indices++ = (uint16_t)vertexIndex;
+				*indices++ = vertexIndex;
 				++numIndices;
 			}
 		}
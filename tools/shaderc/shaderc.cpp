@@ -382,6 +382,8 @@ namespace bgfx
 		, backwardsCompatibility(false)
 		, warningsAreErrors(false)
 		, keepIntermediate(false)
+		, pushConstants(false)
+		, uniformBlocks(false)
 		, optimize(false)
 		, optimizationLevel(3)
 	{
@@ -407,6 +409,8 @@ namespace bgfx
 			"\t  backwardsCompatibility: %s\n"
 			"\t  warningsAreErrors: %s\n"
 			"\t  keepIntermediate: %s\n"
+			"\t  pushConstants: %s\n"
+			"\t  uniformBlocks: %s\n"
 			"\t  optimize: %s\n"
 			"\t  optimizationLevel: %d\n"
 
@@ -427,6 +431,8 @@ namespace bgfx
 			, backwardsCompatibility ? "true" : "false"
 			, warningsAreErrors ? "true" : "false"
 			, keepIntermediate ? "true" : "false"
+			, pushConstants ? "true" : "false"
+			, uniformBlocks ? "true" : "false"
 			, optimize ? "true" : "false"
 			, optimizationLevel
 			);
@@ -1092,6 +1098,18 @@ namespace bgfx
 			  "\n"
 			  "      --debug                   Debug information.\n"
 
+			  "\n"
+			  "(Vulkan only):\n"
+
+			  "\n"
+			  "      --push-constants          Place uniforms in push constants when they fit, instead of uniform buffer.\n"
+
+			  "\n"
+			  "(OpenGL only):\n"
+
+			  "\n"
+			  "      --uniform-blocks          Put uniforms into std140 uniform block. (GLSL 140+ and ESSL 300+ only)\n"
+
 			  "\n"
 			  "(DirectX only):\n"
 
@@ -2722,6 +2740,8 @@ namespace bgfx
 			options.backwardsCompatibility = cmdLine.hasArg('\0', "backwards-compatibility");
 			options.warningsAreErrors      = cmdLine.hasArg('\0', "Werror");
 			options.keepIntermediate       = cmdLine.hasArg('\0', "keep-intermediate");
+			options.pushConstants          = cmdLine.hasArg('\0', "push-constants");
+			options.uniformBlocks          = cmdLine.hasArg('\0', "uniform-blocks");
 
 			uint32_t optimization = 3;
 			if (cmdLine.hasArg(optimization, 'O') )
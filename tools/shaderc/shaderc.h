@@ -105,6 +105,8 @@ namespace bgfx
 		bool backwardsCompatibility;
 		bool warningsAreErrors;
 		bool keepIntermediate;
+		bool pushConstants;
+		bool uniformBlocks;
 
 		bool optimize;
 		uint32_t optimizationLevel;
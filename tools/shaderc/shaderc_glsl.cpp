@@ -8,6 +8,34 @@
 
 namespace bgfx { namespace glsl
 {
+	struct UniformBlockDecl
+	{
+		uint32_t begin;
+		uint32_t end;
+		std::string name;
+		std::string member;
+	};
+
+	static void replaceIdentifier(std::string& _code, uint32_t _start, const std::string& _name, const std::string& _replace)
+	{
+		for (uint32_t pos = _start;;)
+		{
+			const bx::StringView match = bx::findIdentifierMatch(
+				  bx::StringView(_code.c_str() + pos, _code.c_str() + _code.size() )
+				, _name.c_str()
+				);
+
+			if (match.isEmpty() )
+			{
+				break;
+			}
+
+			const uint32_t offset = uint32_t(match.getPtr() - _code.c_str() );
+			_code.replace(offset, _name.size(), _replace);
+			pos = offset + uint32_t(_replace.size() );
+		}
+	}
+
 	static bool compile(const Options& _options, uint32_t _version, const std::string& _code, bx::WriterI* _shaderWriter, bx::WriterI* _messageWriter)
 	{
 		bx::ErrorAssert messageErr;
@@ -103,6 +131,18 @@ namespace bgfx { namespace glsl
 
 		UniformArray uniforms;
 
+		// Uniform blocks require GLSL 1.40 or ESSL 3.00.
+		const bool uniformBlocks = true
+			&& _options.uniformBlocks
+			&& (false
+				|| (target == kGlslTargetOpenGL && _version >= 140)
+				||  target == kGlslTargetOpenGLES30
+				)
+			;
+
+		std::vector<UniformBlockDecl> uniformBlockDecls;
+		uint16_t uniformBlockRegs = 0;
+
 		if (target != kGlslTargetMetal)
 		{
 			bx::StringView parse(optimizedShader);
@@ -113,6 +153,7 @@ namespace bgfx { namespace glsl
 				bx::StringView eol = bx::strFind(parse, ';');
 				if (!eol.isEmpty() )
 				{
+					const char* declBegin = parse.getPtr();
 					bx::StringView qualifier = nextWord(parse);
 
 					if (0 == bx::strCmp(qualifier, "precision", 9) )
@@ -158,6 +199,8 @@ namespace bgfx { namespace glsl
 						continue;
 					}
 
+					const char* memberBegin = parse.getPtr();
+
 					bx::StringView precision;
 					bx::StringView typen = nextWord(parse);
 
@@ -221,6 +264,24 @@ namespace bgfx { namespace glsl
 							break;
 						}
 
+						// Opaque types (samplers) can't be uniform block members.
+						if (uniformBlocks
+						&& (UniformType::Vec4 == un.type
+						||  UniformType::Mat3 == un.type
+						||  UniformType::Mat4 == un.type) )
+						{
+							// All block members are vec4 aligned in std140 layout.
+							un.regIndex = uniformBlockRegs;
+							uniformBlockRegs += un.regCount;
+
+							UniformBlockDecl decl;
+							decl.begin = uint32_t(declBegin - optimizedShader);
+							decl.end   = uint32_t(eol.getPtr() + 1 - optimizedShader);
+							decl.name  = un.name;
+							decl.member.assign(memberBegin, eol.getPtr() + 1);
+							uniformBlockDecls.push_back(decl);
+						}
+
 						uniforms.push_back(un);
 					}
 
@@ -347,6 +408,49 @@ namespace bgfx { namespace glsl
 			}
 		}
 
+		if (!uniformBlockDecls.empty() )
+		{
+			// Move uniform declarations into uniform block, and access them
+			// through block instance name. Instance name keeps member names
+			// unique when the same uniform is used by multiple stages.
+			const char ch = _options.shaderType;
+			const char* blockName = ch == 'f'
+				? "bgfx_FsUniforms"
+				: (ch == 'c' ? "bgfx_CsUniforms" : "bgfx_VsUniforms")
+				;
+			const char* instanceName = ch == 'f'
+				? "bgfx_fs"
+				: (ch == 'c' ? "bgfx_cs" : "bgfx_vs")
+				;
+
+			std::string code;
+			uint32_t pos = 0;
+			for (const UniformBlockDecl& decl : uniformBlockDecls)
+			{
+				code.append(optimizedShader + pos, decl.begin - pos);
+				pos = decl.end;
+			}
+			code.append(optimizedShader + pos);
+
+			const uint32_t insert = uniformBlockDecls[0].begin;
+			std::string tail = code.substr(insert);
+
+			for (const UniformBlockDecl& decl : uniformBlockDecls)
+			{
+				replaceIdentifier(tail, 0, decl.name, std::string(instanceName) + "." + decl.name);
+			}
+
+			std::string block = std::string("layout(std140) uniform ") + blockName + "\n{\n";
+			for (const UniformBlockDecl& decl : uniformBlockDecls)
+			{
+				block += "\t" + decl.member + "\n";
+			}
+			block += std::string("} ") + instanceName + ";\n";
+
+			out = code.substr(0, insert) + block + tail;
+			optimizedShader = out.c_str();
+		}
+
 		bx::ErrorAssert err;
 
 		uint16_t count = (uint16_t)uniforms.size();
@@ -441,6 +441,27 @@ namespace bgfx { namespace spirv
 		}
 	}
 
+	static uint32_t getUniformSize(glslang::TProgram* _program, int32_t _index)
+	{
+		uint32_t numRegs = 1;
+
+		switch (_program->getUniformType(_index) )
+		{
+		case 0x8B5B: // GL_FLOAT_MAT3:
+			numRegs = 3;
+			break;
+
+		case 0x8B5C: // GL_FLOAT_MAT4:
+			numRegs = 4;
+			break;
+
+		default:
+			break;
+		}
+
+		return numRegs * 16 * bx::max<uint32_t>(1, _program->getUniformArraySize(_index) );
+	}
+
 	/// This is the value used to fill out GLSLANG's SpvVersion object.
 	/// The required value is that which is defined by GL_KHR_vulkan_glsl, which is defined here:
 	/// https://github.com/KhronosGroup/GLSL/blob/master/extensions/khr/GL_KHR_vulkan_glsl.txt
@@ -565,6 +586,7 @@ namespace bgfx { namespace spirv
 						std::string decl;
 					};
 					std::vector<Uniform> uniforms;
+					uint32_t uniformSize = 0;
 
 					bx::LineReader reader(_code.c_str() );
 					while (!reader.isDone() )
@@ -579,6 +601,7 @@ namespace bgfx { namespace spirv
 							bool found = false;
 							bool sampler = false;
 							std::string name = "";
+							int32_t index = -1;
 
 							// add to samplers
 
@@ -605,6 +628,7 @@ namespace bgfx { namespace spirv
 									{
 										found = true;
 										name = program->getUniformName(ii);
+										index = ii;
 										break;
 									}
 								}
@@ -624,6 +648,7 @@ namespace bgfx { namespace spirv
 								uniform.name = name;
 								uniform.decl = std::string(strLine.getPtr(), strLine.getTerm() );
 								uniforms.push_back(uniform);
+								uniformSize += getUniformSize(program, index);
 								moved = true;
 							}
 						}
@@ -635,10 +660,42 @@ namespace bgfx { namespace spirv
 						}
 					}
 
+					// With --push-constants small uniform blocks are placed in push
+					// constants, so that renderer can update them without writing
+					// uniform buffer and rebinding descriptor set. It's opt-in since
+					// renderers built before push constant support can't load them.
+					const uint32_t pushConstantSize = 'f' == _options.shaderType
+						? kSpirvPushConstantSize - kSpirvPushConstantFragmentOffset
+						: 'v' == _options.shaderType
+						? kSpirvPushConstantFragmentOffset
+						: kSpirvPushConstantSize
+						;
+					const bool pushConstants = true
+						&& _options.pushConstants
+						&& 0 < uniformSize
+						&& uniformSize <= pushConstantSize
+						;
+
 					std::string uniformBlock;
+
+					if (pushConstants)
+					{
+						uniformBlock += "[[vk::push_constant]]\n";
+					}
+
 					uniformBlock += "cbuffer UniformBlock\n";
 					uniformBlock += "{\n";
 
+					if (pushConstants
+					&&  'f' == _options.shaderType)
+					{
+						// Fragment shader push constants are placed after vertex
+						// shader ones.
+						char temp[64];
+						bx::snprintf(temp, sizeof(temp), "float4 pushConstantOffset[%d];\n", kSpirvPushConstantFragmentOffset/16);
+						uniformBlock += temp;
+					}
+
 					for (const Uniform& uniform : uniforms)
 					{
 						uniformBlock += uniform.decl.substr(7 /* uniform */);